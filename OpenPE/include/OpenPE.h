@@ -7,3 +7,24 @@
 #include "OpenPEDotNet.h"
 #include "OpenPEImports.h"
 #include "OpenPEExports.h"
+#include "OpenPEDataCursor.h"
+#include "OpenPECompactImports.h"
+#include "OpenPEHash.h"
+#include "OpenPEImpHash.h"
+#include "OpenPEModuleCorpus.h"
+#include "OpenPEBoundImports.h"
+#include "OpenPEImportResolver.h"
+#include "OpenPEInternTable.h"
+#include "OpenPEForwarderResolver.h"
+#include "OpenPEApiHash.h"
+#include "OpenPEExportDiff.h"
+#include "OpenPEResources.h"
+#include "OpenPEVersionInfo.h"
+#include "OpenPEMessageTable.h"
+#include "OpenPEStringTable.h"
+#include "OpenPERelocations.h"
+#include "OpenPERebase.h"
+#include "OpenPETLS.h"
+#include "OpenPELoadConfig.h"
+#include "OpenPERuntimeFunctions.h"
+#include "OpenPEUnwindInfo.h"
\ No newline at end of file
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <istream>
+#include <ostream>
+#include <stdint.h>
+#include "OpenPEBase.h"
+#include "OpenPEStringView.h"
+
+namespace OpenPE
+{
+	// Name hashes used by shellcode & packers to resolve imports
+	enum PEApiHashAlgorithm
+	{
+		PE_API_HASH_ROR13			= 0x01,		// h = ror(h, 13) + c over the function name
+		PE_API_HASH_ROR13_MODULE	= 0x02,		// ROR13 of the uppercase UTF-16 library name (with terminator) + ROR13 of the function name (with terminator)
+		PE_API_HASH_CRC32			= 0x04,		// CRC-32 (IEEE 802.3) of the function name
+		PE_API_HASH_FNV1A			= 0x08,		// 32-bit FNV-1a of the function name
+		PE_API_HASH_DJB2			= 0x10,		// h = h * 33 + c over the function name (h = 5381 initially)
+		PE_API_HASH_ALL				= 0x1F
+	};
+
+	// Returns hash of the function exported by the library (sModuleName is used by PE_API_HASH_ROR13_MODULE only)
+	// Throws if eAlgorithm is not a single algorithm
+	uint32_t				computeApiHash(PEApiHashAlgorithm eAlgorithm, const PEStringView& sModuleName, const PEStringView& sFunctionName);
+
+	// Class representing a function found by its hash
+	class PEApiHashMatch
+	{
+		public:
+			// Default Constructor
+			PEApiHashMatch();
+
+			// Returns index of the hash in the batch that was looked up
+			size_t					getHashIndex() const;
+
+			// Returns the algorithm the hash matched
+			PEApiHashAlgorithm		getAlgorithm() const;
+
+			// Returns the hash
+			uint32_t				getHash() const;
+
+			// Returns name of the library (references memory of the table)
+			const PEStringView&		getModuleName() const;
+
+			// Returns name of the function (references memory of the table)
+			const PEStringView&		getFunctionName() const;
+
+			// Returns ordinal of the function
+			uint16_t				getOrdinal() const;
+
+			// Returns RVA of the function (RVA of the forwarded name, if the function is forwarded)
+			uint32_t				getRVA() const;
+		private:
+			friend class PEApiHashTable;
+
+			size_t					m_iHashIndex;
+			PEApiHashAlgorithm		m_eAlgorithm;
+			uint32_t				m_iHash;
+			PEStringView			m_vModuleName;
+			PEStringView			m_vFunctionName;
+			uint16_t				m_iOrdinal;
+			uint32_t				m_iRVA;
+	};
+
+	typedef std::vector<PEApiHashMatch>		PEAPI_HASH_MATCH_LIST;
+
+	// Class representing precomputed hash -> (library, function) tables of named exports of a set of libraries
+	// The tables are a single flat image of 32-bit words (offsets only, native byte order), so that a saved
+	// table can be memory-mapped & used in place with open(), without being parsed or copied
+	// Lookups go through an open-addressing hash table per algorithm (all functions sharing a hash are found)
+	class PEApiHashTable
+	{
+		public:
+			// Default Constructor
+			PEApiHashTable();
+
+			// Uses the table image at pData (e.g. a memory-mapped file written by save()) without copying it
+			// pData must be 4-byte aligned & must stay valid while the table is used
+			// Throws PEException if the image is incorrect
+			void					open(const void* pData, size_t iSize);
+
+			// Reads the table written by save(), throws PEException if the data is incorrect
+			void					load(std::istream& fStream);
+
+			// Writes the table image to the stream
+			void					save(std::ostream& fStream) const;
+
+			// Returns the table image
+			const void*				getData() const;
+
+			// Returns size of the table image in bytes
+			size_t					getSize() const;
+
+			// Returns 'true' if there is no table
+			bool					isEmpty() const;
+
+			// Returns mask of PEApiHashAlgorithm in the table
+			uint32_t				getAlgorithms() const;
+
+			// Returns number of libraries
+			uint32_t				getNumberOfModules() const;
+
+			// Returns number of hashed functions
+			uint32_t				getNumberOfFunctions() const;
+
+			// Returns name of the library at index
+			const PEStringView		getModuleName(uint32_t iModule) const;
+
+			// Appends all functions with the hash to vMatches, returns number of functions appended
+			size_t					findHash(PEApiHashAlgorithm eAlgorithm, uint32_t iHash, PEAPI_HASH_MATCH_LIST& vMatches) const;
+
+			// Looks up iNumberOfHashes hashes with every algorithm of the mask, appends all functions found to vMatches
+			// (getHashIndex() of a match is the index into pHashes), returns number of hashes that matched a function
+			size_t					findHashes(uint32_t iAlgorithms, const uint32_t* pHashes, size_t iNumberOfHashes, PEAPI_HASH_MATCH_LIST& vMatches) const;
+
+			// Drops the table
+			void					clear();
+		private:
+			friend class PEApiHashTableBuilder;
+
+			// Copying is not allowed (the table may point into its own image)
+			PEApiHashTable(const PEApiHashTable&);
+			PEApiHashTable& operator=(const PEApiHashTable&);
+
+			// Image header
+			struct PEApiHashHeader
+			{
+				uint32_t			m_iSignature;
+				uint32_t			m_iVersion;
+				uint32_t			m_iSize;					// Size of the image in bytes
+				uint32_t			m_iAlgorithms;
+				uint32_t			m_iNumberOfModules;
+				uint32_t			m_iNumberOfFunctions;
+				uint32_t			m_iModulesOffset;			// Byte offsets from the start of the image
+				uint32_t			m_iFunctionsOffset;
+				uint32_t			m_iTablesOffset;
+				uint32_t			m_iStringsOffset;
+				uint32_t			m_iStringsSize;
+			};
+
+			// Hashed function
+			struct PEApiHashFunction
+			{
+				uint32_t			m_iModule;
+				uint32_t			m_iNameOffset;				// Offset into the strings
+				uint32_t			m_iOrdinal;
+				uint32_t			m_iRVA;
+			};
+
+			// Hash table of one algorithm (one per algorithm of the mask, in bit order)
+			struct PEApiHashSlots
+			{
+				uint32_t			m_iAlgorithm;
+				uint32_t			m_iNumberOfSlots;			// Power of two, more than the number of functions
+				uint32_t			m_iSlotsOffset;				// Slots are (hash, function index + 1) pairs, 0 = empty
+			};
+
+			// Takes ownership of the image built by PEApiHashTableBuilder
+			void					adopt(std::vector<uint32_t>& vImage);
+
+			// Returns hash table of the algorithm, or 0 if it is not in the table
+			const PEApiHashSlots*	getSlots(PEApiHashAlgorithm eAlgorithm) const;
+
+			// Returns null-terminated string at offset of the strings
+			const PEStringView		getStringAt(uint32_t iOffset) const;
+
+			// Returns word at byte offset of the image
+			const uint32_t*			getWords(uint32_t iOffset) const;
+
+			std::vector<uint32_t>	m_vImage;					// Image owned by the table (empty if open() was used)
+			const uint8_t*			m_pData;
+			const PEApiHashHeader*	m_pHeader;
+	};
+
+	// Class collecting named exports of libraries & building a PEApiHashTable
+	// Every library is parsed once, its names are hashed with all algorithms of the mask as they are added
+	class PEApiHashTableBuilder
+	{
+		public:
+			// Constructor, iAlgorithms is a mask of PEApiHashAlgorithm
+			explicit PEApiHashTableBuilder(uint32_t iAlgorithms = PE_API_HASH_ALL);
+
+			// Adds named exports of the library Image
+			// sModuleName is the file name of the library (e.g. "kernel32.dll"), hashed by PE_API_HASH_ROR13_MODULE
+			void					addModule(const PEBase& peLibrary, const std::string& sModuleName);
+
+			// Reads the library file & adds its named exports under its file name
+			// Returns 'false' if the file can't be opened or is not a correct PE file
+			bool					addModuleFile(const std::string& sFilePath);
+
+			// Returns mask of PEApiHashAlgorithm
+			uint32_t				getAlgorithms() const;
+
+			// Returns number of libraries added
+			uint32_t				getNumberOfModules() const;
+
+			// Returns number of functions added
+			uint32_t				getNumberOfFunctions() const;
+
+			// Builds the table (replaces the contents of peTable)
+			void					build(PEApiHashTable& peTable) const;
+
+			// Removes all libraries
+			void					clear();
+		private:
+			// Appends null-terminated string to the strings & returns its offset
+			uint32_t				addString(const PEStringView& sString);
+
+			uint32_t				m_iAlgorithms;
+			uint32_t				m_iNumberOfAlgorithms;
+
+			std::string				m_sStrings;
+			std::vector<uint32_t>	m_vModuleNameOffsets;
+			std::vector<PEApiHashTable::PEApiHashFunction>	m_vFunctions;
+
+			// Hashes of the functions, m_iNumberOfAlgorithms per function (algorithms in bit order)
+			std::vector<uint32_t>	m_vHashes;
+	};
+}
\ No newline at end of file
@@ -36,7 +36,7 @@ namespace OpenPE
 			// Sets Directory RVA (just a value in PE Header, no movement occurs)
 			void					setDirectoryRVA(uint32_t iDirectoryID, uint32_t iRVA);
 			// Sets Directory Size (just a value in PE Header, no movement occurs)
-			void					setDirectorySize(uint32_t iDirectoryID, uint32_t iRVA);
+			void					setDirectorySize(uint32_t iDirectoryID, uint32_t iSize);
 
 			// Returns 'true' if Image has Import Directory
 			bool					hasImports() const;
@@ -78,6 +78,13 @@ namespace OpenPE
 			// Returns Number of Sections
 			uint32_t				getNumberOfSections() const;
 
+			// Returns 'true' if the Section is one of the Sections of this Image
+			bool					sectionAttached(const PESection& peSection) const;
+
+			// Recalculates raw & virtual sizes of the Section (and Size of Image) after its raw data was changed
+			// If bAutoStrip = true and the Section is the last one, null bytes at the end of its raw data are stripped
+			void					recalculateSectionSizes(PESection& peSection, bool bAutoStrip);
+
 			// Returns Section from RVA inside it
 			PESection&				getSectionFromRVA(uint32_t iRVA);
 			const PESection&		getSectionFromRVA(uint32_t iRVA) const;
@@ -144,12 +151,18 @@ namespace OpenPE
 			char*					getSectionDataFromVA(PESection& peSection, uint64_t iVA); //Always returns raw data
 			const char*				getSectionDataFromVA(const PESection& peSection, uint64_t iVA, SECTION_DATA_TYPE eSectionDataType = SECTION_DATA_RAW) const;
 			////////////////////////////////////////////////////
+			// Returns pointer to the beginning of RAW/VIRTUAL data block (Section or Headers) containing RVA,
+			// together with the RVA the block starts at and its length, so that the caller can walk data inside it
+			// with direct bounded pointers instead of searching the Section list on every access
+			// If bIncludeHeaders = true, data from the beginning of PE file to SizeOfHeaders will be searched, too
+			const char*				getSectionDataBlockFromRVA(uint32_t iRVA, uint32_t& iBlockRVA, uint32_t& iBlockLength, SECTION_DATA_TYPE eSectionDataType = SECTION_DATA_RAW, bool bIncludeHeaders = false) const;
+			////////////////////////////////////////////////////
 
 			//Returns corresponding section data pointer from RVA inside section "s" (checks bounds, checks sizes, the most safe function)
 			template<typename T>
-			T getSectionDataFromRVA(const PESection& s, uint32_t rva, SECTION_DATA_TYPE eSectionDataType = SECTION_DATA_RAW) const
+			T getSectionDataFromRVA(const PESection& peSection, uint32_t iRVA, SECTION_DATA_TYPE eSectionDataType = SECTION_DATA_RAW) const
 			{
-				if (iRVA >= peSection.getVirtualAddress() && iRVA < peSection.getVirtualAddress() + peSection.getAlignedVirtualSize(getSectionAlignment()) && PEUtils::isSumSafess(iRVA, sizeof(T)))
+				if (iRVA >= peSection.getVirtualAddress() && iRVA < peSection.getVirtualAddress() + peSection.getAlignedVirtualSize(getSectionAlignment()) && PEUtils::isSumSafe(iRVA, sizeof(T)))
 				{
 					const std::string& sData = (eSectionDataType == SECTION_DATA_RAW) 
 												? 
@@ -164,7 +177,7 @@ namespace OpenPE
 					return *reinterpret_cast<const T*>(sData.data() + iRVA - peSection.getVirtualAddress());
 				}
 
-				throw PEException("RVA not found inside section", PEException::rva_not_exists);
+				throw PEException("RVA not found inside section", PEException::PEEXCEPTION_RVA_DOESNT_NOT_EXISTS);
 			}
 
 			//Returns corresponding section data pointer from RVA inside section (checks iRVA, checks sizes, the most safe function)
@@ -246,6 +259,12 @@ namespace OpenPE
 			// Returns PE characteristics
 			uint16_t				getCharacteristics() const;
 
+			// Returns Machine of PE file from Header (IMAGE_FILE_MACHINE_*)
+			uint16_t				getMachine() const;
+
+			// Returns TimeDateStamp of PE file from Header
+			uint32_t				getTimeDateStamp() const;
+
 			// Returns Checksum of PE file from Header
 			uint32_t				getChecksum() const;
 			// Sets Checksum of PE file
@@ -265,6 +284,8 @@ namespace OpenPE
 
 			// Returns Size of the Image
 			virtual uint32_t		getSizeOfImage() const;
+			// Recalculates Size of the Image from the last Section (Just the value in PE Header)
+			void					updateImageSize();
 
 			// Returns Image Entry Point
 			uint32_t				getEntryPoint() const;
@@ -274,6 +295,8 @@ namespace OpenPE
 			// Returns Image base for PE(32-bit) & PE+(64-bit) respectively
 			uint32_t				getImageBase32() const;
 			uint64_t				getImageBase64() const;
+			// Sets Image base (Just the value in PE Header, no relocations are applied)
+			void					setImageBase(uint64_t iNewImageBase);
 		public:
 			// Address Convertion
 
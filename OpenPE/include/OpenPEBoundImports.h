@@ -0,0 +1,211 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include "OpenPEStructures.h"
+#include "OpenPEBase.h"
+#include "OpenPEImports.h"
+#include "OpenPEModuleCorpus.h"
+#include "OpenPEStringView.h"
+
+namespace OpenPE
+{
+	// Class representing a module reference of Bound Import descriptor (forwarder ref)
+	class PEBoundImportRef
+	{
+		public:
+			// Default Constructor
+			PEBoundImportRef();
+
+			// Returns 'Name' of the module (owned by the record, or references Image memory or the global intern table, see PENameStorage)
+			const PEStringView		getName() const;
+
+			// Returns 'Name' of the module (same as getName())
+			const PEStringView		getNameView() const;
+
+			// Returns TimeStamp of the module bound to
+			uint32_t				getTimeStamp() const;
+		public:
+			// Sets 'Name' of the module (the name is copied into the record)
+			void					setName(const PEStringView& sName);
+
+			// Sets 'Name' of the module as a reference to memory owned by someone else (e.g. Image data)
+			void					setNameView(const PEStringView& vName);
+
+			// Sets TimeStamp
+			void					setTimeStamp(uint32_t iTimeStamp);
+		private:
+			std::string				m_sName;
+			PEStringView			m_vName;
+			uint32_t				m_iTimeStamp;
+	};
+
+	// Class representing Bound Import descriptor of a library
+	class PEBoundImportLibrary
+	{
+		public:
+			typedef std::vector<PEBoundImportRef>		REF_LIST;
+		public:
+			// Default Constructor
+			PEBoundImportLibrary();
+
+			// Returns 'Name' of the Library (owned by the record, or references Image memory or the global intern table, see PENameStorage)
+			const PEStringView		getName() const;
+
+			// Returns 'Name' of the Library (same as getName())
+			const PEStringView		getNameView() const;
+
+			// Returns TimeStamp of the Library bound to
+			uint32_t				getTimeStamp() const;
+
+			// Returns modules that functions of the Library are forwarded to
+			const REF_LIST&			getModuleForwarderList() const;
+		public:
+			// Sets 'Name' of the Library (the name is copied into the record)
+			void					setName(const PEStringView& sName);
+
+			// Sets 'Name' of the Library as a reference to memory owned by someone else (e.g. Image data)
+			void					setNameView(const PEStringView& vName);
+
+			// Sets TimeStamp
+			void					setTimeStamp(uint32_t iTimeStamp);
+
+			// Adds module forwarder ref
+			void					addModuleForwarder(const PEBoundImportRef& peRef);
+
+			// Clears module forwarder refs
+			void					clearModuleForwarders();
+		private:
+			std::string				m_sName;
+			PEStringView			m_vName;
+			uint32_t				m_iTimeStamp;
+			REF_LIST				m_vModuleForwarders;
+	};
+
+	typedef std::vector<PEBoundImportLibrary>	PEBOUND_IMPORT_LIST;
+
+	// Returns Bound Import libraries with their forwarder refs
+	// If eNameStorage = PE_NAME_STORAGE_VIEW, names reference Image memory instead of being copied
+	// If eNameStorage = PE_NAME_STORAGE_INTERN, names reference the global intern table (each distinct name is stored once)
+	const PEBOUND_IMPORT_LIST					getBoundImportList(const PEBase& peBase, PENameStorage eNameStorage = PE_NAME_STORAGE_COPY);
+
+	// Bound Import staleness checker
+	// Bindings of an Image are compared with export snapshots of the libraries (PEModuleCorpus)
+
+	// Status of the binding of an imported library
+	enum PEBindingStatus
+	{
+		PE_BINDING_NOT_BOUND,				// Imports of the library are not bound
+		PE_BINDING_VALID,					// TimeStamps & prebound IAT values match the library
+		PE_BINDING_MODULE_NOT_FOUND,		// Library (or a module it forwards to) is not in the corpus
+		PE_BINDING_STALE_TIMESTAMP,			// TimeStamp of the library (or a module it forwards to) differs
+		PE_BINDING_STALE_ADDRESS			// TimeStamps match, but some prebound IAT values differ
+	};
+
+	// Class representing a prebound IAT value, that doesn't match the library
+	class PEStaleBinding
+	{
+		public:
+			// Default Constructor
+			PEStaleBinding();
+
+			// Returns 'true' if function is imported by 'Name'
+			bool					hasName() const;
+
+			// Returns 'Name' of the function
+			const std::string&		getName() const;
+
+			// Returns 'Ordinal' of the function
+			uint16_t				getOrdinal() const;
+
+			// Returns prebound IAT value
+			uint64_t				getBoundVA() const;
+
+			// Returns VA of the function in the library (0, if the function is not found)
+			uint64_t				getExpectedVA() const;
+		public:
+			// Sets 'Name' of the function
+			void					setName(const std::string& sName);
+
+			// Sets 'Ordinal' of the function
+			void					setOrdinal(uint16_t iOrdinal);
+
+			// Sets prebound IAT value
+			void					setBoundVA(uint64_t iBoundVA);
+
+			// Sets VA of the function in the library
+			void					setExpectedVA(uint64_t iExpectedVA);
+		private:
+			std::string					m_sName;
+			uint16_t				m_iOrdinal;
+			uint64_t				m_iBoundVA;
+			uint64_t				m_iExpectedVA;
+	};
+
+	// Class representing the binding check result of an imported library
+	class PEBindingCheck
+	{
+		public:
+			typedef std::vector<PEStaleBinding>		STALE_LIST;
+		public:
+			// Default Constructor
+			PEBindingCheck();
+
+			// Returns 'Name' of the Library
+			const std::string&		getName() const;
+
+			// Returns binding status
+			PEBindingStatus			getStatus() const;
+
+			// Returns TimeStamp the Library is bound to
+			uint32_t				getBoundTimeStamp() const;
+
+			// Returns TimeStamp of the Library in the corpus (0, if not found)
+			uint32_t				getModuleTimeStamp() const;
+
+			// Returns number of functions checked
+			uint32_t				getNumberOfFunctions() const;
+
+			// Returns prebound IAT values, which don't match the Library
+			const STALE_LIST&		getStaleBindingList() const;
+
+			// Returns 'true' if the binding is not valid (the loader has to resolve the imports again)
+			bool					isStale() const;
+		public:
+			// Sets 'Name' of the Library
+			void					setName(const std::string& sName);
+
+			// Sets binding status
+			void					setStatus(PEBindingStatus eStatus);
+
+			// Sets TimeStamp the Library is bound to
+			void					setBoundTimeStamp(uint32_t iTimeStamp);
+
+			// Sets TimeStamp of the Library in the corpus
+			void					setModuleTimeStamp(uint32_t iTimeStamp);
+
+			// Sets number of functions checked
+			void					setNumberOfFunctions(uint32_t iNumberOfFunctions);
+
+			// Adds prebound IAT value, which doesn't match the Library
+			void					addStaleBinding(const PEStaleBinding& peStaleBinding);
+		private:
+			std::string					m_sName;
+			PEBindingStatus			m_eStatus;
+			uint32_t				m_iBoundTimeStamp;
+			uint32_t				m_iModuleTimeStamp;
+			uint32_t				m_iNumberOfFunctions;
+			STALE_LIST				m_vStaleBindings;
+	};
+
+	typedef std::vector<PEBindingCheck>			PEBINDING_CHECK_LIST;
+
+	// Checks bindings of all imported libraries of the Image against the corpus
+	const PEBINDING_CHECK_LIST					checkBoundImports(const PEBase& peBase, const PEModuleCorpus& peCorpus);
+
+	// Checks bindings of iNumberOfImages Images against the corpus, pChecks receives a list per Image
+	// Images with incorrect Import Directories get empty lists, the rest of the batch is still processed
+	// Returns number of Images having at least one stale binding
+	size_t										checkBoundImports(const PEBase* const* pImages, size_t iNumberOfImages, const PEModuleCorpus& peCorpus, PEBINDING_CHECK_LIST* pChecks);
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+#include "OpenPEBase.h"
+#include "OpenPEImports.h"
+#include "OpenPEStringView.h"
+
+namespace OpenPE
+{
+	// Class representing imports of an Image in compact (struct-of-arrays) form
+	// All library & function names are kept in one flat null-separated blob,
+	// per-function data is kept in parallel arrays & every library owns a [first, last) range of functions
+	// (around 14 bytes + name per function, instead of a PEImportedFunction with its own std::string)
+	// Name views returned by this class reference the blob & are invalidated when entries are added
+	class PECompactImports
+	{
+		public:
+			// Default Constructor
+			PECompactImports();
+
+			// Constructor from the imported functions list
+			explicit PECompactImports(const PEIMPORTED_FUNCTIONS_LIST& peImports);
+
+			// Returns number of libraries
+			uint32_t						getNumberOfLibraries() const;
+
+			// Returns total number of imported functions (of all libraries)
+			uint32_t						getNumberOfFunctions() const;
+
+			// Returns 'Name' of the Library
+			const PEStringView				getLibraryName(uint32_t iLibrary) const;
+
+			// Returns RVA to Import Address Table(IAT) of the Library
+			uint32_t						getLibraryRVAToIAT(uint32_t iLibrary) const;
+
+			// Returns RVA to Original Import Address Table(Original IAT) of the Library
+			uint32_t						getLibraryRVATOOriginalIAT(uint32_t iLibrary) const;
+
+			// Returns TimeStamp of the Library
+			uint32_t						getLibraryTimeStamp(uint32_t iLibrary) const;
+
+			// Returns index of the first function of the Library
+			uint32_t						getFirstFunction(uint32_t iLibrary) const;
+
+			// Returns number of functions imported from the Library
+			uint32_t						getNumberOfFunctions(uint32_t iLibrary) const;
+
+			// Returns 'true' if function is imported by 'Name' (& Hint)
+			bool							hasName(uint32_t iFunction) const;
+
+			// Returns 'Name' of the function (empty, if imported by ordinal)
+			const PEStringView				getFunctionName(uint32_t iFunction) const;
+
+			// Returns 'Hint' of the function (0, if imported by ordinal)
+			uint16_t						getHint(uint32_t iFunction) const;
+
+			// Returns 'Ordinal' of the function (0, if imported by name)
+			uint16_t						getOrdinal(uint32_t iFunction) const;
+
+			// Returns IAT entry VA of the function
+			uint64_t						getIAT_VA(uint32_t iFunction) const;
+
+			// Returns number of bytes allocated by the arrays
+			size_t							getMemoryUsage() const;
+
+			// Returns imported functions list with related libraries info
+			// If eNameStorage = PE_NAME_STORAGE_VIEW, names reference the blob of this object instead of being copied
+			// If eNameStorage = PE_NAME_STORAGE_INTERN, names are stored once in the global intern table & records carry their symbols
+			const PEIMPORTED_FUNCTIONS_LIST	toImportedFunctionsList(PENameStorage eNameStorage = PE_NAME_STORAGE_COPY) const;
+		public:
+			// Adds Library, functions added afterwards belong to it
+			void							addLibrary(const PEStringView& vName, uint32_t iTimeStamp, uint32_t iRVAToIAT, uint32_t iRVAToOriginalIAT);
+
+			// Adds function imported by 'Name' to the last Library
+			void							addFunction(const PEStringView& vName, uint16_t iHint, uint64_t iIAT_VA);
+
+			// Adds function imported by 'Ordinal' to the last Library
+			void							addFunction(uint16_t iOrdinal, uint64_t iIAT_VA);
+
+			// Reserves space for libraries, functions & name characters
+			void							reserve(uint32_t iNumberOfLibraries, uint32_t iNumberOfFunctions, size_t iNamesLength = 0);
+
+			// Releases unused capacity of all arrays
+			void							shrinkToFit();
+
+			// Removes all libraries & functions
+			void							clear();
+		private:
+			// Appends null-terminated name to the blob & returns its offset
+			uint32_t						addName(const PEStringView& vName);
+
+			// Returns null-terminated name at offset of the blob
+			const PEStringView				getNameAt(uint32_t iOffset) const;
+
+			// Flat blob of null-terminated names
+			std::vector<char>				m_vNames;
+
+			// Per-library arrays
+			std::vector<uint32_t>			m_vLibraryNameOffsets;
+			std::vector<uint32_t>			m_vLibraryTimeStamps;
+			std::vector<uint32_t>			m_vLibraryRVAToIAT;
+			std::vector<uint32_t>			m_vLibraryRVAToOriginalIAT;
+			std::vector<uint32_t>			m_vLibraryFirstFunction;	// NumberOfLibraries + 1 entries
+
+			// Per-function arrays
+			std::vector<uint32_t>			m_vFunctionNameOffsets;		// NO_NAME if imported by ordinal
+			std::vector<uint16_t>			m_vFunctionHintsOrOrdinals;	// Hint if imported by name, Ordinal otherwise
+			std::vector<uint64_t>			m_vFunctionIAT_VAs;
+	};
+
+	// Returns imports of the Image in compact form (decoded directly from the Import Directory, without intermediate lists)
+	const PECompactImports			getCompactImports(const PEBase& peBase);
+}
\ No newline at end of file
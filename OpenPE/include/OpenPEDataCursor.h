@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdint.h>
+#include "OpenPEException.h"
+#include "OpenPESection.h"
+#include "OpenPEBase.h"
+
+namespace OpenPE
+{
+	// Class providing bounded, direct pointer access to Image data by RVA
+	// The data block (Section or Headers) of the last accessed RVA is cached, so that
+	// consecutive reads from the same Section don't search the Section list again
+	// Returned pointers stay valid as long as the Section data of the Image is not changed
+	class PEDataCursor
+	{
+		public:
+			// Default Constructor (cursor is not attached to any Image)
+			PEDataCursor();
+
+			// Constructor
+			// If bIncludeHeaders = true, data from the beginning of PE file to SizeOfHeaders will be searched, too
+			explicit PEDataCursor(const PEBase& peBase, SECTION_DATA_TYPE eSectionDataType = SECTION_DATA_VIRTUAL, bool bIncludeHeaders = true);
+
+			// Returns the Image the cursor reads from
+			const PEBase&			getPEBase() const;
+
+			// Returns 'true' if RVA is inside the cached data block
+			bool					isCached(uint32_t iRVA) const;
+
+			// Returns pointer to data at RVA and the number of bytes available from it to the end of the data block
+			// Throws if RVA is not inside the Image data
+			const char*				getData(uint32_t iRVA, uint32_t& iAvailable);
+
+			// Same as above, but returns 0 instead of throwing if RVA is not inside the Image data
+			const char*				tryGetData(uint32_t iRVA, uint32_t& iAvailable);
+
+			// Returns pointer to null-terminated string at RVA, iLength receives the length of the string
+			// Throws if RVA is not inside the Image data or the string is not null-terminated
+			const char*				getString(uint32_t iRVA, uint32_t& iLength);
+
+			// Returns pointer to 'iCount' consecutive elements of type T at RVA (checks bounds)
+			template<typename T>
+			const T* getArray(uint32_t iRVA, uint32_t iCount)
+			{
+				uint32_t iAvailable;
+				const char* pData = getData(iRVA, iAvailable);
+				if (iAvailable / sizeof(T) < iCount)
+					throw PEException("RVA and requested data size does not exist inside section", PEException::PEEXCEPTION_RVA_DOESNT_NOT_EXISTS);
+
+				return reinterpret_cast<const T*>(pData);
+			}
+
+			// Returns pointer to elements of type T at RVA, iCount receives the number of whole elements available
+			template<typename T>
+			const T* getArray(uint32_t iRVA, uint32_t* iCount)
+			{
+				uint32_t iAvailable;
+				const char* pData = getData(iRVA, iAvailable);
+				*iCount = static_cast<uint32_t>(iAvailable / sizeof(T));
+
+				return reinterpret_cast<const T*>(pData);
+			}
+
+			// Returns value of type T at RVA (checks bounds)
+			template<typename T>
+			T read(uint32_t iRVA)
+			{
+				return *getArray<T>(iRVA, 1);
+			}
+		private:
+			// Looks up & caches the data block containing RVA, returns 'false' if there is none
+			bool					cacheBlock(uint32_t iRVA);
+
+			const PEBase*			m_pPEBase;
+			SECTION_DATA_TYPE		m_eSectionDataType;
+			bool					m_bIncludeHeaders;
+
+			// Cached data block
+			const char*				m_pBlockData;
+			uint32_t				m_iBlockRVA;
+			uint32_t				m_iBlockLength;
+	};
+}
\ No newline at end of file
@@ -36,11 +36,27 @@ namespace OpenPE
 				PEEXCEPTION_INCORRECT_ADDRESS_CONVERSION,
 				PEEXCEPTION_INCORRECT_IMPORT_DIRECTORY,
 				PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY,
+				PEEXCEPTION_INCORRECT_DELAY_IMPORT_DIRECTORY,
+				PEEXCEPTION_INCORRECT_BOUND_IMPORT_DIRECTORY,
+				PEEXCEPTION_INCORRECT_RESOURCE_DIRECTORY,
+				PEEXCEPTION_INCORRECT_RESOURCE_DATA,
+				PEEXCEPTION_INCORRECT_RELOCATION_DIRECTORY,
+				PEEXCEPTION_INCORRECT_TLS_DIRECTORY,
+				PEEXCEPTION_INCORRECT_LOAD_CONFIG_DIRECTORY,
+				PEEXCEPTION_INCORRECT_EXCEPTION_DIRECTORY,
+				PEEXCEPTION_INCORRECT_UNWIND_INFO,
+				PEEXCEPTION_INCORRECT_MODULE_CACHE,
+				PEEXCEPTION_INCORRECT_API_HASH_TABLE,
+				PEEXCEPTION_INCORRECT_API_HASH_ALGORITHM,
 
 				PEEXCEPTION_DIRECTORY_DOESNT_NOT_EXISTS,
 
 				PEEXCEPTION_RVA_DOESNT_NOT_EXISTS,
 				PEEXCEPTION_SECTION_DOESNT_NOT_EXISTS,
+				PEEXCEPTION_SECTION_IS_NOT_ATTACHED,
+				PEEXCEPTION_INSUFFICIENT_SPACE,
+				PEEXCEPTION_DUPLICATE_EXPORTED_FUNCTION_NAME,
+				PEEXCEPTION_DUPLICATE_EXPORTED_FUNCTION_ORDINAL,
 
 				PEEXCEPTION_IMAGE_DOES_NOT_HAVE_MANAGED_CODE,
 			};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+#include "OpenPEExports.h"
+
+namespace OpenPE
+{
+	// Kinds of export changes (a change may have several)
+	enum PEExportChangeFlag
+	{
+		PE_EXPORT_CHANGE_ADDED				= 0x01,		// Function exists in the new Image only
+		PE_EXPORT_CHANGE_REMOVED			= 0x02,		// Function exists in the old Image only
+		PE_EXPORT_CHANGE_RENAMED			= 0x04,		// Same ordinal, other name (or a name gained or lost)
+		PE_EXPORT_CHANGE_ORDINAL			= 0x08,		// Same name, other ordinal
+		PE_EXPORT_CHANGE_RVA				= 0x10,		// Function moved (not reported for functions forwarded in both Images)
+		PE_EXPORT_CHANGE_FORWARDER			= 0x20,		// Forwarder added, removed or redirected
+		PE_EXPORT_CHANGE_ALL				= 0x3F
+	};
+
+	// Class representing a change of a single exported function
+	// Exports reference memory of the Images
+	class PEExportChange
+	{
+		public:
+			// Default Constructor
+			PEExportChange();
+
+			// Returns mask of PEExportChangeFlag
+			uint32_t				getFlags() const;
+
+			// Returns 'true' if the function exists in the old Image
+			bool					hasOldExport() const;
+
+			// Returns the function in the old Image
+			const PEExportEntry&	getOldExport() const;
+
+			// Returns 'true' if the function exists in the new Image
+			bool					hasNewExport() const;
+
+			// Returns the function in the new Image
+			const PEExportEntry&	getNewExport() const;
+		private:
+			friend size_t			diffExports(const PEExportIndex& peOldExports, const PEExportIndex& peNewExports, std::vector<PEExportChange>& vChanges, uint32_t iReportedChanges);
+
+			uint32_t				m_iFlags;
+			PEExportEntry			m_OldExport;
+			PEExportEntry			m_NewExport;
+	};
+
+	typedef std::vector<PEExportChange>		PEEXPORT_CHANGE_LIST;
+
+	// Compares exports of two versions of a library, appends the changes to vChanges & returns number of changes appended
+	// Functions are matched by name first (a merge of both name orders), the rest are matched by ordinal
+	// (a merge of both ordinal orders), so that renamed functions are told from removed & added ones
+	// Changes of functions matched by name come first (in name order), the rest follow in ordinal order
+	// iReportedChanges is a mask of PEExportChangeFlag, other kinds of changes are neither set nor reported
+	// (e.g. PE_EXPORT_CHANGE_ALL & ~PE_EXPORT_CHANGE_RVA ignores functions which only moved)
+	size_t						diffExports(const PEExportIndex& peOldExports, const PEExportIndex& peNewExports, PEEXPORT_CHANGE_LIST& vChanges, uint32_t iReportedChanges = PE_EXPORT_CHANGE_ALL);
+
+	// Compares iNumberOfPairs pairs of export indices (an index may be shared by several pairs, e.g. along a version chain)
+	// pChanges receives a list per pair, pairs with incorrect export directories get empty lists
+	// Returns the total number of changes
+	size_t						diffExports(const PEExportIndex* const* pOldExports, const PEExportIndex* const* pNewExports, size_t iNumberOfPairs, PEEXPORT_CHANGE_LIST* pChanges, uint32_t iReportedChanges = PE_EXPORT_CHANGE_ALL);
+}
\ No newline at end of file
@@ -1,6 +1,11 @@
 #pragma once
 #include <stdint.h>
+#include "OpenPEDirectory.h"
 #include "OpenPEBase.h"
+#include <iterator>
+#include "OpenPEStringView.h"
+#include "OpenPEInternTable.h"
+#include "OpenPEDataCursor.h"
 
 namespace OpenPE
 {
@@ -20,8 +25,14 @@ namespace OpenPE
 			// Returns true if function has name and name ordinal
 			bool				hasName() const;
 
-			// Returns name of function
-			const std::string&	getName() const;
+			// Returns name of function (owned by the record, or references Image memory or the global intern table, see PENameStorage)
+			const PEStringView	getName() const;
+
+			// Returns name of function (same as getName())
+			const PEStringView	getNameView() const;
+
+			// Returns symbol of the name in the global intern table (PE_NO_SYMBOL if the name is not interned)
+			PESymbolID			getNameSymbol() const;
 
 			// Returns name ordinal of function
 			uint16_t			getNameOrdinal() const;
@@ -29,8 +40,14 @@ namespace OpenPE
 			// Returns true if function is forwarded to other library
 			bool				isForwarded() const;
 
-			// Returns the name of forwarded function
-			const std::string&	getForwardedName() const;
+			// Returns the name of forwarded function (owned by the record, or references Image memory or the global intern table, see PENameStorage)
+			const PEStringView	getForwardedName() const;
+
+			// Returns the name of forwarded function (same as getForwardedName())
+			const PEStringView	getForwardedNameView() const;
+
+			// Returns symbol of the forwarded name in the global intern table (PE_NO_SYMBOL if the name is not interned)
+			PESymbolID			getForwardedNameSymbol() const;
 
 		public:
 			// Setters do not change everything inside image, they are used by PE class
@@ -43,22 +60,40 @@ namespace OpenPE
 			void				setRVA(uint32_t	iRVA);
 
 			// Sets name of function (or clears it, if empty name is passed)
-			void				setName(const std::string& sName);
+			// (the name is copied into the record)
+			void				setName(const PEStringView& sName);
+
+			// Sets name of function as a reference to memory owned by someone else (e.g. Image Section data)
+			void				setNameView(const PEStringView& vName);
+
+			// Sets name of function as a symbol of the global intern table
+			void				setNameSymbol(PESymbolID iSymbol);
 
 			// Sets name ordinal
 			void				setNameOrdinal(uint16_t iNameOrdinal);
 
 			// Sets forwarded function name (or clears it, if empty name is passed)
-			void				setForwardedName(const std::string& sName);
+			// (the name is copied into the record)
+			void				setForwardedName(const PEStringView& sName);
+
+			// Sets forwarded function name as a reference to memory owned by someone else (e.g. Image Section data)
+			void				setForwardedNameView(const PEStringView& vName);
+
+			// Sets forwarded function name as a symbol of the global intern table
+			void				setForwardedNameSymbol(PESymbolID iSymbol);
 
 		private:
 			uint16_t			m_iOrdinal;
 			uint32_t			m_iRVA;
 			std::string			m_sName;
+			PEStringView		m_vName;
+			PESymbolID			m_iNameSymbol;
 			bool				m_bHasName;
 			uint16_t			m_iNameOrdinal;
 			bool				m_bForwarded;
 			std::string			m_sForwardedName;
+			PEStringView		m_vForwardedName;
+			PESymbolID			m_iForwardedNameSymbol;
 	};
 
 	// Class representing export information
@@ -80,8 +115,14 @@ namespace OpenPE
 			// Returns minor version
 			uint16_t			getMinorVersion() const;
 
-			// Returns DLL name
-			const std::string&	getName() const; 
+			// Returns DLL name (owned by the record, or references Image memory or the global intern table, see PENameStorage)
+			const PEStringView	getName() const;
+
+			// Returns DLL name (same as getName())
+			const PEStringView	getNameView() const;
+
+			// Returns symbol of DLL name in the global intern table (PE_NO_SYMBOL if the name is not interned)
+			PESymbolID			getNameSymbol() const;
 
 			// Returns ordinal base
 			uint32_t			getOrdinalBase() const;
@@ -117,8 +158,14 @@ namespace OpenPE
 			// Sets minor version
 			void				setMinorVersion(uint16_t iMinorVersion);
 
-			// Sets DLL name
-			void				setName(const std::string& sName);
+			// Sets DLL name (the name is copied into the record)
+			void				setName(const PEStringView& sName);
+
+			// Sets DLL name as a reference to memory owned by someone else (e.g. Image Section data)
+			void				setNameView(const PEStringView& vName);
+
+			// Sets DLL name as a symbol of the global intern table
+			void				setNameSymbol(PESymbolID iSymbol);
 
 			// Sets ordinal base
 			void				setOrdinalBase(uint32_t iOrdinalBase);
@@ -144,6 +191,8 @@ namespace OpenPE
 			uint16_t			m_iMajorVersion;
 			uint16_t			m_iMinorVersion;
 			std::string			m_sName;
+			PEStringView		m_vName;
+			PESymbolID			m_iNameSymbol;
 			uint32_t			m_iOrdinalBase;
 			uint32_t			m_iNumberOfFunctions;
 			uint32_t			m_iNumberOfNames;
@@ -156,33 +205,345 @@ namespace OpenPE
 	typedef std::vector<PEExportedFunction>		PEEXPORTED_FUNCTION_LIST;
 
 	// Returns array of exported functions
-	const PEEXPORTED_FUNCTION_LIST				getExportedFunctionsList(const PEBase& peBase);
+	// If eNameStorage = PE_NAME_STORAGE_VIEW, function & forwarded names reference Image memory instead of being copied
+	// If eNameStorage = PE_NAME_STORAGE_INTERN, names are stored once in the global intern table & records carry their symbols
+	const PEEXPORTED_FUNCTION_LIST				getExportedFunctionsList(const PEBase& peBase, PENameStorage eNameStorage = PE_NAME_STORAGE_COPY);
 
 	// Returns array of exported functions and information about export
-	const PEEXPORTED_FUNCTION_LIST				getExportedFunctionsList(const PEBase& peBase, PEExportInfo& peExportInfo);
+	// If eNameStorage = PE_NAME_STORAGE_VIEW, DLL, function & forwarded names reference Image memory instead of being copied
+	// If eNameStorage = PE_NAME_STORAGE_INTERN, names are stored once in the global intern table & records carry their symbols
+	const PEEXPORTED_FUNCTION_LIST				getExportedFunctionsList(const PEBase& peBase, PEExportInfo& peExportInfo, PENameStorage eNameStorage = PE_NAME_STORAGE_COPY);
+
+	// Class resolving the export directory tables of an Image once
+	// The directory is validated & AddressOfFunctions, AddressOfNames and AddressOfNameOrdinals
+	// are then read through direct bounded pointers (no Section search per entry)
+	// Strings following the directory in its Section are read through the same pointers, other strings through a PEDataCursor
+	class PEExportTables
+	{
+		public:
+			// Default Constructor (no exports)
+			PEExportTables();
+
+			// Constructor, validates export directory of the Image
+			explicit PEExportTables(const PEBase& peBase);
+
+			// Returns 'true' if Image has export directory
+			bool					hasExports() const;
+
+			// Returns export directory
+			const IMAGE_EXPORT_DIRECTORY&	getDirectory() const;
+
+			// Returns number of entries in AddressOfFunctions
+			uint32_t				getNumberOfFunctions() const;
+
+			// Returns number of entries in AddressOfNames & AddressOfNameOrdinals
+			uint32_t				getNumberOfNames() const;
+
+			// Returns ordinal base
+			uint32_t				getOrdinalBase() const;
+
+			// Returns RVA of function at index in AddressOfFunctions
+			uint32_t				getFunctionRVA(uint32_t iIndex) const;
+
+			// Returns RVA of function name at index in AddressOfNames
+			uint32_t				getNameRVA(uint32_t iNameIndex) const;
+
+			// Returns name ordinal (index in AddressOfFunctions) at index in AddressOfNameOrdinals
+			uint16_t				getNameOrdinal(uint32_t iNameIndex) const;
+
+			// Returns function name at index in AddressOfNames (references Image memory)
+			const PEStringView		getName(uint32_t iNameIndex) const;
+
+			// Returns DLL name (references Image memory)
+			const PEStringView		getDllName() const;
+
+			// Returns 'true' if function RVA points inside of the export directory (function is forwarded)
+			bool					isForwarderRVA(uint32_t iRVA) const;
+
+			// Returns forwarded function name at RVA (references Image memory)
+			const PEStringView		getForwardedName(uint32_t iRVA) const;
+
+		private:
+			// Returns null-terminated string at RVA, throws if there is none
+			const PEStringView		getStringAt(uint32_t iRVA) const;
+
+			const PEBase*			m_pPEBase;
+			IMAGE_EXPORT_DIRECTORY	m_Directory;
+			uint32_t				m_iDirectoryRVA;
+			uint32_t				m_iDirectorySize;
+
+			// Data from the export directory to the end of its Section
+			const char*				m_pDirectoryData;
+			uint32_t				m_iDirectoryDataLength;
+
+			const uint32_t*			m_pFunctions;
+			const uint32_t*			m_pNames;
+			const uint16_t*			m_pNameOrdinals;
+	};
+
+	// Class representing Exported Function decoded by export ranges
+	// Names reference Image memory
+	class PEExportEntry
+	{
+		public:
+			// Default Constructor
+			PEExportEntry();
+
+			// Returns ordinal of function (ordinal base is added)
+			uint16_t				getOrdinal() const;
+
+			// Returns RVA of function
+			uint32_t				getRVA() const;
+
+			// Returns true if function has name and name ordinal
+			bool					hasName() const;
+
+			// Returns name of function
+			const PEStringView&		getName() const;
+
+			// Returns name ordinal of function
+			uint16_t				getNameOrdinal() const;
+
+			// Returns true if function is forwarded to other library
+			bool					isForwarded() const;
+
+			// Returns the name of forwarded function
+			const PEStringView&		getForwardedName() const;
+
+			// Returns the entry as PEExportedFunction (names are copied or referenced depending on eNameStorage)
+			const PEExportedFunction	toExportedFunction(PENameStorage eNameStorage = PE_NAME_STORAGE_COPY) const;
+
+		private:
+			friend class PEExportNameRange;
+			friend class PEExportAddressRange;
+			friend class PEModuleExports;
+			friend class PEExportIndex;
+
+			uint16_t				m_iOrdinal;
+			uint32_t				m_iRVA;
+			bool					m_bHasName;
+			PEStringView			m_vName;
+			uint16_t				m_iNameOrdinal;
+			PEStringView			m_vForwardedName;
+	};
+
+	// Forward-iterable range over named exports in AddressOfNames order
+	// Entries are decoded on the fly, nothing is allocated
+	class PEExportNameRange
+	{
+		public:
+			class const_iterator
+			{
+				public:
+					typedef std::forward_iterator_tag	iterator_category;
+					typedef PEExportEntry				value_type;
+					typedef ptrdiff_t					difference_type;
+					typedef const PEExportEntry*		pointer;
+					typedef const PEExportEntry&		reference;
+
+					// Default Constructor (end iterator)
+					const_iterator();
+
+					reference			operator*() const;
+					pointer				operator->() const;
+					const_iterator&		operator++();
+					const_iterator		operator++(int);
+					bool				operator==(const const_iterator& other) const;
+					bool				operator!=(const const_iterator& other) const;
+
+				private:
+					friend class PEExportNameRange;
+					const_iterator(const PEExportNameRange* pRange, uint32_t iIndex);
+
+					// Decodes entry at current index, or turns into end iterator
+					void				decode();
+
+					const PEExportNameRange*	m_pRange;
+					uint32_t					m_iIndex;
+					PEExportEntry				m_Entry;
+			};
+
+			// Constructor
+			explicit PEExportNameRange(const PEBase& peBase);
+
+			const_iterator			begin() const;
+			const_iterator			end() const;
+
+			// Returns 'true' if there are no named exports
+			bool					empty() const;
+
+			// Returns number of named exports
+			uint32_t				count() const;
+
+		private:
+			PEExportTables			m_Tables;
+	};
+
+	// Forward-iterable range over all exports in AddressOfFunctions (ordinal) order
+	// Names are not resolved, skipped (zero) entries are not visited
+	class PEExportAddressRange
+	{
+		public:
+			class const_iterator
+			{
+				public:
+					typedef std::forward_iterator_tag	iterator_category;
+					typedef PEExportEntry				value_type;
+					typedef ptrdiff_t					difference_type;
+					typedef const PEExportEntry*		pointer;
+					typedef const PEExportEntry&		reference;
+
+					// Default Constructor (end iterator)
+					const_iterator();
+
+					reference			operator*() const;
+					pointer				operator->() const;
+					const_iterator&		operator++();
+					const_iterator		operator++(int);
+					bool				operator==(const const_iterator& other) const;
+					bool				operator!=(const const_iterator& other) const;
+
+				private:
+					friend class PEExportAddressRange;
+					const_iterator(const PEExportAddressRange* pRange, uint32_t iIndex);
+
+					// Decodes entry at current (or next non-zero) index, or turns into end iterator
+					void				decode();
+
+					const PEExportAddressRange*	m_pRange;
+					uint32_t					m_iIndex;
+					PEExportEntry				m_Entry;
+			};
+
+			// Constructor
+			explicit PEExportAddressRange(const PEBase& peBase);
+
+			const_iterator			begin() const;
+			const_iterator			end() const;
+
+			// Returns 'true' if there are no exports
+			bool					empty() const;
+
+		private:
+			PEExportTables			m_Tables;
+	};
+
+	// Class looking up exports of an Image by name or ordinal (GetProcAddress-style) without decoding the whole directory
+	// Names are binary searched in AddressOfNames (sorted by the linker; an unsorted table is sorted once into an index),
+	// an optional hash table makes name lookups O(1), ordinals index AddressOfFunctions directly
+	// Names & forwarded names are resolved when the index is built & reference Image memory, the Image must outlive the index
+	// Const lookups read only the index & the tables it resolved (no Section is searched or mapped),
+	// so a built index may be shared by several threads as long as the Image is not changed
+	class PEExportIndex
+	{
+		public:
+			// Default Constructor (no exports)
+			PEExportIndex();
+
+			// Constructor, validates export directory of the Image & builds the ordinal -> name table
+			// If bBuildNameHashTable = true, name lookups go through a hash table instead of the binary search
+			explicit PEExportIndex(const PEBase& peBase, bool bBuildNameHashTable = false);
+
+			// Returns 'true' if Image has export directory
+			bool					hasExports() const;
+
+			// Returns ordinal base
+			uint32_t				getOrdinalBase() const;
+
+			// Returns number of entries in AddressOfFunctions
+			uint32_t				getNumberOfFunctions() const;
+
+			// Returns number of named exports
+			uint32_t				getNumberOfNames() const;
+
+			// Returns 'true' if AddressOfNames of the Image is sorted (no sorted index had to be built)
+			bool					isNameTableSorted() const;
+
+			// Returns 'true' if name lookups go through the hash table
+			bool					hasNameHashTable() const;
+
+			// Builds the name hash table (if it is not built yet)
+			void					buildNameHashTable();
+
+			// Looks up export by name, returns 'false' if there is none
+			bool					findExport(const PEStringView& sName, PEExportEntry& peExport) const;
+
+			// Looks up export by ordinal (ordinal base included), returns 'false' if there is none
+			bool					findExport(uint16_t iOrdinal, PEExportEntry& peExport) const;
+
+			// Returns RVA of function exported by name (forwarder RVA, if forwarded), or 0 if there is none
+			uint32_t				getExportRVA(const PEStringView& sName) const;
+
+			// Returns RVA of function exported by ordinal (forwarder RVA, if forwarded), or 0 if there is none
+			uint32_t				getExportRVA(uint16_t iOrdinal) const;
+
+			// Returns name at position of name order (0 .. getNumberOfNames() - 1)
+			const PEStringView		getSortedName(uint32_t iPosition) const;
+
+			// Looks up export named by the name at position of name order, returns 'false' if its function doesn't exist
+			bool					findSortedExport(uint32_t iPosition, PEExportEntry& peExport) const;
+		private:
+			// Returns index in AddressOfNames of the name, or NO_NAME
+			uint32_t				findNameIndex(const PEStringView& sName) const;
+
+			// Fills export entry of the function at index of AddressOfFunctions (iNameIndex may be NO_NAME)
+			void					getExport(uint32_t iIndex, uint32_t iNameIndex, PEExportEntry& peExport) const;
+
+			PEExportTables			m_Tables;
+
+			// Name at every index of AddressOfNames
+			std::vector<PEStringView>	m_vNames;
+
+			// Forwarded name at every index of AddressOfFunctions (empty if no function is forwarded)
+			std::vector<PEStringView>	m_vForwardedNames;
+
+			// Index in AddressOfNames of every function (NO_NAME if function has no name)
+			std::vector<uint32_t>	m_vFunctionNameIndices;
+
+			// Indices of AddressOfNames in name order (only if AddressOfNames is not sorted)
+			std::vector<uint32_t>	m_vSortedNameIndices;
+
+			// Name hash table (power of two sized, linear probing), slots hold name index + 1 (0 = empty)
+			std::vector<uint32_t>	m_vNameHashTable;
+	};
+
+	// Returns lazy range over named exports of the Image
+	const PEExportNameRange						getExportedNames(const PEBase& peBase);
+
+	// Returns lazy range over all exports of the Image (ordinal order)
+	const PEExportAddressRange					getExportedAddresses(const PEBase& peBase);
+
+	// Returns 'true' if Image exports function by name, stops at the first match
+	bool										isFunctionExported(const PEBase& peBase, const PEStringView& sFunctionName);
 
-	// TODO - PEExportsAdder
 	// Helper export functions
 	// Returns pair: <ordinal base for supplied functions; maximum ordinal value for supplied functions>
-	//const std::pair<uint16_t, uint16_t>			getExportedOrdinalLimits(const EXPORTED_FUNCTION_LIST& peExports);
+	const std::pair<uint16_t, uint16_t>			getExportedOrdinalLimits(const PEEXPORTED_FUNCTION_LIST& peExports);
 
-	// Checks if exported function name already exists
-	//bool										doesExportedNameExists(const std::string& sFunctionName, const EXPORTED_FUNCTION_LIST& peExports);
+	// Checks if exported function name already exists (linear, the rebuilder doesn't use it)
+	bool										doesExportedNameExists(const std::string& sFunctionName, const PEEXPORTED_FUNCTION_LIST& peExports);
 
-	// Checks if exported function ordinal already exists
-	//bool										doesExportedOrdinalExists(uint16_t iOrdinal, const EXPORTED_FUNCTION_LIST& peExports);
+	// Checks if exported function ordinal already exists (linear, the rebuilder doesn't use it)
+	bool										doesExportedOrdinalExists(uint16_t iOrdinal, const PEEXPORTED_FUNCTION_LIST& peExports);
 	
-	//Export directory rebuilder
-	//info - export information
-	//exported_functions_list - list of exported functions
-	//exports_section - section where export directory will be placed (must be attached to PE image)
-	//offset_from_section_start - offset from exports_section raw data start
-	//save_to_pe_headers - if true, new export directory information will be saved to PE image headers
-	//auto_strip_last_section - if true and exports are placed in the last section, it will be automatically stripped
-	//number_of_functions and number_of_names parameters don't matter in "info" when rebuilding, they're calculated independently
-	//characteristics, major_version, minor_version, timestamp and name are the only used members of "info" structure
-	//Returns new export directory information
-	//exported_functions_list is copied intentionally to be sorted by ordinal values later
-	//Name ordinals in exported function don't matter, they will be recalculated
-	//const PEImageDirectory					rebuildExports(PEBase& peBase, const PEExportInfo& peExportInfo, EXPORTED_FUNCTION_LIST peExports, PESection& peExportSection, uint32_t iOffsetFromSectionStart = 0, bool bSaveToPEHeader = true, bool bAutoStripLastSection = true);
+	// Export Directory Rebuilder
+	// peExportInfo - export information, only Characteristics, TimeStamp, Major & Minor versions and Name are used
+	//				  (numbers of functions & names and the table RVAs are calculated)
+	// peExports - exported functions, in any order; name ordinals are recalculated
+	// peExportSection - Section where Export Directory will be placed (must be attached to the Image)
+	// iOffsetFromSectionStart - offset from peExportSection raw data start (aligned up to DWORD)
+	// bSaveToPEHeaders - if true, new Export Directory information will be saved to the Image headers
+	// bAutoStripLastSection - if true and exports are placed in the last Section, it will be automatically stripped
+	// Ordinals are checked through a table indexed by ordinal & names are sorted once (duplicates throw PEException),
+	// then the layout of the whole directory is computed, so peExportSection is resized only once
+	// Layout: IMAGE_EXPORT_DIRECTORY, AddressOfFunctions, AddressOfNames, AddressOfNameOrdinals, DLL name, function names, forwarded names
+	// Strings are staged before peExportSection is changed, so names may reference its data (PE_NAME_STORAGE_VIEW)
+	// Returns RVA & Size of the new Export Directory
+	const PEImageDirectory						rebuildExports(	PEBase& peBase, 
+																const PEExportInfo& peExportInfo, 
+																const PEEXPORTED_FUNCTION_LIST& peExports, 
+																PESection& peExportSection, 
+																uint32_t iOffsetFromSectionStart = 0, 
+																bool bSaveToPEHeaders = true, 
+																bool bAutoStripLastSection = true);
 }
\ No newline at end of file
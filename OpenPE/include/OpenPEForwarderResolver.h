@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+#include "OpenPEExports.h"
+#include "OpenPEModuleCorpus.h"
+
+namespace OpenPE
+{
+	// Class following forwarder chains ("NTDLL.RtlAllocateHeap", "NTDLL.#123") through a corpus of libraries
+	// Every function of a followed chain is memoized with the final library & function of the chain,
+	// so a chain is walked once, however many exports & imports lead into it
+	// (resolving all exports of the corpus is linear in the total number of exports)
+	// A chain coming back to one of its own functions is reported as PE_EXPORT_FORWARDER_LOOP (there is no depth limit)
+	// The corpus must outlive the resolver & must not be changed while the cache is used (call clear() after changing it)
+	// The cache is shared by all callers of one resolver, which must not be used by several threads at once
+	class PEForwarderResolver
+	{
+		public:
+			// Constructor
+			explicit PEForwarderResolver(const PEModuleCorpus& peCorpus);
+
+			// Returns the corpus
+			const PEModuleCorpus&	getCorpus() const;
+
+			// Follows forwarders of peExport exported by pModule (same contract as PEModuleCorpus::followForwarders)
+			// On success pModule & peExport are replaced by the final library & function (peExport is looked up by ordinal)
+			// If pNumberOfForwarders is not 0, it receives the number of forwarders followed
+			PEExportResolution		followForwarders(const PEModuleExports*& pModule, PEExportEntry& peExport, uint32_t* pNumberOfForwarders = 0);
+
+			// Follows forwarders of all exports of all libraries of the corpus, returns number of forwarded exports which didn't resolve
+			size_t					resolveAllExports();
+
+			// Returns number of memoized functions (functions of followed chains)
+			size_t					getNumberOfCachedExports() const;
+
+			// Drops all memoized chains
+			void					clear();
+		private:
+			// Copying is not allowed
+			PEForwarderResolver(const PEForwarderResolver&);
+			PEForwarderResolver& operator=(const PEForwarderResolver&);
+
+			// State of a memoized function
+			enum PEForwarderState
+			{
+				PE_FORWARDER_UNKNOWN,				// Not followed yet
+				PE_FORWARDER_IN_PROGRESS,			// On the chain being followed (meeting it again means a loop)
+				PE_FORWARDER_DONE					// Chain followed, resolution is memoized
+			};
+
+			// Memoized function: result of following its chain
+			struct PEResolvedForwarder
+			{
+				uint8_t					m_eState;
+				uint8_t					m_eResolution;
+				uint32_t				m_iModule;					// Final library (index into the corpus module list)
+				uint32_t				m_iIndex;					// Final function (index into its AddressOfFunctions)
+				uint32_t				m_iNumberOfForwarders;
+			};
+
+			// Returns memoized function at index of AddressOfFunctions of the library (allocates the table of the library on first use)
+			PEResolvedForwarder&	getCacheEntry(uint32_t iModule, uint32_t iIndex);
+
+			// Returns index of the library in the corpus module list, or NO_MODULE if the library is not in the corpus
+			uint32_t				getModuleIndex(const PEModuleExports* pModule) const;
+
+			const PEModuleCorpus&	m_peCorpus;
+
+			// Per library, per AddressOfFunctions entry (tables are allocated when a chain first visits the library)
+			std::vector<std::vector<PEResolvedForwarder> >	m_vCache;
+			size_t					m_iNumberOfCachedExports;
+
+			// Functions of the chain being followed (library & function indices)
+			std::vector<std::pair<uint32_t, uint32_t> >		m_vChain;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace OpenPE
+{
+	// Class computing MD5 digest (RFC 1321) of a stream of bytes
+	// Data may be fed in pieces of any size, nothing is allocated
+	class PEMD5
+	{
+		public:
+			enum { DIGEST_SIZE = 16 };
+
+			// Default Constructor
+			PEMD5();
+
+			// Restarts the digest
+			void				reset();
+
+			// Feeds iLength bytes of data
+			void				update(const void* pData, size_t iLength);
+
+			// Finishes the digest & writes DIGEST_SIZE bytes to pDigest (reset() must be called before reuse)
+			void				finalize(uint8_t* pDigest);
+		private:
+			// Processes one 64-byte block
+			void				transform(const uint8_t* pBlock);
+
+			uint32_t			m_State[4];
+			uint64_t			m_iLength;
+			uint8_t				m_Buffer[64];
+			uint32_t			m_iBufferLength;
+	};
+
+	// Class computing SHA-256 digest (FIPS 180-4) of a stream of bytes
+	// Data may be fed in pieces of any size, nothing is allocated
+	class PESHA256
+	{
+		public:
+			enum { DIGEST_SIZE = 32 };
+
+			// Default Constructor
+			PESHA256();
+
+			// Restarts the digest
+			void				reset();
+
+			// Feeds iLength bytes of data
+			void				update(const void* pData, size_t iLength);
+
+			// Finishes the digest & writes DIGEST_SIZE bytes to pDigest (reset() must be called before reuse)
+			void				finalize(uint8_t* pDigest);
+		private:
+			// Processes one 64-byte block
+			void				transform(const uint8_t* pBlock);
+
+			uint32_t			m_State[8];
+			uint64_t			m_iLength;
+			uint8_t				m_Buffer[64];
+			uint32_t			m_iBufferLength;
+	};
+
+	// Writes iLength bytes as lowercase hex digits followed by null-terminator to pString (2 * iLength + 1 chars)
+	void					digestToHexString(const uint8_t* pDigest, size_t iLength, char* pString);
+}
\ No newline at end of file
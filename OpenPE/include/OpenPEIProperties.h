@@ -25,6 +25,8 @@ namespace OpenPE
 			// Returns Image base for PE(32-bit) & PE+(64-bit) respectively
 			virtual uint32_t						getImageBase32() const = 0;
 			virtual uint64_t						getImageBase64() const = 0;
+			// Sets Image base (Just the Header value, no relocations are applied)
+			virtual void							setImageBase(uint64_t iNewImageBase) = 0;
 
 			//Returns Image Entry Point
 			virtual uint32_t						getEntryPoint() const = 0;
@@ -54,6 +56,8 @@ namespace OpenPE
 
 			// Returns Size of the Image
 			virtual uint32_t						getSizeOfImage() const = 0;
+			// Sets Size of the Image (Just the Header value)
+			virtual void							setSizeOfImage(uint32_t iSizeOfImage) = 0;
 
 			// returns number of RVA's & Sizes (number of DATA_DIRECTORY entries)
 			virtual uint32_t						getNumberOfRVAsAndSizes() const = 0;
@@ -116,6 +120,12 @@ namespace OpenPE
 
 			// Returns Directory Size
 			virtual	uint32_t						getDirectorySize(uint32_t iDirectoryID) const = 0;
+
+			// Sets Directory RVA
+			virtual void							setDirectoryRVA(uint32_t iDirectoryID, uint32_t iRVA) = 0;
+
+			// Sets Directory Size
+			virtual void							setDirectorySize(uint32_t iDirectoryID, uint32_t iSize) = 0;
 		public:
 			// Address Convertion
 
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+#include <stdint.h>
+#include "OpenPEBase.h"
+#include "OpenPEHash.h"
+#include "OpenPEStringView.h"
+
+namespace OpenPE
+{
+	// Digests computed by the imphash engine
+	enum PEImpHashAlgorithm
+	{
+		PE_IMPHASH_MD5		= 0x1,		// Classic imphash
+		PE_IMPHASH_SHA256	= 0x2,		// SHA-256 of the same normalized import string
+		PE_IMPHASH_ALL		= PE_IMPHASH_MD5 | PE_IMPHASH_SHA256
+	};
+
+	// Class representing the import hash of an Image
+	// The hashed string is the comma-separated list of lowercase 'library.function' entries
+	// (library extension .dll/.ocx/.sys is stripped, functions imported by ordinal are named
+	// from the built-in ordinal tables, or 'ordN' if the ordinal is unknown)
+	class PEImpHash
+	{
+		public:
+			// Default Constructor
+			PEImpHash();
+
+			// Returns 'true' if the Image has imported functions (digests are zero-filled otherwise)
+			bool				hasImports() const;
+
+			// Returns number of 'library.function' entries hashed
+			uint32_t			getNumberOfEntries() const;
+
+			// Returns mask of PEImpHashAlgorithm computed
+			uint32_t			getAlgorithms() const;
+
+			// Returns MD5 digest (PEMD5::DIGEST_SIZE bytes)
+			const uint8_t*		getMD5() const;
+
+			// Returns SHA-256 digest (PESHA256::DIGEST_SIZE bytes)
+			const uint8_t*		getSHA256() const;
+
+			// Returns MD5 digest as lowercase hex string (empty, if Image has no imports)
+			const std::string	getMD5String() const;
+
+			// Returns SHA-256 digest as lowercase hex string (empty, if Image has no imports)
+			const std::string	getSHA256String() const;
+
+			// Clears the digests
+			void				clear();
+		private:
+			friend bool			computeImpHash(const PEBase& peBase, PEImpHash& peImpHash, uint32_t iAlgorithms);
+
+			uint8_t				m_MD5[PEMD5::DIGEST_SIZE];
+			uint8_t				m_SHA256[PESHA256::DIGEST_SIZE];
+			uint32_t			m_iNumberOfEntries;
+			uint32_t			m_iAlgorithms;
+	};
+
+	// Computes import hash of the Image directly over the import thunks (nothing is allocated)
+	// Returns 'false' if Image has no imported functions
+	bool					computeImpHash(const PEBase& peBase, PEImpHash& peImpHash, uint32_t iAlgorithms = PE_IMPHASH_ALL);
+
+	// Returns import hash of the Image
+	const PEImpHash			getImpHash(const PEBase& peBase, uint32_t iAlgorithms = PE_IMPHASH_ALL);
+
+	// Computes import hashes of iNumberOfImages Images into pImpHashes
+	// Images with incorrect Import Directory get cleared hashes, the rest of the batch is still processed
+	// Returns number of Images hashed successfully
+	size_t					computeImpHashes(const PEBase* const* pImages, size_t iNumberOfImages, PEImpHash* pImpHashes, uint32_t iAlgorithms = PE_IMPHASH_ALL);
+
+	// Returns built-in name of function imported by ordinal from a system library (ws2_32, wsock32, oleaut32)
+	// Returns 0 if the library or the ordinal is unknown
+	const char*				getOrdinalImportName(const PEStringView& sLibraryName, uint16_t iOrdinal);
+}
\ No newline at end of file
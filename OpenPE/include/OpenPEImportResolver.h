@@ -0,0 +1,111 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+#include "OpenPEBase.h"
+#include "OpenPEImports.h"
+#include "OpenPEModuleCorpus.h"
+#include "OpenPEForwarderResolver.h"
+#include "OpenPEStringView.h"
+
+namespace OpenPE
+{
+	// Class representing an imported function resolved against a corpus of libraries
+	// Imported names reference memory of the import list (or Image) they were resolved from,
+	// exported & forwarded names reference memory of the corpus
+	class PEResolvedImport
+	{
+		public:
+			// Default Constructor
+			PEResolvedImport();
+
+			// Returns name of the library the function is imported from
+			const PEStringView&		getLibraryName() const;
+
+			// Returns true if function is imported by name
+			bool					hasName() const;
+
+			// Returns name of imported function
+			const PEStringView&		getName() const;
+
+			// Returns ordinal of imported function (if imported by ordinal)
+			uint16_t				getOrdinal() const;
+
+			// Returns result of the resolution
+			PEExportResolution		getStatus() const;
+
+			// Returns true if the function was found (following all of its forwarders)
+			bool					isResolved() const;
+
+			// Returns true if the library forwards the function to other library
+			bool					isForwarded() const;
+
+			// Returns number of forwarders followed
+			uint32_t				getNumberOfForwarders() const;
+
+			// Returns the forwarder of the imported library (e.g. "NTDLL.RtlAllocateHeap"), empty if not forwarded
+			const PEStringView&		getForwardedName() const;
+
+			// Returns the library that implements the function (0, if not resolved)
+			const PEModuleExports*	getModule() const;
+
+			// Returns export ordinal of the function in the implementing library
+			uint16_t				getExportOrdinal() const;
+
+			// Returns RVA of the function in the implementing library
+			uint32_t				getRVA() const;
+
+			// Returns VA of the function (preferred Image base of the implementing library + RVA)
+			uint64_t				getVA() const;
+		private:
+			friend class PEImportResolver;
+
+			PEStringView			m_vLibraryName;
+			PEStringView			m_vName;
+			uint16_t				m_iOrdinal;
+			PEExportResolution		m_eStatus;
+			uint32_t				m_iNumberOfForwarders;
+			PEStringView			m_vForwardedName;
+			const PEModuleExports*	m_pModule;
+			uint16_t				m_iExportOrdinal;
+			uint32_t				m_iRVA;
+	};
+
+	typedef std::vector<PEResolvedImport>		PERESOLVED_IMPORT_LIST;
+
+	// Class resolving imported functions to the libraries (and RVAs) implementing them
+	// Every library is looked up once per import descriptor, functions through the hashed export tables of the corpus
+	// The corpus must outlive the resolver & its results
+	class PEImportResolver
+	{
+		public:
+			// Constructor
+			explicit PEImportResolver(const PEModuleCorpus& peCorpus);
+
+			// Constructor, forwarders are followed through the memoizing peForwarders (which may be shared by several resolvers)
+			explicit PEImportResolver(PEForwarderResolver& peForwarders);
+
+			// Returns the corpus
+			const PEModuleCorpus&	getCorpus() const;
+
+			// Resolves a single function imported from the library
+			PEExportResolution		resolveImport(const PEStringView& sLibraryName, const PEImportedFunction& peFunction, PEResolvedImport& peResult) const;
+
+			// Resolves all functions of the list (in the order of the list), returns number of unresolved functions
+			size_t					resolveImports(const PEIMPORTED_FUNCTIONS_LIST& vImports, PERESOLVED_IMPORT_LIST& vResults) const;
+
+			// Resolves all functions imported by the Image without building the import list, returns number of unresolved functions
+			size_t					resolveImports(const PEBase& peBase, PERESOLVED_IMPORT_LIST& vResults) const;
+
+			// Resolves imports of iNumberOfImages Images, pResults receives a list per Image
+			// Images with incorrect Import Directories get empty lists, the rest of the batch is still processed
+			// Returns total number of unresolved functions
+			size_t					resolveImports(const PEBase* const* pImages, size_t iNumberOfImages, PERESOLVED_IMPORT_LIST* pResults) const;
+		private:
+			// Resolves the function (name or ordinal are already set in peResult) exported by pLibrary
+			void					resolveFunction(const PEModuleExports* pLibrary, PEResolvedImport& peResult) const;
+
+			const PEModuleCorpus&	m_peCorpus;
+			PEForwarderResolver*	m_pForwarders;
+	};
+}
\ No newline at end of file
@@ -2,9 +2,13 @@
 
 #include <vector>
 #include <string>
+#include <iterator>
 #include "OpenPEStructures.h"
 #include "OpenPEDirectory.h"
 #include "OpenPEBase.h"
+#include "OpenPEStringView.h"
+#include "OpenPEInternTable.h"
+#include "OpenPEDataCursor.h"
 
 namespace OpenPE
 {
@@ -18,8 +22,14 @@ namespace OpenPE
 			// Returns 'true' if imported function has 'Name' (& Hint)
 			bool					hasName() const;
 
-			// Returns 'Name' of the function
-			const std::string&		getName() const;
+			// Returns 'Name' of the function (owned by the record, or references Image memory or the global intern table, see PENameStorage)
+			const PEStringView		getName() const;
+
+			// Returns 'Name' of the function (same as getName())
+			const PEStringView		getNameView() const;
+
+			// Returns symbol of 'Name' in the global intern table (PE_NO_SYMBOL if the name is not interned)
+			PESymbolID				getNameSymbol() const;
 
 			// Returns 'Hint'
 			uint16_t				getHint() const;
@@ -33,8 +43,14 @@ namespace OpenPE
 			// Setters do not change everything inside image, they are used by PE class
 			// You also can use them to rebuild image imports
 
-			// Sets 'Name' of function
-			void					setName(const std::string& sName);
+			// Sets 'Name' of function (the name is copied into the record)
+			void					setName(const PEStringView& sName);
+
+			// Sets 'Name' of function as a reference to memory owned by someone else (e.g. Image Section data)
+			void					setNameView(const PEStringView& vName);
+
+			// Sets 'Name' of function as a symbol of the global intern table
+			void					setNameSymbol(PESymbolID iSymbol);
 
 			// Sets 'Hint'
 			void					setHint(uint16_t iHint);
@@ -46,6 +62,8 @@ namespace OpenPE
 			void					setIAT_VA(uint64_t iVA);
 		private:
 			std::string				m_sName;
+			PEStringView			m_vName;
+			PESymbolID				m_iNameSymbol;
 			uint16_t				m_iHint;
 			uint16_t				m_iOrdinal;
 			uint64_t				m_iIAT_VA;
@@ -60,8 +78,14 @@ namespace OpenPE
 			// Default Constructor
 			PEImportLibrary();
 
-			// Returns 'Name' of the Library
-			const std::string&				getName() const;
+			// Returns 'Name' of the Library (owned by the record, or references Image memory or the global intern table, see PENameStorage)
+			const PEStringView				getName() const;
+
+			// Returns 'Name' of the Library (same as getName())
+			const PEStringView				getNameView() const;
+
+			// Returns symbol of 'Name' in the global intern table (PE_NO_SYMBOL if the name is not interned)
+			PESymbolID						getNameSymbol() const;
 
 			// Returns RVA to Import Address Table(IAT)
 			uint32_t						getRVAToIAT() const;
@@ -78,8 +102,14 @@ namespace OpenPE
 			// Setters do not change everything inside image, they are used by PE class
 			// You also can use them to rebuild image imports
 
-			// Sets 'Name' of the Library
-			void							setName(const std::string& sName);
+			// Sets 'Name' of the Library (the name is copied into the record)
+			void							setName(const PEStringView& sName);
+
+			// Sets 'Name' of the Library as a reference to memory owned by someone else (e.g. Image Section data)
+			void							setNameView(const PEStringView& vName);
+
+			// Sets 'Name' of the Library as a symbol of the global intern table
+			void							setNameSymbol(PESymbolID iSymbol);
 
 			// Sets RVA to Import Address Table(IAT)
 			void							setRVAToIAT(uint32_t iRVAToIAT);
@@ -95,8 +125,13 @@ namespace OpenPE
 
 			// Clears 'Imported' function list
 			void							clearImports();
+
+			// Reserves space for 'Imported' functions
+			void							reserveImports(size_t iCount);
 		private:
 			std::string						m_sName;
+			PEStringView					m_vName;
+			PESymbolID						m_iNameSymbol;
 			uint32_t						m_iRVAToIAT;
 			uint32_t						m_iRVAToOriginalIAT;
 			uint32_t						m_iTimeStamp;
@@ -185,28 +220,366 @@ namespace OpenPE
 	typedef	std::vector<PEImportLibrary>		PEIMPORTED_FUNCTIONS_LIST;
 
 	// Returns imported functions list with related libraries info
-	const PEIMPORTED_FUNCTIONS_LIST				getImportedFunctionsList(const PEBase& peBase);
+	// If eNameStorage = PE_NAME_STORAGE_VIEW, library & function names reference Image memory instead of being copied
+	// If eNameStorage = PE_NAME_STORAGE_INTERN, names are stored once in the global intern table & records carry their symbols
+	const PEIMPORTED_FUNCTIONS_LIST				getImportedFunctionsList(const PEBase& peBase, PENameStorage eNameStorage = PE_NAME_STORAGE_COPY);
 
 	template<typename PEClassType>
-	const PEIMPORTED_FUNCTIONS_LIST				getImportedFunctionsBase(const PEBase& peBase);
+	const PEIMPORTED_FUNCTIONS_LIST				getImportedFunctionsBase(const PEBase& peBase, PENameStorage eNameStorage = PE_NAME_STORAGE_COPY);
+
+	// Lazy Import Directory iteration
+	// Ranges below decode descriptors & thunks on the fly, without any allocation,
+	// so that early-exit queries cost only the entries actually visited
+
+	// Class representing an Import thunk decoded by PEImportThunkRange
+	class PEImportThunk
+	{
+		public:
+			// Default Constructor
+			PEImportThunk();
+
+			// Returns 'true' if function is imported by ordinal
+			bool					isImportedByOrdinal() const;
+
+			// Returns 'true' if function is imported by 'Name' (& Hint)
+			bool					hasName() const;
+
+			// Returns 'Name' of the function (references Image memory)
+			const PEStringView&		getName() const;
+
+			// Returns 'Hint'
+			uint16_t				getHint() const;
+
+			// Returns 'Ordinal' of the function
+			uint16_t				getOrdinal() const;
+
+			// Returns IAT entry value (VA, if image is bound)
+			uint64_t				getIAT_VA() const;
 
-	// TODO - PEImportAdder
-	// You can get all image imports with get_imported_functions() function
+			// Returns RVA of the IAT entry of this thunk
+			uint32_t				getRVAOfIATEntry() const;
+
+			// Returns index of the thunk inside of its table
+			uint32_t				getIndex() const;
+
+			// Returns the thunk as PEImportedFunction (name is copied or referenced depending on eNameStorage)
+			const PEImportedFunction	toImportedFunction(PENameStorage eNameStorage = PE_NAME_STORAGE_COPY) const;
+		private:
+			friend class PEImportThunkRange;
+
+			PEStringView			m_vName;
+			uint16_t				m_iHint;
+			uint16_t				m_iOrdinal;
+			bool					m_bByOrdinal;
+			uint64_t				m_iIAT_VA;
+			uint32_t				m_iRVAOfIATEntry;
+			uint32_t				m_iIndex;
+	};
+
+	// Class representing thunks of one imported library: IAT & original IAT (lookup table) are resolved once,
+	// then walked with direct bounded pointers
+	class PEImportThunkRange
+	{
+		public:
+			// Forward iterator decoding one thunk per step
+			class const_iterator
+			{
+				public:
+					typedef std::forward_iterator_tag	iterator_category;
+					typedef PEImportThunk				value_type;
+					typedef ptrdiff_t					difference_type;
+					typedef const PEImportThunk*		pointer;
+					typedef const PEImportThunk&		reference;
+				public:
+					// Default Constructor (end iterator)
+					const_iterator();
+
+					reference			operator*() const;
+					pointer				operator->() const;
+
+					const_iterator&		operator++();
+					const_iterator		operator++(int);
+
+					bool				operator==(const const_iterator& other) const;
+					bool				operator!=(const const_iterator& other) const;
+				private:
+					friend class PEImportThunkRange;
+					const_iterator(const PEImportThunkRange* pRange, uint32_t iIndex);
+
+					// Decodes thunk at current index, or turns into end iterator at the terminating thunk
+					void				decode();
+
+					const PEImportThunkRange*	m_pRange;
+					PEDataCursor		m_NameCursor;
+					uint32_t			m_iIndex;
+					PEImportThunk		m_Thunk;
+			};
+		public:
+			// Default Constructor (empty range)
+			PEImportThunkRange();
+
+			// Constructor from IAT & original IAT RVAs (iRVAToOriginalIAT can be 0, then names are taken from IAT)
+			// Thunk size is taken from the Image type
+			PEImportThunkRange(const PEBase& peBase, uint32_t iRVAToIAT, uint32_t iRVAToOriginalIAT);
+
+			// Same as above, with explicit thunk size (PE+ = 64-bit thunks)
+			// iLookupBase is subtracted from name pointers of lookup table (non-zero for VA-based tables)
+			// Only a zero lookup entry ends the table, IAT entries may be zero or bound addresses
+			// (the IAT ends the table only when there is no lookup table)
+			PEImportThunkRange(const PEBase& peBase, uint32_t iRVAToIAT, uint32_t iRVAToOriginalIAT, bool b64BitThunks, uint64_t iLookupBase = 0);
+
+			const_iterator			begin() const;
+			const_iterator			end() const;
+
+			// Returns 'true' if there are no thunks
+			bool					empty() const;
+
+			// Counts thunks up to the terminating one (no decoding)
+			uint32_t				count() const;
+		private:
+			// Returns thunk value at index from table
+			uint64_t				getThunk(const char* pTable, uint32_t iIndex) const;
+
+			const PEBase*			m_pPEBase;
+			const char*				m_pIAT;
+			const char*				m_pLookupTable;
+			uint32_t				m_iIATCount;
+			uint32_t				m_iLookupCount;
+			uint32_t				m_iRVAToIAT;
+			bool					m_b64BitThunks;
+			uint64_t				m_iLookupBase;
+	};
+
+	// Class representing an Import descriptor decoded by PEImportDescriptorRange
+	class PEImportDescriptorEntry
+	{
+		public:
+			// Default Constructor
+			PEImportDescriptorEntry();
+
+			// Returns 'Name' of the Library (references Image memory)
+			const PEStringView&		getName() const;
+
+			// Returns RVA to Import Address Table(IAT)
+			uint32_t				getRVAToIAT() const;
+
+			// Returns RVA to Original Import Address Table(Original IAT)
+			uint32_t				getRVATOOriginalIAT() const;
+
+			// Returns TimeStamp
+			uint32_t				getTimeStamp() const;
+
+			// Returns Forwarder chain
+			uint32_t				getForwarderChain() const;
+
+			// Returns lazy range over imported functions of the Library
+			const PEImportThunkRange	getThunks() const;
+		private:
+			friend class PEImportDescriptorRange;
+
+			const PEBase*			m_pPEBase;
+			bool					m_b64BitThunks;
+			PEStringView			m_vName;
+			IMAGE_IMPORT_DESCRIPTOR	m_Descriptor;
+	};
+
+	// Class representing the Import Directory descriptors, decoded on the fly
+	class PEImportDescriptorRange
+	{
+		public:
+			// Forward iterator decoding one descriptor per step
+			class const_iterator
+			{
+				public:
+					typedef std::forward_iterator_tag	iterator_category;
+					typedef PEImportDescriptorEntry		value_type;
+					typedef ptrdiff_t					difference_type;
+					typedef const PEImportDescriptorEntry*	pointer;
+					typedef const PEImportDescriptorEntry&	reference;
+				public:
+					// Default Constructor (end iterator)
+					const_iterator();
+
+					reference			operator*() const;
+					pointer				operator->() const;
+
+					const_iterator&		operator++();
+					const_iterator		operator++(int);
+
+					bool				operator==(const const_iterator& other) const;
+					bool				operator!=(const const_iterator& other) const;
+				private:
+					friend class PEImportDescriptorRange;
+					const_iterator(const PEImportDescriptorRange* pRange, uint32_t iIndex);
+
+					// Decodes descriptor at current index, or turns into end iterator at the zero-element
+					void				decode();
+
+					const PEImportDescriptorRange*	m_pRange;
+					PEDataCursor		m_NameCursor;
+					uint32_t			m_iIndex;
+					PEImportDescriptorEntry	m_Entry;
+			};
+		public:
+			// Constructor (empty range if image has no imports)
+			explicit PEImportDescriptorRange(const PEBase& peBase);
+
+			const_iterator			begin() const;
+			const_iterator			end() const;
+
+			// Returns 'true' if there are no descriptors
+			bool					empty() const;
+
+			// Counts descriptors up to the zero-element (no decoding)
+			uint32_t				count() const;
+		private:
+			const PEBase*			m_pPEBase;
+			const IMAGE_IMPORT_DESCRIPTOR*	m_pDescriptors;
+			uint32_t				m_iNumberOfDescriptors;
+	};
+
+	// Returns lazy range over Import descriptors of the Image
+	const PEImportDescriptorRange				getImportDescriptors(const PEBase& peBase);
+
+	// Returns 'true' if Image imports function by name
+	// If sLibraryName is empty, all libraries are searched (library names are compared case-insensitively)
+	// Stops at the first match
+	bool										isFunctionImported(const PEBase& peBase, const PEStringView& sFunctionName, const PEStringView& sLibraryName = PEStringView());
+
+	// Delay Import Directory
+	// Delay Import descriptors share the thunk walker (PEImportThunkRange) & the output types of the Import Directory
+
+	// Class representing a Delay Import descriptor decoded by PEDelayImportDescriptorRange
+	// All addresses are returned as RVAs (legacy VA-based descriptors are converted)
+	class PEDelayImportDescriptorEntry
+	{
+		public:
+			// Default Constructor
+			PEDelayImportDescriptorEntry();
+
+			// Returns 'Name' of the Library (references Image memory)
+			const PEStringView&		getName() const;
+
+			// Returns Attributes
+			uint32_t				getAttributes() const;
+
+			// Returns 'true' if descriptor fields are RVAs ('false' for legacy VA-based descriptors)
+			bool					isRVABased() const;
+
+			// Returns RVA to the module handle of the Library
+			uint32_t				getRVAToModuleHandle() const;
+
+			// Returns RVA to Delay Import Address Table(IAT)
+			uint32_t				getRVAToIAT() const;
+
+			// Returns RVA to Delay Import Name Table(INT)
+			uint32_t				getRVAToNameTable() const;
+
+			// Returns RVA to bound Delay Import Address Table (0, if none)
+			uint32_t				getRVAToBoundIAT() const;
+
+			// Returns RVA to unload information table (copy of IAT, 0 if none)
+			uint32_t				getRVAToUnloadInformationTable() const;
+
+			// Returns TimeStamp of the Library bound to (0, if not bound)
+			uint32_t				getTimeStamp() const;
+
+			// Returns lazy range over delay imported functions of the Library
+			const PEImportThunkRange	getThunks() const;
+		private:
+			friend class PEDelayImportDescriptorRange;
+
+			const PEBase*					m_pPEBase;
+			uint64_t						m_iLookupBase;
+			PEStringView					m_vName;
+			IMAGE_DELAYLOAD_DESCRIPTOR		m_Descriptor;		// Fields converted to RVAs
+	};
+
+	// Class representing Delay Import descriptors of an Image (zero-terminated array)
+	class PEDelayImportDescriptorRange
+	{
+		public:
+			// Forward iterator decoding one descriptor per step
+			class const_iterator
+			{
+				public:
+					typedef std::forward_iterator_tag		iterator_category;
+					typedef PEDelayImportDescriptorEntry	value_type;
+					typedef ptrdiff_t						difference_type;
+					typedef const PEDelayImportDescriptorEntry*	pointer;
+					typedef const PEDelayImportDescriptorEntry&	reference;
+				public:
+					// Default Constructor (end iterator)
+					const_iterator();
+
+					reference			operator*() const;
+					pointer				operator->() const;
+
+					const_iterator&		operator++();
+					const_iterator		operator++(int);
+
+					bool				operator==(const const_iterator& other) const;
+					bool				operator!=(const const_iterator& other) const;
+				private:
+					friend class PEDelayImportDescriptorRange;
+					const_iterator(const PEDelayImportDescriptorRange* pRange, uint32_t iIndex);
+
+					// Decodes descriptor at current index, or turns into end iterator at the zero-element
+					void				decode();
+
+					// Converts descriptor field to RVA (legacy descriptors hold VAs)
+					uint32_t			toRVA(uint32_t iAddress, bool bRVABased) const;
+
+					const PEDelayImportDescriptorRange*	m_pRange;
+					PEDataCursor					m_NameCursor;
+					uint32_t						m_iIndex;
+					PEDelayImportDescriptorEntry	m_Entry;
+			};
+		public:
+			// Constructor (empty range if image has no Delay Import Directory)
+			explicit PEDelayImportDescriptorRange(const PEBase& peBase);
+
+			const_iterator			begin() const;
+			const_iterator			end() const;
+
+			// Returns 'true' if there are no descriptors
+			bool					empty() const;
+
+			// Counts descriptors up to the zero-element (no decoding)
+			uint32_t				count() const;
+		private:
+			const PEBase*						m_pPEBase;
+			const IMAGE_DELAYLOAD_DESCRIPTOR*	m_pDescriptors;
+			uint32_t							m_iNumberOfDescriptors;
+	};
+
+	// Returns lazy range over Delay Import descriptors of the Image
+	const PEDelayImportDescriptorRange			getDelayImportDescriptors(const PEBase& peBase);
+
+	// Returns delay imported functions list with related libraries info
+	// (RVA to original IAT of each library is the RVA to its Delay Import Name Table)
+	// If eNameStorage = PE_NAME_STORAGE_VIEW, library & function names reference Image memory instead of being copied
+	// If eNameStorage = PE_NAME_STORAGE_INTERN, names are stored once in the global intern table & records carry their symbols
+	const PEIMPORTED_FUNCTIONS_LIST				getDelayImportedFunctionsList(const PEBase& peBase, PENameStorage eNameStorage = PE_NAME_STORAGE_COPY);
+
+	// You can get all image imports with getImportedFunctionsList() function
 	// You can use returned value to, for example, add new imported library with some functions
 	// to the end of list of imported libraries
-	// To keep PE file working, rebuild its imports with save_iat_and_original_iat_rvas = true (default)
+	// To keep PE file working, rebuild its imports with saveIATAndOriginalIATRVAs = true (default)
 	// Don't add new imported functions to existing imported library entries, because this can cause
 	// rewriting of some used memory (or other IAT/orig.IAT fields) by system loader
-	// The safest way is just adding import libraries with functions to the end of imported_functions_list array
-	//const PEImageDirectory						rebuildImports(	PEBase& peBase, 
-	//															const PEIMPORTED_FUNCTIONS_LIST& imports, 
-	//															PESection& importSection, 
-	//															const PEImportRebuilderSettings& import_settings = PEImportRebuilderSettings());
-
-	// TODO - PEImportAdder
-	//template<typename PEClassType>
-	//const PEImageDirectory						rebuildImportsBase(	PEBase& pe, 
-	//																const PEIMPORTED_FUNCTIONS_LIST& imports,
-	//																PESection& importSection,
-	//																const PEImportRebuilderSettings& import_settings = PEImportRebuilderSettings());
+	// The safest way is just adding import libraries with functions to the end of imported functions list
+	// The layout of the whole directory is computed first, so importSection is resized only once
+	// Names are staged before importSection is changed, so vImports may reference its data (PE_NAME_STORAGE_VIEW)
+	// Returns RVA & Size of the new Import Directory
+	const PEImageDirectory						rebuildImports(	PEBase& peBase, 
+																const PEIMPORTED_FUNCTIONS_LIST& vImports, 
+																PESection& peImportSection, 
+																const PEImportRebuilderSettings& peSettings = PEImportRebuilderSettings());
+
+	template<typename PEClassType>
+	const PEImageDirectory						rebuildImportsBase(	PEBase& peBase, 
+																	const PEIMPORTED_FUNCTIONS_LIST& vImports,
+																	PESection& peImportSection,
+																	const PEImportRebuilderSettings& peSettings = PEImportRebuilderSettings());
 }
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include "OpenPEStringView.h"
+
+namespace OpenPE
+{
+	// Identifier of a name stored in an intern table
+	typedef uint32_t			PESymbolID;
+
+	// Symbol of names which are not interned
+	static const PESymbolID		PE_NO_SYMBOL = 0;
+
+	// Class storing every distinct name once & identifying it by a 32-bit symbol
+	// Lookups (find, getName) never lock, interning a new name takes a lock
+	// Names & symbols stay valid for the lifetime of the table, they are never removed or moved
+	class PEInternTable
+	{
+		public:
+			// Default Constructor
+			PEInternTable();
+
+			// Destructor
+			~PEInternTable();
+
+			// Returns the table shared by the whole process (used by PE_NAME_STORAGE_INTERN)
+			static PEInternTable&	getGlobal();
+
+			// Returns symbol of the name, stores the name if it is not in the table yet
+			// Throws PEException if the table is full
+			PESymbolID				intern(const PEStringView& sName);
+
+			// Returns symbol of the name, or PE_NO_SYMBOL if it is not in the table
+			PESymbolID				find(const PEStringView& sName) const;
+
+			// Returns name of the symbol (null-terminated), empty if there is no such symbol
+			const PEStringView		getName(PESymbolID iSymbol) const;
+
+			// Returns number of symbols
+			uint32_t				getNumberOfSymbols() const;
+
+			// Returns number of bytes allocated by the table
+			size_t					getMemoryUsage() const;
+		private:
+			// Copying is not allowed
+			PEInternTable(const PEInternTable&);
+			PEInternTable& operator=(const PEInternTable&);
+
+			// Symbols are stored in pages of 2^PAGE_SHIFT entries
+			static const uint32_t	PAGE_SHIFT = 12;
+			static const uint32_t	PAGE_SIZE = 1 << PAGE_SHIFT;
+			static const uint32_t	MAX_PAGES = 4096;
+
+			// Names are stored in blocks of BLOCK_SIZE bytes (longer names get a block of their own)
+			static const size_t		BLOCK_SIZE = 64 * 1024;
+
+			// Initial number of hash slots (power of two)
+			static const uint32_t	INITIAL_SLOTS = 1024;
+
+			// Interned name
+			struct PESymbolEntry
+			{
+				const char*			m_pName;
+				uint32_t			m_iLength;
+				uint32_t			m_iHash;
+			};
+
+			// Hash slots (linear probing), slots hold symbols (PE_NO_SYMBOL = empty)
+			// Replaced arrays are kept till destruction, as readers may still probe them
+			struct PESlotArray
+			{
+				uint32_t					m_iMask;
+				std::atomic<PESymbolID>*	m_pSlots;
+				PESlotArray*				m_pPrevious;
+			};
+
+			// Returns entry of the (existing) symbol
+			const PESymbolEntry&	getEntry(PESymbolID iSymbol) const;
+
+			// Probes the slot array for the name
+			PESymbolID				findInSlots(const PESlotArray* pSlotArray, const PEStringView& sName, uint32_t iHash) const;
+
+			// Copies the name into the name blocks (lock must be held)
+			const char*				storeName(const PEStringView& sName);
+
+			// Doubles the number of slots (lock must be held)
+			void					growSlots();
+
+			std::atomic<PESymbolEntry*>	m_pPages[MAX_PAGES];
+			std::atomic<PESlotArray*>	m_pSlotArray;
+			std::atomic<uint32_t>		m_iNumberOfSymbols;
+
+			std::vector<char*>			m_vBlocks;
+			char*						m_pBlockPosition;
+			size_t						m_iBlockAvailable;
+			size_t						m_iMemoryUsage;
+
+			mutable std::mutex			m_Mutex;
+	};
+}
\ No newline at end of file
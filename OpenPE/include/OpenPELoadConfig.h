@@ -0,0 +1,147 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+#include "OpenPEBase.h"
+
+namespace OpenPE
+{
+	class PELoadConfig;
+
+	// Class representing a table of RVAs of the Load Configuration Directory (SafeSEH handlers, Guard tables)
+	// RVAs are kept sorted in a flat array (with the metadata byte of each entry in a parallel array),
+	// so that membership is a binary search even for hundreds of thousands of entries
+	class PEGuardTable
+	{
+		public:
+			// Default Constructor (empty table)
+			PEGuardTable();
+
+			// Returns number of entries
+			size_t					size() const;
+
+			// Returns 'true' if table has no entries
+			bool					empty() const;
+
+			// Returns RVA of entry at index
+			uint32_t				getRVA(size_t iIndex) const;
+
+			// Returns metadata of entry at index (IMAGE_GUARD_FLAG_*, 0 if the table has no metadata)
+			uint8_t					getFlags(size_t iIndex) const;
+
+			// Returns the sorted RVAs
+			const std::vector<uint32_t>&	getRVAs() const;
+
+			// Returns 'true' if RVA is in the table
+			bool					contains(uint32_t iRVA) const;
+
+			// Sets iIndex to the index of the RVA, returns 'false' if it is not in the table
+			bool					find(uint32_t iRVA, size_t& iIndex) const;
+
+			// Clears the table (keeps capacity)
+			void					clear();
+		private:
+			template<typename PEClassType>
+			friend bool				readLoadConfigBase(const PEBase& peBase, PELoadConfig& peLoadConfig);
+
+			// Decodes iCount entries of iEntrySize bytes (RVA, then metadata) at pData & sorts them
+			void					assign(const char* pData, uint32_t iCount, uint32_t iEntrySize);
+
+			std::vector<uint32_t>	m_vRVAs;
+			std::vector<uint8_t>	m_vFlags;
+	};
+
+	// Class representing Load Configuration Directory of an Image
+	// Fields missing from older versions of the structure (as told by its Size) read 0
+	// An object can be reused for many Images, the tables keep their capacity
+	class PELoadConfig
+	{
+		public:
+			// Default Constructor
+			PELoadConfig();
+
+			// Returns Size of the structure in the Image (its version)
+			uint32_t				getSize() const;
+
+			// Returns TimeDateStamp
+			uint32_t				getTimeDateStamp() const;
+
+			// Returns major & minor version
+			uint16_t				getMajorVersion() const;
+			uint16_t				getMinorVersion() const;
+
+			// Returns global flags cleared & set by the loader
+			uint32_t				getGlobalFlagsClear() const;
+			uint32_t				getGlobalFlagsSet() const;
+
+			// Returns VA of the /GS security cookie
+			uint64_t				getSecurityCookie() const;
+
+			// Returns VA of the Control Flow Guard check & dispatch function pointers
+			uint64_t				getGuardCFCheckFunctionPointer() const;
+			uint64_t				getGuardCFDispatchFunctionPointer() const;
+
+			// Returns VA of the XFG check, dispatch & table dispatch function pointers
+			uint64_t				getGuardXFGCheckFunctionPointer() const;
+			uint64_t				getGuardXFGDispatchFunctionPointer() const;
+			uint64_t				getGuardXFGTableDispatchFunctionPointer() const;
+
+			// Returns GuardFlags (IMAGE_GUARD_*)
+			uint32_t				getGuardFlags() const;
+
+			// Returns dependent load flags (LOAD_LIBRARY_SEARCH_*)
+			uint16_t				getDependentLoadFlags() const;
+
+			// Returns SafeSEH handler table (32-bit Images)
+			const PEGuardTable&		getSEHandlerTable() const;
+
+			// Returns Guard CF function table (valid indirect call targets)
+			const PEGuardTable&		getGuardCFFunctionTable() const;
+
+			// Returns Guard address-taken IAT entry table
+			const PEGuardTable&		getGuardAddressTakenIATEntryTable() const;
+
+			// Returns Guard long jump target table
+			const PEGuardTable&		getGuardLongJumpTargetTable() const;
+
+			// Returns Guard EH continuation table
+			const PEGuardTable&		getGuardEHContinuationTable() const;
+
+			// Clears the information (keeps capacity of the tables)
+			void					clear();
+		private:
+			template<typename PEClassType>
+			friend bool				readLoadConfigBase(const PEBase& peBase, PELoadConfig& peLoadConfig);
+
+			uint32_t				m_iSize;
+			uint32_t				m_iTimeDateStamp;
+			uint16_t				m_iMajorVersion;
+			uint16_t				m_iMinorVersion;
+			uint32_t				m_iGlobalFlagsClear;
+			uint32_t				m_iGlobalFlagsSet;
+			uint64_t				m_iSecurityCookie;
+			uint64_t				m_iGuardCFCheckFunctionPointer;
+			uint64_t				m_iGuardCFDispatchFunctionPointer;
+			uint64_t				m_iGuardXFGCheckFunctionPointer;
+			uint64_t				m_iGuardXFGDispatchFunctionPointer;
+			uint64_t				m_iGuardXFGTableDispatchFunctionPointer;
+			uint32_t				m_iGuardFlags;
+			uint16_t				m_iDependentLoadFlags;
+
+			PEGuardTable			m_SEHandlerTable;
+			PEGuardTable			m_GuardCFFunctionTable;
+			PEGuardTable			m_GuardAddressTakenIATEntryTable;
+			PEGuardTable			m_GuardLongJumpTargetTable;
+			PEGuardTable			m_GuardEHContinuationTable;
+	};
+
+	// Reads Load Configuration Directory of the Image & its tables
+	// Throws PEException if the directory or a table is not inside the Image data, returns 'false' if Image has no Load Configuration Directory
+	bool							readLoadConfig(const PEBase& peBase, PELoadConfig& peLoadConfig);
+
+	template<typename PEClassType>
+	bool							readLoadConfigBase(const PEBase& peBase, PELoadConfig& peLoadConfig);
+
+	// Reads XFG type hash of the function (the QWORD preceding it, see IMAGE_GUARD_FLAG_FID_XFG), returns 'false' if it is not inside the Image data
+	bool							readXFGHash(const PEBase& peBase, uint32_t iFunctionRVA, uint64_t& iHash);
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include "OpenPEResources.h"
+#include "OpenPEStringView.h"
+
+namespace OpenPE
+{
+	class PEMessageTable;
+
+	// Class representing a message of a message table (RT_MESSAGETABLE)
+	// Text references Image memory
+	class PEMessage
+	{
+		public:
+			// Default Constructor
+			PEMessage();
+
+			// Returns ID of the message
+			uint32_t				getID() const;
+
+			// Returns flags of the entry (MESSAGE_RESOURCE_UNICODE, MESSAGE_RESOURCE_UTF8)
+			uint16_t				getFlags() const;
+
+			// Returns 'true' if the text is UTF-16
+			bool					isUnicode() const;
+
+			// Returns ANSI/UTF-8 text (empty if the text is UTF-16), without trailing nulls
+			const PEStringView&		getText() const;
+
+			// Returns UTF-16 text (empty if the text is ANSI/UTF-8), without trailing nulls
+			const PEWideStringView&	getWideText() const;
+
+			// Returns the text, UTF-16 text is converted to UTF-8 (ANSI text is returned as is)
+			std::string				str() const;
+		private:
+			friend class PEMessageTable;
+
+			uint32_t				m_iID;
+			uint16_t				m_iFlags;
+			PEStringView			m_vText;
+			PEWideStringView		m_vWideText;
+	};
+
+	typedef std::vector<PEMessage>	PEMESSAGE_LIST;
+
+	// Class representing message tables of an Image
+	// The blocks are decoded once into a list of messages (ID order) & an open-addressing table of IDs,
+	// so that every lookup afterwards is a single probe sequence without touching the resource
+	// The table can be reused for many Images, its lists keep their capacity
+	class PEMessageTable
+	{
+		public:
+			// Default Constructor (no messages)
+			PEMessageTable();
+
+			// Decodes all message tables of the language (PE_RESOURCE_ANY_LANGUAGE: the first language of each table)
+			// Lookups of an ID found in several tables return the first message, throws PEException if a message table is incorrect
+			// Returns 'false' if Image has no message table
+			bool					load(const PEResources& peResources, uint32_t iLanguage = PE_RESOURCE_ANY_LANGUAGE);
+
+			// Returns number of messages
+			size_t					getNumberOfMessages() const;
+
+			// Returns all messages (ID order of the tables)
+			const PEMESSAGE_LIST&	getMessages() const;
+
+			// Returns the message with the ID, or 0 if there is none
+			const PEMessage*		findMessage(uint32_t iID) const;
+
+			// Clears the table (keeps capacity of the lists)
+			void					clear();
+		private:
+			// Decodes MESSAGE_RESOURCE_DATA of iSize bytes at pData into the message list
+			void					addMessages(const char* pData, uint32_t iSize);
+
+			// Builds the table of IDs
+			void					buildSlots();
+
+			PEMESSAGE_LIST			m_vMessages;
+			std::vector<uint32_t>	m_vSlots;				// Index + 1 of the message, 0 for an empty slot
+	};
+}
\ No newline at end of file
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <istream>
+#include <ostream>
+#include <stdint.h>
+#include "OpenPEBase.h"
+#include "OpenPEExports.h"
+#include "OpenPEStringView.h"
+
+namespace OpenPE
+{
+	// Class representing an export snapshot of a library (DLL)
+	// Exports are copied out of the library Image once, so that the Image doesn't have to be kept loaded
+	// Name lookup goes through an open-addressing hash table, ordinal lookup is a direct array access
+	class PEModuleExports
+	{
+		public:
+			// Default Constructor
+			PEModuleExports();
+
+			// Constructor, takes the snapshot of exports of the library Image
+			// sModuleName is the file name the library is imported by (e.g. "kernel32.dll")
+			PEModuleExports(const PEBase& peLibrary, const std::string& sModuleName);
+
+			// Returns file name of the library
+			const std::string&		getName() const;
+
+			// Returns TimeDateStamp of the library (File Header)
+			uint32_t				getTimeStamp() const;
+
+			// Returns preferred Image base of the library
+			uint64_t				getImageBase() const;
+
+			// Returns ordinal base
+			uint32_t				getOrdinalBase() const;
+
+			// Returns number of exported functions (non-zero entries of AddressOfFunctions)
+			uint32_t				getNumberOfExports() const;
+
+			// Returns number of entries in AddressOfFunctions (including the empty ones)
+			uint32_t				getNumberOfFunctions() const;
+
+			// Returns number of named exports
+			uint32_t				getNumberOfNames() const;
+
+			// Looks up export by name, returns 'false' if there is none
+			// (names of peExport reference memory of this snapshot)
+			bool					findExport(const PEStringView& sName, PEExportEntry& peExport) const;
+
+			// Looks up export by ordinal (ordinal base included), returns 'false' if there is none
+			bool					findExport(uint16_t iOrdinal, PEExportEntry& peExport) const;
+
+			// Writes the snapshot to the stream (native byte order)
+			void					save(std::ostream& fStream) const;
+
+			// Reads the snapshot written by save(), throws PEException if the data is incorrect
+			void					load(std::istream& fStream);
+		private:
+			// Appends null-terminated string to the blob & returns its offset
+			uint32_t				addString(const PEStringView& sString);
+
+			// Returns null-terminated string at offset of the blob
+			const PEStringView		getStringAt(uint32_t iOffset) const;
+
+			// Fills export entry of the function at index
+			void					getExport(uint32_t iIndex, PEExportEntry& peExport) const;
+
+			// (Re)builds the name hash table from the per-name arrays
+			void					buildNameHashTable();
+
+			std::string				m_sName;
+			uint32_t				m_iTimeStamp;
+			uint64_t				m_iImageBase;
+			uint32_t				m_iOrdinalBase;
+			uint32_t				m_iNumberOfExports;
+
+			// Null-separated names & forwarded names
+			std::string				m_sStrings;
+
+			// Per-function arrays (index = ordinal - ordinal base)
+			std::vector<uint32_t>	m_vFunctionRVAs;			// 0 if there is no function
+			std::vector<uint32_t>	m_vForwarderOffsets;		// NO_STRING if function is not forwarded
+
+			// Per-name arrays, in AddressOfNames order
+			std::vector<uint32_t>	m_vNameOffsets;
+			std::vector<uint16_t>	m_vNameFunctionIndices;
+
+			// Name hash table (power of two sized, linear probing), slots hold name index + 1 (0 = empty)
+			std::vector<uint32_t>	m_vNameHashTable;
+	};
+
+	// Result of following forwarders through the corpus
+	enum PEExportResolution
+	{
+		PE_EXPORT_RESOLVED,						// Function (and all of its forwarders) found
+		PE_EXPORT_MODULE_NOT_FOUND,				// A library of the chain is not in the corpus
+		PE_EXPORT_FUNCTION_NOT_FOUND,			// A function of the chain is not exported
+		PE_EXPORT_FORWARDER_LOOP				// Forwarder chain loops (or is too long)
+	};
+
+	// Class representing a corpus of library export snapshots, looked up by library file name (case-insensitive)
+	// Aliases redirect other names (e.g. API set contracts) to libraries of the corpus
+	class PEModuleCorpus
+	{
+		public:
+			typedef std::vector<PEModuleExports>					MODULE_LIST;
+			typedef std::vector<std::pair<std::string, std::string> >	ALIAS_LIST;
+		public:
+			// Default Constructor
+			PEModuleCorpus();
+
+			// Adds export snapshot of the library Image (replaces the library with the same name)
+			void					addModule(const PEBase& peLibrary, const std::string& sModuleName);
+
+			// Adds export snapshot (replaces the library with the same name)
+			void					addModule(const PEModuleExports& peModule);
+
+			// Reads the library file & adds its export snapshot under its file name
+			// Returns 'false' if the file can't be opened or is not a correct PE file
+			bool					addModuleFile(const std::string& sFilePath);
+
+			// Redirects sAlias (e.g. "api-ms-win-core-synch-l1-2-0.dll") to the library sModuleName (replaces existing alias)
+			void					addAlias(const std::string& sAlias, const std::string& sModuleName);
+
+			// Returns export snapshot of the library (or of the library its alias redirects to), or 0 if it is not in the corpus
+			const PEModuleExports*	findModule(const PEStringView& sModuleName) const;
+
+			// Follows forwarders of peExport exported by pModule ("LIBRARY.Function" or "LIBRARY.#Ordinal")
+			// On success pModule & peExport are replaced by the final library & function
+			// If pNumberOfForwarders is not 0, it receives the number of forwarders followed
+			// Chains which come back to a function of the chain (or are longer than MAX_FORWARDER_DEPTH) return PE_EXPORT_FORWARDER_LOOP
+			PEExportResolution		followForwarders(const PEModuleExports*& pModule, PEExportEntry& peExport, uint32_t* pNumberOfForwarders = 0) const;
+
+			// Follows a single forwarder ("LIBRARY.Function" or "LIBRARY.#Ordinal")
+			// On success pModule & peExport receive the library & function the forwarder points to (which may forward again)
+			PEExportResolution		findForwardedExport(const PEStringView& sForwardedName, const PEModuleExports*& pModule, PEExportEntry& peExport) const;
+
+			// Returns all libraries (in the order they were added)
+			const MODULE_LIST&		getModuleList() const;
+
+			// Returns all aliases sorted by name
+			const ALIAS_LIST&		getAliasList() const;
+
+			// Returns number of libraries
+			size_t					getNumberOfModules() const;
+
+			// Removes all libraries & aliases
+			void					clear();
+
+			// Writes all libraries & aliases to the stream, so that the corpus doesn't have to be rebuilt from the files
+			void					save(std::ostream& fStream) const;
+
+			// Replaces the corpus with the one written by save(), throws PEException if the data is incorrect
+			void					load(std::istream& fStream);
+		private:
+			// Maximum number of forwarders followed
+			static const uint32_t	MAX_FORWARDER_DEPTH = 16;
+
+			// Helper: compares library with a name ignoring case (for binary search)
+			struct ModuleFinder
+			{
+				const PEModuleCorpus*	m_pCorpus;
+
+				bool operator()(uint32_t iModuleIndex, const PEStringView& sModuleName) const;
+			};
+
+			// Helper: compares alias with a name ignoring case (for binary search)
+			struct AliasFinder
+			{
+				bool operator()(const std::pair<std::string, std::string>& peAlias, const PEStringView& sAlias) const;
+			};
+
+			// Returns library of the corpus by its own name, or 0
+			const PEModuleExports*	findModuleByName(const PEStringView& sModuleName) const;
+
+			MODULE_LIST				m_vModules;
+			std::vector<uint32_t>	m_vSortedModules;			// Indices into m_vModules, sorted by name
+			ALIAS_LIST				m_vAliases;
+	};
+}
\ No newline at end of file
@@ -48,6 +48,8 @@ namespace OpenPE
 			// Returns Image base for PE(32-bit) & PE+(64-bit) respectively
 			virtual uint32_t						getImageBase32() const;
 			virtual uint64_t						getImageBase64() const;
+			// Sets Image base (Just the Header value, no relocations are applied)
+			virtual void							setImageBase(uint64_t iNewImageBase);
 
 			//Returns Image Entry Point
 			virtual uint32_t						getEntryPoint() const;
@@ -77,6 +79,8 @@ namespace OpenPE
 
 			// Returns Size of the Image
 			virtual uint32_t						getSizeOfImage() const;
+			// Sets Size of the Image (Just the Header value)
+			virtual void							setSizeOfImage(uint32_t iSizeOfImage);
 
 			// returns number of RVA's & Sizes (number of DATA_DIRECTORY entries)
 			virtual uint32_t						getNumberOfRVAsAndSizes() const;
@@ -139,6 +143,12 @@ namespace OpenPE
 
 			// Returns Directory Size
 			virtual	uint32_t						getDirectorySize(uint32_t iDirectoryID) const;
+
+			// Sets Directory RVA
+			virtual void							setDirectoryRVA(uint32_t iDirectoryID, uint32_t iRVA);
+
+			// Sets Directory Size
+			virtual void							setDirectorySize(uint32_t iDirectoryID, uint32_t iSize);
 		public:
 			// Address Convertion
 
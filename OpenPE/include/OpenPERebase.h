@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+#include "OpenPEBase.h"
+#include "OpenPERelocations.h"
+
+namespace OpenPE
+{
+	// Class applying base relocations of an Image, so that it can be rebased to many bases
+	// The relocations are decoded & sorted once, runs of relocations of the same type are then patched by
+	// type-specific loops (no per-entry dispatch)
+	// Supported types: IMAGE_REL_BASED_HIGH, LOW, HIGHLOW, HIGHADJ, DIR64, ARM_MOV32 & THUMB_MOV32 (the last two on ARM Images only,
+	// other machines give these values other meanings)
+	// Relocations of other types or outside the data are skipped
+	class PERebaser
+	{
+		public:
+			// Default Constructor (no relocations)
+			PERebaser();
+
+			// Constructor, decodes relocations of the Image (throws PEException if Base Relocation Directory is incorrect)
+			explicit PERebaser(const PEBase& peBase);
+
+			// Returns Image base of the Image the relocations were decoded from
+			uint64_t				getImageBase() const;
+
+			// Returns the relocations (sorted by RVA)
+			const PERELOCATION_LIST&	getRelocations() const;
+
+			// Rebases loaded Image (iSize bytes laid out by RVA, as by the loader or in a memory dump)
+			// from iOldBase to iNewBase in place, returns number of relocations applied
+			size_t					rebase(char* pImage, uint32_t iSize, uint64_t iOldBase, uint64_t iNewBase) const;
+
+			// Copies loaded Image from pSource to pTarget (iSize bytes each) & rebases the copy, returns number of relocations applied
+			size_t					rebase(const char* pSource, char* pTarget, uint32_t iSize, uint64_t iOldBase, uint64_t iNewBase) const;
+
+			// Rebases Section data of the Image (the one the relocations were decoded from, or a copy of it) to iNewBase
+			// in place & sets its Image base, returns number of relocations applied
+			// To rebase into a copy, copy the PEBase first
+			size_t					rebase(PEBase& peBase, uint64_t iNewBase) const;
+		private:
+			// Applies relocations [iFirst, iLast) (RVAs >= iDataRVA) to iSize bytes at pData, which holds RVA iDataRVA
+			// Returns number of relocations applied
+			size_t					applyRelocations(size_t iFirst, size_t iLast, char* pData, uint32_t iDataRVA, uint32_t iSize, uint64_t iDelta) const;
+
+			PERELOCATION_LIST		m_vRelocations;
+			uint64_t				m_iImageBase;
+			uint16_t				m_iMachine;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <iterator>
+#include <vector>
+#include <stdint.h>
+#include "OpenPEBase.h"
+
+namespace OpenPE
+{
+	// Class representing a base relocation (8 bytes, so that millions of them can be kept in an array)
+	class PERelocation
+	{
+		public:
+			// Default Constructor
+			PERelocation();
+
+			// Constructor
+			PERelocation(uint32_t iRVA, uint16_t iType, uint16_t iParameter = 0);
+
+			// Returns RVA of the relocated value
+			uint32_t				getRVA() const;
+
+			// Returns type of the relocation (IMAGE_REL_BASED_*)
+			uint16_t				getType() const;
+
+			// Returns low 16 bits of the 32-bit value of IMAGE_REL_BASED_HIGHADJ (the entry following it)
+			uint16_t				getParameter() const;
+
+			// Returns number of bytes patched by the relocation, 0 if the type is unknown
+			uint32_t				getSize() const;
+
+			// Orders relocations by RVA
+			bool					operator<(const PERelocation& other) const;
+		private:
+			uint32_t				m_iRVA;
+			uint16_t				m_iType;
+			uint16_t				m_iParameter;
+	};
+
+	typedef std::vector<PERelocation>	PERELOCATION_LIST;
+
+	// Class representing Base Relocation Directory of an Image
+	// Sizes of all blocks are validated by the constructor, the entries are decoded on the fly by the iterator
+	// (nothing is allocated) or all at once into a sorted array
+	// Iterators reference the Image & this object, both must outlive them
+	class PERelocations
+	{
+		public:
+			// Forward iterator over relocations (block order, IMAGE_REL_BASED_ABSOLUTE padding is skipped)
+			class const_iterator
+			{
+				public:
+					typedef std::forward_iterator_tag	iterator_category;
+					typedef PERelocation				value_type;
+					typedef ptrdiff_t					difference_type;
+					typedef const PERelocation*			pointer;
+					typedef const PERelocation&			reference;
+
+					// Default Constructor (end iterator)
+					const_iterator();
+
+					reference			operator*() const;
+					pointer				operator->() const;
+					const_iterator&		operator++();
+					const_iterator		operator++(int);
+					bool				operator==(const const_iterator& other) const;
+					bool				operator!=(const const_iterator& other) const;
+
+				private:
+					friend class PERelocations;
+					const_iterator(const PERelocations* pRelocations, uint32_t iBlockOffset);
+
+					// Decodes entry at current offset (or the next one that is not padding), or turns into end iterator
+					void				decode();
+
+					const PERelocations*	m_pRelocations;
+					uint32_t				m_iBlockOffset;			// Offset of the block from the beginning of the directory
+					uint32_t				m_iOffset;				// Offset of the entry from the beginning of the directory
+					PERelocation			m_Relocation;
+			};
+
+			// Default Constructor (no relocations)
+			PERelocations();
+
+			// Constructor, validates all blocks of the Base Relocation Directory of the Image
+			// Throws PEException if a block does not fit into the directory or has incorrect size
+			explicit PERelocations(const PEBase& peBase);
+
+			const_iterator			begin() const;
+			const_iterator			end() const;
+
+			// Returns 'true' if Image has Base Relocation Directory
+			bool					hasRelocations() const;
+
+			// Returns RVA of the Base Relocation Directory
+			uint32_t				getDirectoryRVA() const;
+
+			// Returns number of blocks
+			uint32_t				getNumberOfBlocks() const;
+
+			// Returns number of entries (including padding)
+			uint32_t				getNumberOfEntries() const;
+
+			// Decodes all relocations into vRelocations (cleared first) sorted by RVA, returns number of relocations
+			// The array is allocated once, sorting is skipped when the blocks are already in order (as linkers write them)
+			size_t					getRelocations(PERELOCATION_LIST& vRelocations) const;
+		private:
+			// Returns block header at offset
+			IMAGE_BASE_RELOCATION	getBlock(uint32_t iBlockOffset) const;
+
+			// Returns entry at offset
+			uint16_t				getEntry(uint32_t iOffset) const;
+
+			const char*				m_pDirectory;
+			uint32_t				m_iDirectoryRVA;
+			uint32_t				m_iDirectorySize;			// Bytes of the blocks (padding at the end is excluded)
+			uint32_t				m_iNumberOfBlocks;
+			uint32_t				m_iNumberOfEntries;
+	};
+
+	// Returns index of the first relocation of the sorted list with RVA >= iRVA (binary search)
+	size_t							findRelocation(const PERELOCATION_LIST& vRelocations, uint32_t iRVA);
+
+	// Returns 'true' if a relocation of the sorted list patches any of iSize bytes at iRVA
+	bool							isRelocated(const PERELOCATION_LIST& vRelocations, uint32_t iRVA, uint32_t iSize);
+}
\ No newline at end of file
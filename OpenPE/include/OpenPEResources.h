@@ -0,0 +1,227 @@
+#pragma once
+
+#include <iterator>
+#include <stdint.h>
+#include "OpenPEBase.h"
+#include "OpenPEDataCursor.h"
+#include "OpenPEStringView.h"
+
+namespace OpenPE
+{
+	class PEResources;
+	class PEResourceDirectory;
+
+	// Language of findResource() which matches the first language of a resource
+	static const uint32_t PE_RESOURCE_ANY_LANGUAGE = 0xFFFFFFFF;
+
+	// Class representing resource data (a leaf of the resource tree)
+	// Data references Section memory, nothing is copied
+	class PEResourceData
+	{
+		public:
+			// Default Constructor
+			PEResourceData();
+
+			// Returns RVA of the data
+			uint32_t				getRVA() const;
+
+			// Returns size of the data
+			uint32_t				getSize() const;
+
+			// Returns code page of the data
+			uint32_t				getCodePage() const;
+
+			// Returns 'true' if all of the data is inside the Image data
+			bool					hasData() const;
+
+			// Returns the data (getSize() bytes), 0 if it is not inside the Image data
+			const char*				getData() const;
+		private:
+			friend class PEResources;
+
+			uint32_t				m_iRVA;
+			uint32_t				m_iSize;
+			uint32_t				m_iCodePage;
+			const char*				m_pData;
+	};
+
+	// Class representing an entry of a resource directory (a subdirectory or data)
+	// Names reference Section memory
+	class PEResourceEntry
+	{
+		public:
+			// Default Constructor
+			PEResourceEntry();
+
+			// Returns 'true' if the entry is named (identified by ID otherwise)
+			bool					hasName() const;
+
+			// Returns name of the entry (UTF-16)
+			const PEWideStringView&	getName() const;
+
+			// Returns ID of the entry (if it is not named)
+			uint16_t				getID() const;
+
+			// Returns 'true' if the entry is a subdirectory (data otherwise)
+			bool					isDirectory() const;
+
+			// Returns the subdirectory (decodes its header), throws PEException if the entry is not a subdirectory
+			const PEResourceDirectory	getDirectory() const;
+
+			// Returns the data (empty if the entry is a subdirectory)
+			const PEResourceData&	getData() const;
+		private:
+			friend class PEResources;
+
+			const PEResources*		m_pResources;
+			uint32_t				m_iLevel;					// Level of the directory containing the entry
+			bool					m_bHasName;
+			PEWideStringView		m_vName;
+			uint16_t				m_iID;
+			bool					m_bIsDirectory;
+			uint32_t				m_iDirectoryOffset;			// Offset of the subdirectory from the beginning of the Resource Directory
+			PEResourceData			m_Data;
+	};
+
+	// Class representing a resource directory (a node of the resource tree)
+	// Only the header is decoded, entries are decoded when they are iterated or looked up
+	class PEResourceDirectory
+	{
+		public:
+			// Forward iterator over entries (named entries first, then ID entries), decoded on the fly
+			class const_iterator
+			{
+				public:
+					typedef std::forward_iterator_tag	iterator_category;
+					typedef PEResourceEntry				value_type;
+					typedef ptrdiff_t					difference_type;
+					typedef const PEResourceEntry*		pointer;
+					typedef const PEResourceEntry&		reference;
+
+					// Default Constructor (end iterator)
+					const_iterator();
+
+					reference			operator*() const;
+					pointer				operator->() const;
+					const_iterator&		operator++();
+					const_iterator		operator++(int);
+					bool				operator==(const const_iterator& other) const;
+					bool				operator!=(const const_iterator& other) const;
+
+				private:
+					friend class PEResourceDirectory;
+					const_iterator(const PEResourceDirectory* pDirectory, uint32_t iIndex);
+
+					// Decodes entry at current index, or turns into end iterator
+					void				decode();
+
+					const PEResourceDirectory*	m_pDirectory;
+					uint32_t					m_iIndex;
+					PEResourceEntry				m_Entry;
+			};
+
+			// Default Constructor (empty directory)
+			PEResourceDirectory();
+
+			const_iterator			begin() const;
+			const_iterator			end() const;
+
+			// Returns level of the directory in the tree (0 = types, 1 = names, 2 = languages)
+			uint32_t				getLevel() const;
+
+			// Returns Characteristics of the directory
+			uint32_t				getCharacteristics() const;
+
+			// Returns TimeDateStamp of the directory
+			uint32_t				getTimeDateStamp() const;
+
+			// Returns major version of the directory
+			uint16_t				getMajorVersion() const;
+
+			// Returns minor version of the directory
+			uint16_t				getMinorVersion() const;
+
+			// Returns number of named entries
+			uint32_t				getNumberOfNamedEntries() const;
+
+			// Returns number of ID entries
+			uint32_t				getNumberOfIdEntries() const;
+
+			// Returns number of entries
+			uint32_t				getNumberOfEntries() const;
+
+			// Decodes entry at index (named entries first), returns 'false' if there is none
+			bool					getEntry(uint32_t iIndex, PEResourceEntry& peEntry) const;
+
+			// Looks up entry by ID (binary search, ID entries are sorted by the linker), returns 'false' if there is none
+			bool					findEntry(uint16_t iID, PEResourceEntry& peEntry) const;
+
+			// Looks up entry by name (ASCII, case-insensitive), returns 'false' if there is none
+			bool					findEntry(const PEStringView& sName, PEResourceEntry& peEntry) const;
+		private:
+			friend class PEResources;
+
+			const PEResources*		m_pResources;
+			uint32_t				m_iOffset;					// Offset of the directory from the beginning of the Resource Directory
+			uint32_t				m_iLevel;
+			IMAGE_RESOURCE_DIRECTORY	m_Directory;
+	};
+
+	// Class representing the resource tree of an Image
+	// The tree is expanded lazily: a directory is decoded when it is reached, its entries when they are iterated,
+	// so that Images with tens of thousands of resources can be queried without building the tree
+	// Directories, entries & data reference the Image & this object, both must outlive them
+	// Lookups share a Section cursor, so a single object must not be used by several threads at once
+	class PEResources
+	{
+		public:
+			// Default Constructor (no resources)
+			PEResources();
+
+			// Constructor, validates the root of the Resource Directory of the Image
+			explicit PEResources(const PEBase& peBase);
+
+			// Returns 'true' if Image has Resource Directory
+			bool					hasResources() const;
+
+			// Returns RVA of the Resource Directory
+			uint32_t				getDirectoryRVA() const;
+
+			// Returns the root directory (types)
+			const PEResourceDirectory	getRoot() const;
+
+			// Looks up the data of resource type/name/language (PE_RESOURCE_ANY_LANGUAGE: the first language)
+			// Returns 'false' if there is none
+			bool					findResource(uint16_t iType, uint16_t iName, uint32_t iLanguage, PEResourceData& peData) const;
+
+			// Looks up the data of named resource of the type, returns 'false' if there is none
+			bool					findResource(uint16_t iType, const PEStringView& sName, uint32_t iLanguage, PEResourceData& peData) const;
+
+			// Looks up the data of a language of the name entry (second level of the tree), returns 'false' if there is none
+			bool					findLanguage(const PEResourceEntry& peNameEntry, uint32_t iLanguage, PEResourceData& peData) const;
+		private:
+			friend class PEResourceEntry;
+			friend class PEResourceDirectory;
+
+			// Maximum depth of the tree (the loader uses 3 levels; limits loops of malformed trees)
+			static const uint32_t	MAX_LEVEL = 8;
+
+			// Copying is not allowed (directories & entries point to the object)
+			PEResources(const PEResources&);
+			PEResources& operator=(const PEResources&);
+
+			// Decodes directory header at offset
+			const PEResourceDirectory	getDirectory(uint32_t iOffset, uint32_t iLevel) const;
+
+			// Decodes entry at index of the directory
+			void					decodeEntry(const PEResourceDirectory& peDirectory, uint32_t iIndex, PEResourceEntry& peEntry) const;
+
+			// Returns 'true' if iSize bytes at offset are inside the Resource Directory
+			bool					isInside(uint32_t iOffset, uint32_t iSize) const;
+
+			mutable PEDataCursor	m_Cursor;
+			const char*				m_pDirectory;
+			uint32_t				m_iDirectoryRVA;
+			uint32_t				m_iDirectorySize;			// Bytes of the Resource Directory available in the Section
+	};
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+#include "OpenPEBase.h"
+
+namespace OpenPE
+{
+	// Index returned by the lookups of PERuntimeFunctions for RVAs outside of any function
+	const uint32_t FUNCTION_NOT_FOUND = static_cast<uint32_t>(-1);
+
+	// Class representing Exception Directory (.pdata) of an x64 (or Itanium) Image as an array of runtime functions
+	// The entries are used in place, the sort order is validated once by the constructor (a sorted copy is made
+	// only for malformed Images), so that any RVA is mapped to its function by a binary search
+	// Images of other machines (ARM .pdata has a different layout) have no functions
+	// The Image must outlive this object
+	class PERuntimeFunctions
+	{
+		public:
+			typedef const IMAGE_RUNTIME_FUNCTION_ENTRY*	const_iterator;
+
+			// Default Constructor (no functions)
+			PERuntimeFunctions();
+
+			// Constructor, validates the Exception Directory of the Image
+			// Throws PEException if it is not inside the Image data or a function ends before it begins
+			explicit PERuntimeFunctions(const PEBase& peBase);
+
+			const_iterator			begin() const;
+			const_iterator			end() const;
+
+			// Returns function at index
+			const IMAGE_RUNTIME_FUNCTION_ENTRY&	operator[](uint32_t iIndex) const;
+
+			// Returns number of functions
+			uint32_t				size() const;
+
+			// Returns 'true' if there are no functions
+			bool					empty() const;
+
+			// Returns RVA of the Exception Directory
+			uint32_t				getDirectoryRVA() const;
+
+			// Returns 'true' if the functions are sorted & don't overlap in the Image (as linkers write them)
+			bool					isSortedInImage() const;
+
+			// Returns index of the function containing RVA, FUNCTION_NOT_FOUND if there is none
+			uint32_t				findFunction(uint32_t iRVA) const;
+
+			// Returns the function containing RVA, 0 if there is none
+			const IMAGE_RUNTIME_FUNCTION_ENTRY*	getFunction(uint32_t iRVA) const;
+
+			// Maps iCount RVAs to indices of the functions containing them (FUNCTION_NOT_FOUND if there is none)
+			// Returns number of RVAs found
+			// Ascending runs of RVAs (e.g. sorted samples) are searched forward from the previous hit,
+			// so a sorted batch costs about O(n + m) instead of O(m log n)
+			size_t					findFunctions(const uint32_t* pRVAs, size_t iCount, uint32_t* pIndices) const;
+
+			// Same as above, vIndices is resized to the number of RVAs
+			size_t					findFunctions(const std::vector<uint32_t>& vRVAs, std::vector<uint32_t>& vIndices) const;
+		private:
+			// Returns the functions (in the Image, or the sorted copy)
+			const IMAGE_RUNTIME_FUNCTION_ENTRY*	getFunctions() const;
+
+			// Returns index of the first function in [iLow, iHigh) beginning after iRVA
+			uint32_t				upperBound(uint32_t iRVA, uint32_t iLow, uint32_t iHigh) const;
+
+			// Returns index of the function containing RVA, given index of the first function beginning after it
+			uint32_t				containingFunction(uint32_t iRVA, uint32_t iUpperBound) const;
+
+			const IMAGE_RUNTIME_FUNCTION_ENTRY*			m_pFunctions;
+			uint32_t									m_iNumberOfFunctions;
+			uint32_t									m_iDirectoryRVA;
+			bool										m_bSortedInImage;
+			std::vector<IMAGE_RUNTIME_FUNCTION_ENTRY>	m_vSortedFunctions;
+	};
+}
\ No newline at end of file
@@ -18,6 +18,10 @@ namespace OpenPE
 			// Default Constructor
 			PESection();
 
+			// Copy Constructor & assignment (room reserved for the virtual data is kept, see getRawData())
+			PESection(const PESection& peSection);
+			PESection&				operator=(const PESection& peSection);
+
 			// Sets the name of the Section(Stripped off to 8 characters)
 			void					SetName(const std::string& sName);
 
@@ -42,10 +46,13 @@ namespace OpenPE
 			bool					empty() const;
 
 			// Return raw section data from File image
+			// Raw & virtual data share one buffer, which is allocated once at the virtual size: switching between
+			// them only changes the length, the data itself never moves (pointers into it stay valid)
+			// The data moves only if it is changed through the non-const accessors or setRawData()
 			std::string&			getRawData();
 			const std::string&		getRawData() const;
 
-			// Returns mapped virtual section data
+			// Returns mapped virtual section data (raw data followed by zeros up to the aligned virtual size)
 			std::string&			getVirtualData(uint32_t iSectionAlignment);
 			const std::string&		getVirtualData(uint32_t iSectionAlignment) const;
 
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include "OpenPEResources.h"
+#include "OpenPEStringView.h"
+
+namespace OpenPE
+{
+	// Class representing string tables (RT_STRING) of an Image
+	// Every RT_STRING resource holds a bundle of 16 strings, the bundles are decoded once into a list of views
+	// & a table indexed by bundle number, so that a lookup is two array accesses
+	// Strings reference Image memory, the table can be reused for many Images (its lists keep their capacity)
+	class PEStringTable
+	{
+		public:
+			// Default Constructor (no strings)
+			PEStringTable();
+
+			// Decodes all string bundles of the language (PE_RESOURCE_ANY_LANGUAGE: the first language of each bundle)
+			// Throws PEException if a bundle is incorrect, returns 'false' if Image has no string table
+			bool					load(const PEResources& peResources, uint32_t iLanguage = PE_RESOURCE_ANY_LANGUAGE);
+
+			// Returns number of (non-empty) strings
+			size_t					getNumberOfStrings() const;
+
+			// Sets vString to the string with the ID (UTF-16), returns 'false' if there is none
+			// Empty strings are not distinguished from missing ones (as by the loader)
+			bool					findString(uint16_t iID, PEWideStringView& vString) const;
+
+			// Sets sString to UTF-8 string with the ID, returns 'false' if there is none
+			bool					getString(uint16_t iID, std::string& sString) const;
+
+			// Clears the table (keeps capacity of the lists)
+			void					clear();
+		private:
+			// Decodes a bundle of iSize bytes at pData
+			void					addBundle(uint16_t iBundle, const char* pData, uint32_t iSize);
+
+			std::vector<PEWideStringView>	m_vStrings;				// STRING_TABLE_BUNDLE_SIZE strings per bundle
+			std::vector<uint32_t>	m_vBundles;				// Index + 1 of the first string of the bundle, 0 if there is no bundle
+			size_t					m_iNumberOfStrings;
+	};
+}
\ No newline at end of file
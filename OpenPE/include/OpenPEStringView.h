@@ -0,0 +1,190 @@
+#pragma once
+
+#include <string>
+#include <ostream>
+#include <string.h>
+#include <stdint.h>
+#include "OpenPEStructures.h"
+#include "OpenPEUtils.h"
+
+namespace OpenPE
+{
+	// How names of parsed records (imports, exports, ...) are stored
+	enum PENameStorage
+	{
+		PE_NAME_STORAGE_COPY,		// Names are copied out of Section data, each record owns the copy of its names
+		PE_NAME_STORAGE_VIEW,		// Names reference Image memory (valid for the lifetime of the owning PEBase, as long as
+									// its Sections are not changed through non-const access, see PESection::getRawData())
+		PE_NAME_STORAGE_INTERN		// Names are stored once in the global intern table (PEInternTable::getGlobal()),
+									// records reference the table & carry the 32-bit symbol of the name
+	};
+
+	// Class representing a non-owning, read-only reference to a sequence of characters
+	class PEStringView
+	{
+		public:
+			// Default Constructor
+			PEStringView()
+				: m_pData(0)
+				, m_iLength(0)
+			{}
+
+			// Constructor from pointer & length
+			PEStringView(const char* pData, size_t iLength)
+				: m_pData(pData)
+				, m_iLength(iLength)
+			{}
+
+			// Constructor from null-terminated string
+			PEStringView(const char* pString)
+				: m_pData(pString)
+				, m_iLength(pString ? strlen(pString) : 0)
+			{}
+
+			// Constructor from std::string (references its buffer)
+			PEStringView(const std::string& sString)
+				: m_pData(sString.data())
+				, m_iLength(sString.length())
+			{}
+
+			// Returns pointer to the first character (not null-terminated in general)
+			const char*			data() const			{ return m_pData; }
+
+			// Returns number of characters
+			size_t				length() const			{ return m_iLength; }
+			size_t				size() const			{ return m_iLength; }
+
+			// Returns 'true' if view has no characters
+			bool				empty() const			{ return m_iLength == 0; }
+
+			// Iterators
+			const char*			begin() const			{ return m_pData; }
+			const char*			end() const				{ return m_pData + m_iLength; }
+
+			// Returns character at position
+			char				operator[](size_t i) const	{ return m_pData[i]; }
+
+			// Returns copy of the referenced characters
+			std::string			str() const				{ return m_iLength ? std::string(m_pData, m_iLength) : std::string(); }
+
+			// Compares two views lexicographically (same as std::string::compare)
+			int compare(const PEStringView& other) const
+			{
+				size_t iLength = m_iLength < other.m_iLength ? m_iLength : other.m_iLength;
+				int iResult = iLength ? memcmp(m_pData, other.m_pData, iLength) : 0;
+				if (iResult NOT_EQUAL_TO 0)
+					return iResult;
+
+				return m_iLength < other.m_iLength ? -1 : (m_iLength > other.m_iLength ? 1 : 0);
+			}
+
+			bool operator==(const PEStringView& other) const
+			{
+				return m_iLength == other.m_iLength && (m_iLength == 0 || memcmp(m_pData, other.m_pData, m_iLength) == 0);
+			}
+
+			// Returns 'true' if both views are equal ignoring ASCII case (module names are case-insensitive)
+			bool equalsIgnoreCase(const PEStringView& other) const
+			{
+				return m_iLength == other.m_iLength && compareIgnoreCase(other) == 0;
+			}
+
+			// Compares two views lexicographically ignoring ASCII case
+			int compareIgnoreCase(const PEStringView& other) const
+			{
+				size_t iLength = m_iLength < other.m_iLength ? m_iLength : other.m_iLength;
+				for (size_t i = 0; i < iLength; i++)
+				{
+					unsigned char c1 = m_pData[i], c2 = other.m_pData[i];
+					if (c1 >= 'A' && c1 <= 'Z') c1 += 'a' - 'A';
+					if (c2 >= 'A' && c2 <= 'Z') c2 += 'a' - 'A';
+					if (c1 NOT_EQUAL_TO c2)
+						return c1 < c2 ? -1 : 1;
+				}
+
+				return m_iLength < other.m_iLength ? -1 : (m_iLength > other.m_iLength ? 1 : 0);
+			}
+
+			bool operator!=(const PEStringView& other) const	{ return NOT(*this == other); }
+			bool operator<(const PEStringView& other) const		{ return compare(other) < 0; }
+		private:
+			const char*			m_pData;
+			size_t				m_iLength;
+	};
+
+	// Writes the referenced characters to the stream (formatted like std::string)
+	inline std::ostream& operator<<(std::ostream& osStream, const PEStringView& sView)
+	{
+		return osStream << sView.str();
+	}
+
+	// Class representing a non-owning, read-only reference to a little-endian UTF-16 string (e.g. resource names)
+	// The data doesn't have to be aligned, code units are read byte by byte
+	class PEWideStringView
+	{
+		public:
+			// Default Constructor
+			PEWideStringView()
+				: m_pData(0)
+				, m_iLength(0)
+			{}
+
+			// Constructor from pointer & length in UTF-16 code units
+			PEWideStringView(const char* pData, size_t iLength)
+				: m_pData(pData)
+				, m_iLength(iLength)
+			{}
+
+			// Returns pointer to the first byte
+			const char*			data() const			{ return m_pData; }
+
+			// Returns length in UTF-16 code units
+			size_t				length() const			{ return m_iLength; }
+
+			// Returns 'true' if string is empty
+			bool				empty() const			{ return m_iLength == 0; }
+
+			// Returns code unit at index
+			uint16_t			operator[](size_t i) const
+			{
+				return static_cast<uint16_t>(static_cast<uint8_t>(m_pData[2 * i]) | (static_cast<uint8_t>(m_pData[2 * i + 1]) << 8));
+			}
+
+			// Returns the string converted to UTF-8
+			std::string			str() const
+			{
+				std::string sResult;
+				PEUtils::appendUTF8(sResult, m_pData, m_iLength);
+				return sResult;
+			}
+
+			// Compares with an ASCII string ignoring ASCII case
+			bool equalsIgnoreCase(const PEStringView& other) const
+			{
+				if (m_iLength NOT_EQUAL_TO other.length())
+					return false;
+
+				for (size_t i = 0; i < m_iLength; i++)
+				{
+					uint16_t c1 = (*this)[i];
+					uint16_t c2 = static_cast<uint8_t>(other[i]);
+					if (c1 >= 'A' && c1 <= 'Z') c1 += 'a' - 'A';
+					if (c2 >= 'A' && c2 <= 'Z') c2 += 'a' - 'A';
+					if (c1 NOT_EQUAL_TO c2)
+						return false;
+				}
+
+				return true;
+			}
+
+			bool operator==(const PEWideStringView& other) const
+			{
+				return m_iLength == other.m_iLength && (m_iLength == 0 || memcmp(m_pData, other.m_pData, 2 * m_iLength) == 0);
+			}
+
+			bool operator!=(const PEWideStringView& other) const	{ return NOT(*this == other); }
+		private:
+			const char*			m_pData;
+			size_t				m_iLength;
+	};
+}
\ No newline at end of file
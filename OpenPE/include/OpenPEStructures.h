@@ -23,6 +23,9 @@ namespace OpenPE
 	const uint32_t IMAGE_ORDINAL_FLAG32						= 0x80000000;
 	const uint64_t IMAGE_ORDINAL_FLAG64						= 0x8000000000000000ull;
 
+	// Delay Imports
+	const uint32_t IMAGE_DELAYLOAD_RVA_BASED				= 0x1;			// Descriptor fields are RVAs (VAs otherwise)
+
 	// Section Flags
 	const uint32_t IMAGE_SCN_LNK_NRELOC_OVFL				= 0x01000000;	// The section contains extended relocations. 
 																			// The count of relocations for the section exceeds the 16 bits 
@@ -47,6 +50,13 @@ namespace OpenPE
 	// Image File Characteristics
 	const uint32_t IMAGE_FILE_RELOCS_STRIPPED				= 0x0001;		// Relocations info stripped from File.
 
+	// Image File Machine
+	const uint16_t IMAGE_FILE_MACHINE_ARM					= 0x01C0;		// ARM little endian
+	const uint16_t IMAGE_FILE_MACHINE_THUMB					= 0x01C2;		// ARM Thumb/Thumb-2 little endian
+	const uint16_t IMAGE_FILE_MACHINE_ARMNT					= 0x01C4;		// ARM Thumb-2 little endian
+	const uint16_t IMAGE_FILE_MACHINE_IA64					= 0x0200;		// Intel Itanium
+	const uint16_t IMAGE_FILE_MACHINE_AMD64					= 0x8664;		// x64
+
 	// Directory Entries
 	const uint32_t IMAGE_DIRECTORY_ENTRY_EXPORT				= 0;
 	const uint32_t IMAGE_DIRECTORY_ENTRY_IMPORT				= 1;
@@ -186,6 +196,15 @@ namespace OpenPE
 	};
 
 	// Load Configuration Directory Entry
+	// Fields were appended by later linkers, Size holds the size of the version in the Image
+	struct Image_Load_Config_Code_Integrity
+	{
+		uint16_t			Flags;
+		uint16_t			Catalog;
+		uint32_t			CatalogOffset;
+		uint32_t			Reserved;
+	};
+
 	struct Image_Load_Config_Directory32
 	{
 		uint32_t			Size;
@@ -203,11 +222,40 @@ namespace OpenPE
 		uint32_t			ProcessHeapFlags;
 		uint32_t			ProcessAffinityMask;
 		uint16_t			CSDVersion;
-		uint16_t			Reserved;
+		uint16_t			DependentLoadFlags;
 		uint32_t			EditList;
 		uint32_t			SecurityCookie;
 		uint32_t			SEHandlerTable;
 		uint32_t			SEHandlerCount;
+		uint32_t			GuardCFCheckFunctionPointer;
+		uint32_t			GuardCFDispatchFunctionPointer;
+		uint32_t			GuardCFFunctionTable;
+		uint32_t			GuardCFFunctionCount;
+		uint32_t			GuardFlags;
+		Image_Load_Config_Code_Integrity	CodeIntegrity;
+		uint32_t			GuardAddressTakenIatEntryTable;
+		uint32_t			GuardAddressTakenIatEntryCount;
+		uint32_t			GuardLongJumpTargetTable;
+		uint32_t			GuardLongJumpTargetCount;
+		uint32_t			DynamicValueRelocTable;
+		uint32_t			CHPEMetadataPointer;
+		uint32_t			GuardRFFailureRoutine;
+		uint32_t			GuardRFFailureRoutineFunctionPointer;
+		uint32_t			DynamicValueRelocTableOffset;
+		uint16_t			DynamicValueRelocTableSection;
+		uint16_t			Reserved2;
+		uint32_t			GuardRFVerifyStackPointerFunctionPointer;
+		uint32_t			HotPatchTableOffset;
+		uint32_t			Reserved3;
+		uint32_t			EnclaveConfigurationPointer;
+		uint32_t			VolatileMetadataPointer;
+		uint32_t			GuardEHContinuationTable;
+		uint32_t			GuardEHContinuationCount;
+		uint32_t			GuardXFGCheckFunctionPointer;
+		uint32_t			GuardXFGDispatchFunctionPointer;
+		uint32_t			GuardXFGTableDispatchFunctionPointer;
+		uint32_t			CastGuardOsDeterminedFailureMode;
+		uint32_t			GuardMemcpyFunctionPointer;
 	};
 	//////////////////////////////////////////////////////////////////////////////////////////
 
@@ -262,33 +310,62 @@ namespace OpenPE
 		uint64_t			EndAddressOfRawData;
 		uint64_t			AddressOfIndex;			// PDWORD
 		uint64_t			AddressOfCallback;		// PIMAGE_TLS_CALLBACK*
-		uint64_t			SizeOfZeroFill;
-		uint64_t			Charecteristics;
+		uint32_t			SizeOfZeroFill;
+		uint32_t			Charecteristics;
 	};
 
 	// Load Configuration Directory Entry
 	struct Image_Load_Config_Directory64
 	{
-		uint64_t			Size;
-		uint64_t			TimeDateStamp;
-		uint32_t			MajorVersion;
-		uint32_t			MinorVersion;
-		uint64_t			GlobalFlagsClear;
-		uint64_t			GlobalFlagsSet;
-		uint64_t			CriticalSectionDefaultTimeout;
+		uint32_t			Size;
+		uint32_t			TimeDateStamp;
+		uint16_t			MajorVersion;
+		uint16_t			MinorVersion;
+		uint32_t			GlobalFlagsClear;
+		uint32_t			GlobalFlagsSet;
+		uint32_t			CriticalSectionDefaultTimeout;
 		uint64_t			DeCommitFreeBlockThreshold;
 		uint64_t			DeCommitTotalFreeThreshold;
 		uint64_t			LockPrefixTable;
 		uint64_t			MaximumAllocationSize;
 		uint64_t			VirtualMemoryThreshold;
-		uint64_t			ProcessHeapFlags;
 		uint64_t			ProcessAffinityMask;
-		uint32_t			CSDVersion;
-		uint32_t			Reserved;
+		uint32_t			ProcessHeapFlags;
+		uint16_t			CSDVersion;
+		uint16_t			DependentLoadFlags;
 		uint64_t			EditList;
 		uint64_t			SecurityCookie;
 		uint64_t			SEHandlerTable;
 		uint64_t			SEHandlerCount;
+		uint64_t			GuardCFCheckFunctionPointer;
+		uint64_t			GuardCFDispatchFunctionPointer;
+		uint64_t			GuardCFFunctionTable;
+		uint64_t			GuardCFFunctionCount;
+		uint32_t			GuardFlags;
+		Image_Load_Config_Code_Integrity	CodeIntegrity;
+		uint64_t			GuardAddressTakenIatEntryTable;
+		uint64_t			GuardAddressTakenIatEntryCount;
+		uint64_t			GuardLongJumpTargetTable;
+		uint64_t			GuardLongJumpTargetCount;
+		uint64_t			DynamicValueRelocTable;
+		uint64_t			CHPEMetadataPointer;
+		uint64_t			GuardRFFailureRoutine;
+		uint64_t			GuardRFFailureRoutineFunctionPointer;
+		uint32_t			DynamicValueRelocTableOffset;
+		uint16_t			DynamicValueRelocTableSection;
+		uint16_t			Reserved2;
+		uint64_t			GuardRFVerifyStackPointerFunctionPointer;
+		uint32_t			HotPatchTableOffset;
+		uint32_t			Reserved3;
+		uint64_t			EnclaveConfigurationPointer;
+		uint64_t			VolatileMetadataPointer;
+		uint64_t			GuardEHContinuationTable;
+		uint64_t			GuardEHContinuationCount;
+		uint64_t			GuardXFGCheckFunctionPointer;
+		uint64_t			GuardXFGDispatchFunctionPointer;
+		uint64_t			GuardXFGTableDispatchFunctionPointer;
+		uint64_t			CastGuardOsDeterminedFailureMode;
+		uint64_t			GuardMemcpyFunctionPointer;
 	};
 	//////////////////////////////////////////////////////////////////////////////////////////
 
@@ -431,6 +508,33 @@ namespace OpenPE
 		uint32_t			iFirstThunk;				// RVA to IAT (if bound this IAT has actual addresses)
 	};
 
+	struct IMAGE_DELAYLOAD_DESCRIPTOR
+	{
+		uint32_t			iAttributes;					// IMAGE_DELAYLOAD_RVA_BASED if fields below are RVAs
+		uint32_t			iDllNameRVA;					// RVA to the name of the target library (null-terminated ASCII string)
+		uint32_t			iModuleHandleRVA;				// RVA to the HMODULE caching location (PHMODULE)
+		uint32_t			iImportAddressTableRVA;			// RVA to the start of the IAT (PIMAGE_THUNK_DATA)
+		uint32_t			iImportNameTableRVA;			// RVA to the start of the name table (PIMAGE_THUNK_DATA::AddressOfData)
+		uint32_t			iBoundImportAddressTableRVA;	// RVA to an optional bound IAT
+		uint32_t			iUnloadInformationTableRVA;		// RVA to an optional unload info table
+		uint32_t			iTimeDateStamp;					// 0 if not bound,
+															// Otherwise, date/time of the target DLL
+	};
+
+	struct IMAGE_BOUND_IMPORT_DESCRIPTOR
+	{
+		uint32_t			iTimeDateStamp;
+		uint16_t			iOffsetModuleName;				// Offset of the name from the beginning of the Bound Import Directory
+		uint16_t			iNumberOfModuleForwarderRefs;	// Number of IMAGE_BOUND_FORWARDER_REFs following the descriptor
+	};
+
+	struct IMAGE_BOUND_FORWARDER_REF
+	{
+		uint32_t			iTimeDateStamp;
+		uint16_t			iOffsetModuleName;				// Offset of the name from the beginning of the Bound Import Directory
+		uint16_t			iReserved;
+	};
+
 	// EXPORTS
 	struct IMAGE_EXPORT_DIRECTORY
 	{
@@ -447,6 +551,174 @@ namespace OpenPE
 		uint32_t			iAddressOfNameOrdinals;  // RVA from base of image
 	};	
 
+	// RESOURCES
+	const uint32_t IMAGE_RESOURCE_NAME_IS_STRING			= 0x80000000;	// Name of the entry is an offset to IMAGE_RESOURCE_DIR_STRING_U
+	const uint32_t IMAGE_RESOURCE_DATA_IS_DIRECTORY			= 0x80000000;	// Entry points to a subdirectory (IMAGE_RESOURCE_DATA_ENTRY otherwise)
+
+	// Predefined resource types (IDs of the first level of the resource tree)
+	enum PEResourceType
+	{
+		PE_RESOURCE_CURSOR							= 1,
+		PE_RESOURCE_BITMAP							= 2,
+		PE_RESOURCE_ICON							= 3,
+		PE_RESOURCE_MENU							= 4,
+		PE_RESOURCE_DIALOG							= 5,
+		PE_RESOURCE_STRING							= 6,
+		PE_RESOURCE_FONTDIR							= 7,
+		PE_RESOURCE_FONT							= 8,
+		PE_RESOURCE_ACCELERATOR						= 9,
+		PE_RESOURCE_RCDATA							= 10,
+		PE_RESOURCE_MESSAGETABLE					= 11,
+		PE_RESOURCE_GROUP_CURSOR					= 12,
+		PE_RESOURCE_GROUP_ICON						= 14,
+		PE_RESOURCE_VERSION							= 16,
+		PE_RESOURCE_DLGINCLUDE						= 17,
+		PE_RESOURCE_PLUGPLAY						= 19,
+		PE_RESOURCE_VXD								= 20,
+		PE_RESOURCE_ANICURSOR						= 21,
+		PE_RESOURCE_ANIICON							= 22,
+		PE_RESOURCE_HTML							= 23,
+		PE_RESOURCE_MANIFEST						= 24,
+	};
+
+	struct IMAGE_RESOURCE_DIRECTORY
+	{
+		uint32_t			iCharacteristics;
+		uint32_t			iTimeDateStamp;
+		uint16_t			iMajorVersion;
+		uint16_t			iMinorVersion;
+		uint16_t			iNumberOfNamedEntries;			// Named entries come first, sorted by name
+		uint16_t			iNumberOfIdEntries;				// ID entries follow, sorted by ID
+	};
+
+	struct IMAGE_RESOURCE_DIRECTORY_ENTRY
+	{
+		uint32_t			iName;							// ID, or IMAGE_RESOURCE_NAME_IS_STRING | offset of the name
+		uint32_t			iOffsetToData;					// Offset of IMAGE_RESOURCE_DATA_ENTRY, or IMAGE_RESOURCE_DATA_IS_DIRECTORY | offset of the subdirectory
+	};														// (offsets from the beginning of the Resource Directory)
+
+	struct IMAGE_RESOURCE_DATA_ENTRY
+	{
+		uint32_t			iOffsetToData;					// RVA of the data
+		uint32_t			iSize;
+		uint32_t			iCodePage;
+		uint32_t			iReserved;
+	};
+
+	// VERSION INFORMATION
+	const uint32_t VS_FFI_SIGNATURE							= 0xFEEF04BD;
+
+	struct VS_FIXEDFILEINFO
+	{
+		uint32_t			iSignature;						// VS_FFI_SIGNATURE
+		uint32_t			iStrucVersion;
+		uint32_t			iFileVersionMS;
+		uint32_t			iFileVersionLS;
+		uint32_t			iProductVersionMS;
+		uint32_t			iProductVersionLS;
+		uint32_t			iFileFlagsMask;
+		uint32_t			iFileFlags;
+		uint32_t			iFileOS;
+		uint32_t			iFileType;
+		uint32_t			iFileSubtype;
+		uint32_t			iFileDateMS;
+		uint32_t			iFileDateLS;
+	};
+
+	// MESSAGE TABLES
+	const uint16_t MESSAGE_RESOURCE_UNICODE					= 0x0001;		// Text of the entry is UTF-16 (ANSI otherwise)
+	const uint16_t MESSAGE_RESOURCE_UTF8					= 0x0002;		// Text of the entry is UTF-8
+
+	struct MESSAGE_RESOURCE_BLOCK
+	{
+		uint32_t			iLowId;
+		uint32_t			iHighId;
+		uint32_t			iOffsetToEntries;				// Offset of MESSAGE_RESOURCE_ENTRY list from the beginning of MESSAGE_RESOURCE_DATA
+	};
+
+	// MESSAGE_RESOURCE_DATA is NumberOfBlocks followed by the blocks,
+	// MESSAGE_RESOURCE_ENTRY is Length (of the entry), Flags & the text
+	const uint32_t MESSAGE_RESOURCE_ENTRY_HEADER_SIZE		= 2 * sizeof(uint16_t);
+
+	// STRING TABLES
+	const uint32_t STRING_TABLE_BUNDLE_SIZE					= 16;			// Strings of a RT_STRING resource (its name is ID / 16 + 1)
+
+	// BASE RELOCATIONS
+	// Type is the high 4 bits of an entry, offset from VirtualAddress of the block the low 12 bits
+	const uint16_t IMAGE_REL_BASED_ABSOLUTE					= 0;			// Padding, the entry is skipped
+	const uint16_t IMAGE_REL_BASED_HIGH						= 1;			// High 16 bits of the delta are added to the WORD
+	const uint16_t IMAGE_REL_BASED_LOW						= 2;			// Low 16 bits of the delta are added to the WORD
+	const uint16_t IMAGE_REL_BASED_HIGHLOW					= 3;			// Delta is added to the DWORD
+	const uint16_t IMAGE_REL_BASED_HIGHADJ					= 4;			// As HIGH, the next entry holds the low 16 bits of the 32-bit value
+	const uint16_t IMAGE_REL_BASED_ARM_MOV32				= 5;			// MOVW/MOVT pair of ARM instructions (ARM Images only; MIPS_JMPADDR on MIPS)
+	const uint16_t IMAGE_REL_BASED_THUMB_MOV32				= 7;			// MOVW/MOVT pair of Thumb-2 instructions (ARM Images only)
+	const uint16_t IMAGE_REL_BASED_DIR64					= 10;			// Delta is added to the QWORD
+
+	struct IMAGE_BASE_RELOCATION
+	{
+		uint32_t			iVirtualAddress;				// RVA of the 4K page
+		uint32_t			iSizeOfBlock;					// Size of the block, including this header & WORD entries
+	};
+
+	// EXCEPTIONS
+	// Entry of the Exception Directory (.pdata) of x64 & Itanium Images, sorted by iBeginAddress
+	struct IMAGE_RUNTIME_FUNCTION_ENTRY
+	{
+		uint32_t			iBeginAddress;					// RVA of the first byte of the function
+		uint32_t			iEndAddress;					// RVA past the last byte of the function
+		uint32_t			iUnwindInfoAddress;				// RVA of the UNWIND_INFO of the function
+	};
+
+	// UNWIND_INFO Flags
+	const uint8_t UNW_FLAG_NHANDLER							= 0x00;
+	const uint8_t UNW_FLAG_EHANDLER							= 0x01;			// Function has an exception handler
+	const uint8_t UNW_FLAG_UHANDLER							= 0x02;			// Function has a termination handler
+	const uint8_t UNW_FLAG_CHAININFO						= 0x04;			// Unwind info is chained to the one of a primary function
+
+	// UNWIND_CODE operations
+	const uint8_t UWOP_PUSH_NONVOL							= 0;			// Push of a nonvolatile register (OpInfo)
+	const uint8_t UWOP_ALLOC_LARGE							= 1;			// Allocation, size in the next slot (* 8) or the next 2 slots
+	const uint8_t UWOP_ALLOC_SMALL							= 2;			// Allocation of OpInfo * 8 + 8 bytes
+	const uint8_t UWOP_SET_FPREG							= 3;			// Frame register set to RSP + FrameOffset * 16
+	const uint8_t UWOP_SAVE_NONVOL							= 4;			// Save of a nonvolatile register (OpInfo), offset in the next slot (* 8)
+	const uint8_t UWOP_SAVE_NONVOL_FAR						= 5;			// As above, offset in the next 2 slots
+	const uint8_t UWOP_EPILOG								= 6;			// Epilog description (version 2), UWOP_SAVE_XMM in version 1
+	const uint8_t UWOP_SPARE_CODE							= 7;			// 3 slots, UWOP_SAVE_XMM_FAR in version 1
+	const uint8_t UWOP_SAVE_XMM128							= 8;			// Save of an XMM register (OpInfo), offset in the next slot (* 16)
+	const uint8_t UWOP_SAVE_XMM128_FAR						= 9;			// As above, offset in the next 2 slots
+	const uint8_t UWOP_PUSH_MACHFRAME						= 10;			// Machine frame push, OpInfo = 1 if it has an error code
+
+	// Header of UNWIND_INFO, followed by CountOfCodes UNWIND_CODEs (2 bytes each, padded to an even count)
+	// & the exception handler RVA with its data, or the IMAGE_RUNTIME_FUNCTION_ENTRY of the primary function
+	struct UNWIND_INFO
+	{
+		uint8_t				iVersionAndFlags;				// Version (low 3 bits) & UNW_FLAG_* (high 5 bits)
+		uint8_t				iSizeOfProlog;
+		uint8_t				iCountOfCodes;					// Number of UNWIND_CODE slots
+		uint8_t				iFrameRegisterAndOffset;		// Frame register (low 4 bits) & scaled offset (high 4 bits)
+	};
+
+	// LOAD CONFIGURATION GuardFlags
+	const uint32_t IMAGE_GUARD_CF_INSTRUMENTED					= 0x00000100;	// Module performs control flow integrity checks
+	const uint32_t IMAGE_GUARD_CFW_INSTRUMENTED					= 0x00000200;	// Module performs control flow & write integrity checks
+	const uint32_t IMAGE_GUARD_CF_FUNCTION_TABLE_PRESENT		= 0x00000400;	// Module contains valid control flow target metadata
+	const uint32_t IMAGE_GUARD_SECURITY_COOKIE_UNUSED			= 0x00000800;	// Module does not make use of the /GS security cookie
+	const uint32_t IMAGE_GUARD_PROTECT_DELAYLOAD_IAT			= 0x00001000;	// Module supports read only delay load IAT
+	const uint32_t IMAGE_GUARD_DELAYLOAD_IAT_IN_ITS_OWN_SECTION	= 0x00002000;	// Delayload import table in its own .didat section
+	const uint32_t IMAGE_GUARD_CF_EXPORT_SUPPRESSION_INFO_PRESENT	= 0x00004000;	// Module contains suppressed export information
+	const uint32_t IMAGE_GUARD_CF_ENABLE_EXPORT_SUPPRESSION		= 0x00008000;	// Module enables suppression of exports
+	const uint32_t IMAGE_GUARD_CF_LONGJUMP_TABLE_PRESENT		= 0x00010000;	// Module contains longjmp target information
+	const uint32_t IMAGE_GUARD_EH_CONTINUATION_TABLE_PRESENT	= 0x00400000;	// Module contains EH continuation target information
+	const uint32_t IMAGE_GUARD_XFG_ENABLED						= 0x00800000;	// Module was built with XFG
+	const uint32_t IMAGE_GUARD_CF_FUNCTION_TABLE_SIZE_MASK		= 0xF0000000;	// Number of metadata bytes following each RVA of the Guard tables
+	const uint32_t IMAGE_GUARD_CF_FUNCTION_TABLE_SIZE_SHIFT		= 28;
+
+	// Metadata of Guard table entries
+	const uint8_t IMAGE_GUARD_FLAG_FID_SUPPRESSED				= 0x01;			// Call target is explicitly suppressed
+	const uint8_t IMAGE_GUARD_FLAG_EXPORT_SUPPRESSED			= 0x02;			// Call target is export suppressed
+	const uint8_t IMAGE_GUARD_FLAG_FID_LANGEXCPTHANDLER			= 0x04;			// Call target is a language exception handler
+	const uint8_t IMAGE_GUARD_FLAG_FID_XFG						= 0x08;			// Call target has an XFG type hash (the QWORD preceding it)
+
 //#define SAVE_ISTREAM_STATE(__iFileStream__) \
 //	std::ios_base::iostate iState = __iFileStream__.exceptions(); \
 //	std::streamoff oldStreamOffset = __iFileStream__.tellg(); \
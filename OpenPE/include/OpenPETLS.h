@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+#include "OpenPEBase.h"
+
+namespace OpenPE
+{
+	// Class representing TLS Directory of an Image & its callbacks
+	// An object can be reused for many Images, the callback list keeps its capacity
+	class PETLSInfo
+	{
+		public:
+			// Default Constructor
+			PETLSInfo();
+
+			// Returns VA of the beginning of the template data
+			uint64_t				getStartAddressOfRawData() const;
+
+			// Returns VA of the end of the template data
+			uint64_t				getEndAddressOfRawData() const;
+
+			// Returns VA of the TLS index variable
+			uint64_t				getAddressOfIndex() const;
+
+			// Returns VA of the null-terminated callback list (0 if there is none)
+			uint64_t				getAddressOfCallbacks() const;
+
+			// Returns number of bytes zero-filled after the template data
+			uint32_t				getSizeOfZeroFill() const;
+
+			// Returns Characteristics (alignment of the TLS block, IMAGE_SCN_ALIGN_*)
+			uint32_t				getCharacteristics() const;
+
+			// Returns RVA of the template data (0 if there is none)
+			uint32_t				getRawDataRVA() const;
+
+			// Returns size of the template data
+			uint32_t				getSizeOfRawData() const;
+
+			// Returns the template data (getSizeOfRawData() bytes), 0 if it is not inside the Image data
+			const char*				getRawData() const;
+
+			// Returns VAs of the callbacks
+			const std::vector<uint64_t>&	getCallbacks() const;
+
+			// Returns 'true' if the callback list doesn't end inside the Image data (it could be completed at run time)
+			bool					isCallbackListTruncated() const;
+
+			// Clears the information (keeps capacity of the callback list)
+			void					clear();
+		private:
+			template<typename PEClassType>
+			friend bool				readTLSBase(const PEBase& peBase, PETLSInfo& peTLSInfo);
+
+			uint64_t				m_iStartAddressOfRawData;
+			uint64_t				m_iEndAddressOfRawData;
+			uint64_t				m_iAddressOfIndex;
+			uint64_t				m_iAddressOfCallbacks;
+			uint32_t				m_iSizeOfZeroFill;
+			uint32_t				m_iCharacteristics;
+			uint32_t				m_iRawDataRVA;
+			uint32_t				m_iSizeOfRawData;
+			const char*				m_pRawData;
+			std::vector<uint64_t>	m_vCallbacks;
+			bool					m_bCallbackListTruncated;
+	};
+
+	// Reads TLS Directory of the Image & walks its callback list (bounded by the Section holding it)
+	// Throws PEException if TLS Directory is not inside the Image data, returns 'false' if Image has no TLS Directory
+	bool							readTLS(const PEBase& peBase, PETLSInfo& peTLSInfo);
+
+	template<typename PEClassType>
+	bool							readTLSBase(const PEBase& peBase, PETLSInfo& peTLSInfo);
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <stdint.h>
+#include "OpenPEBase.h"
+#include "OpenPEDataCursor.h"
+#include "OpenPERuntimeFunctions.h"
+
+namespace OpenPE
+{
+	// Class representing a decoded unwind operation (the slots it takes are merged into it)
+	class PEUnwindCode
+	{
+		public:
+			// Default Constructor
+			PEUnwindCode();
+
+			// Constructor
+			PEUnwindCode(uint8_t iCodeOffset, uint8_t iOperation, uint8_t iOperationInfo, uint32_t iOperand);
+
+			// Returns offset of the end of the prolog instruction from the beginning of the prolog
+			uint8_t					getCodeOffset() const;
+
+			// Returns the operation (UWOP_*)
+			uint8_t					getOperation() const;
+
+			// Returns the operation info (register number for pushes & saves)
+			uint8_t					getOperationInfo() const;
+
+			// Returns allocation size (UWOP_ALLOC_*), stack offset (UWOP_SAVE_*, UWOP_SET_FPREG) in bytes,
+			// or the raw value of the following slots for other operations
+			uint32_t				getOperand() const;
+		private:
+			uint8_t					m_iCodeOffset;
+			uint8_t					m_iOperation;
+			uint8_t					m_iOperationInfo;
+			uint32_t				m_iOperand;
+	};
+
+	// Class representing a decoded UNWIND_INFO
+	class PEUnwindInfo
+	{
+		public:
+			// Default Constructor
+			PEUnwindInfo();
+
+			// Returns RVA of the UNWIND_INFO
+			uint32_t				getUnwindInfoRVA() const;
+
+			// Returns version (1 or 2)
+			uint8_t					getVersion() const;
+
+			// Returns flags (UNW_FLAG_*)
+			uint8_t					getFlags() const;
+
+			// Returns size of the prolog in bytes
+			uint8_t					getSizeOfProlog() const;
+
+			// Returns the frame register (0 if the function doesn't use one)
+			uint8_t					getFrameRegister() const;
+
+			// Returns offset of the frame register from RSP in bytes
+			uint32_t				getFrameOffset() const;
+
+			// Returns number of decoded unwind operations
+			uint32_t				getNumberOfCodes() const;
+
+			// Returns unwind operation at index (in the order of UNWIND_INFO, the reverse of the prolog)
+			const PEUnwindCode&		getCode(uint32_t iIndex) const;
+
+			// Returns 'true' if function has an exception or termination handler
+			bool					hasHandler() const;
+
+			// Returns RVA of the exception handler (0 if there is none)
+			uint32_t				getHandlerRVA() const;
+
+			// Returns RVA of the language-specific handler data (0 if there is no handler)
+			uint32_t				getHandlerDataRVA() const;
+
+			// Returns 'true' if the unwind info is chained to the one of a primary function
+			bool					isChained() const;
+
+			// Returns the primary function the unwind info is chained to (zeros if it is not chained)
+			const IMAGE_RUNTIME_FUNCTION_ENTRY&	getChainedFunction() const;
+		private:
+			friend class PEUnwindTable;
+
+			uint32_t				m_iUnwindInfoRVA;
+			uint8_t					m_iVersion;
+			uint8_t					m_iFlags;
+			uint8_t					m_iSizeOfProlog;
+			uint8_t					m_iFrameRegisterAndOffset;
+			uint32_t				m_iNumberOfCodes;
+			const PEUnwindCode*		m_pCodes;
+			uint32_t				m_iHandlerRVA;
+			uint32_t				m_iHandlerDataRVA;
+			IMAGE_RUNTIME_FUNCTION_ENTRY	m_ChainedFunction;
+	};
+
+	// Class decoding UNWIND_INFO of the functions of the Exception Directory of an x64 Image
+	// Unwind info of a function is decoded on first use & cached (per function index), so repeated unwinds
+	// against the same Image don't decode it again
+	// Returned references stay valid until clear(), the Image & the functions must outlive this object
+	class PEUnwindTable
+	{
+		public:
+			// Constructor
+			// Throws PEException if the Image is not an x64 Image (IA64 unwind info has another layout)
+			PEUnwindTable(const PEBase& peBase, const PERuntimeFunctions& peFunctions);
+
+			// Returns the functions the unwind infos belong to
+			const PERuntimeFunctions&	getFunctions() const;
+
+			// Returns unwind info of the function at index (decodes it on first use)
+			// Throws PEException if the UNWIND_INFO is not inside the Image data or is incorrect
+			const PEUnwindInfo&		getUnwindInfo(uint32_t iFunctionIndex);
+
+			// Returns unwind info of the function containing RVA, 0 if there is none
+			const PEUnwindInfo*		findUnwindInfo(uint32_t iRVA);
+
+			// Returns index of the primary function of the function at index (itself if its unwind info is not chained)
+			// Throws PEException if a chained function is not in the Exception Directory or the chain is too long
+			uint32_t				getPrimaryFunction(uint32_t iFunctionIndex);
+
+			// Returns number of decoded unwind infos
+			uint32_t				getNumberOfDecoded() const;
+
+			// Drops the decoded unwind infos
+			void					clear();
+		private:
+			// Not copyable, the unwind infos point into the code pools
+			PEUnwindTable(const PEUnwindTable&);
+			PEUnwindTable&			operator=(const PEUnwindTable&);
+
+			// Decodes UNWIND_INFO at RVA into peUnwindInfo
+			void					decode(uint32_t iUnwindInfoRVA, PEUnwindInfo& peUnwindInfo);
+
+			// Returns storage for iCount unwind operations
+			PEUnwindCode*			allocateCodes(uint32_t iCount);
+
+			const PEBase*						m_pPEBase;
+			const PERuntimeFunctions*			m_pFunctions;
+			PEDataCursor						m_Cursor;
+
+			std::vector<uint32_t>				m_vInfoIndices;		// Per function, index + 1 of its unwind info (0 if it is not decoded)
+			std::deque<PEUnwindInfo>			m_dInfos;			// Decoded unwind infos (a deque, so that references stay valid)
+			std::deque<std::vector<PEUnwindCode> >	m_dCodePools;	// Unwind operations, pools are never reallocated or moved
+	};
+}
\ No newline at end of file
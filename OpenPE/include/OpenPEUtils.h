@@ -1,9 +1,12 @@
 #pragma once
 #include <istream>
+#include <string>
 #include <stdint.h>
 
 namespace OpenPE
 {
+	class PEStringView;
+
 	class PEUtils
 	{
 		public:
@@ -53,6 +56,13 @@ namespace OpenPE
 				return false;
 			}
 
+			// Appends little-endian UTF-16 string (iLength code units, need not be aligned) to sResult as UTF-8
+			// Unpaired surrogates are replaced by U+FFFD
+			static void				appendUTF8(std::string& sResult, const char* pUTF16, size_t iLength);
+
+			// Returns FNV-1a hash of the name
+			static uint32_t			hashName(const PEStringView& sName);
+
 			static const uint32_t TWO_GB = 0x80000000;
 			static const uint32_t MAX_DWORD = 0xFFFF0000;
 			static const uint32_t MAX_WORD = 0x0000FFFF;
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include "OpenPEBase.h"
+#include "OpenPEStringView.h"
+
+namespace OpenPE
+{
+	class PEVersionInfo;
+
+	// Class representing a key/value pair of a StringTable of StringFileInfo (e.g. "CompanyName")
+	// Key & value reference Image memory (UTF-16)
+	class PEVersionString
+	{
+		public:
+			// Default Constructor
+			PEVersionString();
+
+			// Returns language of the StringTable
+			uint16_t				getLanguage() const;
+
+			// Returns code page of the StringTable
+			uint16_t				getCodePage() const;
+
+			// Returns the key
+			const PEWideStringView&	getKey() const;
+
+			// Returns the value (without trailing nulls)
+			const PEWideStringView&	getValue() const;
+
+			// Returns the value converted to UTF-8
+			std::string				getValueUTF8() const;
+		private:
+			friend bool				parseVersionInfo(const char* pData, uint32_t iSize, PEVersionInfo& peVersionInfo);
+
+			uint16_t				m_iLanguage;
+			uint16_t				m_iCodePage;
+			PEWideStringView		m_vKey;
+			PEWideStringView		m_vValue;
+	};
+
+	typedef std::vector<PEVersionString>	PEVERSION_STRING_LIST;
+
+	// Class representing version information (VS_VERSIONINFO) of an Image
+	// The blocks are decoded straight into the fixed fields & the string list (no tree is built),
+	// strings reference Image memory & are converted to UTF-8 only when asked for
+	// An object can be reused for many Images, its lists keep their capacity
+	class PEVersionInfo
+	{
+		public:
+			// Default Constructor
+			PEVersionInfo();
+
+			// Returns 'true' if version information has VS_FIXEDFILEINFO
+			bool					hasFixedFileInfo() const;
+
+			// Returns VS_FIXEDFILEINFO (zero-filled if there is none)
+			const VS_FIXEDFILEINFO&	getFixedFileInfo() const;
+
+			// Returns file version (FileVersionMS:FileVersionLS)
+			uint64_t				getFileVersion() const;
+
+			// Returns product version (ProductVersionMS:ProductVersionLS)
+			uint64_t				getProductVersion() const;
+
+			// Returns file flags (masked by FileFlagsMask)
+			uint32_t				getFileFlags() const;
+
+			// Returns operating system the file was designed for
+			uint32_t				getFileOS() const;
+
+			// Returns file type & subtype
+			uint32_t				getFileType() const;
+			uint32_t				getFileSubtype() const;
+
+			// Returns file version as "major.minor.build.revision" (empty, if there is no VS_FIXEDFILEINFO)
+			std::string				getFileVersionString() const;
+
+			// Returns product version as "major.minor.build.revision" (empty, if there is no VS_FIXEDFILEINFO)
+			std::string				getProductVersionString() const;
+
+			// Returns all strings of all StringTables (in the order of the resource)
+			const PEVERSION_STRING_LIST&	getStrings() const;
+
+			// Returns the first string with the key (ASCII, case-insensitive), or 0 if there is none
+			const PEVersionString*	findString(const PEStringView& sKey) const;
+
+			// Sets sValue to UTF-8 value of the first string with the key, returns 'false' if there is none
+			bool					getString(const PEStringView& sKey, std::string& sValue) const;
+
+			// Returns translations of VarFileInfo (language in the low word, code page in the high word)
+			const std::vector<uint32_t>&	getTranslations() const;
+
+			// Clears the information (keeps capacity of the lists)
+			void					clear();
+		private:
+			friend bool				parseVersionInfo(const char* pData, uint32_t iSize, PEVersionInfo& peVersionInfo);
+
+			bool					m_bHasFixedFileInfo;
+			VS_FIXEDFILEINFO		m_FixedFileInfo;
+			PEVERSION_STRING_LIST	m_vStrings;
+			std::vector<uint32_t>	m_vTranslations;
+	};
+
+	// Decodes VS_VERSIONINFO of iSize bytes at pData (e.g. RT_VERSION resource data)
+	// Returns 'false' if the data is not version information, malformed blocks are skipped
+	bool						parseVersionInfo(const char* pData, uint32_t iSize, PEVersionInfo& peVersionInfo);
+
+	// Locates RT_VERSION resource of the Image (3 lookups down the resource tree, nothing else is decoded) & decodes it
+	// Returns 'false' if Image has no version information
+	bool						readVersionInfo(const PEBase& peBase, PEVersionInfo& peVersionInfo);
+
+	// Reads version information of iNumberOfImages Images into pVersionInfos
+	// Images with incorrect resources get cleared information, the rest of the batch is still processed
+	// Returns number of Images with version information
+	size_t						readVersionInfos(const PEBase* const* pImages, size_t iNumberOfImages, PEVersionInfo* pVersionInfos);
+}
\ No newline at end of file
@@ -0,0 +1,659 @@
+#include "OpenPEApiHash.h"
+#include "OpenPEExports.h"
+#include "OpenPEFactory.h"
+#include "OpenPEException.h"
+#include <fstream>
+#include <string.h>
+
+namespace OpenPE
+{
+	// API hash table signature ("OPAH") & format version
+	static const uint32_t API_HASH_TABLE_SIGNATURE = 0x4841504F;
+	static const uint32_t API_HASH_TABLE_VERSION = 1;
+
+	// Helper: CRC-32 lookup table (IEEE 802.3, reflected), built before main()
+	struct PECRC32Table
+	{
+		uint32_t	m_Table[256];
+
+		PECRC32Table()
+		{
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				uint32_t iValue = i;
+				for (int iBit = 0; iBit < 8; iBit++)
+					iValue = (iValue & 1) ? (iValue >> 1) ^ 0xEDB88320 : iValue >> 1;
+
+				m_Table[i] = iValue;
+			}
+		}
+	};
+
+	static const PECRC32Table g_peCRC32Table;
+
+	// Helper: returns the hash rotated right by 13 bits & added the byte
+	static inline uint32_t addROR13(uint32_t iHash, uint8_t iByte)
+	{
+		return ((iHash >> 13) | (iHash << 19)) + iByte;
+	}
+
+	// Helper: returns ROR13 hash of the name (with the terminator, if bTerminator is set)
+	static uint32_t hashROR13(const PEStringView& sName, bool bTerminator)
+	{
+		uint32_t iHash = 0;
+		for (const char* p = sName.begin(); p != sName.end(); ++p)
+			iHash = addROR13(iHash, static_cast<uint8_t>(*p));
+
+		return bTerminator ? addROR13(iHash, 0) : iHash;
+	}
+
+	// Helper: returns ROR13 hash of the uppercase UTF-16 library name (with the terminator)
+	static uint32_t hashROR13Module(const PEStringView& sModuleName)
+	{
+		uint32_t iHash = 0;
+		for (const char* p = sModuleName.begin(); p != sModuleName.end(); ++p)
+		{
+			uint8_t c = static_cast<uint8_t>(*p);
+			if (c >= 'a' && c <= 'z')
+				c -= 'a' - 'A';
+
+			iHash = addROR13(addROR13(iHash, c), 0);
+		}
+
+		return addROR13(addROR13(iHash, 0), 0);
+	}
+
+	// Helper: returns slot of the hash
+	static inline uint32_t getSlotIndex(uint32_t iHash, uint32_t iMask)
+	{
+		return (iHash ^ (iHash >> 16)) & iMask;
+	}
+
+	// Helper: returns 'true' if iCount elements of iElementSize bytes at (4-byte aligned) iOffset fit into iSize bytes
+	static bool isRangeInside(uint32_t iOffset, uint32_t iCount, uint32_t iElementSize, uint32_t iSize)
+	{
+		return (iOffset & 3) == 0 && static_cast<uint64_t>(iOffset) + static_cast<uint64_t>(iCount) * iElementSize <= iSize;
+	}
+
+	// Helper: returns number of algorithms in the mask
+	static uint32_t getNumberOfAlgorithms(uint32_t iAlgorithms)
+	{
+		uint32_t iNumberOfAlgorithms = 0;
+		for (uint32_t iAlgorithm = 1; iAlgorithm <= PE_API_HASH_ALL; iAlgorithm <<= 1)
+		{
+			if (iAlgorithms & iAlgorithm)
+				iNumberOfAlgorithms++;
+		}
+
+		return iNumberOfAlgorithms;
+	}
+
+	// Returns hash of the function exported by the library
+	uint32_t computeApiHash(PEApiHashAlgorithm eAlgorithm, const PEStringView& sModuleName, const PEStringView& sFunctionName)
+	{
+		switch (eAlgorithm)
+		{
+			case PE_API_HASH_ROR13:
+				return hashROR13(sFunctionName, false);
+
+			case PE_API_HASH_ROR13_MODULE:
+				return hashROR13Module(sModuleName) + hashROR13(sFunctionName, true);
+
+			case PE_API_HASH_CRC32:
+			{
+				uint32_t iHash = 0xFFFFFFFF;
+				for (const char* p = sFunctionName.begin(); p != sFunctionName.end(); ++p)
+					iHash = (iHash >> 8) ^ g_peCRC32Table.m_Table[(iHash ^ static_cast<uint8_t>(*p)) & 0xFF];
+
+				return ~iHash;
+			}
+
+			case PE_API_HASH_FNV1A:
+			{
+				uint32_t iHash = 0x811C9DC5;
+				for (const char* p = sFunctionName.begin(); p != sFunctionName.end(); ++p)
+				{
+					iHash ^= static_cast<uint8_t>(*p);
+					iHash *= 0x01000193;
+				}
+
+				return iHash;
+			}
+
+			case PE_API_HASH_DJB2:
+			{
+				uint32_t iHash = 5381;
+				for (const char* p = sFunctionName.begin(); p != sFunctionName.end(); ++p)
+					iHash = iHash * 33 + static_cast<uint8_t>(*p);
+
+				return iHash;
+			}
+
+			// A combination of algorithms has no single hash
+			case PE_API_HASH_ALL:
+			default:
+				throw PEException("Incorrect API hash algorithm", PEException::PEEXCEPTION_INCORRECT_API_HASH_ALGORITHM);
+		}
+	}
+
+	// Default Constructor
+	PEApiHashMatch::PEApiHashMatch()
+		: m_iHashIndex(0)
+		, m_eAlgorithm(PE_API_HASH_ROR13)
+		, m_iHash(0)
+		, m_iOrdinal(0)
+		, m_iRVA(0)
+	{
+	}
+
+	// Returns index of the hash in the batch that was looked up
+	size_t PEApiHashMatch::getHashIndex() const
+	{
+		return m_iHashIndex;
+	}
+
+	// Returns the algorithm the hash matched
+	PEApiHashAlgorithm PEApiHashMatch::getAlgorithm() const
+	{
+		return m_eAlgorithm;
+	}
+
+	// Returns the hash
+	uint32_t PEApiHashMatch::getHash() const
+	{
+		return m_iHash;
+	}
+
+	// Returns name of the library (references memory of the table)
+	const PEStringView& PEApiHashMatch::getModuleName() const
+	{
+		return m_vModuleName;
+	}
+
+	// Returns name of the function (references memory of the table)
+	const PEStringView& PEApiHashMatch::getFunctionName() const
+	{
+		return m_vFunctionName;
+	}
+
+	// Returns ordinal of the function
+	uint16_t PEApiHashMatch::getOrdinal() const
+	{
+		return m_iOrdinal;
+	}
+
+	// Returns RVA of the function
+	uint32_t PEApiHashMatch::getRVA() const
+	{
+		return m_iRVA;
+	}
+
+	// Default Constructor
+	PEApiHashTable::PEApiHashTable()
+		: m_pData(0)
+		, m_pHeader(0)
+	{
+	}
+
+	// Uses the table image at pData without copying it, throws PEException if the image is incorrect
+	void PEApiHashTable::open(const void* pData, size_t iSize)
+	{
+		const uint8_t* pImage = static_cast<const uint8_t*>(pData);
+		if (NOT pImage || (reinterpret_cast<uintptr_t>(pImage) & 3) || iSize < sizeof(PEApiHashHeader))
+			throw PEException("Incorrect API hash table", PEException::PEEXCEPTION_INCORRECT_API_HASH_TABLE);
+
+		const PEApiHashHeader* pHeader = reinterpret_cast<const PEApiHashHeader*>(pImage);
+		const uint32_t iImageSize = pHeader->m_iSize;
+		if (	pHeader->m_iSignature NOT_EQUAL_TO API_HASH_TABLE_SIGNATURE
+				||
+				pHeader->m_iVersion NOT_EQUAL_TO API_HASH_TABLE_VERSION
+				||
+				iImageSize < sizeof(PEApiHashHeader)
+				||
+				iImageSize > iSize
+				||
+				(pHeader->m_iAlgorithms & ~static_cast<uint32_t>(PE_API_HASH_ALL))
+				||
+				NOT isRangeInside(pHeader->m_iModulesOffset, pHeader->m_iNumberOfModules, sizeof(uint32_t), iImageSize)
+				||
+				NOT isRangeInside(pHeader->m_iFunctionsOffset, pHeader->m_iNumberOfFunctions, sizeof(PEApiHashFunction), iImageSize)
+				||
+				NOT isRangeInside(pHeader->m_iTablesOffset, getNumberOfAlgorithms(pHeader->m_iAlgorithms), sizeof(PEApiHashSlots), iImageSize)
+				||
+				NOT isRangeInside(pHeader->m_iStringsOffset, pHeader->m_iStringsSize, 1, iImageSize)
+				||
+				(pHeader->m_iStringsSize && pImage[pHeader->m_iStringsOffset + pHeader->m_iStringsSize - 1])
+		) {
+			throw PEException("Incorrect API hash table", PEException::PEEXCEPTION_INCORRECT_API_HASH_TABLE);
+		}
+
+		// Lookups rely on these, so they are checked instead of trusted
+		const uint32_t* pModules = reinterpret_cast<const uint32_t*>(pImage + pHeader->m_iModulesOffset);
+		for (uint32_t i = 0; i < pHeader->m_iNumberOfModules; i++)
+		{
+			if (pModules[i] >= pHeader->m_iStringsSize)
+				throw PEException("Incorrect API hash table", PEException::PEEXCEPTION_INCORRECT_API_HASH_TABLE);
+		}
+
+		const PEApiHashFunction* pFunctions = reinterpret_cast<const PEApiHashFunction*>(pImage + pHeader->m_iFunctionsOffset);
+		for (uint32_t i = 0; i < pHeader->m_iNumberOfFunctions; i++)
+		{
+			if (	pFunctions[i].m_iModule >= pHeader->m_iNumberOfModules
+					||
+					pFunctions[i].m_iNameOffset >= pHeader->m_iStringsSize
+					||
+					pFunctions[i].m_iOrdinal > PEUtils::MAX_WORD
+			) {
+				throw PEException("Incorrect API hash table", PEException::PEEXCEPTION_INCORRECT_API_HASH_TABLE);
+			}
+		}
+
+		const PEApiHashSlots* pTables = reinterpret_cast<const PEApiHashSlots*>(pImage + pHeader->m_iTablesOffset);
+		for (uint32_t iAlgorithm = 1; iAlgorithm <= PE_API_HASH_ALL; iAlgorithm <<= 1)
+		{
+			if (NOT (pHeader->m_iAlgorithms & iAlgorithm))
+				continue;
+
+			// Every probe must end on an empty slot
+			const PEApiHashSlots& peSlots = *pTables++;
+			if (	peSlots.m_iAlgorithm NOT_EQUAL_TO iAlgorithm
+					||
+					peSlots.m_iNumberOfSlots <= pHeader->m_iNumberOfFunctions
+					||
+					(peSlots.m_iNumberOfSlots & (peSlots.m_iNumberOfSlots - 1))
+					||
+					NOT isRangeInside(peSlots.m_iSlotsOffset, peSlots.m_iNumberOfSlots, 2 * sizeof(uint32_t), iImageSize)
+			) {
+				throw PEException("Incorrect API hash table", PEException::PEEXCEPTION_INCORRECT_API_HASH_TABLE);
+			}
+
+			const uint32_t* pSlots = reinterpret_cast<const uint32_t*>(pImage + peSlots.m_iSlotsOffset);
+			uint32_t iNumberOfUsedSlots = 0;
+			for (uint32_t i = 0; i < peSlots.m_iNumberOfSlots; i++)
+			{
+				if (pSlots[2 * i + 1] > pHeader->m_iNumberOfFunctions)
+					throw PEException("Incorrect API hash table", PEException::PEEXCEPTION_INCORRECT_API_HASH_TABLE);
+
+				if (pSlots[2 * i + 1])
+					iNumberOfUsedSlots++;
+			}
+
+			if (iNumberOfUsedSlots >= peSlots.m_iNumberOfSlots)
+				throw PEException("Incorrect API hash table", PEException::PEEXCEPTION_INCORRECT_API_HASH_TABLE);
+		}
+
+		// Release the owned image, unless pData is the image itself
+		if (m_vImage.empty() || pImage NOT_EQUAL_TO reinterpret_cast<const uint8_t*>(&m_vImage[0]))
+			std::vector<uint32_t>().swap(m_vImage);
+
+		m_pData = pImage;
+		m_pHeader = pHeader;
+	}
+
+	// Reads the table written by save(), throws PEException if the data is incorrect
+	void PEApiHashTable::load(std::istream& fStream)
+	{
+		PEApiHashHeader peHeader;
+		fStream.read(reinterpret_cast<char*>(&peHeader), sizeof(PEApiHashHeader));
+		if (	NOT fStream
+				||
+				peHeader.m_iSignature NOT_EQUAL_TO API_HASH_TABLE_SIGNATURE
+				||
+				peHeader.m_iSize < sizeof(PEApiHashHeader)
+				||
+				(peHeader.m_iSize & 3)
+		) {
+			throw PEException("Incorrect API hash table", PEException::PEEXCEPTION_INCORRECT_API_HASH_TABLE);
+		}
+
+		std::vector<uint32_t> vImage(peHeader.m_iSize / sizeof(uint32_t));
+		memcpy(&vImage[0], &peHeader, sizeof(PEApiHashHeader));
+		fStream.read(reinterpret_cast<char*>(&vImage[0]) + sizeof(PEApiHashHeader), peHeader.m_iSize - sizeof(PEApiHashHeader));
+		if (NOT fStream)
+			throw PEException("Incorrect API hash table", PEException::PEEXCEPTION_INCORRECT_API_HASH_TABLE);
+
+		open(&vImage[0], peHeader.m_iSize);
+		m_vImage.swap(vImage);
+	}
+
+	// Writes the table image to the stream
+	void PEApiHashTable::save(std::ostream& fStream) const
+	{
+		if (m_pHeader)
+			fStream.write(reinterpret_cast<const char*>(m_pData), m_pHeader->m_iSize);
+	}
+
+	// Returns the table image
+	const void* PEApiHashTable::getData() const
+	{
+		return m_pData;
+	}
+
+	// Returns size of the table image in bytes
+	size_t PEApiHashTable::getSize() const
+	{
+		return m_pHeader ? m_pHeader->m_iSize : 0;
+	}
+
+	// Returns 'true' if there is no table
+	bool PEApiHashTable::isEmpty() const
+	{
+		return m_pHeader == 0;
+	}
+
+	// Returns mask of PEApiHashAlgorithm in the table
+	uint32_t PEApiHashTable::getAlgorithms() const
+	{
+		return m_pHeader ? m_pHeader->m_iAlgorithms : 0;
+	}
+
+	// Returns number of libraries
+	uint32_t PEApiHashTable::getNumberOfModules() const
+	{
+		return m_pHeader ? m_pHeader->m_iNumberOfModules : 0;
+	}
+
+	// Returns number of hashed functions
+	uint32_t PEApiHashTable::getNumberOfFunctions() const
+	{
+		return m_pHeader ? m_pHeader->m_iNumberOfFunctions : 0;
+	}
+
+	// Returns name of the library at index
+	const PEStringView PEApiHashTable::getModuleName(uint32_t iModule) const
+	{
+		if (iModule >= getNumberOfModules())
+			return PEStringView();
+
+		return getStringAt(getWords(m_pHeader->m_iModulesOffset)[iModule]);
+	}
+
+	// Appends all functions with the hash to vMatches, returns number of functions appended
+	size_t PEApiHashTable::findHash(PEApiHashAlgorithm eAlgorithm, uint32_t iHash, PEAPI_HASH_MATCH_LIST& vMatches) const
+	{
+		const PEApiHashSlots* pSlots = getSlots(eAlgorithm);
+		if (NOT pSlots)
+			return 0;
+
+		const uint32_t* pSlotWords = getWords(pSlots->m_iSlotsOffset);
+		const PEApiHashFunction* pFunctions = reinterpret_cast<const PEApiHashFunction*>(getWords(m_pHeader->m_iFunctionsOffset));
+
+		// Functions sharing the hash are all on the probe sequence of the hash
+		size_t iNumberOfMatches = 0;
+		const uint32_t iMask = pSlots->m_iNumberOfSlots - 1;
+		for (uint32_t iSlot = getSlotIndex(iHash, iMask); pSlotWords[2 * iSlot + 1]; iSlot = (iSlot + 1) & iMask)
+		{
+			if (pSlotWords[2 * iSlot] NOT_EQUAL_TO iHash)
+				continue;
+
+			const PEApiHashFunction& peFunction = pFunctions[pSlotWords[2 * iSlot + 1] - 1];
+
+			vMatches.push_back(PEApiHashMatch());
+			PEApiHashMatch& peMatch = vMatches.back();
+			peMatch.m_eAlgorithm = eAlgorithm;
+			peMatch.m_iHash = iHash;
+			peMatch.m_vModuleName = getModuleName(peFunction.m_iModule);
+			peMatch.m_vFunctionName = getStringAt(peFunction.m_iNameOffset);
+			peMatch.m_iOrdinal = static_cast<uint16_t>(peFunction.m_iOrdinal);
+			peMatch.m_iRVA = peFunction.m_iRVA;
+
+			iNumberOfMatches++;
+		}
+
+		return iNumberOfMatches;
+	}
+
+	// Looks up iNumberOfHashes hashes with every algorithm of the mask, returns number of hashes that matched a function
+	size_t PEApiHashTable::findHashes(uint32_t iAlgorithms, const uint32_t* pHashes, size_t iNumberOfHashes, PEAPI_HASH_MATCH_LIST& vMatches) const
+	{
+		size_t iNumberOfFound = 0;
+
+		for (size_t i = 0; i < iNumberOfHashes; i++)
+		{
+			const size_t iFirstMatch = vMatches.size();
+			for (uint32_t iAlgorithm = 1; iAlgorithm <= PE_API_HASH_ALL; iAlgorithm <<= 1)
+			{
+				if (iAlgorithms & iAlgorithm)
+					findHash(static_cast<PEApiHashAlgorithm>(iAlgorithm), pHashes[i], vMatches);
+			}
+
+			if (vMatches.size() == iFirstMatch)
+				continue;
+
+			for (size_t iMatch = iFirstMatch; iMatch < vMatches.size(); iMatch++)
+				vMatches[iMatch].m_iHashIndex = i;
+
+			iNumberOfFound++;
+		}
+
+		return iNumberOfFound;
+	}
+
+	// Drops the table
+	void PEApiHashTable::clear()
+	{
+		std::vector<uint32_t>().swap(m_vImage);
+		m_pData = 0;
+		m_pHeader = 0;
+	}
+
+	// Takes ownership of the image built by PEApiHashTableBuilder
+	void PEApiHashTable::adopt(std::vector<uint32_t>& vImage)
+	{
+		m_vImage.swap(vImage);
+		m_pData = reinterpret_cast<const uint8_t*>(&m_vImage[0]);
+		m_pHeader = reinterpret_cast<const PEApiHashHeader*>(m_pData);
+	}
+
+	// Returns hash table of the algorithm, or 0 if it is not in the table
+	const PEApiHashTable::PEApiHashSlots* PEApiHashTable::getSlots(PEApiHashAlgorithm eAlgorithm) const
+	{
+		if (NOT m_pHeader || NOT (m_pHeader->m_iAlgorithms & eAlgorithm) || (eAlgorithm & (eAlgorithm - 1)))
+			return 0;
+
+		// Tables are in bit order, skip the ones of the lower algorithms
+		const uint32_t iIndex = getNumberOfAlgorithms(m_pHeader->m_iAlgorithms & (eAlgorithm - 1));
+		return reinterpret_cast<const PEApiHashSlots*>(getWords(m_pHeader->m_iTablesOffset)) + iIndex;
+	}
+
+	// Returns null-terminated string at offset of the strings
+	const PEStringView PEApiHashTable::getStringAt(uint32_t iOffset) const
+	{
+		return PEStringView(reinterpret_cast<const char*>(m_pData + m_pHeader->m_iStringsOffset + iOffset));
+	}
+
+	// Returns word at byte offset of the image
+	const uint32_t* PEApiHashTable::getWords(uint32_t iOffset) const
+	{
+		return reinterpret_cast<const uint32_t*>(m_pData + iOffset);
+	}
+
+	// Constructor, iAlgorithms is a mask of PEApiHashAlgorithm
+	PEApiHashTableBuilder::PEApiHashTableBuilder(uint32_t iAlgorithms)
+		: m_iAlgorithms(iAlgorithms & PE_API_HASH_ALL)
+		, m_iNumberOfAlgorithms(getNumberOfAlgorithms(iAlgorithms & PE_API_HASH_ALL))
+	{
+	}
+
+	// Adds named exports of the library Image
+	void PEApiHashTableBuilder::addModule(const PEBase& peLibrary, const std::string& sModuleName)
+	{
+		// Names are copied right away, so they don't have to be copied by the parser
+		const PEEXPORTED_FUNCTION_LIST vExports = getExportedFunctionsList(peLibrary, PE_NAME_STORAGE_VIEW);
+
+		const uint32_t iModule = static_cast<uint32_t>(m_vModuleNameOffsets.size());
+		m_vModuleNameOffsets.push_back(addString(sModuleName));
+
+		for (PEEXPORTED_FUNCTION_LIST::const_iterator itr = vExports.begin(); itr != vExports.end(); ++itr)
+		{
+			if (NOT itr->hasName())
+				continue;
+
+			const PEStringView sName = itr->getNameView();
+
+			PEApiHashTable::PEApiHashFunction peFunction;
+			peFunction.m_iModule = iModule;
+			peFunction.m_iNameOffset = addString(sName);
+			peFunction.m_iOrdinal = itr->getOrdinal();
+			peFunction.m_iRVA = itr->getRVA();
+			m_vFunctions.push_back(peFunction);
+
+			for (uint32_t iAlgorithm = 1; iAlgorithm <= PE_API_HASH_ALL; iAlgorithm <<= 1)
+			{
+				if (m_iAlgorithms & iAlgorithm)
+					m_vHashes.push_back(computeApiHash(static_cast<PEApiHashAlgorithm>(iAlgorithm), sModuleName, sName));
+			}
+		}
+	}
+
+	// Reads the library file & adds its named exports under its file name
+	// Returns 'false' if the file can't be opened or is not a correct PE file
+	bool PEApiHashTableBuilder::addModuleFile(const std::string& sFilePath)
+	{
+		std::ifstream fStream(sFilePath.c_str(), std::ios::in | std::ios::binary);
+		if (NOT fStream)
+			return false;
+
+		std::string::size_type iNameStart = sFilePath.find_last_of("\\/");
+		std::string sModuleName = (iNameStart == std::string::npos) ? sFilePath : sFilePath.substr(iNameStart + 1);
+
+		// Nothing of the library is added, if its exports can't be read
+		const size_t iStringsSize = m_sStrings.size();
+		const size_t iNumberOfModules = m_vModuleNameOffsets.size();
+		const size_t iNumberOfFunctions = m_vFunctions.size();
+
+		try
+		{
+			PEBase peLibrary(PEFactory::createPE(fStream, false));
+			addModule(peLibrary, sModuleName);
+		}
+		catch (const PEException&)
+		{
+			m_sStrings.resize(iStringsSize);
+			m_vModuleNameOffsets.resize(iNumberOfModules);
+			m_vFunctions.resize(iNumberOfFunctions);
+			m_vHashes.resize(iNumberOfFunctions * m_iNumberOfAlgorithms);
+
+			return false;
+		}
+
+		return true;
+	}
+
+	// Returns mask of PEApiHashAlgorithm
+	uint32_t PEApiHashTableBuilder::getAlgorithms() const
+	{
+		return m_iAlgorithms;
+	}
+
+	// Returns number of libraries added
+	uint32_t PEApiHashTableBuilder::getNumberOfModules() const
+	{
+		return static_cast<uint32_t>(m_vModuleNameOffsets.size());
+	}
+
+	// Returns number of functions added
+	uint32_t PEApiHashTableBuilder::getNumberOfFunctions() const
+	{
+		return static_cast<uint32_t>(m_vFunctions.size());
+	}
+
+	// Builds the table (replaces the contents of peTable)
+	void PEApiHashTableBuilder::build(PEApiHashTable& peTable) const
+	{
+		const uint32_t iNumberOfModules = getNumberOfModules();
+		const uint32_t iNumberOfFunctions = getNumberOfFunctions();
+
+		// Keep the load factor at or below 1/2
+		uint32_t iNumberOfSlots = 1;
+		while (iNumberOfSlots <= iNumberOfFunctions * 2)
+			iNumberOfSlots <<= 1;
+
+		// Layout: header, library names, functions, slot table descriptors, slots, strings
+		const uint64_t iModulesOffset = sizeof(PEApiHashTable::PEApiHashHeader);
+		const uint64_t iFunctionsOffset = iModulesOffset + static_cast<uint64_t>(iNumberOfModules) * sizeof(uint32_t);
+		const uint64_t iTablesOffset = iFunctionsOffset + static_cast<uint64_t>(iNumberOfFunctions) * sizeof(PEApiHashTable::PEApiHashFunction);
+		const uint64_t iSlotsOffset = iTablesOffset + static_cast<uint64_t>(m_iNumberOfAlgorithms) * sizeof(PEApiHashTable::PEApiHashSlots);
+		const uint64_t iStringsOffset = iSlotsOffset + static_cast<uint64_t>(m_iNumberOfAlgorithms) * iNumberOfSlots * 2 * sizeof(uint32_t);
+		const uint64_t iImageSize = (iStringsOffset + m_sStrings.size() + 3) & ~static_cast<uint64_t>(3);
+
+		if (iImageSize > 0xFFFFFFF0)
+			throw PEException("API hash table is too large.", PEException::PEEXCEPTION_INSUFFICIENT_SPACE);
+
+		std::vector<uint32_t> vImage(static_cast<size_t>(iImageSize / sizeof(uint32_t)), 0);
+		uint8_t* pImage = reinterpret_cast<uint8_t*>(&vImage[0]);
+
+		PEApiHashTable::PEApiHashHeader* pHeader = reinterpret_cast<PEApiHashTable::PEApiHashHeader*>(pImage);
+		pHeader->m_iSignature = API_HASH_TABLE_SIGNATURE;
+		pHeader->m_iVersion = API_HASH_TABLE_VERSION;
+		pHeader->m_iSize = static_cast<uint32_t>(iImageSize);
+		pHeader->m_iAlgorithms = m_iAlgorithms;
+		pHeader->m_iNumberOfModules = iNumberOfModules;
+		pHeader->m_iNumberOfFunctions = iNumberOfFunctions;
+		pHeader->m_iModulesOffset = static_cast<uint32_t>(iModulesOffset);
+		pHeader->m_iFunctionsOffset = static_cast<uint32_t>(iFunctionsOffset);
+		pHeader->m_iTablesOffset = static_cast<uint32_t>(iTablesOffset);
+		pHeader->m_iStringsOffset = static_cast<uint32_t>(iStringsOffset);
+		pHeader->m_iStringsSize = static_cast<uint32_t>(m_sStrings.size());
+
+		if (iNumberOfModules)
+			memcpy(pImage + iModulesOffset, &m_vModuleNameOffsets[0], iNumberOfModules * sizeof(uint32_t));
+
+		if (iNumberOfFunctions)
+			memcpy(pImage + iFunctionsOffset, &m_vFunctions[0], iNumberOfFunctions * sizeof(PEApiHashTable::PEApiHashFunction));
+
+		if (NOT m_sStrings.empty())
+			memcpy(pImage + iStringsOffset, m_sStrings.data(), m_sStrings.size());
+
+		// Fill the slots of every algorithm from the hashes computed when the libraries were added
+		PEApiHashTable::PEApiHashSlots* pTables = reinterpret_cast<PEApiHashTable::PEApiHashSlots*>(pImage + iTablesOffset);
+		const uint32_t iMask = iNumberOfSlots - 1;
+		uint32_t iTable = 0;
+		for (uint32_t iAlgorithm = 1; iAlgorithm <= PE_API_HASH_ALL; iAlgorithm <<= 1)
+		{
+			if (NOT (m_iAlgorithms & iAlgorithm))
+				continue;
+
+			const uint64_t iTableSlotsOffset = iSlotsOffset + static_cast<uint64_t>(iTable) * iNumberOfSlots * 2 * sizeof(uint32_t);
+			pTables[iTable].m_iAlgorithm = iAlgorithm;
+			pTables[iTable].m_iNumberOfSlots = iNumberOfSlots;
+			pTables[iTable].m_iSlotsOffset = static_cast<uint32_t>(iTableSlotsOffset);
+
+			uint32_t* pSlots = reinterpret_cast<uint32_t*>(pImage + iTableSlotsOffset);
+			for (uint32_t i = 0; i < iNumberOfFunctions; i++)
+			{
+				const uint32_t iHash = m_vHashes[i * m_iNumberOfAlgorithms + iTable];
+
+				uint32_t iSlot = getSlotIndex(iHash, iMask);
+				while (pSlots[2 * iSlot + 1])
+					iSlot = (iSlot + 1) & iMask;
+
+				pSlots[2 * iSlot] = iHash;
+				pSlots[2 * iSlot + 1] = i + 1;
+			}
+
+			iTable++;
+		}
+
+		peTable.adopt(vImage);
+	}
+
+	// Removes all libraries
+	void PEApiHashTableBuilder::clear()
+	{
+		m_sStrings.clear();
+		m_vModuleNameOffsets.clear();
+		m_vFunctions.clear();
+		m_vHashes.clear();
+	}
+
+	// Appends null-terminated string to the strings & returns its offset
+	uint32_t PEApiHashTableBuilder::addString(const PEStringView& sString)
+	{
+		uint32_t iOffset = static_cast<uint32_t>(m_sStrings.length());
+		m_sStrings.append(sString.data(), sString.length());
+		m_sStrings.push_back(0);
+
+		return iOffset;
+	}
+}
\ No newline at end of file
@@ -288,7 +288,8 @@ namespace OpenPE
 				pFileStream.seekg(PEUtils::alignDown(peSection.getPointerToRawData(), getFileAlignment()));
 				THROW_EXCEPTION_IF_BAD_FILESTREAM(pFileStream, "Cannot reach Section Data.", PEException::PEEXCEPTION_IMAGE_SECTION_DATA_NOT_FOUND);
 
-				// Read Section Raw Data
+				// Read Section Raw Data (room for the virtual data is reserved, so that mapping never moves it)
+				peSection.getRawData().reserve(std::max(peSection.getSizeOfRawData(), peSection.getAlignedVirtualSize(getSectionAlignment())));
 				peSection.getRawData().resize(peSection.getSizeOfRawData());
 				pFileStream.read(&peSection.getRawData()[0], peSection.getSizeOfRawData());
 				THROW_EXCEPTION_IF_BAD_FILESTREAM(pFileStream, "Error reading Section Data.", PEException::PEEXCEPTION_IMAGE_SECTION_ERROR_READING_SECTION_DATA);
@@ -400,13 +401,13 @@ namespace OpenPE
 	// Sets Directory RVA (just a value in PE Header, no movement occurs)
 	void PEBase::setDirectoryRVA(uint32_t iDirectoryID, uint32_t iRVA)
 	{
-		// TODO
+		m_pProperties->setDirectoryRVA(iDirectoryID, iRVA);
 	}
 
 	// Sets Directory Size (just a value in PE Header, no movement occurs)
-	void PEBase::setDirectorySize(uint32_t iDirectoryID, uint32_t iRVA)
+	void PEBase::setDirectorySize(uint32_t iDirectoryID, uint32_t iSize)
 	{
-		// TODO
+		m_pProperties->setDirectorySize(iDirectoryID, iSize);
 	}
 
 	// Returns 'true' if Image has Import Directory
@@ -558,6 +559,18 @@ namespace OpenPE
 		return m_pProperties->getCharacteristics();
 	}
 
+	// Returns Machine of PE file from Header (IMAGE_FILE_MACHINE_*)
+	uint16_t PEBase::getMachine() const
+	{
+		return m_pProperties->getMachine();
+	}
+
+	// Returns TimeDateStamp of PE file from Header
+	uint32_t PEBase::getTimeDateStamp() const
+	{
+		return m_pProperties->getTimeDateStamp();
+	}
+
 	// Returns Checksum of PE file from Header
 	uint32_t PEBase::getChecksum() const
 	{
@@ -576,6 +589,51 @@ namespace OpenPE
 		return m_pProperties->getNumberOfSections();
 	}
 
+	// Returns 'true' if the Section is one of the Sections of this Image
+	bool PEBase::sectionAttached(const PESection& peSection) const
+	{
+		for (SECTION_LIST::const_iterator itr = m_vSections.begin(); itr != m_vSections.end(); ++itr)
+		{
+			if (&(*itr) == &peSection)
+				return true;
+		}
+
+		return false;
+	}
+
+	// Recalculates raw & virtual sizes of the Section (and Size of Image) after its raw data was changed
+	// If bAutoStrip = true and the Section is the last one, null bytes at the end of its raw data are stripped
+	void PEBase::recalculateSectionSizes(PESection& peSection, bool bAutoStrip)
+	{
+		if (NOT sectionAttached(peSection))
+			throw PEException("Section is not attached to this Image", PEException::PEEXCEPTION_SECTION_IS_NOT_ATTACHED);
+
+		std::string& sRawData = peSection.getRawData();
+
+		// Virtual size must cover all the data, including null bytes stripped below
+		uint32_t iDataLength = static_cast<uint32_t>(sRawData.length());
+		if (peSection.getVirtualSize() < iDataLength)
+			peSection.setVirtualSize(iDataLength);
+
+		if (&peSection == &m_vSections.back())
+		{
+			// The last Section can be stripped, its virtual tail is zero-filled by the loader anyway
+			if (bAutoStrip)
+			{
+				std::string::size_type iLastNonZero = sRawData.find_last_not_of('\0');
+				sRawData.resize(iLastNonZero == std::string::npos ? 0 : iLastNonZero + 1);
+			}
+
+			peSection.setSizeOfRawData(PEUtils::alignUp(static_cast<uint32_t>(sRawData.length()), getFileAlignment()));
+			updateImageSize();
+		}
+		else if (peSection.getSizeOfRawData() < iDataLength)
+		{
+			// Other Sections can only grow up to their file-aligned raw size
+			peSection.setSizeOfRawData(PEUtils::alignUp(iDataLength, getFileAlignment()));
+		}
+	}
+
 	// Returns Section from RVA inside it
 	PESection& PEBase::getSectionFromRVA(uint32_t iRVA)
 	{
@@ -592,6 +650,8 @@ namespace OpenPE
 				return peSection;
 			}
 		}
+
+		throw PEException("No section found that accommodates the RVA", PEException::PEEXXEPTION_NO_SECTION_FOUND);
 	}
 
 	// Returns Section from RVA inside it
@@ -610,6 +670,8 @@ namespace OpenPE
 				return peSection;
 			}
 		}
+
+		throw PEException("No section found that accommodates the RVA", PEException::PEEXXEPTION_NO_SECTION_FOUND);
 	}
 
 	// Returns Section from Directory ID
@@ -863,6 +925,33 @@ namespace OpenPE
 		return getSectionDataFromRVA(peSection, getVAToRVA(iVA), eSectionDataType);
 	}
 
+	// Returns pointer to the beginning of RAW/VIRTUAL data block (Section or Headers) containing RVA,
+	// together with the RVA the block starts at and its length
+	// If bIncludeHeaders = true, data from the beginning of PE file to SizeOfHeaders will be searched, too
+	const char* PEBase::getSectionDataBlockFromRVA(uint32_t iRVA, uint32_t& iBlockRVA, uint32_t& iBlockLength, SECTION_DATA_TYPE eSectionDataType, bool bIncludeHeaders) const
+	{
+		// If RVA is inside of headers and we're searching them too...
+		if (bIncludeHeaders && iRVA < m_sFullHeadersData.length())
+		{
+			iBlockRVA = 0;
+			iBlockLength = static_cast<uint32_t>(m_sFullHeadersData.length());
+
+			return m_sFullHeadersData.data();
+		}
+
+		const PESection& peSection = getSectionFromRVA(iRVA);
+		const std::string& sData = (eSectionDataType == SECTION_DATA_RAW)
+									?
+									peSection.getRawData()
+									:
+									peSection.getVirtualData(getSectionAlignment());
+
+		iBlockRVA = peSection.getVirtualAddress();
+		iBlockLength = static_cast<uint32_t>(sData.length());
+
+		return sData.data();
+	}
+
 	uint16_t PEBase::getPEMagic() const
 	{
 		return m_pProperties->getPEMagic();
@@ -902,6 +991,16 @@ namespace OpenPE
 		return m_pProperties->getSizeOfImage();
 	}
 
+	// Recalculates Size of the Image from the last Section (Just the value in PE Header)
+	void PEBase::updateImageSize()
+	{
+		if (m_vSections.empty())
+			return;
+
+		const PESection& peLastSection = m_vSections.back();
+		m_pProperties->setSizeOfImage(PEUtils::alignUp(peLastSection.getVirtualAddress() + peLastSection.getAlignedVirtualSize(getSectionAlignment()), getSectionAlignment()));
+	}
+
 	// Returns Image Entry Point
 	uint32_t PEBase::getEntryPoint() const
 	{
@@ -924,6 +1023,12 @@ namespace OpenPE
 		return m_pProperties->getImageBase64();
 	}
 
+	// Sets Image base (Just the value in PE Header, no relocations are applied)
+	void PEBase::setImageBase(uint64_t iNewImageBase)
+	{
+		m_pProperties->setImageBase(iNewImageBase);
+	}
+
 	// Virtual Address(VA) to Relative Virtual Address(RVA) convertion
 	// for PE32 & PE64 respectively
 	uint32_t PEBase::getVAToRVA(uint32_t VA, bool bBoundCheck /*= true*/) const
@@ -0,0 +1,492 @@
+#include "OpenPEBoundImports.h"
+#include "OpenPEDataCursor.h"
+#include <string.h>
+
+namespace OpenPE
+{
+	// Default Constructor
+	PEBoundImportRef::PEBoundImportRef()
+		: m_iTimeStamp(0)
+	{
+	}
+
+	// Returns 'Name' of the module (owned by the record, or references Image memory or the global intern table, see PENameStorage)
+	const PEStringView PEBoundImportRef::getName() const
+	{
+		return m_sName.empty() ? m_vName : PEStringView(m_sName);
+	}
+
+	// Returns 'Name' of the module (same as getName())
+	const PEStringView PEBoundImportRef::getNameView() const
+	{
+		return getName();
+	}
+
+	// Returns TimeStamp of the module bound to
+	uint32_t PEBoundImportRef::getTimeStamp() const
+	{
+		return m_iTimeStamp;
+	}
+
+	// Sets 'Name' of the module (the name is copied into the record)
+	void PEBoundImportRef::setName(const PEStringView& sName)
+	{
+		m_sName.assign(sName.data(), sName.length());
+		m_vName = PEStringView();
+	}
+
+	// Sets 'Name' of the module as a reference to memory owned by someone else (e.g. Image data)
+	void PEBoundImportRef::setNameView(const PEStringView& vName)
+	{
+		m_sName.clear();
+		m_vName = vName;
+	}
+
+	// Sets TimeStamp
+	void PEBoundImportRef::setTimeStamp(uint32_t iTimeStamp)
+	{
+		m_iTimeStamp = iTimeStamp;
+	}
+
+	// Default Constructor
+	PEBoundImportLibrary::PEBoundImportLibrary()
+		: m_iTimeStamp(0)
+	{
+	}
+
+	// Returns 'Name' of the Library (owned by the record, or references Image memory or the global intern table, see PENameStorage)
+	const PEStringView PEBoundImportLibrary::getName() const
+	{
+		return m_sName.empty() ? m_vName : PEStringView(m_sName);
+	}
+
+	// Returns 'Name' of the Library (same as getName())
+	const PEStringView PEBoundImportLibrary::getNameView() const
+	{
+		return getName();
+	}
+
+	// Returns TimeStamp of the Library bound to
+	uint32_t PEBoundImportLibrary::getTimeStamp() const
+	{
+		return m_iTimeStamp;
+	}
+
+	// Returns modules that functions of the Library are forwarded to
+	const PEBoundImportLibrary::REF_LIST& PEBoundImportLibrary::getModuleForwarderList() const
+	{
+		return m_vModuleForwarders;
+	}
+
+	// Sets 'Name' of the Library (the name is copied into the record)
+	void PEBoundImportLibrary::setName(const PEStringView& sName)
+	{
+		m_sName.assign(sName.data(), sName.length());
+		m_vName = PEStringView();
+	}
+
+	// Sets 'Name' of the Library as a reference to memory owned by someone else (e.g. Image data)
+	void PEBoundImportLibrary::setNameView(const PEStringView& vName)
+	{
+		m_sName.clear();
+		m_vName = vName;
+	}
+
+	// Sets TimeStamp
+	void PEBoundImportLibrary::setTimeStamp(uint32_t iTimeStamp)
+	{
+		m_iTimeStamp = iTimeStamp;
+	}
+
+	// Adds module forwarder ref
+	void PEBoundImportLibrary::addModuleForwarder(const PEBoundImportRef& peRef)
+	{
+		m_vModuleForwarders.push_back(peRef);
+	}
+
+	// Clears module forwarder refs
+	void PEBoundImportLibrary::clearModuleForwarders()
+	{
+		m_vModuleForwarders.clear();
+	}
+
+	// Helper: returns null-terminated module name at offset from the beginning of Bound Import Directory
+	static const PEStringView getBoundImportName(const char* pDirectory, uint32_t iAvailable, uint16_t iOffsetModuleName)
+	{
+		const char* pNameEnd = (iOffsetModuleName < iAvailable)
+								?
+								static_cast<const char*>(memchr(pDirectory + iOffsetModuleName, 0, iAvailable - iOffsetModuleName))
+								:
+								0;
+		if (NOT pNameEnd)
+			throw PEException("Incorrect Bound Import Directory.", PEException::PEEXCEPTION_INCORRECT_BOUND_IMPORT_DIRECTORY);
+
+		return PEStringView(pDirectory + iOffsetModuleName, pNameEnd - pDirectory - iOffsetModuleName);
+	}
+
+	// Returns Bound Import libraries with their forwarder refs
+	const PEBOUND_IMPORT_LIST getBoundImportList(const PEBase& peBase, PENameStorage eNameStorage)
+	{
+		PEBOUND_IMPORT_LIST returnList;
+
+		// If image has no bound imports, return empty array
+		if (NOT peBase.hasBoundImport())
+			return returnList;
+
+		// Bound Import Directory is usually placed in headers, right after the Section table
+		PEDataCursor peCursor(peBase);
+		uint32_t iAvailable;
+		const char* pDirectory = peCursor.tryGetData(peBase.getDirectoryRVA(IMAGE_DIRECTORY_ENTRY_BOUND_IMPORT), iAvailable);
+		if (NOT pDirectory)
+			throw PEException("Incorrect Bound Import Directory.", PEException::PEEXCEPTION_INCORRECT_BOUND_IMPORT_DIRECTORY);
+
+		uint32_t iOffset = 0;
+		while (true)
+		{
+			IMAGE_BOUND_IMPORT_DESCRIPTOR peDescriptor;
+			if (iAvailable - iOffset < sizeof(IMAGE_BOUND_IMPORT_DESCRIPTOR))
+				throw PEException("Incorrect Bound Import Directory.", PEException::PEEXCEPTION_INCORRECT_BOUND_IMPORT_DIRECTORY);
+
+			memcpy(&peDescriptor, pDirectory + iOffset, sizeof(IMAGE_BOUND_IMPORT_DESCRIPTOR));
+			iOffset += sizeof(IMAGE_BOUND_IMPORT_DESCRIPTOR);
+
+			// Zero-element ends the directory
+			if (NOT peDescriptor.iTimeDateStamp && NOT peDescriptor.iOffsetModuleName && NOT peDescriptor.iNumberOfModuleForwarderRefs)
+				break;
+
+			returnList.push_back(PEBoundImportLibrary());
+			PEBoundImportLibrary& peLibrary = returnList.back();
+
+			const PEStringView vName = getBoundImportName(pDirectory, iAvailable, peDescriptor.iOffsetModuleName);
+			if (eNameStorage == PE_NAME_STORAGE_INTERN)
+				peLibrary.setNameView(PEInternTable::getGlobal().getName(PEInternTable::getGlobal().intern(vName)));
+			else if (eNameStorage == PE_NAME_STORAGE_VIEW)
+				peLibrary.setNameView(vName);
+			else
+				peLibrary.setName(vName);
+
+			peLibrary.setTimeStamp(peDescriptor.iTimeDateStamp);
+
+			// Forwarder refs follow the descriptor
+			for (uint16_t i = 0; i < peDescriptor.iNumberOfModuleForwarderRefs; i++)
+			{
+				IMAGE_BOUND_FORWARDER_REF peForwarderRef;
+				if (iAvailable - iOffset < sizeof(IMAGE_BOUND_FORWARDER_REF))
+					throw PEException("Incorrect Bound Import Directory.", PEException::PEEXCEPTION_INCORRECT_BOUND_IMPORT_DIRECTORY);
+
+				memcpy(&peForwarderRef, pDirectory + iOffset, sizeof(IMAGE_BOUND_FORWARDER_REF));
+				iOffset += sizeof(IMAGE_BOUND_FORWARDER_REF);
+
+				PEBoundImportRef peRef;
+				const PEStringView vRefName = getBoundImportName(pDirectory, iAvailable, peForwarderRef.iOffsetModuleName);
+				if (eNameStorage == PE_NAME_STORAGE_INTERN)
+					peRef.setNameView(PEInternTable::getGlobal().getName(PEInternTable::getGlobal().intern(vRefName)));
+				else if (eNameStorage == PE_NAME_STORAGE_VIEW)
+					peRef.setNameView(vRefName);
+				else
+					peRef.setName(vRefName);
+
+				peRef.setTimeStamp(peForwarderRef.iTimeDateStamp);
+				peLibrary.addModuleForwarder(peRef);
+			}
+		}
+
+		return returnList;
+	}
+
+	// Default Constructor
+	PEStaleBinding::PEStaleBinding()
+		: m_iOrdinal(0)
+		, m_iBoundVA(0)
+		, m_iExpectedVA(0)
+	{
+	}
+
+	// Returns 'true' if function is imported by 'Name'
+	bool PEStaleBinding::hasName() const
+	{
+		return NOT m_sName.empty();
+	}
+
+	// Returns 'Name' of the function
+	const std::string& PEStaleBinding::getName() const
+	{
+		return m_sName;
+	}
+
+	// Returns 'Ordinal' of the function
+	uint16_t PEStaleBinding::getOrdinal() const
+	{
+		return m_iOrdinal;
+	}
+
+	// Returns prebound IAT value
+	uint64_t PEStaleBinding::getBoundVA() const
+	{
+		return m_iBoundVA;
+	}
+
+	// Returns VA of the function in the library (0, if the function is not found)
+	uint64_t PEStaleBinding::getExpectedVA() const
+	{
+		return m_iExpectedVA;
+	}
+
+	// Sets 'Name' of the function
+	void PEStaleBinding::setName(const std::string& sName)
+	{
+		m_sName = sName;
+	}
+
+	// Sets 'Ordinal' of the function
+	void PEStaleBinding::setOrdinal(uint16_t iOrdinal)
+	{
+		m_iOrdinal = iOrdinal;
+	}
+
+	// Sets prebound IAT value
+	void PEStaleBinding::setBoundVA(uint64_t iBoundVA)
+	{
+		m_iBoundVA = iBoundVA;
+	}
+
+	// Sets VA of the function in the library
+	void PEStaleBinding::setExpectedVA(uint64_t iExpectedVA)
+	{
+		m_iExpectedVA = iExpectedVA;
+	}
+
+	// Default Constructor
+	PEBindingCheck::PEBindingCheck()
+		: m_eStatus(PE_BINDING_NOT_BOUND)
+		, m_iBoundTimeStamp(0)
+		, m_iModuleTimeStamp(0)
+		, m_iNumberOfFunctions(0)
+	{
+	}
+
+	// Returns 'Name' of the Library
+	const std::string& PEBindingCheck::getName() const
+	{
+		return m_sName;
+	}
+
+	// Returns binding status
+	PEBindingStatus PEBindingCheck::getStatus() const
+	{
+		return m_eStatus;
+	}
+
+	// Returns TimeStamp the Library is bound to
+	uint32_t PEBindingCheck::getBoundTimeStamp() const
+	{
+		return m_iBoundTimeStamp;
+	}
+
+	// Returns TimeStamp of the Library in the corpus (0, if not found)
+	uint32_t PEBindingCheck::getModuleTimeStamp() const
+	{
+		return m_iModuleTimeStamp;
+	}
+
+	// Returns number of functions checked
+	uint32_t PEBindingCheck::getNumberOfFunctions() const
+	{
+		return m_iNumberOfFunctions;
+	}
+
+	// Returns prebound IAT values, which don't match the Library
+	const PEBindingCheck::STALE_LIST& PEBindingCheck::getStaleBindingList() const
+	{
+		return m_vStaleBindings;
+	}
+
+	// Returns 'true' if the binding is not valid (the loader has to resolve the imports again)
+	bool PEBindingCheck::isStale() const
+	{
+		return m_eStatus NOT_EQUAL_TO PE_BINDING_NOT_BOUND && m_eStatus NOT_EQUAL_TO PE_BINDING_VALID;
+	}
+
+	// Sets 'Name' of the Library
+	void PEBindingCheck::setName(const std::string& sName)
+	{
+		m_sName = sName;
+	}
+
+	// Sets binding status
+	void PEBindingCheck::setStatus(PEBindingStatus eStatus)
+	{
+		m_eStatus = eStatus;
+	}
+
+	// Sets TimeStamp the Library is bound to
+	void PEBindingCheck::setBoundTimeStamp(uint32_t iTimeStamp)
+	{
+		m_iBoundTimeStamp = iTimeStamp;
+	}
+
+	// Sets TimeStamp of the Library in the corpus
+	void PEBindingCheck::setModuleTimeStamp(uint32_t iTimeStamp)
+	{
+		m_iModuleTimeStamp = iTimeStamp;
+	}
+
+	// Sets number of functions checked
+	void PEBindingCheck::setNumberOfFunctions(uint32_t iNumberOfFunctions)
+	{
+		m_iNumberOfFunctions = iNumberOfFunctions;
+	}
+
+	// Adds prebound IAT value, which doesn't match the Library
+	void PEBindingCheck::addStaleBinding(const PEStaleBinding& peStaleBinding)
+	{
+		m_vStaleBindings.push_back(peStaleBinding);
+	}
+
+	// Checks bindings of all imported libraries of the Image against the corpus
+	const PEBINDING_CHECK_LIST checkBoundImports(const PEBase& peBase, const PEModuleCorpus& peCorpus)
+	{
+		PEBINDING_CHECK_LIST returnList;
+
+		// If image has no imports, return empty array
+		if (NOT peBase.hasImports())
+			return returnList;
+
+		// New style bindings keep TimeStamps in Bound Import Directory
+		const PEBOUND_IMPORT_LIST peBoundImports = getBoundImportList(peBase, PE_NAME_STORAGE_VIEW);
+
+		PEImportDescriptorRange peDescriptors(peBase);
+		returnList.reserve(peDescriptors.count());
+
+		for (PEImportDescriptorRange::const_iterator itr = peDescriptors.begin(); itr != peDescriptors.end(); ++itr)
+		{
+			returnList.push_back(PEBindingCheck());
+			PEBindingCheck& peCheck = returnList.back();
+			peCheck.setName(itr->getName().str());
+
+			// Not bound
+			if (NOT itr->getTimeStamp())
+				continue;
+
+			// Find TimeStamp & forwarder refs the library is bound to
+			bool bNewBinding = (itr->getTimeStamp() == static_cast<uint32_t>(-1));
+			const PEBoundImportLibrary* pBoundLibrary = 0;
+			if (bNewBinding)
+			{
+				for (PEBOUND_IMPORT_LIST::const_iterator itrBound = peBoundImports.begin(); NOT pBoundLibrary && itrBound != peBoundImports.end(); ++itrBound)
+				{
+					if (itrBound->getNameView().equalsIgnoreCase(itr->getName()))
+						pBoundLibrary = &(*itrBound);
+				}
+
+				// Bound Import Directory doesn't describe the library, the loader won't use the binding
+				if (NOT pBoundLibrary)
+					continue;
+			}
+
+			peCheck.setBoundTimeStamp(pBoundLibrary ? pBoundLibrary->getTimeStamp() : itr->getTimeStamp());
+			peCheck.setStatus(PE_BINDING_VALID);
+
+			const PEModuleExports* pModule = peCorpus.findModule(itr->getName());
+			if (NOT pModule)
+			{
+				peCheck.setStatus(PE_BINDING_MODULE_NOT_FOUND);
+				continue;
+			}
+
+			peCheck.setModuleTimeStamp(pModule->getTimeStamp());
+			if (pModule->getTimeStamp() NOT_EQUAL_TO peCheck.getBoundTimeStamp())
+				peCheck.setStatus(PE_BINDING_STALE_TIMESTAMP);
+
+			// Modules that functions are forwarded to must match, too
+			if (pBoundLibrary)
+			{
+				const PEBoundImportLibrary::REF_LIST& peRefs = pBoundLibrary->getModuleForwarderList();
+				for (PEBoundImportLibrary::REF_LIST::const_iterator itrRef = peRefs.begin(); itrRef != peRefs.end(); ++itrRef)
+				{
+					const PEModuleExports* pRefModule = peCorpus.findModule(itrRef->getNameView());
+					if (NOT pRefModule)
+						peCheck.setStatus(PE_BINDING_MODULE_NOT_FOUND);
+					else if (pRefModule->getTimeStamp() NOT_EQUAL_TO itrRef->getTimeStamp() && peCheck.getStatus() == PE_BINDING_VALID)
+						peCheck.setStatus(PE_BINDING_STALE_TIMESTAMP);
+				}
+			}
+
+			// Prebound IAT values can only be checked if the binding is used & function names are kept in original IAT
+			if (peCheck.getStatus() NOT_EQUAL_TO PE_BINDING_VALID || NOT itr->getRVATOOriginalIAT())
+				continue;
+
+			uint32_t iNumberOfFunctions = 0;
+			const PEImportThunkRange peThunks = itr->getThunks();
+			for (PEImportThunkRange::const_iterator itrThunk = peThunks.begin(); itrThunk != peThunks.end(); ++itrThunk)
+			{
+				PEExportEntry peExport;
+				bool bFound = itrThunk->hasName()
+								?
+								pModule->findExport(itrThunk->getName(), peExport)
+								:
+								pModule->findExport(itrThunk->getOrdinal(), peExport);
+
+				// Old style bindings leave forwarded functions in the forwarder chain, they are resolved by the loader
+				if (bFound && peExport.isForwarded() && NOT bNewBinding)
+					continue;
+
+				iNumberOfFunctions++;
+
+				uint64_t iExpectedVA = 0;
+				const PEModuleExports* pExportModule = pModule;
+				if (bFound && peCorpus.followForwarders(pExportModule, peExport) == PE_EXPORT_RESOLVED)
+					iExpectedVA = pExportModule->getImageBase() + peExport.getRVA();
+
+				if (NOT iExpectedVA || iExpectedVA NOT_EQUAL_TO itrThunk->getIAT_VA())
+				{
+					PEStaleBinding peStaleBinding;
+					if (itrThunk->hasName())
+						peStaleBinding.setName(itrThunk->getName().str());
+					else
+						peStaleBinding.setOrdinal(itrThunk->getOrdinal());
+
+					peStaleBinding.setBoundVA(itrThunk->getIAT_VA());
+					peStaleBinding.setExpectedVA(iExpectedVA);
+					peCheck.addStaleBinding(peStaleBinding);
+				}
+			}
+
+			peCheck.setNumberOfFunctions(iNumberOfFunctions);
+			if (NOT peCheck.getStaleBindingList().empty())
+				peCheck.setStatus(PE_BINDING_STALE_ADDRESS);
+		}
+
+		return returnList;
+	}
+
+	// Checks bindings of iNumberOfImages Images against the corpus, pChecks receives a list per Image
+	size_t checkBoundImports(const PEBase* const* pImages, size_t iNumberOfImages, const PEModuleCorpus& peCorpus, PEBINDING_CHECK_LIST* pChecks)
+	{
+		size_t iNumberOfStaleImages = 0;
+
+		for (size_t i = 0; i < iNumberOfImages; i++)
+		{
+			try
+			{
+				pChecks[i] = checkBoundImports(*pImages[i], peCorpus);
+			}
+			catch (const PEException&)
+			{
+				pChecks[i].clear();
+				continue;
+			}
+
+			for (PEBINDING_CHECK_LIST::const_iterator itr = pChecks[i].begin(); itr != pChecks[i].end(); ++itr)
+			{
+				if (itr->isStale())
+				{
+					iNumberOfStaleImages++;
+					break;
+				}
+			}
+		}
+
+		return iNumberOfStaleImages;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,343 @@
+#include "OpenPECompactImports.h"
+#include <string.h>
+
+namespace OpenPE
+{
+	// Name offset of functions imported by ordinal
+	static const uint32_t NO_NAME = static_cast<uint32_t>(-1);
+
+	// Default Constructor
+	PECompactImports::PECompactImports()
+	{
+		m_vLibraryFirstFunction.push_back(0);
+	}
+
+	// Constructor from the imported functions list
+	PECompactImports::PECompactImports(const PEIMPORTED_FUNCTIONS_LIST& peImports)
+	{
+		m_vLibraryFirstFunction.push_back(0);
+
+		// Count everything first, so that each array is allocated once
+		uint32_t iNumberOfFunctions = 0;
+		size_t iNamesLength = 0;
+		for (PEIMPORTED_FUNCTIONS_LIST::const_iterator itr = peImports.begin(); itr != peImports.end(); ++itr)
+		{
+			const PEImportLibrary::IMPORTED_LIST& peFunctions = itr->getImportedFunctionList();
+
+			iNumberOfFunctions += static_cast<uint32_t>(peFunctions.size());
+			iNamesLength += itr->getNameView().length() + 1;
+			for (PEImportLibrary::IMPORTED_LIST::const_iterator itrFunc = peFunctions.begin(); itrFunc != peFunctions.end(); ++itrFunc)
+			{
+				if (itrFunc->hasName())
+					iNamesLength += itrFunc->getNameView().length() + 1;
+			}
+		}
+
+		reserve(static_cast<uint32_t>(peImports.size()), iNumberOfFunctions, iNamesLength);
+
+		for (PEIMPORTED_FUNCTIONS_LIST::const_iterator itr = peImports.begin(); itr != peImports.end(); ++itr)
+		{
+			addLibrary(itr->getNameView(), itr->getTimeStamp(), itr->getRVAToIAT(), itr->getRVATOOriginalIAT());
+
+			const PEImportLibrary::IMPORTED_LIST& peFunctions = itr->getImportedFunctionList();
+			for (PEImportLibrary::IMPORTED_LIST::const_iterator itrFunc = peFunctions.begin(); itrFunc != peFunctions.end(); ++itrFunc)
+			{
+				if (itrFunc->hasName())
+					addFunction(itrFunc->getNameView(), itrFunc->getHint(), itrFunc->getIAT_VA());
+				else
+					addFunction(itrFunc->getOrdinal(), itrFunc->getIAT_VA());
+			}
+		}
+	}
+
+	// Returns number of libraries
+	uint32_t PECompactImports::getNumberOfLibraries() const
+	{
+		return static_cast<uint32_t>(m_vLibraryNameOffsets.size());
+	}
+
+	// Returns total number of imported functions (of all libraries)
+	uint32_t PECompactImports::getNumberOfFunctions() const
+	{
+		return static_cast<uint32_t>(m_vFunctionNameOffsets.size());
+	}
+
+	// Returns 'Name' of the Library
+	const PEStringView PECompactImports::getLibraryName(uint32_t iLibrary) const
+	{
+		return getNameAt(m_vLibraryNameOffsets.at(iLibrary));
+	}
+
+	// Returns RVA to Import Address Table(IAT) of the Library
+	uint32_t PECompactImports::getLibraryRVAToIAT(uint32_t iLibrary) const
+	{
+		return m_vLibraryRVAToIAT.at(iLibrary);
+	}
+
+	// Returns RVA to Original Import Address Table(Original IAT) of the Library
+	uint32_t PECompactImports::getLibraryRVATOOriginalIAT(uint32_t iLibrary) const
+	{
+		return m_vLibraryRVAToOriginalIAT.at(iLibrary);
+	}
+
+	// Returns TimeStamp of the Library
+	uint32_t PECompactImports::getLibraryTimeStamp(uint32_t iLibrary) const
+	{
+		return m_vLibraryTimeStamps.at(iLibrary);
+	}
+
+	// Returns index of the first function of the Library
+	uint32_t PECompactImports::getFirstFunction(uint32_t iLibrary) const
+	{
+		return m_vLibraryFirstFunction.at(iLibrary);
+	}
+
+	// Returns number of functions imported from the Library
+	uint32_t PECompactImports::getNumberOfFunctions(uint32_t iLibrary) const
+	{
+		return m_vLibraryFirstFunction.at(iLibrary + 1) - m_vLibraryFirstFunction[iLibrary];
+	}
+
+	// Returns 'true' if function is imported by 'Name' (& Hint)
+	bool PECompactImports::hasName(uint32_t iFunction) const
+	{
+		return m_vFunctionNameOffsets.at(iFunction) NOT_EQUAL_TO NO_NAME;
+	}
+
+	// Returns 'Name' of the function (empty, if imported by ordinal)
+	const PEStringView PECompactImports::getFunctionName(uint32_t iFunction) const
+	{
+		return hasName(iFunction) ? getNameAt(m_vFunctionNameOffsets[iFunction]) : PEStringView();
+	}
+
+	// Returns 'Hint' of the function (0, if imported by ordinal)
+	uint16_t PECompactImports::getHint(uint32_t iFunction) const
+	{
+		return hasName(iFunction) ? m_vFunctionHintsOrOrdinals[iFunction] : 0;
+	}
+
+	// Returns 'Ordinal' of the function (0, if imported by name)
+	uint16_t PECompactImports::getOrdinal(uint32_t iFunction) const
+	{
+		return hasName(iFunction) ? 0 : m_vFunctionHintsOrOrdinals[iFunction];
+	}
+
+	// Returns IAT entry VA of the function
+	uint64_t PECompactImports::getIAT_VA(uint32_t iFunction) const
+	{
+		return m_vFunctionIAT_VAs.at(iFunction);
+	}
+
+	// Returns number of bytes allocated by the arrays
+	size_t PECompactImports::getMemoryUsage() const
+	{
+		return	m_vNames.capacity()
+				+
+				(	m_vLibraryNameOffsets.capacity()
+					+
+					m_vLibraryTimeStamps.capacity()
+					+
+					m_vLibraryRVAToIAT.capacity()
+					+
+					m_vLibraryRVAToOriginalIAT.capacity()
+					+
+					m_vLibraryFirstFunction.capacity()
+					+
+					m_vFunctionNameOffsets.capacity()
+				) * sizeof(uint32_t)
+				+
+				m_vFunctionHintsOrOrdinals.capacity() * sizeof(uint16_t)
+				+
+				m_vFunctionIAT_VAs.capacity() * sizeof(uint64_t);
+	}
+
+	// Returns imported functions list with related libraries info
+	const PEIMPORTED_FUNCTIONS_LIST PECompactImports::toImportedFunctionsList(PENameStorage eNameStorage) const
+	{
+		PEIMPORTED_FUNCTIONS_LIST returnList;
+		returnList.reserve(getNumberOfLibraries());
+
+		for (uint32_t iLibrary = 0; iLibrary < getNumberOfLibraries(); iLibrary++)
+		{
+			returnList.push_back(PEImportLibrary());
+			PEImportLibrary& peLibrary = returnList.back();
+
+			if (eNameStorage == PE_NAME_STORAGE_INTERN)
+				peLibrary.setNameSymbol(PEInternTable::getGlobal().intern(getLibraryName(iLibrary)));
+			else if (eNameStorage == PE_NAME_STORAGE_VIEW)
+				peLibrary.setNameView(getLibraryName(iLibrary));
+			else
+				peLibrary.setName(getLibraryName(iLibrary));
+
+			peLibrary.setTimeStamp(m_vLibraryTimeStamps[iLibrary]);
+			peLibrary.setRVAToIAT(m_vLibraryRVAToIAT[iLibrary]);
+			peLibrary.setRVATOOriginalIAT(m_vLibraryRVAToOriginalIAT[iLibrary]);
+			peLibrary.reserveImports(getNumberOfFunctions(iLibrary));
+
+			for (uint32_t iFunction = m_vLibraryFirstFunction[iLibrary]; iFunction < m_vLibraryFirstFunction[iLibrary + 1]; iFunction++)
+			{
+				PEImportedFunction func;
+				func.setIAT_VA(m_vFunctionIAT_VAs[iFunction]);
+
+				if (hasName(iFunction))
+				{
+					if (eNameStorage == PE_NAME_STORAGE_INTERN)
+						func.setNameSymbol(PEInternTable::getGlobal().intern(getFunctionName(iFunction)));
+					else if (eNameStorage == PE_NAME_STORAGE_VIEW)
+						func.setNameView(getFunctionName(iFunction));
+					else
+						func.setName(getFunctionName(iFunction));
+
+					func.setHint(m_vFunctionHintsOrOrdinals[iFunction]);
+				}
+				else
+				{
+					func.setOrdinal(m_vFunctionHintsOrOrdinals[iFunction]);
+				}
+
+				peLibrary.addImport(func);
+			}
+		}
+
+		return returnList;
+	}
+
+	// Adds Library, functions added afterwards belong to it
+	void PECompactImports::addLibrary(const PEStringView& vName, uint32_t iTimeStamp, uint32_t iRVAToIAT, uint32_t iRVAToOriginalIAT)
+	{
+		m_vLibraryNameOffsets.push_back(addName(vName));
+		m_vLibraryTimeStamps.push_back(iTimeStamp);
+		m_vLibraryRVAToIAT.push_back(iRVAToIAT);
+		m_vLibraryRVAToOriginalIAT.push_back(iRVAToOriginalIAT);
+		m_vLibraryFirstFunction.push_back(getNumberOfFunctions());
+	}
+
+	// Adds function imported by 'Name' to the last Library
+	void PECompactImports::addFunction(const PEStringView& vName, uint16_t iHint, uint64_t iIAT_VA)
+	{
+		if (m_vLibraryNameOffsets.empty())
+			throw PEException("No library to add the function to", PEException::PEEXCEPTION_INCORRECT_IMPORT_DIRECTORY);
+
+		m_vFunctionNameOffsets.push_back(addName(vName));
+		m_vFunctionHintsOrOrdinals.push_back(iHint);
+		m_vFunctionIAT_VAs.push_back(iIAT_VA);
+		m_vLibraryFirstFunction.back() = getNumberOfFunctions();
+	}
+
+	// Adds function imported by 'Ordinal' to the last Library
+	void PECompactImports::addFunction(uint16_t iOrdinal, uint64_t iIAT_VA)
+	{
+		if (m_vLibraryNameOffsets.empty())
+			throw PEException("No library to add the function to", PEException::PEEXCEPTION_INCORRECT_IMPORT_DIRECTORY);
+
+		m_vFunctionNameOffsets.push_back(NO_NAME);
+		m_vFunctionHintsOrOrdinals.push_back(iOrdinal);
+		m_vFunctionIAT_VAs.push_back(iIAT_VA);
+		m_vLibraryFirstFunction.back() = getNumberOfFunctions();
+	}
+
+	// Reserves space for libraries, functions & name characters
+	void PECompactImports::reserve(uint32_t iNumberOfLibraries, uint32_t iNumberOfFunctions, size_t iNamesLength)
+	{
+		m_vNames.reserve(iNamesLength);
+
+		m_vLibraryNameOffsets.reserve(iNumberOfLibraries);
+		m_vLibraryTimeStamps.reserve(iNumberOfLibraries);
+		m_vLibraryRVAToIAT.reserve(iNumberOfLibraries);
+		m_vLibraryRVAToOriginalIAT.reserve(iNumberOfLibraries);
+		m_vLibraryFirstFunction.reserve(iNumberOfLibraries + 1);
+
+		m_vFunctionNameOffsets.reserve(iNumberOfFunctions);
+		m_vFunctionHintsOrOrdinals.reserve(iNumberOfFunctions);
+		m_vFunctionIAT_VAs.reserve(iNumberOfFunctions);
+	}
+
+	// Helper: releases unused capacity of the array
+	template<typename T>
+	static void shrinkVector(std::vector<T>& vArray)
+	{
+		if (vArray.capacity() NOT_EQUAL_TO vArray.size())
+			std::vector<T>(vArray).swap(vArray);
+	}
+
+	// Releases unused capacity of all arrays
+	void PECompactImports::shrinkToFit()
+	{
+		shrinkVector(m_vNames);
+
+		shrinkVector(m_vLibraryNameOffsets);
+		shrinkVector(m_vLibraryTimeStamps);
+		shrinkVector(m_vLibraryRVAToIAT);
+		shrinkVector(m_vLibraryRVAToOriginalIAT);
+		shrinkVector(m_vLibraryFirstFunction);
+
+		shrinkVector(m_vFunctionNameOffsets);
+		shrinkVector(m_vFunctionHintsOrOrdinals);
+		shrinkVector(m_vFunctionIAT_VAs);
+	}
+
+	// Removes all libraries & functions
+	void PECompactImports::clear()
+	{
+		m_vNames.clear();
+
+		m_vLibraryNameOffsets.clear();
+		m_vLibraryTimeStamps.clear();
+		m_vLibraryRVAToIAT.clear();
+		m_vLibraryRVAToOriginalIAT.clear();
+		m_vLibraryFirstFunction.assign(1, 0);
+
+		m_vFunctionNameOffsets.clear();
+		m_vFunctionHintsOrOrdinals.clear();
+		m_vFunctionIAT_VAs.clear();
+	}
+
+	// Appends null-terminated name to the blob & returns its offset
+	uint32_t PECompactImports::addName(const PEStringView& vName)
+	{
+		if (m_vNames.size() + vName.length() + 1 >= NO_NAME)
+			throw PEException("Import names do not fit into compact table", PEException::PEEXCEPTION_INCORRECT_IMPORT_DIRECTORY);
+
+		uint32_t iOffset = static_cast<uint32_t>(m_vNames.size());
+		m_vNames.insert(m_vNames.end(), vName.begin(), vName.end());
+		m_vNames.push_back(0);
+
+		return iOffset;
+	}
+
+	// Returns null-terminated name at offset of the blob
+	const PEStringView PECompactImports::getNameAt(uint32_t iOffset) const
+	{
+		return PEStringView(&m_vNames[iOffset]);
+	}
+
+	// Returns imports of the Image in compact form (decoded directly from the Import Directory, without intermediate lists)
+	const PECompactImports getCompactImports(const PEBase& peBase)
+	{
+		PECompactImports peCompactImports;
+
+		// If image has no imports, return empty table
+		if (NOT peBase.hasImports())
+			return peCompactImports;
+
+		PEImportDescriptorRange peDescriptors(peBase);
+		for (PEImportDescriptorRange::const_iterator itr = peDescriptors.begin(); itr != peDescriptors.end(); ++itr)
+		{
+			peCompactImports.addLibrary(itr->getName(), itr->getTimeStamp(), itr->getRVAToIAT(), itr->getRVATOOriginalIAT());
+
+			const PEImportThunkRange peThunks = itr->getThunks();
+			for (PEImportThunkRange::const_iterator itrThunk = peThunks.begin(); itrThunk != peThunks.end(); ++itrThunk)
+			{
+				if (itrThunk->hasName())
+					peCompactImports.addFunction(itrThunk->getName(), itrThunk->getHint(), itrThunk->getIAT_VA());
+				else
+					peCompactImports.addFunction(itrThunk->getOrdinal(), itrThunk->getIAT_VA());
+			}
+		}
+
+		// Growth slack is released, the table is expected to be kept around
+		peCompactImports.shrinkToFit();
+
+		return peCompactImports;
+	}
+}
\ No newline at end of file
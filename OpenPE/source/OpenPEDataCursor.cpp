@@ -0,0 +1,100 @@
+#include "OpenPEDataCursor.h"
+#include <string.h>
+
+namespace OpenPE
+{
+	// Default Constructor (cursor is not attached to any Image)
+	PEDataCursor::PEDataCursor()
+		: m_pPEBase(0)
+		, m_eSectionDataType(SECTION_DATA_VIRTUAL)
+		, m_bIncludeHeaders(true)
+		, m_pBlockData(0)
+		, m_iBlockRVA(0)
+		, m_iBlockLength(0)
+	{
+	}
+
+	// Constructor
+	PEDataCursor::PEDataCursor(const PEBase& peBase, SECTION_DATA_TYPE eSectionDataType, bool bIncludeHeaders)
+		: m_pPEBase(&peBase)
+		, m_eSectionDataType(eSectionDataType)
+		, m_bIncludeHeaders(bIncludeHeaders)
+		, m_pBlockData(0)
+		, m_iBlockRVA(0)
+		, m_iBlockLength(0)
+	{
+	}
+
+	// Returns the Image the cursor reads from
+	const PEBase& PEDataCursor::getPEBase() const
+	{
+		return *m_pPEBase;
+	}
+
+	// Returns 'true' if RVA is inside the cached data block
+	bool PEDataCursor::isCached(uint32_t iRVA) const
+	{
+		return m_pBlockData NOT_EQUAL_TO 0 && iRVA >= m_iBlockRVA && iRVA - m_iBlockRVA < m_iBlockLength;
+	}
+
+	// Looks up & caches the data block containing RVA, returns 'false' if there is none
+	bool PEDataCursor::cacheBlock(uint32_t iRVA)
+	{
+		if (isCached(iRVA))
+			return true;
+
+		if (NOT m_pPEBase)
+			return false;
+
+		try
+		{
+			m_pBlockData = m_pPEBase->getSectionDataBlockFromRVA(iRVA, m_iBlockRVA, m_iBlockLength, m_eSectionDataType, m_bIncludeHeaders);
+		}
+		catch (const PEException&)
+		{
+			m_pBlockData = 0;
+			return false;
+		}
+
+		// RVA can be inside the Section virtual space, but beyond its RAW data
+		return isCached(iRVA);
+	}
+
+	// Returns pointer to data at RVA and the number of bytes available from it to the end of the data block
+	const char* PEDataCursor::getData(uint32_t iRVA, uint32_t& iAvailable)
+	{
+		const char* pData = tryGetData(iRVA, iAvailable);
+		if (NOT pData)
+			throw PEException("RVA not found inside section", PEException::PEEXCEPTION_RVA_DOESNT_NOT_EXISTS);
+
+		return pData;
+	}
+
+	// Returns pointer to data at RVA and the number of bytes available, or 0 if RVA is not inside the Image data
+	const char* PEDataCursor::tryGetData(uint32_t iRVA, uint32_t& iAvailable)
+	{
+		if (NOT cacheBlock(iRVA))
+		{
+			iAvailable = 0;
+			return 0;
+		}
+
+		iAvailable = m_iBlockLength - (iRVA - m_iBlockRVA);
+		return m_pBlockData + (iRVA - m_iBlockRVA);
+	}
+
+	// Returns pointer to null-terminated string at RVA, iLength receives the length of the string
+	const char* PEDataCursor::getString(uint32_t iRVA, uint32_t& iLength)
+	{
+		uint32_t iAvailable;
+		const char* pString = getData(iRVA, iAvailable);
+
+		// Check for null-termination
+		const char* pEnd = static_cast<const char*>(memchr(pString, 0, iAvailable));
+		if (NOT pEnd)
+			throw PEException("String is not null-terminated", PEException::PEEXCEPTION_RVA_DOESNT_NOT_EXISTS);
+
+		iLength = static_cast<uint32_t>(pEnd - pString);
+		return pString;
+	}
+}
\ No newline at end of file
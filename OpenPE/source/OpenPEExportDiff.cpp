@@ -0,0 +1,198 @@
+#include "OpenPEExportDiff.h"
+#include "OpenPEException.h"
+#include <algorithm>
+
+namespace OpenPE
+{
+	// Helper: orders exports by ordinal (for the ordinal merge)
+	struct ExportOrdinalSorter
+	{
+		bool operator()(const PEExportEntry& peExport1, const PEExportEntry& peExport2) const
+		{
+			return peExport1.getOrdinal() < peExport2.getOrdinal();
+		}
+	};
+
+	// Helper: returns changes of the function besides its name & ordinal
+	static uint32_t compareExports(const PEExportEntry& peOldExport, const PEExportEntry& peNewExport)
+	{
+		uint32_t iFlags = 0;
+
+		if (	peOldExport.isForwarded() NOT_EQUAL_TO peNewExport.isForwarded()
+				||
+				peOldExport.getForwardedName() NOT_EQUAL_TO peNewExport.getForwardedName()
+		) {
+			iFlags |= PE_EXPORT_CHANGE_FORWARDER;
+		}
+
+		// RVAs of forwarders point to their names, they move with the export directory
+		if (NOT (peOldExport.isForwarded() && peNewExport.isForwarded()) && peOldExport.getRVA() NOT_EQUAL_TO peNewExport.getRVA())
+			iFlags |= PE_EXPORT_CHANGE_RVA;
+
+		return iFlags;
+	}
+
+	// Helper: appends exports without a name (ordinal order)
+	static void addUnnamedExports(const PEExportIndex& peExports, std::vector<PEExportEntry>& vExports)
+	{
+		const uint32_t iOrdinalBase = peExports.getOrdinalBase();
+		for (uint32_t i = 0; i < peExports.getNumberOfFunctions() && iOrdinalBase + i <= PEUtils::MAX_WORD; i++)
+		{
+			PEExportEntry peExport;
+			if (peExports.findExport(static_cast<uint16_t>(iOrdinalBase + i), peExport) && NOT peExport.hasName())
+				vExports.push_back(peExport);
+		}
+	}
+
+	// Default Constructor
+	PEExportChange::PEExportChange()
+		: m_iFlags(0)
+	{
+	}
+
+	// Returns mask of PEExportChangeFlag
+	uint32_t PEExportChange::getFlags() const
+	{
+		return m_iFlags;
+	}
+
+	// Returns 'true' if the function exists in the old Image
+	bool PEExportChange::hasOldExport() const
+	{
+		return NOT (m_iFlags & PE_EXPORT_CHANGE_ADDED);
+	}
+
+	// Returns the function in the old Image
+	const PEExportEntry& PEExportChange::getOldExport() const
+	{
+		return m_OldExport;
+	}
+
+	// Returns 'true' if the function exists in the new Image
+	bool PEExportChange::hasNewExport() const
+	{
+		return NOT (m_iFlags & PE_EXPORT_CHANGE_REMOVED);
+	}
+
+	// Returns the function in the new Image
+	const PEExportEntry& PEExportChange::getNewExport() const
+	{
+		return m_NewExport;
+	}
+
+	// Compares exports of two versions of a library, appends the changes to vChanges & returns number of changes appended
+	size_t diffExports(const PEExportIndex& peOldExports, const PEExportIndex& peNewExports, PEEXPORT_CHANGE_LIST& vChanges, uint32_t iReportedChanges)
+	{
+		const size_t iFirstChange = vChanges.size();
+
+		// Functions not matched by name (kept for the ordinal merge)
+		std::vector<PEExportEntry> vOldExports, vNewExports;
+
+		// Merge both name orders
+		const uint32_t iNumberOfOldNames = peOldExports.getNumberOfNames();
+		const uint32_t iNumberOfNewNames = peNewExports.getNumberOfNames();
+		uint32_t iOld = 0, iNew = 0;
+		while (iOld < iNumberOfOldNames || iNew < iNumberOfNewNames)
+		{
+			int iCompare;
+			if (iOld == iNumberOfOldNames)
+				iCompare = 1;
+			else if (iNew == iNumberOfNewNames)
+				iCompare = -1;
+			else
+				iCompare = peOldExports.getSortedName(iOld).compare(peNewExports.getSortedName(iNew));
+
+			PEExportEntry peOldExport, peNewExport;
+			const bool bOldExport = iCompare <= 0 && peOldExports.findSortedExport(iOld++, peOldExport);
+			const bool bNewExport = iCompare >= 0 && peNewExports.findSortedExport(iNew++, peNewExport);
+
+			if (NOT bOldExport || NOT bNewExport)
+			{
+				if (bOldExport)
+					vOldExports.push_back(peOldExport);
+				if (bNewExport)
+					vNewExports.push_back(peNewExport);
+
+				continue;
+			}
+
+			uint32_t iFlags = compareExports(peOldExport, peNewExport);
+			if (peOldExport.getOrdinal() NOT_EQUAL_TO peNewExport.getOrdinal())
+				iFlags |= PE_EXPORT_CHANGE_ORDINAL;
+
+			iFlags &= iReportedChanges;
+			if (iFlags)
+			{
+				vChanges.push_back(PEExportChange());
+				vChanges.back().m_iFlags = iFlags;
+				vChanges.back().m_OldExport = peOldExport;
+				vChanges.back().m_NewExport = peNewExport;
+			}
+		}
+
+		// Merge the rest by ordinal (stable sort keeps name order of functions with several names)
+		addUnnamedExports(peOldExports, vOldExports);
+		addUnnamedExports(peNewExports, vNewExports);
+
+		std::stable_sort(vOldExports.begin(), vOldExports.end(), ExportOrdinalSorter());
+		std::stable_sort(vNewExports.begin(), vNewExports.end(), ExportOrdinalSorter());
+
+		std::vector<PEExportEntry>::const_iterator itrOld = vOldExports.begin(), itrNew = vNewExports.begin();
+		while (itrOld NOT_EQUAL_TO vOldExports.end() || itrNew NOT_EQUAL_TO vNewExports.end())
+		{
+			PEExportChange peChange;
+
+			if (itrNew == vNewExports.end() || (itrOld NOT_EQUAL_TO vOldExports.end() && itrOld->getOrdinal() < itrNew->getOrdinal()))
+			{
+				peChange.m_iFlags = PE_EXPORT_CHANGE_REMOVED;
+				peChange.m_OldExport = *itrOld++;
+			}
+			else if (itrOld == vOldExports.end() || itrNew->getOrdinal() < itrOld->getOrdinal())
+			{
+				peChange.m_iFlags = PE_EXPORT_CHANGE_ADDED;
+				peChange.m_NewExport = *itrNew++;
+			}
+			else
+			{
+				peChange.m_OldExport = *itrOld++;
+				peChange.m_NewExport = *itrNew++;
+				peChange.m_iFlags = compareExports(peChange.m_OldExport, peChange.m_NewExport);
+
+				if (	peChange.m_OldExport.hasName() NOT_EQUAL_TO peChange.m_NewExport.hasName()
+						||
+						peChange.m_OldExport.getName() NOT_EQUAL_TO peChange.m_NewExport.getName()
+				) {
+					peChange.m_iFlags |= PE_EXPORT_CHANGE_RENAMED;
+				}
+			}
+
+			peChange.m_iFlags &= iReportedChanges;
+			if (peChange.m_iFlags)
+				vChanges.push_back(peChange);
+		}
+
+		return vChanges.size() - iFirstChange;
+	}
+
+	// Compares iNumberOfPairs pairs of export indices, pChanges receives a list per pair, returns the total number of changes
+	size_t diffExports(const PEExportIndex* const* pOldExports, const PEExportIndex* const* pNewExports, size_t iNumberOfPairs, PEEXPORT_CHANGE_LIST* pChanges, uint32_t iReportedChanges)
+	{
+		size_t iNumberOfChanges = 0;
+
+		for (size_t i = 0; i < iNumberOfPairs; i++)
+		{
+			pChanges[i].clear();
+
+			try
+			{
+				iNumberOfChanges += diffExports(*pOldExports[i], *pNewExports[i], pChanges[i], iReportedChanges);
+			}
+			catch (const PEException&)
+			{
+				pChanges[i].clear();
+			}
+		}
+
+		return iNumberOfChanges;
+	}
+}
\ No newline at end of file
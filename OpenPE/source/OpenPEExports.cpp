@@ -1,4 +1,6 @@
 #include "OpenPEExports.h"
+#include <string.h>
+#include <algorithm>
 
 namespace OpenPE
 {
@@ -6,9 +8,11 @@ namespace OpenPE
 	PEExportedFunction::PEExportedFunction()
 		: m_iOrdinal(0)
 		, m_iRVA(0)
+		, m_iNameSymbol(PE_NO_SYMBOL)
 		, m_bHasName(false)
 		, m_iNameOrdinal(0)
 		, m_bForwarded(false)
+		, m_iForwardedNameSymbol(PE_NO_SYMBOL)
 	{
 	}
 
@@ -30,10 +34,22 @@ namespace OpenPE
 		return m_bHasName;
 	}
 
-	// Returns name of function
-	const std::string& PEExportedFunction::getName() const
+	// Returns name of function (owned by the record, or references Image memory or the global intern table, see PENameStorage)
+	const PEStringView PEExportedFunction::getName() const
+	{
+		return m_sName.empty() ? m_vName : PEStringView(m_sName);
+	}
+
+	// Returns name of function (same as getName())
+	const PEStringView PEExportedFunction::getNameView() const
 	{
-		return m_sName;
+		return getName();
+	}
+
+	// Returns symbol of the name in the global intern table (PE_NO_SYMBOL if the name is not interned)
+	PESymbolID PEExportedFunction::getNameSymbol() const
+	{
+		return m_iNameSymbol;
 	}
 
 	// Returns name ordinal of function
@@ -48,10 +64,22 @@ namespace OpenPE
 		return m_bForwarded;
 	}
 
-	// Returns the name of forwarded function
-	const std::string& PEExportedFunction::getForwardedName() const
+	// Returns the name of forwarded function (owned by the record, or references Image memory or the global intern table, see PENameStorage)
+	const PEStringView PEExportedFunction::getForwardedName() const
 	{
-		return m_sForwardedName;
+		return m_sForwardedName.empty() ? m_vForwardedName : PEStringView(m_sForwardedName);
+	}
+
+	// Returns the name of forwarded function (same as getForwardedName())
+	const PEStringView PEExportedFunction::getForwardedNameView() const
+	{
+		return getForwardedName();
+	}
+
+	// Returns symbol of the forwarded name in the global intern table (PE_NO_SYMBOL if the name is not interned)
+	PESymbolID PEExportedFunction::getForwardedNameSymbol() const
+	{
+		return m_iForwardedNameSymbol;
 	}
 
 	// Sets ordinal of function
@@ -67,12 +95,33 @@ namespace OpenPE
 	}
 
 	// Sets name of function (or clears it, if empty name is passed)
-	void PEExportedFunction::setName(const std::string& sName)
+	// (the name is copied into the record)
+	void PEExportedFunction::setName(const PEStringView& sName)
 	{
-		m_sName = sName;
+		m_sName.assign(sName.data(), sName.length());
+		m_vName = PEStringView();
+		m_iNameSymbol = PE_NO_SYMBOL;
 		m_bHasName = NOT sName.empty();
 	}
 
+	// Sets name of function as a reference to memory owned by someone else (e.g. Image Section data)
+	void PEExportedFunction::setNameView(const PEStringView& vName)
+	{
+		m_sName.clear();
+		m_vName = vName;
+		m_iNameSymbol = PE_NO_SYMBOL;
+		m_bHasName = NOT vName.empty();
+	}
+
+	// Sets name of function as a symbol of the global intern table
+	void PEExportedFunction::setNameSymbol(PESymbolID iSymbol)
+	{
+		m_sName.clear();
+		m_vName = PEInternTable::getGlobal().getName(iSymbol);
+		m_iNameSymbol = iSymbol;
+		m_bHasName = NOT m_vName.empty();
+	}
+
 	// Sets name ordinal
 	void PEExportedFunction::setNameOrdinal(uint16_t iNameOrdinal)
 	{
@@ -80,12 +129,33 @@ namespace OpenPE
 	}
 
 	// Sets forwarded function name (or clears it, if empty name is passed)
-	void PEExportedFunction::setForwardedName(const std::string& sName)
+	// (the name is copied into the record)
+	void PEExportedFunction::setForwardedName(const PEStringView& sName)
 	{
-		m_sForwardedName = sName;
+		m_sForwardedName.assign(sName.data(), sName.length());
+		m_vForwardedName = PEStringView();
+		m_iForwardedNameSymbol = PE_NO_SYMBOL;
 		m_bForwarded = NOT sName.empty();
 	}
 
+	// Sets forwarded function name as a reference to memory owned by someone else (e.g. Image Section data)
+	void PEExportedFunction::setForwardedNameView(const PEStringView& vName)
+	{
+		m_sForwardedName.clear();
+		m_vForwardedName = vName;
+		m_iForwardedNameSymbol = PE_NO_SYMBOL;
+		m_bForwarded = NOT vName.empty();
+	}
+
+	// Sets forwarded function name as a symbol of the global intern table
+	void PEExportedFunction::setForwardedNameSymbol(PESymbolID iSymbol)
+	{
+		m_sForwardedName.clear();
+		m_vForwardedName = PEInternTable::getGlobal().getName(iSymbol);
+		m_iForwardedNameSymbol = iSymbol;
+		m_bForwarded = NOT m_vForwardedName.empty();
+	}
+
 	// Class representing export information
 	// Default constructor
 	PEExportInfo::PEExportInfo()
@@ -93,6 +163,7 @@ namespace OpenPE
 		, m_iTimeStamp(0)
 		, m_iMajorVersion(0)
 		, m_iMinorVersion(0)
+		, m_iNameSymbol(PE_NO_SYMBOL)
 		, m_iOrdinalBase(0)
 		, m_iNumberOfFunctions(0)
 		, m_iNumberOfNames(0)
@@ -126,10 +197,22 @@ namespace OpenPE
 		return m_iMinorVersion;
 	}
 
-	// Returns DLL name
-	const std::string& PEExportInfo::getName() const
+	// Returns DLL name (owned by the record, or references Image memory or the global intern table, see PENameStorage)
+	const PEStringView PEExportInfo::getName() const
+	{
+		return m_sName.empty() ? m_vName : PEStringView(m_sName);
+	}
+
+	// Returns DLL name (same as getName())
+	const PEStringView PEExportInfo::getNameView() const
 	{
-		return m_sName;
+		return getName();
+	}
+
+	// Returns symbol of DLL name in the global intern table (PE_NO_SYMBOL if the name is not interned)
+	PESymbolID PEExportInfo::getNameSymbol() const
+	{
+		return m_iNameSymbol;
 	}
 
 	// Returns ordinal base
@@ -192,10 +275,28 @@ namespace OpenPE
 		m_iMinorVersion = iMinorVersion;
 	}
 
-	// Sets DLL name
-	void PEExportInfo::setName(const std::string& sName)
+	// Sets DLL name (the name is copied into the record)
+	void PEExportInfo::setName(const PEStringView& sName)
+	{
+		m_sName.assign(sName.data(), sName.length());
+		m_vName = PEStringView();
+		m_iNameSymbol = PE_NO_SYMBOL;
+	}
+
+	// Sets DLL name as a reference to memory owned by someone else (e.g. Image Section data)
+	void PEExportInfo::setNameView(const PEStringView& vName)
+	{
+		m_sName.clear();
+		m_vName = vName;
+		m_iNameSymbol = PE_NO_SYMBOL;
+	}
+
+	// Sets DLL name as a symbol of the global intern table
+	void PEExportInfo::setNameSymbol(PESymbolID iSymbol)
 	{
-		m_sName = sName;
+		m_sName.clear();
+		m_vName = PEInternTable::getGlobal().getName(iSymbol);
+		m_iNameSymbol = iSymbol;
 	}
 
 	// Sets ordinal base
@@ -234,19 +335,805 @@ namespace OpenPE
 		m_iAddressOfNameOrdinals = iRVAOfNameOrdinals;
 	}
 
+	// Index of end iterators
+	static const uint32_t ITERATOR_END = static_cast<uint32_t>(-1);
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor (no exports)
+	PEExportTables::PEExportTables()
+		: m_pPEBase(0)
+		, m_iDirectoryRVA(0)
+		, m_iDirectorySize(0)
+		, m_pDirectoryData(0)
+		, m_iDirectoryDataLength(0)
+		, m_pFunctions(0)
+		, m_pNames(0)
+		, m_pNameOrdinals(0)
+	{
+		memset(&m_Directory, 0, sizeof(IMAGE_EXPORT_DIRECTORY));
+	}
+
+	// Constructor, validates export directory of the Image
+	PEExportTables::PEExportTables(const PEBase& peBase)
+		: m_pPEBase(&peBase)
+		, m_iDirectoryRVA(0)
+		, m_iDirectorySize(0)
+		, m_pDirectoryData(0)
+		, m_iDirectoryDataLength(0)
+		, m_pFunctions(0)
+		, m_pNames(0)
+		, m_pNameOrdinals(0)
+	{
+		memset(&m_Directory, 0, sizeof(IMAGE_EXPORT_DIRECTORY));
+
+		if (NOT peBase.hasExports())
+		{
+			m_pPEBase = 0;
+			return;
+		}
+
+		m_iDirectoryRVA = peBase.getDirectoryRVA(IMAGE_DIRECTORY_ENTRY_EXPORT);
+		m_iDirectorySize = peBase.getDirectorySize(IMAGE_DIRECTORY_ENTRY_EXPORT);
+
+		// Check the length in bytes of the section containing export directory
+		PEDataCursor peCursor(peBase);
+		uint32_t iAvailable;
+		m_pDirectoryData = peCursor.tryGetData(m_iDirectoryRVA, m_iDirectoryDataLength);
+		if (NOT m_pDirectoryData || m_iDirectoryDataLength < sizeof(IMAGE_EXPORT_DIRECTORY))
+			throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
+
+		memcpy(&m_Directory, m_pDirectoryData, sizeof(IMAGE_EXPORT_DIRECTORY));
+
+		if (NOT m_Directory.iNumberOfFunctions)
+			return;
+
+		// Check IMAGE_EXPORT_DIRECTORY fields
+		if (	m_Directory.iNumberOfNames > m_Directory.iNumberOfFunctions
+				||
+				(NOT m_Directory.iAddressOfNameOrdinals && m_Directory.iAddressOfNames) 
+				||
+				(m_Directory.iAddressOfNameOrdinals && NOT m_Directory.iAddressOfNames) 
+				||
+				NOT m_Directory.iAddressOfFunctions
+				|| 
+				m_Directory.iNumberOfFunctions >= PEUtils::MAX_DWORD / sizeof(uint32_t)
+				|| 
+				NOT PEUtils::isSumSafe(m_iDirectoryRVA, m_iDirectorySize)
+		) {
+			throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
+		}
+
+		// Check if it is enough bytes to hold AddressOfFunctions table
+		m_pFunctions = reinterpret_cast<const uint32_t*>(peCursor.tryGetData(m_Directory.iAddressOfFunctions, iAvailable));
+		if (NOT m_pFunctions || iAvailable / sizeof(uint32_t) < m_Directory.iNumberOfFunctions)
+			throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
+
+		if (m_Directory.iAddressOfNames && m_Directory.iNumberOfNames)
+		{
+			// Check if it is enough bytes to hold name and ordinal tables
+			m_pNames = reinterpret_cast<const uint32_t*>(peCursor.tryGetData(m_Directory.iAddressOfNames, iAvailable));
+			if (NOT m_pNames || iAvailable / sizeof(uint32_t) < m_Directory.iNumberOfNames)
+				throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
+
+			m_pNameOrdinals = reinterpret_cast<const uint16_t*>(peCursor.tryGetData(m_Directory.iAddressOfNameOrdinals, iAvailable));
+			if (NOT m_pNameOrdinals || iAvailable / sizeof(uint16_t) < m_Directory.iNumberOfNames)
+				throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
+		}
+	}
+
+	// Returns 'true' if Image has export directory
+	bool PEExportTables::hasExports() const
+	{
+		return m_pPEBase NOT_EQUAL_TO 0;
+	}
+
+	// Returns export directory
+	const IMAGE_EXPORT_DIRECTORY& PEExportTables::getDirectory() const
+	{
+		return m_Directory;
+	}
+
+	// Returns number of entries in AddressOfFunctions
+	uint32_t PEExportTables::getNumberOfFunctions() const
+	{
+		return m_pFunctions ? m_Directory.iNumberOfFunctions : 0;
+	}
+
+	// Returns number of entries in AddressOfNames & AddressOfNameOrdinals
+	uint32_t PEExportTables::getNumberOfNames() const
+	{
+		return m_pNames ? m_Directory.iNumberOfNames : 0;
+	}
+
+	// Returns ordinal base
+	uint32_t PEExportTables::getOrdinalBase() const
+	{
+		return m_Directory.iBase;
+	}
+
+	// Returns RVA of function at index in AddressOfFunctions
+	uint32_t PEExportTables::getFunctionRVA(uint32_t iIndex) const
+	{
+		uint32_t iRVA;
+		memcpy(&iRVA, m_pFunctions + iIndex, sizeof(uint32_t));
+
+		return iRVA;
+	}
+
+	// Returns RVA of function name at index in AddressOfNames
+	uint32_t PEExportTables::getNameRVA(uint32_t iNameIndex) const
+	{
+		uint32_t iRVA;
+		memcpy(&iRVA, m_pNames + iNameIndex, sizeof(uint32_t));
+
+		return iRVA;
+	}
+
+	// Returns name ordinal (index in AddressOfFunctions) at index in AddressOfNameOrdinals
+	uint16_t PEExportTables::getNameOrdinal(uint32_t iNameIndex) const
+	{
+		uint16_t iNameOrdinal;
+		memcpy(&iNameOrdinal, m_pNameOrdinals + iNameIndex, sizeof(uint16_t));
+
+		return iNameOrdinal;
+	}
+
+	// Returns function name at index in AddressOfNames (references Image memory)
+	const PEStringView PEExportTables::getName(uint32_t iNameIndex) const
+	{
+		return getStringAt(getNameRVA(iNameIndex));
+	}
+
+	// Returns DLL name (references Image memory)
+	const PEStringView PEExportTables::getDllName() const
+	{
+		return getStringAt(m_Directory.iName);
+	}
+
+	// Returns 'true' if function RVA points inside of the export directory (function is forwarded)
+	bool PEExportTables::isForwarderRVA(uint32_t iRVA) const
+	{
+		return iRVA >= m_iDirectoryRVA && iRVA - m_iDirectoryRVA < m_iDirectorySize;
+	}
+
+	// Returns forwarded function name at RVA (references Image memory)
+	const PEStringView PEExportTables::getForwardedName(uint32_t iRVA) const
+	{
+		return getStringAt(iRVA);
+	}
+
+	// Returns null-terminated string at RVA, throws if there is none
+	const PEStringView PEExportTables::getStringAt(uint32_t iRVA) const
+	{
+		// Linkers place names & forwarders behind the directory, other strings are looked up through a local cursor
+		uint32_t iAvailable;
+		const char* pString;
+		if (iRVA >= m_iDirectoryRVA && iRVA - m_iDirectoryRVA < m_iDirectoryDataLength)
+		{
+			pString = m_pDirectoryData + (iRVA - m_iDirectoryRVA);
+			iAvailable = m_iDirectoryDataLength - (iRVA - m_iDirectoryRVA);
+		}
+		else
+		{
+			PEDataCursor peCursor(*m_pPEBase);
+			pString = peCursor.tryGetData(iRVA, iAvailable);
+		}
+		
+		// Check for null-termination
+		const char* pStringEnd = pString ? static_cast<const char*>(memchr(pString, 0, iAvailable)) : 0;
+		if (NOT pStringEnd)
+			throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
+
+		return PEStringView(pString, pStringEnd - pString);
+	}
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor
+	PEExportEntry::PEExportEntry()
+		: m_iOrdinal(0)
+		, m_iRVA(0)
+		, m_bHasName(false)
+		, m_iNameOrdinal(0)
+	{
+	}
+
+	// Returns ordinal of function (ordinal base is added)
+	uint16_t PEExportEntry::getOrdinal() const
+	{
+		return m_iOrdinal;
+	}
+
+	// Returns RVA of function
+	uint32_t PEExportEntry::getRVA() const
+	{
+		return m_iRVA;
+	}
+
+	// Returns true if function has name and name ordinal
+	bool PEExportEntry::hasName() const
+	{
+		return m_bHasName;
+	}
+
+	// Returns name of function
+	const PEStringView& PEExportEntry::getName() const
+	{
+		return m_vName;
+	}
+
+	// Returns name ordinal of function
+	uint16_t PEExportEntry::getNameOrdinal() const
+	{
+		return m_iNameOrdinal;
+	}
+
+	// Returns true if function is forwarded to other library
+	bool PEExportEntry::isForwarded() const
+	{
+		return NOT m_vForwardedName.empty();
+	}
+
+	// Returns the name of forwarded function
+	const PEStringView& PEExportEntry::getForwardedName() const
+	{
+		return m_vForwardedName;
+	}
+
+	// Returns the entry as PEExportedFunction (names are copied or referenced depending on eNameStorage)
+	const PEExportedFunction PEExportEntry::toExportedFunction(PENameStorage eNameStorage) const
+	{
+		PEExportedFunction func;
+		func.setRVA(m_iRVA);
+		func.setOrdinal(m_iOrdinal);
+
+		if (m_bHasName)
+		{
+			if (eNameStorage == PE_NAME_STORAGE_INTERN)
+				func.setNameSymbol(PEInternTable::getGlobal().intern(m_vName));
+			else if (eNameStorage == PE_NAME_STORAGE_VIEW)
+				func.setNameView(m_vName);
+			else
+				func.setName(m_vName);
+
+			func.setNameOrdinal(m_iNameOrdinal);
+		}
+
+		if (NOT m_vForwardedName.empty())
+		{
+			if (eNameStorage == PE_NAME_STORAGE_INTERN)
+				func.setForwardedNameSymbol(PEInternTable::getGlobal().intern(m_vForwardedName));
+			else if (eNameStorage == PE_NAME_STORAGE_VIEW)
+				func.setForwardedNameView(m_vForwardedName);
+			else
+				func.setForwardedName(m_vForwardedName);
+		}
+
+		return func;
+	}
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	// Helper: returns ordinal of export entry for function at index in AddressOfFunctions
+	static uint16_t decodeExportOrdinal(const PEExportTables& peTables, uint32_t iIndex)
+	{
+		if (NOT PEUtils::isSumSafe(peTables.getOrdinalBase(), iIndex)
+			||
+			peTables.getOrdinalBase() + iIndex > PEUtils::MAX_WORD
+		) {
+			throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
+		}
+
+		return static_cast<uint16_t>(peTables.getOrdinalBase() + iIndex);
+	}
+
+	// Helper: decodes ordinal & forwarded name of export entry for function at index in AddressOfFunctions
+	static void decodeExportAddress(const PEExportTables& peTables, uint32_t iIndex, uint32_t iRVA, uint16_t& iOrdinal, PEStringView& vForwardedName)
+	{
+		iOrdinal = decodeExportOrdinal(peTables, iIndex);
+
+		// If the function is just a redirect, save its name
+		vForwardedName = peTables.isForwarderRVA(iRVA) ? peTables.getForwardedName(iRVA) : PEStringView();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor (end iterator)
+	PEExportNameRange::const_iterator::const_iterator()
+		: m_pRange(0)
+		, m_iIndex(ITERATOR_END)
+	{
+	}
+
+	PEExportNameRange::const_iterator::const_iterator(const PEExportNameRange* pRange, uint32_t iIndex)
+		: m_pRange(pRange)
+		, m_iIndex(iIndex)
+	{
+		decode();
+	}
+
+	PEExportNameRange::const_iterator::reference PEExportNameRange::const_iterator::operator*() const
+	{
+		return m_Entry;
+	}
+
+	PEExportNameRange::const_iterator::pointer PEExportNameRange::const_iterator::operator->() const
+	{
+		return &m_Entry;
+	}
+
+	PEExportNameRange::const_iterator& PEExportNameRange::const_iterator::operator++()
+	{
+		if (m_iIndex NOT_EQUAL_TO ITERATOR_END)
+		{
+			m_iIndex++;
+			decode();
+		}
+
+		return *this;
+	}
+
+	PEExportNameRange::const_iterator PEExportNameRange::const_iterator::operator++(int)
+	{
+		const_iterator itr(*this);
+		++(*this);
+
+		return itr;
+	}
+
+	bool PEExportNameRange::const_iterator::operator==(const const_iterator& other) const
+	{
+		return m_iIndex == other.m_iIndex;
+	}
+
+	bool PEExportNameRange::const_iterator::operator!=(const const_iterator& other) const
+	{
+		return m_iIndex NOT_EQUAL_TO other.m_iIndex;
+	}
+
+	// Decodes entry at current index, or turns into end iterator
+	void PEExportNameRange::const_iterator::decode()
+	{
+		const PEExportTables& peTables = m_pRange->m_Tables;
+		if (m_iIndex >= peTables.getNumberOfNames())
+		{
+			m_iIndex = ITERATOR_END;
+			return;
+		}
+
+		// Name ordinal is the index of the function in AddressOfFunctions
+		uint16_t iNameOrdinal = peTables.getNameOrdinal(m_iIndex);
+		if (iNameOrdinal >= peTables.getNumberOfFunctions())
+			throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
+
+		m_Entry = PEExportEntry();
+		m_Entry.m_iRVA = peTables.getFunctionRVA(iNameOrdinal);
+		decodeExportAddress(peTables, iNameOrdinal, m_Entry.m_iRVA, m_Entry.m_iOrdinal, m_Entry.m_vForwardedName);
+
+		m_Entry.m_bHasName = true;
+		m_Entry.m_vName = peTables.getName(m_iIndex);
+		m_Entry.m_iNameOrdinal = iNameOrdinal;
+	}
+
+	// Constructor
+	PEExportNameRange::PEExportNameRange(const PEBase& peBase)
+		: m_Tables(peBase)
+	{
+	}
+
+	PEExportNameRange::const_iterator PEExportNameRange::begin() const
+	{
+		return const_iterator(this, 0);
+	}
+
+	PEExportNameRange::const_iterator PEExportNameRange::end() const
+	{
+		return const_iterator();
+	}
+
+	// Returns 'true' if there are no named exports
+	bool PEExportNameRange::empty() const
+	{
+		return m_Tables.getNumberOfNames() == 0;
+	}
+
+	// Returns number of named exports
+	uint32_t PEExportNameRange::count() const
+	{
+		return m_Tables.getNumberOfNames();
+	}
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor (end iterator)
+	PEExportAddressRange::const_iterator::const_iterator()
+		: m_pRange(0)
+		, m_iIndex(ITERATOR_END)
+	{
+	}
+
+	PEExportAddressRange::const_iterator::const_iterator(const PEExportAddressRange* pRange, uint32_t iIndex)
+		: m_pRange(pRange)
+		, m_iIndex(iIndex)
+	{
+		decode();
+	}
+
+	PEExportAddressRange::const_iterator::reference PEExportAddressRange::const_iterator::operator*() const
+	{
+		return m_Entry;
+	}
+
+	PEExportAddressRange::const_iterator::pointer PEExportAddressRange::const_iterator::operator->() const
+	{
+		return &m_Entry;
+	}
+
+	PEExportAddressRange::const_iterator& PEExportAddressRange::const_iterator::operator++()
+	{
+		if (m_iIndex NOT_EQUAL_TO ITERATOR_END)
+		{
+			m_iIndex++;
+			decode();
+		}
+
+		return *this;
+	}
+
+	PEExportAddressRange::const_iterator PEExportAddressRange::const_iterator::operator++(int)
+	{
+		const_iterator itr(*this);
+		++(*this);
+
+		return itr;
+	}
+
+	bool PEExportAddressRange::const_iterator::operator==(const const_iterator& other) const
+	{
+		return m_iIndex == other.m_iIndex;
+	}
+
+	bool PEExportAddressRange::const_iterator::operator!=(const const_iterator& other) const
+	{
+		return m_iIndex NOT_EQUAL_TO other.m_iIndex;
+	}
+
+	// Decodes entry at current (or next non-zero) index, or turns into end iterator
+	void PEExportAddressRange::const_iterator::decode()
+	{
+		const PEExportTables& peTables = m_pRange->m_Tables;
+
+		// Skip zero entries
+		while (m_iIndex < peTables.getNumberOfFunctions() && NOT peTables.getFunctionRVA(m_iIndex))
+			m_iIndex++;
+
+		if (m_iIndex >= peTables.getNumberOfFunctions())
+		{
+			m_iIndex = ITERATOR_END;
+			return;
+		}
+
+		m_Entry = PEExportEntry();
+		m_Entry.m_iRVA = peTables.getFunctionRVA(m_iIndex);
+		decodeExportAddress(peTables, m_iIndex, m_Entry.m_iRVA, m_Entry.m_iOrdinal, m_Entry.m_vForwardedName);
+	}
+
+	// Constructor
+	PEExportAddressRange::PEExportAddressRange(const PEBase& peBase)
+		: m_Tables(peBase)
+	{
+	}
+
+	PEExportAddressRange::const_iterator PEExportAddressRange::begin() const
+	{
+		return const_iterator(this, 0);
+	}
+
+	PEExportAddressRange::const_iterator PEExportAddressRange::end() const
+	{
+		return const_iterator();
+	}
+
+	// Returns 'true' if there are no exports
+	bool PEExportAddressRange::empty() const
+	{
+		return begin() == end();
+	}
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	// Name index of functions which have no name
+	static const uint32_t NO_NAME = static_cast<uint32_t>(-1);
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor (no exports)
+	PEExportIndex::PEExportIndex()
+	{
+	}
+
+	// Constructor, validates export directory of the Image & builds the ordinal -> name table
+	PEExportIndex::PEExportIndex(const PEBase& peBase, bool bBuildNameHashTable)
+		: m_Tables(peBase)
+	{
+		const uint32_t iNumberOfFunctions = m_Tables.getNumberOfFunctions();
+		const uint32_t iNumberOfNames = m_Tables.getNumberOfNames();
+
+		// Inverse of AddressOfNameOrdinals (walked backwards, so that the first name of a function wins)
+		m_vFunctionNameIndices.assign(iNumberOfFunctions, NO_NAME);
+		for (uint32_t iNameIndex = iNumberOfNames; iNameIndex-- > 0; )
+		{
+			const uint16_t iNameOrdinal = m_Tables.getNameOrdinal(iNameIndex);
+			if (iNameOrdinal < iNumberOfFunctions)
+				m_vFunctionNameIndices[iNameOrdinal] = iNameIndex;
+		}
+
+		// Names are resolved once, lookups compare the views only
+		m_vNames.reserve(iNumberOfNames);
+		for (uint32_t iNameIndex = 0; iNameIndex < iNumberOfNames; iNameIndex++)
+			m_vNames.push_back(m_Tables.getName(iNameIndex));
+
+		// Forwarded names too, so that lookups never read strings through a PEDataCursor (which may map Section data)
+		for (uint32_t iIndex = 0; iIndex < iNumberOfFunctions; iIndex++)
+		{
+			const uint32_t iRVA = m_Tables.getFunctionRVA(iIndex);
+			if (m_Tables.isForwarderRVA(iRVA))
+			{
+				if (m_vForwardedNames.empty())
+					m_vForwardedNames.resize(iNumberOfFunctions);
+
+				m_vForwardedNames[iIndex] = m_Tables.getForwardedName(iRVA);
+			}
+		}
+
+		// The loader binary searches AddressOfNames, so linkers sort it; sort an index only for Images which don't
+		std::vector<std::pair<PEStringView, uint32_t> > vNames;
+		for (uint32_t iNameIndex = 1; iNameIndex < iNumberOfNames; iNameIndex++)
+		{
+			if (m_vNames[iNameIndex] < m_vNames[iNameIndex - 1])
+			{
+				vNames.reserve(iNumberOfNames);
+				for (uint32_t i = 0; i < iNumberOfNames; i++)
+					vNames.push_back(std::make_pair(m_vNames[i], i));
+
+				break;
+			}
+		}
+
+		if (NOT vNames.empty())
+		{
+			// Equal names keep AddressOfNames order (pairs compare indices too)
+			std::sort(vNames.begin(), vNames.end());
+
+			m_vSortedNameIndices.reserve(vNames.size());
+			for (std::vector<std::pair<PEStringView, uint32_t> >::const_iterator itr = vNames.begin(); itr != vNames.end(); ++itr)
+				m_vSortedNameIndices.push_back(itr->second);
+		}
+
+		if (bBuildNameHashTable)
+			buildNameHashTable();
+	}
+
+	// Returns 'true' if Image has export directory
+	bool PEExportIndex::hasExports() const
+	{
+		return m_Tables.hasExports();
+	}
+
+	// Returns ordinal base
+	uint32_t PEExportIndex::getOrdinalBase() const
+	{
+		return m_Tables.getOrdinalBase();
+	}
+
+	// Returns number of entries in AddressOfFunctions
+	uint32_t PEExportIndex::getNumberOfFunctions() const
+	{
+		return m_Tables.getNumberOfFunctions();
+	}
+
+	// Returns number of named exports
+	uint32_t PEExportIndex::getNumberOfNames() const
+	{
+		return m_Tables.getNumberOfNames();
+	}
+
+	// Returns 'true' if AddressOfNames of the Image is sorted (no sorted index had to be built)
+	bool PEExportIndex::isNameTableSorted() const
+	{
+		return m_vSortedNameIndices.empty();
+	}
+
+	// Returns 'true' if name lookups go through the hash table
+	bool PEExportIndex::hasNameHashTable() const
+	{
+		return NOT m_vNameHashTable.empty();
+	}
+
+	// Builds the name hash table (if it is not built yet)
+	void PEExportIndex::buildNameHashTable()
+	{
+		const uint32_t iNumberOfNames = m_Tables.getNumberOfNames();
+		if (NOT iNumberOfNames || hasNameHashTable())
+			return;
+
+		// Keep at most half of the slots used
+		uint32_t iNumberOfSlots = 16;
+		while (iNumberOfSlots < iNumberOfNames * 2)
+			iNumberOfSlots *= 2;
+
+		m_vNameHashTable.assign(iNumberOfSlots, 0);
+
+		// Names are inserted in AddressOfNames order, so the first of equal names is found first
+		const uint32_t iMask = iNumberOfSlots - 1;
+		for (uint32_t iNameIndex = 0; iNameIndex < iNumberOfNames; iNameIndex++)
+		{
+			uint32_t iSlot = PEUtils::hashName(m_vNames[iNameIndex]) & iMask;
+			while (m_vNameHashTable[iSlot])
+				iSlot = (iSlot + 1) & iMask;
+
+			m_vNameHashTable[iSlot] = iNameIndex + 1;
+		}
+	}
+
+	// Looks up export by name, returns 'false' if there is none
+	bool PEExportIndex::findExport(const PEStringView& sName, PEExportEntry& peExport) const
+	{
+		const uint32_t iNameIndex = findNameIndex(sName);
+		if (iNameIndex == NO_NAME)
+			return false;
+
+		const uint16_t iIndex = m_Tables.getNameOrdinal(iNameIndex);
+		if (iIndex >= m_Tables.getNumberOfFunctions() || NOT m_Tables.getFunctionRVA(iIndex))
+			return false;
+
+		getExport(iIndex, iNameIndex, peExport);
+		return true;
+	}
+
+	// Looks up export by ordinal (ordinal base included), returns 'false' if there is none
+	bool PEExportIndex::findExport(uint16_t iOrdinal, PEExportEntry& peExport) const
+	{
+		if (iOrdinal < m_Tables.getOrdinalBase())
+			return false;
+
+		const uint32_t iIndex = iOrdinal - m_Tables.getOrdinalBase();
+		if (iIndex >= m_Tables.getNumberOfFunctions() || NOT m_Tables.getFunctionRVA(iIndex))
+			return false;
+
+		getExport(iIndex, m_vFunctionNameIndices[iIndex], peExport);
+		return true;
+	}
+
+	// Returns RVA of function exported by name (forwarder RVA, if forwarded), or 0 if there is none
+	uint32_t PEExportIndex::getExportRVA(const PEStringView& sName) const
+	{
+		const uint32_t iNameIndex = findNameIndex(sName);
+		if (iNameIndex == NO_NAME)
+			return 0;
+
+		const uint16_t iIndex = m_Tables.getNameOrdinal(iNameIndex);
+		return iIndex < m_Tables.getNumberOfFunctions() ? m_Tables.getFunctionRVA(iIndex) : 0;
+	}
+
+	// Returns RVA of function exported by ordinal (forwarder RVA, if forwarded), or 0 if there is none
+	uint32_t PEExportIndex::getExportRVA(uint16_t iOrdinal) const
+	{
+		if (iOrdinal < m_Tables.getOrdinalBase() || iOrdinal - m_Tables.getOrdinalBase() >= m_Tables.getNumberOfFunctions())
+			return 0;
+
+		return m_Tables.getFunctionRVA(iOrdinal - m_Tables.getOrdinalBase());
+	}
+
+	// Returns index in AddressOfNames of the name, or NO_NAME
+	uint32_t PEExportIndex::findNameIndex(const PEStringView& sName) const
+	{
+		const uint32_t iNumberOfNames = m_Tables.getNumberOfNames();
+		if (NOT iNumberOfNames)
+			return NO_NAME;
+
+		if (hasNameHashTable())
+		{
+			const uint32_t iMask = static_cast<uint32_t>(m_vNameHashTable.size()) - 1;
+			for (uint32_t iSlot = PEUtils::hashName(sName) & iMask; m_vNameHashTable[iSlot]; iSlot = (iSlot + 1) & iMask)
+			{
+				if (m_vNames[m_vNameHashTable[iSlot] - 1] == sName)
+					return m_vNameHashTable[iSlot] - 1;
+			}
+
+			return NO_NAME;
+		}
+
+		// Lower bound, so that the first of equal names is found
+		uint32_t iFirst = 0, iLast = iNumberOfNames;
+		while (iFirst < iLast)
+		{
+			const uint32_t iMiddle = iFirst + (iLast - iFirst) / 2;
+			if (getSortedName(iMiddle).compare(sName) < 0)
+				iFirst = iMiddle + 1;
+			else
+				iLast = iMiddle;
+		}
+
+		if (iFirst == iNumberOfNames || getSortedName(iFirst) NOT_EQUAL_TO sName)
+			return NO_NAME;
+
+		return m_vSortedNameIndices.empty() ? iFirst : m_vSortedNameIndices[iFirst];
+	}
+
+	// Returns name at position of name order
+	const PEStringView PEExportIndex::getSortedName(uint32_t iPosition) const
+	{
+		return m_vNames[m_vSortedNameIndices.empty() ? iPosition : m_vSortedNameIndices[iPosition]];
+	}
+
+	// Looks up export named by the name at position of name order, returns 'false' if its function doesn't exist
+	bool PEExportIndex::findSortedExport(uint32_t iPosition, PEExportEntry& peExport) const
+	{
+		if (iPosition >= m_Tables.getNumberOfNames())
+			return false;
+
+		const uint32_t iNameIndex = m_vSortedNameIndices.empty() ? iPosition : m_vSortedNameIndices[iPosition];
+		const uint16_t iIndex = m_Tables.getNameOrdinal(iNameIndex);
+		if (iIndex >= m_Tables.getNumberOfFunctions() || NOT m_Tables.getFunctionRVA(iIndex))
+			return false;
+
+		getExport(iIndex, iNameIndex, peExport);
+		return true;
+	}
+
+	// Fills export entry of the function at index of AddressOfFunctions (iNameIndex may be NO_NAME)
+	void PEExportIndex::getExport(uint32_t iIndex, uint32_t iNameIndex, PEExportEntry& peExport) const
+	{
+		peExport = PEExportEntry();
+		peExport.m_iRVA = m_Tables.getFunctionRVA(iIndex);
+		peExport.m_iOrdinal = decodeExportOrdinal(m_Tables, iIndex);
+		if (NOT m_vForwardedNames.empty())
+			peExport.m_vForwardedName = m_vForwardedNames[iIndex];
+
+		if (iNameIndex NOT_EQUAL_TO NO_NAME)
+		{
+			peExport.m_bHasName = true;
+			peExport.m_vName = m_vNames[iNameIndex];
+			peExport.m_iNameOrdinal = static_cast<uint16_t>(iIndex);
+		}
+	}
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	// Returns lazy range over named exports of the Image
+	const PEExportNameRange getExportedNames(const PEBase& peBase)
+	{
+		return PEExportNameRange(peBase);
+	}
+
+	// Returns lazy range over all exports of the Image (ordinal order)
+	const PEExportAddressRange getExportedAddresses(const PEBase& peBase)
+	{
+		return PEExportAddressRange(peBase);
+	}
+
+	// Returns 'true' if Image exports function by name, stops at the first match
+	bool isFunctionExported(const PEBase& peBase, const PEStringView& sFunctionName)
+	{
+		PEExportNameRange peExports(peBase);
+		for (PEExportNameRange::const_iterator itr = peExports.begin(); itr != peExports.end(); ++itr)
+		{
+			if (itr->getName() == sFunctionName)
+				return true;
+		}
+
+		return false;
+	}
+
 	// forward declaration
-	const PEEXPORTED_FUNCTION_LIST				getExportedFunctionsList(const PEBase& peBase, PEExportInfo* peExportInfo);
+	const PEEXPORTED_FUNCTION_LIST				getExportedFunctionsList(const PEBase& peBase, PEExportInfo* peExportInfo, PENameStorage eNameStorage);
 	
 	// Returns array of exported functions
-	const PEEXPORTED_FUNCTION_LIST				getExportedFunctionsList(const PEBase& peBase)
+	const PEEXPORTED_FUNCTION_LIST				getExportedFunctionsList(const PEBase& peBase, PENameStorage eNameStorage)
 	{
-		return getExportedFunctionsList(peBase, 0);
+		return getExportedFunctionsList(peBase, 0, eNameStorage);
 	}
 
 	// Returns array of exported functions and information about export
-	const PEEXPORTED_FUNCTION_LIST				getExportedFunctionsList(const PEBase& peBase, PEExportInfo& peExportInfo)
+	const PEEXPORTED_FUNCTION_LIST				getExportedFunctionsList(const PEBase& peBase, PEExportInfo& peExportInfo, PENameStorage eNameStorage)
 	{
-		return getExportedFunctionsList(peBase, &peExportInfo);
+		return getExportedFunctionsList(peBase, &peExportInfo, eNameStorage);
 	}
 
 	// Helper: sorts exported function list by ordinals
@@ -257,233 +1144,336 @@ namespace OpenPE
 	};
 
 	// Returns array of exported functions and information about export
-	const PEEXPORTED_FUNCTION_LIST				getExportedFunctionsList(const PEBase& peBase, PEExportInfo* peExportInfo)
+	// If eNameStorage = PE_NAME_STORAGE_VIEW, names reference Image memory & the only allocations are the list
+	// and the name index table
+	const PEEXPORTED_FUNCTION_LIST				getExportedFunctionsList(const PEBase& peBase, PEExportInfo* peExportInfo, PENameStorage eNameStorage)
 	{
 		// Returned exported functions info array
 		std::vector<PEExportedFunction>		returnList;
 
-		if (peBase.hasExports())
+		// Validates the directory & resolves the three tables to direct pointers
+		PEExportTables peTables(peBase);
+		if (NOT peTables.hasExports())
+			return returnList;
+
+		if (peExportInfo)
 		{
-			// Check the length in bytes of the section containing export directory
-			if (peBase.getSectionDataLengthFromRVA(	peBase.getDirectoryRVA(IMAGE_DIRECTORY_ENTRY_EXPORT),
-													peBase.getDirectoryRVA(IMAGE_DIRECTORY_ENTRY_EXPORT),
-													SECTION_DATA_VIRTUAL,
-													true) < sizeof(IMAGE_EXPORT_DIRECTORY))
-			{
-				throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
-			}
+			const IMAGE_EXPORT_DIRECTORY& exports = peTables.getDirectory();
+
+			// Save export info data
+			peExportInfo->setCharacteristics(exports.iCharacteristics);
+			peExportInfo->setMajorVersion(exports.iMajorVersion);
+			peExportInfo->setMinorVersion(exports.iMinorVersion);
+
+			const PEStringView vDllName = peTables.getDllName();
+			if (eNameStorage == PE_NAME_STORAGE_INTERN)
+				peExportInfo->setNameSymbol(PEInternTable::getGlobal().intern(vDllName));
+			else if (eNameStorage == PE_NAME_STORAGE_VIEW)
+				peExportInfo->setNameView(vDllName);
+			else
+				peExportInfo->setName(vDllName);
+
+			peExportInfo->setNumberOfFunctions(exports.iNumberOfFunctions);
+			peExportInfo->setNumberOfNames(exports.iNumberOfNames);
+			peExportInfo->setOrdinalBase(exports.iBase);
+			peExportInfo->setRVAOfFunctions(exports.iAddressOfFunctions);
+			peExportInfo->setRVAOfNames(exports.iAddressOfNames);
+			peExportInfo->setRVAOfNameOrdinals(exports.iAddressOfNameOrdinals);
+			peExportInfo->setTimeStamp(exports.iTimeDateStamp);
+		}
 
-			IMAGE_EXPORT_DIRECTORY exports = peBase.getSectionDataFromRVA<IMAGE_EXPORT_DIRECTORY>(	peBase.getDirectoryRVA(IMAGE_DIRECTORY_ENTRY_EXPORT),
-																									SECTION_DATA_VIRTUAL,
-																									true);
+		const uint32_t iNumberOfFunctions = peTables.getNumberOfFunctions();
+		if (NOT iNumberOfFunctions)
+			return returnList;
 
-			unsigned long iMaxNameLength;
-			if (peExportInfo)
-			{
-				// Save some export info data
-				peExportInfo->setCharacteristics(exports.iCharacteristics);
-				peExportInfo->setMajorVersion(exports.iMajorVersion);
-				peExportInfo->setMinorVersion(exports.iMinorVersion);
-
-				// Get byte count that we have for dll name
-				if ((iMaxNameLength = peBase.getSectionDataLengthFromRVA(	exports.iName, 
-																			exports.iName, 
-																			SECTION_DATA_VIRTUAL, 
-																			true)) < 2)
-				{
-					throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
-				}
-
-				// Get dll name pointer
-				const char* sDllName = peBase.getSectionDataFromRVA(exports.iName, SECTION_DATA_VIRTUAL, true);
-
-				// Check for null-termination
-				if (NOT PEUtils::isNullTerminated(sDllName, iMaxNameLength))
-					throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
-
-				//Save the rest of export information data
-				peExportInfo->setName(sDllName);
-				peExportInfo->setNumberOfFunctions(exports.iNumberOfFunctions);
-				peExportInfo->setNumberOfNames(exports.iNumberOfNames);
-				peExportInfo->setOrdinalBase(exports.iBase);
-				peExportInfo->setRVAOfFunctions(exports.iAddressOfFunctions);
-				peExportInfo->setRVAOfNames(exports.iAddressOfNames);
-				peExportInfo->setRVAOfNameOrdinals(exports.iAddressOfNameOrdinals);
-				peExportInfo->setTimeStamp(exports.iTimeDateStamp);
-			}
+		// Inverse of AddressOfNameOrdinals, built in one pass: index in AddressOfNames of every function
+		// Walked backwards, so that the first name wins if a function has several
+		// Name ordinals out of AddressOfFunctions are ignored
+		std::vector<uint32_t> vNameIndices(iNumberOfFunctions, ITERATOR_END);
+		for (uint32_t iNameIndex = peTables.getNumberOfNames(); iNameIndex-- > 0; )
+		{
+			const uint16_t iNameOrdinal = peTables.getNameOrdinal(iNameIndex);
+			if (iNameOrdinal < iNumberOfFunctions)
+				vNameIndices[iNameOrdinal] = iNameIndex;
+		}
 
-			if (!exports.iNumberOfFunctions)
-				return returnList;
+		// Allocate the list once (the number of functions is bounded by the Section size checked by PEExportTables)
+		returnList.reserve(iNumberOfFunctions);
 
-			// Check IMAGE_EXPORT_DIRECTORY fields
-			if (exports.iNumberOfNames > exports.iNumberOfFunctions)
+		for (uint32_t iIndex = 0; iIndex < iNumberOfFunctions; iIndex++)
+		{
+			// If we have a skip
+			const uint32_t iRVA = peTables.getFunctionRVA(iIndex);
+			if (NOT iRVA)
+				continue;
+
+			uint16_t iOrdinal;
+			PEStringView vForwardedName;
+			decodeExportAddress(peTables, iIndex, iRVA, iOrdinal, vForwardedName);
+
+			returnList.push_back(PEExportedFunction());
+			PEExportedFunction& func = returnList.back();
+			func.setRVA(iRVA);
+			func.setOrdinal(iOrdinal);
+
+			// If function has name (and name ordinal)
+			if (vNameIndices[iIndex] NOT_EQUAL_TO ITERATOR_END)
 			{
-				throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
+				const PEStringView vName = peTables.getName(vNameIndices[iIndex]);
+				if (eNameStorage == PE_NAME_STORAGE_INTERN)
+					func.setNameSymbol(PEInternTable::getGlobal().intern(vName));
+				else if (eNameStorage == PE_NAME_STORAGE_VIEW)
+					func.setNameView(vName);
+				else
+					func.setName(vName);
+
+				func.setNameOrdinal(static_cast<uint16_t>(iIndex));
 			}
 
-			// Check some export directory fields
-			if (	(NOT exports.iAddressOfNameOrdinals && exports.iAddressOfNames) 
-					||
-					(exports.iAddressOfNameOrdinals && !exports.iAddressOfNames) 
-					||
-					NOT exports.iAddressOfFunctions
-					|| 
-					exports.iNumberOfFunctions >= PEUtils::MAX_DWORD / sizeof(uint32_t)
-					|| 
-					exports.iNumberOfNames > PEUtils::MAX_DWORD / sizeof(uint32_t)
-					|| 
-					NOT PEUtils::isSumSafe(exports.iAddressOfFunctions, exports.iNumberOfFunctions * sizeof(uint32_t))
-					|| 
-					NOT PEUtils::isSumSafe(exports.iAddressOfNames, exports.iNumberOfNames * sizeof(uint32_t))
-					|| 
-					NOT PEUtils::isSumSafe(exports.iAddressOfNameOrdinals, exports.iNumberOfFunctions * sizeof(uint32_t))
-					|| 
-					NOT PEUtils::isSumSafe(	peBase.getDirectoryRVA(IMAGE_DIRECTORY_ENTRY_EXPORT), 
-											peBase.getDirectorySize(IMAGE_DIRECTORY_ENTRY_EXPORT))
-			) {
-				throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
+			// If the function is just a redirect (its RVA points inside of the export directory), save its name
+			if (NOT vForwardedName.empty())
+			{
+				if (eNameStorage == PE_NAME_STORAGE_INTERN)
+					func.setForwardedNameSymbol(PEInternTable::getGlobal().intern(vForwardedName));
+				else if (eNameStorage == PE_NAME_STORAGE_VIEW)
+					func.setForwardedNameView(vForwardedName);
+				else
+					func.setForwardedName(vForwardedName);
 			}
+		}
+
+		return returnList;
+	}
 
-			// Check if it is enough bytes to hold AddressOfFunctions table
-			if (	peBase.getSectionDataLengthFromRVA(	exports.iAddressOfFunctions, 
-														exports.iAddressOfFunctions, 
-														SECTION_DATA_VIRTUAL, 
-														true)
-					< 
-					exports.iNumberOfFunctions * sizeof(uint32_t)
-			) {
-				throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
-			}
 
-			if (exports.iAddressOfNames)
+	// Returns pair: <ordinal base for supplied functions; maximum ordinal value for supplied functions>
+	const std::pair<uint16_t, uint16_t> getExportedOrdinalLimits(const PEEXPORTED_FUNCTION_LIST& peExports)
+	{
+		if (peExports.empty())
+			return std::pair<uint16_t, uint16_t>(0, 0);
+
+		uint16_t iOrdinalBase = static_cast<uint16_t>(PEUtils::MAX_WORD);
+		uint16_t iMaxOrdinal = 0;
+		for (PEEXPORTED_FUNCTION_LIST::const_iterator itr = peExports.begin(); itr != peExports.end(); ++itr)
+		{
+			if (itr->getOrdinal() < iOrdinalBase)
+				iOrdinalBase = itr->getOrdinal();
+
+			if (itr->getOrdinal() > iMaxOrdinal)
+				iMaxOrdinal = itr->getOrdinal();
+		}
+
+		return std::make_pair(iOrdinalBase, iMaxOrdinal);
+	}
+
+	// Checks if exported function name already exists
+	bool doesExportedNameExists(const std::string& sFunctionName, const PEEXPORTED_FUNCTION_LIST& peExports)
+	{
+		for (PEEXPORTED_FUNCTION_LIST::const_iterator itr = peExports.begin(); itr != peExports.end(); ++itr)
+		{
+			if (itr->hasName() && itr->getNameView() == PEStringView(sFunctionName))
+				return true;
+		}
+
+		return false;
+	}
+
+	// Checks if exported function ordinal already exists
+	bool doesExportedOrdinalExists(uint16_t iOrdinal, const PEEXPORTED_FUNCTION_LIST& peExports)
+	{
+		for (PEEXPORTED_FUNCTION_LIST::const_iterator itr = peExports.begin(); itr != peExports.end(); ++itr)
+		{
+			if (itr->getOrdinal() == iOrdinal)
+				return true;
+		}
+
+		return false;
+	}
+
+	// Helper: orders indices of exported functions by their names (AddressOfNames must be sorted for the loader)
+	struct ExportNameSorter
+	{
+		const PEEXPORTED_FUNCTION_LIST*	m_pExports;
+
+		bool operator()(uint32_t iExport1, uint32_t iExport2) const
+		{
+			return (*m_pExports)[iExport1].getNameView() < (*m_pExports)[iExport2].getNameView();
+		}
+	};
+
+	// Slot of AddressOfFunctions without exported function
+	static const uint32_t NO_EXPORT = static_cast<uint32_t>(-1);
+
+	// Rebuilds Export Directory of the Image into peExportSection
+	const PEImageDirectory rebuildExports(	PEBase& peBase,
+											const PEExportInfo& peExportInfo,
+											const PEEXPORTED_FUNCTION_LIST& peExports,
+											PESection& peExportSection,
+											uint32_t iOffsetFromSectionStart,
+											bool bSaveToPEHeaders,
+											bool bAutoStripLastSection
+	) {
+		// Check that peExportSection is attached to this Image
+		if (NOT peBase.sectionAttached(peExportSection))
+			throw PEException("Export Section must be attached to the Image", PEException::PEEXCEPTION_SECTION_IS_NOT_ATTACHED);
+
+		// Validation pass: AddressOfFunctions slot of every function (indexed by ordinal - ordinal base),
+		// named functions & the size of all strings
+		const std::pair<uint16_t, uint16_t> peOrdinalLimits = getExportedOrdinalLimits(peExports);
+		const uint32_t iNumberOfFunctions = peExports.empty() ? 0 : peOrdinalLimits.second - peOrdinalLimits.first + 1;
+
+		std::vector<uint32_t> vFunctionExports(iNumberOfFunctions, NO_EXPORT);
+		std::vector<uint32_t> vNamedExports;
+		uint64_t iStringsSize = peExportInfo.getNameView().length() + 1 /* nullbyte */;
+
+		for (uint32_t iExport = 0; iExport < peExports.size(); iExport++)
+		{
+			const PEExportedFunction& func = peExports[iExport];
+
+			uint32_t& iFunctionExport = vFunctionExports[func.getOrdinal() - peOrdinalLimits.first];
+			if (iFunctionExport NOT_EQUAL_TO NO_EXPORT)
+				throw PEException("Duplicate exported function ordinal", PEException::PEEXCEPTION_DUPLICATE_EXPORTED_FUNCTION_ORDINAL);
+			iFunctionExport = iExport;
+
+			if (func.hasName())
 			{
-				// Check if it is enough bytes to hold name and ordinal tables
-				if (	peBase.getSectionDataLengthFromRVA(	exports.iAddressOfNameOrdinals, 
-															exports.iAddressOfNameOrdinals, 
-															SECTION_DATA_VIRTUAL, 
-															true)
-						< 
-						exports.iNumberOfNames * sizeof(uint32_t)
-				) {
-					throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
-				}
-
-				if (	peBase.getSectionDataLengthFromRVA(	exports.iAddressOfNames, 
-															exports.iAddressOfNames, 
-															SECTION_DATA_VIRTUAL, 
-															true)
-						< 
-						exports.iNumberOfNames * sizeof(uint32_t)
-				) {
-					throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
-				}
+				vNamedExports.push_back(iExport);
+				iStringsSize += func.getNameView().length() + 1 /* nullbyte */;
 			}
 
-			for (uint32_t iOrdinal = 0; iOrdinal < exports.iNumberOfFunctions; iOrdinal++)
+			if (func.isForwarded())
+				iStringsSize += func.getForwardedNameView().length() + 1 /* nullbyte */;
+		}
+
+		// The only sort: names in binary order, equal names end up adjacent
+		ExportNameSorter peSorter = { &peExports };
+		std::sort(vNamedExports.begin(), vNamedExports.end(), peSorter);
+		for (uint32_t i = 1; i < vNamedExports.size(); i++)
+		{
+			if (peExports[vNamedExports[i - 1]].getNameView() == peExports[vNamedExports[i]].getNameView())
+				throw PEException("Duplicate exported function name", PEException::PEEXCEPTION_DUPLICATE_EXPORTED_FUNCTION_NAME);
+		}
+
+		// Strings are staged in their final order (DLL name, names in name order, forwarded names in ordinal order),
+		// as names may reference the data of peExportSection (PE_NAME_STORAGE_VIEW), which is resized & cleared below
+		// (only their lengths are used after that)
+		std::string sStrings;
+		sStrings.reserve(static_cast<size_t>(iStringsSize));
+		sStrings.append(peExportInfo.getNameView().data(), peExportInfo.getNameView().length());
+		sStrings.push_back(0);
+
+		for (uint32_t i = 0; i < vNamedExports.size(); i++)
+		{
+			const PEStringView sName = peExports[vNamedExports[i]].getNameView();
+			sStrings.append(sName.data(), sName.length());
+			sStrings.push_back(0);
+		}
+
+		for (uint32_t iIndex = 0; iIndex < iNumberOfFunctions; iIndex++)
+		{
+			if (vFunctionExports[iIndex] NOT_EQUAL_TO NO_EXPORT && peExports[vFunctionExports[iIndex]].isForwarded())
 			{
-				// Get function address
-				// Sum and multiplication are safe (checked above)
-				uint32_t iRVA = peBase.getSectionDataFromRVA<uint32_t>(	exports.iAddressOfFunctions + iOrdinal * sizeof(uint32_t),
-																		SECTION_DATA_VIRTUAL,
-																		true);
-
-				// If we have a skip
-				if (NOT iRVA)
-					continue;
-
-				PEExportedFunction func;
-				func.setRVA(iRVA);
-
-				if (NOT PEUtils::isSumSafe(exports.iBase, iOrdinal)
-					||
-					exports.iBase + iOrdinal > PEUtils::MAX_WORD
-				) {
-					throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
-				}
-
-				func.setOrdinal(static_cast<uint16_t>(iOrdinal + exports.iBase));
-
-				// Scan for function name ordinal
-				for (uint32_t i = 0; i < exports.iNumberOfNames; i++)
-				{
-					uint16_t iOrdinal2 = peBase.getSectionDataFromRVA<uint16_t>(	exports.iAddressOfNameOrdinals + i * sizeof(uint16_t), 
-																					SECTION_DATA_VIRTUAL, 
-																					true);
-
-					// If function has name (and name ordinal)
-					if (iOrdinal == iOrdinal2)
-					{
-						// Get function name
-						// Sum and multiplication are safe (checked above)
-						uint32_t iFunctionNameRVA = peBase.getSectionDataFromRVA<uint32_t>(	exports.iAddressOfNames + i * sizeof(uint32_t), 
-																							SECTION_DATA_VIRTUAL, 
-																							true);
-
-						// Get byte count that we have for function name
-						if ((iMaxNameLength = peBase.getSectionDataLengthFromRVA(	iFunctionNameRVA, 
-																					iFunctionNameRVA, 
-																					SECTION_DATA_VIRTUAL, 
-																					true)
-																				) < 2
-						) {
-							throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
-						}
-
-						// Get function name pointer
-						const char* pFuncName = peBase.getSectionDataFromRVA(iFunctionNameRVA, SECTION_DATA_VIRTUAL, true);
-
-						//Check for null-termination
-						if (NOT PEUtils::isNullTerminated(pFuncName, iMaxNameLength))
-							throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
-
-						//Save function info
-						func.setName(pFuncName);
-						func.setNameOrdinal(iOrdinal2);
-
-						// If the function is just a redirect, save its name
-						if (	iRVA >=	peBase.getDirectoryRVA(IMAGE_DIRECTORY_ENTRY_EXPORT) 
-										+ 
-										sizeof(IMAGE_DIRECTORY_ENTRY_EXPORT) 
-								&&
-								iRVA <	peBase.getDirectoryRVA(IMAGE_DIRECTORY_ENTRY_EXPORT) 
-										+ 
-										peBase.getDirectorySize(IMAGE_DIRECTORY_ENTRY_EXPORT))
-						{
-							if ((iMaxNameLength = peBase.getSectionDataLengthFromRVA(iRVA, iRVA, SECTION_DATA_VIRTUAL, true)) < 2)
-								throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
-
-							// Get forwarded function name pointer
-							const char* pForwardedFuncName = peBase.getSectionDataFromRVA(iRVA, SECTION_DATA_VIRTUAL, true);
-
-							// Check for null-termination
-							if (NOT PEUtils::isNullTerminated(pForwardedFuncName, iMaxNameLength))
-								throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
-
-							// Set the name of forwarded function
-							func.setForwardedName(pForwardedFuncName);
-						} {
-							break;
-						}
-					}
-				}
-
-				//Add function info to output array
-				returnList.push_back(func);
+				const PEStringView sForwardedName = peExports[vFunctionExports[iIndex]].getForwardedNameView();
+				sStrings.append(sForwardedName.data(), sForwardedName.length());
+				sStrings.push_back(0);
 			}
 		}
 
-		return returnList;
-	}
+		// Layout pass
+		const uint32_t iNumberOfNames = static_cast<uint32_t>(vNamedExports.size());
+		const uint32_t iDirectoryOffset = PEUtils::alignUp(iOffsetFromSectionStart, sizeof(uint32_t));
+		const uint32_t iFunctionsOffset = iDirectoryOffset + sizeof(IMAGE_EXPORT_DIRECTORY);
+		const uint32_t iNamesOffset = iFunctionsOffset + iNumberOfFunctions * sizeof(uint32_t);
+		const uint32_t iNameOrdinalsOffset = iNamesOffset + iNumberOfNames * sizeof(uint32_t);
+		const uint32_t iStringsOffset = iNameOrdinalsOffset + iNumberOfNames * sizeof(uint16_t);
+
+		if (iStringsOffset < iDirectoryOffset || iStringsSize > PEUtils::MAX_DWORD - iStringsOffset)
+			throw PEException("Insufficient space for Export Directory", PEException::PEEXCEPTION_INSUFFICIENT_SPACE);
+
+		const uint32_t iEndOffset = iStringsOffset + static_cast<uint32_t>(iStringsSize);
+
+		// If peExportSection is not the last one, the directory must fit into its raw data
+		bool bLastSection = (&peExportSection == &peBase.getImageSectionList().back());
+		if (NOT bLastSection && peExportSection.getAlignedRawSize(peBase.getFileAlignment()) < iEndOffset)
+			throw PEException("Insufficient space for Export Directory", PEException::PEEXCEPTION_INSUFFICIENT_SPACE);
+
+		// The only (re)allocation of the Section data
+		std::string& sRawData = peExportSection.getRawData();
+		if (sRawData.length() < iEndOffset)
+			sRawData.resize(iEndOffset);
+
+		char* pData = &sRawData[0];
+		memset(pData + iDirectoryOffset, 0, iStringsOffset - iDirectoryOffset);
+		memcpy(pData + iStringsOffset, sStrings.data(), sStrings.length());
+
+		// Write pass
+		uint32_t iStringPos = iStringsOffset;
+
+		IMAGE_EXPORT_DIRECTORY peDirectory;
+		memset(&peDirectory, 0, sizeof(IMAGE_EXPORT_DIRECTORY));
+		peDirectory.iCharacteristics = peExportInfo.getCharacteristics();
+		peDirectory.iTimeDateStamp = peExportInfo.getTimeStamp();
+		peDirectory.iMajorVersion = peExportInfo.getMajorVersion();
+		peDirectory.iMinorVersion = peExportInfo.getMinorVersion();
+		peDirectory.iBase = peExports.empty() ? 1 : peOrdinalLimits.first;
+		peDirectory.iNumberOfFunctions = iNumberOfFunctions;
+		peDirectory.iNumberOfNames = iNumberOfNames;
+		peDirectory.iAddressOfFunctions = peBase.getRVAFromSectionOffset(peExportSection, iFunctionsOffset);
+		peDirectory.iAddressOfNames = peBase.getRVAFromSectionOffset(peExportSection, iNamesOffset);
+		peDirectory.iAddressOfNameOrdinals = peBase.getRVAFromSectionOffset(peExportSection, iNameOrdinalsOffset);
+
+		// DLL name (strings are already copied from the staging buffer)
+		peDirectory.iName = peBase.getRVAFromSectionOffset(peExportSection, iStringPos);
+		iStringPos += static_cast<uint32_t>(peExportInfo.getNameView().length() + 1 /* nullbyte */);
+
+		memcpy(pData + iDirectoryOffset, &peDirectory, sizeof(IMAGE_EXPORT_DIRECTORY));
+
+		// AddressOfNames & AddressOfNameOrdinals (name order) with the function names
+		for (uint32_t i = 0; i < iNumberOfNames; i++)
+		{
+			const PEExportedFunction& func = peExports[vNamedExports[i]];
 
+			uint32_t iNameRVA = peBase.getRVAFromSectionOffset(peExportSection, iStringPos);
+			uint16_t iNameOrdinal = static_cast<uint16_t>(func.getOrdinal() - peOrdinalLimits.first);
 
-// Helper export functions
-// Returns pair: <ordinal base for supplied functions; maximum ordinal value for supplied functions>
-const std::pair<uint16_t, uint16_t>			getExportedOrdinalLimits(const PEEXPORTED_FUNCTION_LIST& peExports);
+			memcpy(pData + iNamesOffset + i * sizeof(uint32_t), &iNameRVA, sizeof(uint32_t));
+			memcpy(pData + iNameOrdinalsOffset + i * sizeof(uint16_t), &iNameOrdinal, sizeof(uint16_t));
 
-// Checks if exported function name already exists
-bool										doesExportedNameExists(const std::string& sFunctionName, const PEEXPORTED_FUNCTION_LIST& peExports);
+			iStringPos += static_cast<uint32_t>(func.getNameView().length() + 1 /* nullbyte */);
+		}
+
+		// AddressOfFunctions (ordinal order, gaps stay zero) with the forwarded names
+		for (uint32_t iIndex = 0; iIndex < iNumberOfFunctions; iIndex++)
+		{
+			if (vFunctionExports[iIndex] == NO_EXPORT)
+				continue;
+
+			const PEExportedFunction& func = peExports[vFunctionExports[iIndex]];
+
+			uint32_t iRVA = func.getRVA();
+			if (func.isForwarded())
+			{
+				// Forwarded function RVA points to its forwarded name inside of the directory
+				iRVA = peBase.getRVAFromSectionOffset(peExportSection, iStringPos);
+				iStringPos += static_cast<uint32_t>(func.getForwardedNameView().length() + 1 /* nullbyte */);
+			}
 
-// Checks if exported function ordinal already exists
-bool										doesExportedOrdinalExists(uint16_t iOrdinal, const PEEXPORTED_FUNCTION_LIST& peExports);
+			memcpy(pData + iFunctionsOffset + iIndex * sizeof(uint32_t), &iRVA, sizeof(uint32_t));
+		}
+
+		// Adjust Section raw & virtual sizes
+		peBase.recalculateSectionSizes(peExportSection, bAutoStripLastSection);
 
+		// Return information about rebuilt Export Directory
+		PEImageDirectory peImageDirectory(peBase.getRVAFromSectionOffset(peExportSection, iDirectoryOffset), iEndOffset - iDirectoryOffset);
+
+		// If auto-rewrite of PE headers is required
+		if (bSaveToPEHeaders)
+		{
+			peBase.setDirectoryRVA(IMAGE_DIRECTORY_ENTRY_EXPORT, peImageDirectory.getRVA());
+			peBase.setDirectorySize(IMAGE_DIRECTORY_ENTRY_EXPORT, peImageDirectory.getSize());
+		}
+
+		return peImageDirectory;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "OpenPEForwarderResolver.h"
+
+namespace OpenPE
+{
+	// Index of libraries which are not in the corpus
+	static const uint32_t NO_MODULE = static_cast<uint32_t>(-1);
+
+	// Constructor
+	PEForwarderResolver::PEForwarderResolver(const PEModuleCorpus& peCorpus)
+		: m_peCorpus(peCorpus)
+		, m_iNumberOfCachedExports(0)
+	{
+		clear();
+	}
+
+	// Returns the corpus
+	const PEModuleCorpus& PEForwarderResolver::getCorpus() const
+	{
+		return m_peCorpus;
+	}
+
+	// Follows forwarders of peExport exported by pModule (same contract as PEModuleCorpus::followForwarders)
+	PEExportResolution PEForwarderResolver::followForwarders(const PEModuleExports*& pModule, PEExportEntry& peExport, uint32_t* pNumberOfForwarders)
+	{
+		if (NOT peExport.isForwarded())
+		{
+			if (pNumberOfForwarders)
+				*pNumberOfForwarders = 0;
+
+			return PE_EXPORT_RESOLVED;
+		}
+
+		// Libraries which are not in the corpus can't be memoized
+		uint32_t iModule = getModuleIndex(pModule);
+		if (iModule == NO_MODULE)
+			return m_peCorpus.followForwarders(pModule, peExport, pNumberOfForwarders);
+
+		const PEModuleExports* pCurrentModule = pModule;
+		PEExportEntry peCurrentExport = peExport;
+		uint32_t iIndex = peCurrentExport.getOrdinal() - pCurrentModule->getOrdinalBase();
+
+		// Walk the chain till a memoized or not forwarded function (or an error)
+		PEExportResolution eResolution = PE_EXPORT_RESOLVED;
+		uint32_t iFinalModule = NO_MODULE;
+		uint32_t iFinalIndex = 0;
+		uint32_t iNumberOfForwarders = 0;
+
+		m_vChain.clear();
+		for (;;)
+		{
+			PEResolvedForwarder& peEntry = getCacheEntry(iModule, iIndex);
+			if (peEntry.m_eState == PE_FORWARDER_DONE)
+			{
+				eResolution = static_cast<PEExportResolution>(peEntry.m_eResolution);
+				iFinalModule = peEntry.m_iModule;
+				iFinalIndex = peEntry.m_iIndex;
+				iNumberOfForwarders = peEntry.m_iNumberOfForwarders;
+				break;
+			}
+
+			if (peEntry.m_eState == PE_FORWARDER_IN_PROGRESS)
+			{
+				eResolution = PE_EXPORT_FORWARDER_LOOP;
+				break;
+			}
+
+			if (NOT peCurrentExport.isForwarded())
+			{
+				iFinalModule = iModule;
+				iFinalIndex = iIndex;
+				break;
+			}
+
+			peEntry.m_eState = PE_FORWARDER_IN_PROGRESS;
+			m_vChain.push_back(std::make_pair(iModule, iIndex));
+
+			eResolution = m_peCorpus.findForwardedExport(peCurrentExport.getForwardedName(), pCurrentModule, peCurrentExport);
+			if (eResolution NOT_EQUAL_TO PE_EXPORT_RESOLVED)
+				break;
+
+			iModule = getModuleIndex(pCurrentModule);
+			iIndex = peCurrentExport.getOrdinal() - pCurrentModule->getOrdinalBase();
+		}
+
+		// Memoize every function of the chain (the last one is one forwarder away from the result)
+		for (size_t i = m_vChain.size(); i-- > 0; )
+		{
+			PEResolvedForwarder& peEntry = getCacheEntry(m_vChain[i].first, m_vChain[i].second);
+			peEntry.m_eState = PE_FORWARDER_DONE;
+			peEntry.m_eResolution = static_cast<uint8_t>(eResolution);
+			peEntry.m_iModule = iFinalModule;
+			peEntry.m_iIndex = iFinalIndex;
+			peEntry.m_iNumberOfForwarders = ++iNumberOfForwarders;
+		}
+
+		m_iNumberOfCachedExports += m_vChain.size();
+
+		if (eResolution NOT_EQUAL_TO PE_EXPORT_RESOLVED)
+			return eResolution;
+
+		// Set the result only on success (as PEModuleCorpus::followForwarders)
+		pModule = &m_peCorpus.getModuleList()[iFinalModule];
+		pModule->findExport(static_cast<uint16_t>(pModule->getOrdinalBase() + iFinalIndex), peExport);
+
+		if (pNumberOfForwarders)
+			*pNumberOfForwarders = iNumberOfForwarders;
+
+		return PE_EXPORT_RESOLVED;
+	}
+
+	// Follows forwarders of all exports of all libraries of the corpus, returns number of forwarded exports which didn't resolve
+	size_t PEForwarderResolver::resolveAllExports()
+	{
+		size_t iNumberOfUnresolved = 0;
+
+		const PEModuleCorpus::MODULE_LIST& vModules = m_peCorpus.getModuleList();
+		for (PEModuleCorpus::MODULE_LIST::const_iterator itr = vModules.begin(); itr != vModules.end(); ++itr)
+		{
+			for (uint32_t iIndex = 0; iIndex < itr->getNumberOfFunctions(); iIndex++)
+			{
+				PEExportEntry peExport;
+				if (NOT itr->findExport(static_cast<uint16_t>(itr->getOrdinalBase() + iIndex), peExport) || NOT peExport.isForwarded())
+					continue;
+
+				const PEModuleExports* pModule = &*itr;
+				if (followForwarders(pModule, peExport) NOT_EQUAL_TO PE_EXPORT_RESOLVED)
+					iNumberOfUnresolved++;
+			}
+		}
+
+		return iNumberOfUnresolved;
+	}
+
+	// Returns number of memoized functions (functions of followed chains)
+	size_t PEForwarderResolver::getNumberOfCachedExports() const
+	{
+		return m_iNumberOfCachedExports;
+	}
+
+	// Drops all memoized chains
+	void PEForwarderResolver::clear()
+	{
+		m_vCache.clear();
+		m_vCache.resize(m_peCorpus.getNumberOfModules());
+		m_iNumberOfCachedExports = 0;
+	}
+
+	// Returns memoized function at index of AddressOfFunctions of the library (allocates the table of the library on first use)
+	PEForwarderResolver::PEResolvedForwarder& PEForwarderResolver::getCacheEntry(uint32_t iModule, uint32_t iIndex)
+	{
+		// Libraries added to the corpus after clear()
+		if (iModule >= m_vCache.size())
+			m_vCache.resize(m_peCorpus.getNumberOfModules());
+
+		std::vector<PEResolvedForwarder>& vModuleCache = m_vCache[iModule];
+		if (vModuleCache.empty())
+		{
+			PEResolvedForwarder peEmpty;
+			peEmpty.m_eState = PE_FORWARDER_UNKNOWN;
+			peEmpty.m_eResolution = PE_EXPORT_RESOLVED;
+			peEmpty.m_iModule = NO_MODULE;
+			peEmpty.m_iIndex = 0;
+			peEmpty.m_iNumberOfForwarders = 0;
+
+			vModuleCache.assign(m_peCorpus.getModuleList()[iModule].getNumberOfFunctions(), peEmpty);
+		}
+
+		return vModuleCache[iIndex];
+	}
+
+	// Returns index of the library in the corpus module list, or NO_MODULE if the library is not in the corpus
+	uint32_t PEForwarderResolver::getModuleIndex(const PEModuleExports* pModule) const
+	{
+		const PEModuleCorpus::MODULE_LIST& vModules = m_peCorpus.getModuleList();
+		if (vModules.empty() || pModule < &vModules.front() || pModule > &vModules.back())
+			return NO_MODULE;
+
+		return static_cast<uint32_t>(pModule - &vModules.front());
+	}
+}
\ No newline at end of file
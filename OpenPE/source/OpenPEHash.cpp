@@ -0,0 +1,322 @@
+#include "OpenPEHash.h"
+#include <string.h>
+
+namespace OpenPE
+{
+	// Helper: rotates 32-bit value left
+	static inline uint32_t rotateLeft(uint32_t iValue, uint32_t iBits)
+	{
+		return (iValue << iBits) | (iValue >> (32 - iBits));
+	}
+
+	// Helper: rotates 32-bit value right
+	static inline uint32_t rotateRight(uint32_t iValue, uint32_t iBits)
+	{
+		return (iValue >> iBits) | (iValue << (32 - iBits));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// MD5 per-round shift amounts
+	static const uint32_t MD5_SHIFTS[64] =
+	{
+		7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+		5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+		4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+		6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+	};
+
+	// MD5 constants (integer part of abs(sin(i + 1)) * 2^32)
+	static const uint32_t MD5_CONSTANTS[64] =
+	{
+		0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+		0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+		0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+		0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+		0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+		0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+		0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+		0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+	};
+
+	// Default Constructor
+	PEMD5::PEMD5()
+	{
+		reset();
+	}
+
+	// Restarts the digest
+	void PEMD5::reset()
+	{
+		m_State[0] = 0x67452301;
+		m_State[1] = 0xefcdab89;
+		m_State[2] = 0x98badcfe;
+		m_State[3] = 0x10325476;
+
+		m_iLength = 0;
+		m_iBufferLength = 0;
+	}
+
+	// Feeds iLength bytes of data
+	void PEMD5::update(const void* pData, size_t iLength)
+	{
+		const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+		m_iLength += iLength;
+
+		// Fill partially filled block first
+		if (m_iBufferLength)
+		{
+			size_t iCopy = sizeof(m_Buffer) - m_iBufferLength;
+			if (iCopy > iLength)
+				iCopy = iLength;
+
+			memcpy(m_Buffer + m_iBufferLength, pBytes, iCopy);
+			m_iBufferLength += static_cast<uint32_t>(iCopy);
+			pBytes += iCopy;
+			iLength -= iCopy;
+
+			if (m_iBufferLength < sizeof(m_Buffer))
+				return;
+
+			transform(m_Buffer);
+			m_iBufferLength = 0;
+		}
+
+		// Process whole blocks directly from the input
+		for (; iLength >= sizeof(m_Buffer); pBytes += sizeof(m_Buffer), iLength -= sizeof(m_Buffer))
+			transform(pBytes);
+
+		memcpy(m_Buffer, pBytes, iLength);
+		m_iBufferLength = static_cast<uint32_t>(iLength);
+	}
+
+	// Finishes the digest & writes DIGEST_SIZE bytes to pDigest
+	void PEMD5::finalize(uint8_t* pDigest)
+	{
+		uint64_t iBitLength = m_iLength * 8;
+
+		// Padding: 0x80, zeros up to 56 mod 64, then little-endian bit length
+		static const uint8_t PADDING[64] = { 0x80 };
+		update(PADDING, (m_iBufferLength < 56) ? (56 - m_iBufferLength) : (120 - m_iBufferLength));
+
+		uint8_t iLengthBytes[8];
+		for (int i = 0; i < 8; i++)
+			iLengthBytes[i] = static_cast<uint8_t>(iBitLength >> (8 * i));
+		update(iLengthBytes, sizeof(iLengthBytes));
+
+		for (int i = 0; i < 4; i++)
+		{
+			pDigest[i * 4 + 0] = static_cast<uint8_t>(m_State[i]);
+			pDigest[i * 4 + 1] = static_cast<uint8_t>(m_State[i] >> 8);
+			pDigest[i * 4 + 2] = static_cast<uint8_t>(m_State[i] >> 16);
+			pDigest[i * 4 + 3] = static_cast<uint8_t>(m_State[i] >> 24);
+		}
+	}
+
+	// Processes one 64-byte block
+	void PEMD5::transform(const uint8_t* pBlock)
+	{
+		uint32_t M[16];
+		for (int i = 0; i < 16; i++)
+		{
+			M[i] =	static_cast<uint32_t>(pBlock[i * 4])
+					| (static_cast<uint32_t>(pBlock[i * 4 + 1]) << 8)
+					| (static_cast<uint32_t>(pBlock[i * 4 + 2]) << 16)
+					| (static_cast<uint32_t>(pBlock[i * 4 + 3]) << 24);
+		}
+
+		uint32_t A = m_State[0], B = m_State[1], C = m_State[2], D = m_State[3];
+		for (uint32_t i = 0; i < 64; i++)
+		{
+			uint32_t F, g;
+			if (i < 16)
+			{
+				F = (B & C) | (~B & D);
+				g = i;
+			}
+			else if (i < 32)
+			{
+				F = (D & B) | (~D & C);
+				g = (5 * i + 1) & 15;
+			}
+			else if (i < 48)
+			{
+				F = B ^ C ^ D;
+				g = (3 * i + 5) & 15;
+			}
+			else
+			{
+				F = C ^ (B | ~D);
+				g = (7 * i) & 15;
+			}
+
+			F += A + MD5_CONSTANTS[i] + M[g];
+			A = D;
+			D = C;
+			C = B;
+			B += rotateLeft(F, MD5_SHIFTS[i]);
+		}
+
+		m_State[0] += A;
+		m_State[1] += B;
+		m_State[2] += C;
+		m_State[3] += D;
+	}
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// SHA-256 round constants (first 32 bits of the fractional parts of the cube roots of the first 64 primes)
+	static const uint32_t SHA256_CONSTANTS[64] =
+	{
+		0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+		0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+		0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+		0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+		0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+		0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+		0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+		0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+	};
+
+	// Default Constructor
+	PESHA256::PESHA256()
+	{
+		reset();
+	}
+
+	// Restarts the digest
+	void PESHA256::reset()
+	{
+		m_State[0] = 0x6a09e667;
+		m_State[1] = 0xbb67ae85;
+		m_State[2] = 0x3c6ef372;
+		m_State[3] = 0xa54ff53a;
+		m_State[4] = 0x510e527f;
+		m_State[5] = 0x9b05688c;
+		m_State[6] = 0x1f83d9ab;
+		m_State[7] = 0x5be0cd19;
+
+		m_iLength = 0;
+		m_iBufferLength = 0;
+	}
+
+	// Feeds iLength bytes of data
+	void PESHA256::update(const void* pData, size_t iLength)
+	{
+		const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+		m_iLength += iLength;
+
+		// Fill partially filled block first
+		if (m_iBufferLength)
+		{
+			size_t iCopy = sizeof(m_Buffer) - m_iBufferLength;
+			if (iCopy > iLength)
+				iCopy = iLength;
+
+			memcpy(m_Buffer + m_iBufferLength, pBytes, iCopy);
+			m_iBufferLength += static_cast<uint32_t>(iCopy);
+			pBytes += iCopy;
+			iLength -= iCopy;
+
+			if (m_iBufferLength < sizeof(m_Buffer))
+				return;
+
+			transform(m_Buffer);
+			m_iBufferLength = 0;
+		}
+
+		// Process whole blocks directly from the input
+		for (; iLength >= sizeof(m_Buffer); pBytes += sizeof(m_Buffer), iLength -= sizeof(m_Buffer))
+			transform(pBytes);
+
+		memcpy(m_Buffer, pBytes, iLength);
+		m_iBufferLength = static_cast<uint32_t>(iLength);
+	}
+
+	// Finishes the digest & writes DIGEST_SIZE bytes to pDigest
+	void PESHA256::finalize(uint8_t* pDigest)
+	{
+		uint64_t iBitLength = m_iLength * 8;
+
+		// Padding: 0x80, zeros up to 56 mod 64, then big-endian bit length
+		static const uint8_t PADDING[64] = { 0x80 };
+		update(PADDING, (m_iBufferLength < 56) ? (56 - m_iBufferLength) : (120 - m_iBufferLength));
+
+		uint8_t iLengthBytes[8];
+		for (int i = 0; i < 8; i++)
+			iLengthBytes[i] = static_cast<uint8_t>(iBitLength >> (56 - 8 * i));
+		update(iLengthBytes, sizeof(iLengthBytes));
+
+		for (int i = 0; i < 8; i++)
+		{
+			pDigest[i * 4 + 0] = static_cast<uint8_t>(m_State[i] >> 24);
+			pDigest[i * 4 + 1] = static_cast<uint8_t>(m_State[i] >> 16);
+			pDigest[i * 4 + 2] = static_cast<uint8_t>(m_State[i] >> 8);
+			pDigest[i * 4 + 3] = static_cast<uint8_t>(m_State[i]);
+		}
+	}
+
+	// Processes one 64-byte block
+	void PESHA256::transform(const uint8_t* pBlock)
+	{
+		uint32_t W[64];
+		for (int i = 0; i < 16; i++)
+		{
+			W[i] =	(static_cast<uint32_t>(pBlock[i * 4]) << 24)
+					| (static_cast<uint32_t>(pBlock[i * 4 + 1]) << 16)
+					| (static_cast<uint32_t>(pBlock[i * 4 + 2]) << 8)
+					| static_cast<uint32_t>(pBlock[i * 4 + 3]);
+		}
+
+		for (int i = 16; i < 64; i++)
+		{
+			uint32_t s0 = rotateRight(W[i - 15], 7) ^ rotateRight(W[i - 15], 18) ^ (W[i - 15] >> 3);
+			uint32_t s1 = rotateRight(W[i - 2], 17) ^ rotateRight(W[i - 2], 19) ^ (W[i - 2] >> 10);
+			W[i] = W[i - 16] + s0 + W[i - 7] + s1;
+		}
+
+		uint32_t A = m_State[0], B = m_State[1], C = m_State[2], D = m_State[3];
+		uint32_t E = m_State[4], F = m_State[5], G = m_State[6], H = m_State[7];
+		for (int i = 0; i < 64; i++)
+		{
+			uint32_t S1 = rotateRight(E, 6) ^ rotateRight(E, 11) ^ rotateRight(E, 25);
+			uint32_t ch = (E & F) ^ (~E & G);
+			uint32_t temp1 = H + S1 + ch + SHA256_CONSTANTS[i] + W[i];
+			uint32_t S0 = rotateRight(A, 2) ^ rotateRight(A, 13) ^ rotateRight(A, 22);
+			uint32_t maj = (A & B) ^ (A & C) ^ (B & C);
+			uint32_t temp2 = S0 + maj;
+
+			H = G;
+			G = F;
+			F = E;
+			E = D + temp1;
+			D = C;
+			C = B;
+			B = A;
+			A = temp1 + temp2;
+		}
+
+		m_State[0] += A;
+		m_State[1] += B;
+		m_State[2] += C;
+		m_State[3] += D;
+		m_State[4] += E;
+		m_State[5] += F;
+		m_State[6] += G;
+		m_State[7] += H;
+	}
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	// Writes iLength bytes as lowercase hex digits followed by null-terminator to pString (2 * iLength + 1 chars)
+	void digestToHexString(const uint8_t* pDigest, size_t iLength, char* pString)
+	{
+		static const char HEX_DIGITS[] = "0123456789abcdef";
+
+		for (size_t i = 0; i < iLength; i++)
+		{
+			pString[i * 2] = HEX_DIGITS[pDigest[i] >> 4];
+			pString[i * 2 + 1] = HEX_DIGITS[pDigest[i] & 0x0f];
+		}
+
+		pString[iLength * 2] = 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,257 @@
+#include "OpenPEImportResolver.h"
+
+namespace OpenPE
+{
+	// Default Constructor
+	PEResolvedImport::PEResolvedImport()
+		: m_iOrdinal(0)
+		, m_eStatus(PE_EXPORT_MODULE_NOT_FOUND)
+		, m_iNumberOfForwarders(0)
+		, m_pModule(0)
+		, m_iExportOrdinal(0)
+		, m_iRVA(0)
+	{
+	}
+
+	// Returns name of the library the function is imported from
+	const PEStringView& PEResolvedImport::getLibraryName() const
+	{
+		return m_vLibraryName;
+	}
+
+	// Returns true if function is imported by name
+	bool PEResolvedImport::hasName() const
+	{
+		return NOT m_vName.empty();
+	}
+
+	// Returns name of imported function
+	const PEStringView& PEResolvedImport::getName() const
+	{
+		return m_vName;
+	}
+
+	// Returns ordinal of imported function (if imported by ordinal)
+	uint16_t PEResolvedImport::getOrdinal() const
+	{
+		return m_iOrdinal;
+	}
+
+	// Returns result of the resolution
+	PEExportResolution PEResolvedImport::getStatus() const
+	{
+		return m_eStatus;
+	}
+
+	// Returns true if the function was found (following all of its forwarders)
+	bool PEResolvedImport::isResolved() const
+	{
+		return m_eStatus == PE_EXPORT_RESOLVED;
+	}
+
+	// Returns true if the library forwards the function to other library
+	bool PEResolvedImport::isForwarded() const
+	{
+		return NOT m_vForwardedName.empty();
+	}
+
+	// Returns number of forwarders followed
+	uint32_t PEResolvedImport::getNumberOfForwarders() const
+	{
+		return m_iNumberOfForwarders;
+	}
+
+	// Returns the forwarder of the imported library, empty if not forwarded
+	const PEStringView& PEResolvedImport::getForwardedName() const
+	{
+		return m_vForwardedName;
+	}
+
+	// Returns the library that implements the function (0, if not resolved)
+	const PEModuleExports* PEResolvedImport::getModule() const
+	{
+		return m_pModule;
+	}
+
+	// Returns export ordinal of the function in the implementing library
+	uint16_t PEResolvedImport::getExportOrdinal() const
+	{
+		return m_iExportOrdinal;
+	}
+
+	// Returns RVA of the function in the implementing library
+	uint32_t PEResolvedImport::getRVA() const
+	{
+		return m_iRVA;
+	}
+
+	// Returns VA of the function (preferred Image base of the implementing library + RVA)
+	uint64_t PEResolvedImport::getVA() const
+	{
+		return m_pModule ? m_pModule->getImageBase() + m_iRVA : 0;
+	}
+
+	// Constructor
+	PEImportResolver::PEImportResolver(const PEModuleCorpus& peCorpus)
+		: m_peCorpus(peCorpus)
+		, m_pForwarders(0)
+	{
+	}
+
+	// Constructor, forwarders are followed through the memoizing peForwarders (which may be shared by several resolvers)
+	PEImportResolver::PEImportResolver(PEForwarderResolver& peForwarders)
+		: m_peCorpus(peForwarders.getCorpus())
+		, m_pForwarders(&peForwarders)
+	{
+	}
+
+	// Returns the corpus
+	const PEModuleCorpus& PEImportResolver::getCorpus() const
+	{
+		return m_peCorpus;
+	}
+
+	// Resolves a single function imported from the library
+	PEExportResolution PEImportResolver::resolveImport(const PEStringView& sLibraryName, const PEImportedFunction& peFunction, PEResolvedImport& peResult) const
+	{
+		peResult = PEResolvedImport();
+		peResult.m_vLibraryName = sLibraryName;
+		if (peFunction.hasName())
+			peResult.m_vName = peFunction.getNameView();
+		else
+			peResult.m_iOrdinal = peFunction.getOrdinal();
+
+		resolveFunction(m_peCorpus.findModule(sLibraryName), peResult);
+
+		return peResult.m_eStatus;
+	}
+
+	// Resolves all functions of the list (in the order of the list), returns number of unresolved functions
+	size_t PEImportResolver::resolveImports(const PEIMPORTED_FUNCTIONS_LIST& vImports, PERESOLVED_IMPORT_LIST& vResults) const
+	{
+		size_t iNumberOfFunctions = 0;
+		for (PEIMPORTED_FUNCTIONS_LIST::const_iterator itr = vImports.begin(); itr != vImports.end(); ++itr)
+			iNumberOfFunctions += itr->getImportedFunctionList().size();
+
+		vResults.clear();
+		vResults.resize(iNumberOfFunctions);
+
+		size_t iNumberOfUnresolved = 0;
+		PERESOLVED_IMPORT_LIST::iterator itrResult = vResults.begin();
+		for (PEIMPORTED_FUNCTIONS_LIST::const_iterator itr = vImports.begin(); itr != vImports.end(); ++itr)
+		{
+			const PEStringView sLibraryName = itr->getNameView();
+			const PEModuleExports* pLibrary = m_peCorpus.findModule(sLibraryName);
+
+			const PEImportLibrary::IMPORTED_LIST& vFunctions = itr->getImportedFunctionList();
+			for (PEImportLibrary::IMPORTED_LIST::const_iterator itrFunction = vFunctions.begin(); itrFunction != vFunctions.end(); ++itrFunction, ++itrResult)
+			{
+				itrResult->m_vLibraryName = sLibraryName;
+				if (itrFunction->hasName())
+					itrResult->m_vName = itrFunction->getNameView();
+				else
+					itrResult->m_iOrdinal = itrFunction->getOrdinal();
+
+				resolveFunction(pLibrary, *itrResult);
+				if (NOT itrResult->isResolved())
+					iNumberOfUnresolved++;
+			}
+		}
+
+		return iNumberOfUnresolved;
+	}
+
+	// Resolves all functions imported by the Image without building the import list, returns number of unresolved functions
+	size_t PEImportResolver::resolveImports(const PEBase& peBase, PERESOLVED_IMPORT_LIST& vResults) const
+	{
+		// Thunks are walked once & appended, a reused list keeps its capacity
+		vResults.clear();
+
+		// If image has no imports, return empty array
+		if (NOT peBase.hasImports())
+			return 0;
+
+		size_t iNumberOfUnresolved = 0;
+
+		PEImportDescriptorRange peDescriptors(peBase);
+		for (PEImportDescriptorRange::const_iterator itr = peDescriptors.begin(); itr != peDescriptors.end(); ++itr)
+		{
+			const PEModuleExports* pLibrary = m_peCorpus.findModule(itr->getName());
+
+			const PEImportThunkRange peThunks = itr->getThunks();
+			for (PEImportThunkRange::const_iterator itrThunk = peThunks.begin(); itrThunk != peThunks.end(); ++itrThunk)
+			{
+				vResults.push_back(PEResolvedImport());
+				PEResolvedImport& peResult = vResults.back();
+
+				peResult.m_vLibraryName = itr->getName();
+				if (itrThunk->hasName())
+					peResult.m_vName = itrThunk->getName();
+				else
+					peResult.m_iOrdinal = itrThunk->getOrdinal();
+
+				resolveFunction(pLibrary, peResult);
+				if (NOT peResult.isResolved())
+					iNumberOfUnresolved++;
+			}
+		}
+
+		return iNumberOfUnresolved;
+	}
+
+	// Resolves imports of iNumberOfImages Images, pResults receives a list per Image
+	size_t PEImportResolver::resolveImports(const PEBase* const* pImages, size_t iNumberOfImages, PERESOLVED_IMPORT_LIST* pResults) const
+	{
+		size_t iNumberOfUnresolved = 0;
+
+		for (size_t i = 0; i < iNumberOfImages; i++)
+		{
+			try
+			{
+				iNumberOfUnresolved += resolveImports(*pImages[i], pResults[i]);
+			}
+			catch (const PEException&)
+			{
+				pResults[i].clear();
+			}
+		}
+
+		return iNumberOfUnresolved;
+	}
+
+	// Resolves the function (name or ordinal are already set in peResult) exported by pLibrary
+	void PEImportResolver::resolveFunction(const PEModuleExports* pLibrary, PEResolvedImport& peResult) const
+	{
+		if (NOT pLibrary)
+		{
+			peResult.m_eStatus = PE_EXPORT_MODULE_NOT_FOUND;
+			return;
+		}
+
+		PEExportEntry peExport;
+		bool bFound = peResult.hasName()
+						?
+						pLibrary->findExport(peResult.m_vName, peExport)
+						:
+						pLibrary->findExport(peResult.m_iOrdinal, peExport);
+
+		if (NOT bFound)
+		{
+			peResult.m_eStatus = PE_EXPORT_FUNCTION_NOT_FOUND;
+			return;
+		}
+
+		peResult.m_vForwardedName = peExport.getForwardedName();
+		peResult.m_eStatus = m_pForwarders
+								?
+								m_pForwarders->followForwarders(pLibrary, peExport, &peResult.m_iNumberOfForwarders)
+								:
+								m_peCorpus.followForwarders(pLibrary, peExport, &peResult.m_iNumberOfForwarders);
+		if (peResult.m_eStatus NOT_EQUAL_TO PE_EXPORT_RESOLVED)
+			return;
+
+		peResult.m_pModule = pLibrary;
+		peResult.m_iExportOrdinal = peExport.getOrdinal();
+		peResult.m_iRVA = peExport.getRVA();
+	}
+}
\ No newline at end of file
@@ -1,11 +1,14 @@
 #include "OpenPEImports.h"
 #include "OpenPEPropertiesGeneric.h"
+#include "OpenPEDataCursor.h"
+#include <string.h>
 
 namespace OpenPE
 {
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	PEImportedFunction::PEImportedFunction()
-		: m_iHint(0)
+		: m_iNameSymbol(PE_NO_SYMBOL)
+		, m_iHint(0)
 		, m_iOrdinal(0)
 		, m_iIAT_VA(0)
 	{
@@ -15,13 +18,25 @@ namespace OpenPE
 	// Returns 'true' if imported function has 'Name' (& Hint)
 	bool PEImportedFunction::hasName() const
 	{
-		return NOT m_sName.empty();
+		return NOT getName().empty();
+	}
+
+	// Returns 'Name' of the function (owned by the record, or references Image memory or the global intern table, see PENameStorage)
+	const PEStringView PEImportedFunction::getName() const
+	{
+		return m_sName.empty() ? m_vName : PEStringView(m_sName);
 	}
 
-	// Returns 'Name' of the function
-	const std::string& PEImportedFunction::getName() const
+	// Returns 'Name' of the function (same as getName())
+	const PEStringView PEImportedFunction::getNameView() const
 	{
-		return m_sName;
+		return getName();
+	}
+
+	// Returns symbol of 'Name' in the global intern table (PE_NO_SYMBOL if the name is not interned)
+	PESymbolID PEImportedFunction::getNameSymbol() const
+	{
+		return m_iNameSymbol;
 	}
 
 	// Returns 'Hint'
@@ -44,10 +59,28 @@ namespace OpenPE
 
 	// Setters do not change everything inside image, they are used by PE class
 	// You also can use them to rebuild image imports
-	// Sets 'Name' of function
-	void PEImportedFunction::setName(const std::string& sName)
+	// Sets 'Name' of function (the name is copied into the record)
+	void PEImportedFunction::setName(const PEStringView& sName)
 	{
-		m_sName = sName;
+		m_sName.assign(sName.data(), sName.length());
+		m_vName = PEStringView();
+		m_iNameSymbol = PE_NO_SYMBOL;
+	}
+
+	// Sets 'Name' of function as a reference to memory owned by someone else (e.g. Image Section data)
+	void PEImportedFunction::setNameView(const PEStringView& vName)
+	{
+		m_sName.clear();
+		m_vName = vName;
+		m_iNameSymbol = PE_NO_SYMBOL;
+	}
+
+	// Sets 'Name' of function as a symbol of the global intern table
+	void PEImportedFunction::setNameSymbol(PESymbolID iSymbol)
+	{
+		m_sName.clear();
+		m_vName = PEInternTable::getGlobal().getName(iSymbol);
+		m_iNameSymbol = iSymbol;
 	}
 
 	// Sets 'Hint'
@@ -72,17 +105,30 @@ namespace OpenPE
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	// Default Constructor
 	PEImportLibrary::PEImportLibrary()
-		: m_iRVAToIAT(0)
+		: m_iNameSymbol(PE_NO_SYMBOL)
+		, m_iRVAToIAT(0)
 		, m_iRVAToOriginalIAT(0)
 		, m_iTimeStamp(0)
 	{
 
 	}
 
-	// Returns 'Name' of the Library
-	const std::string& PEImportLibrary::getName() const
+	// Returns 'Name' of the Library (owned by the record, or references Image memory or the global intern table, see PENameStorage)
+	const PEStringView PEImportLibrary::getName() const
 	{
-		return m_sName;
+		return m_sName.empty() ? m_vName : PEStringView(m_sName);
+	}
+
+	// Returns 'Name' of the Library (same as getName())
+	const PEStringView PEImportLibrary::getNameView() const
+	{
+		return getName();
+	}
+
+	// Returns symbol of 'Name' in the global intern table (PE_NO_SYMBOL if the name is not interned)
+	PESymbolID PEImportLibrary::getNameSymbol() const
+	{
+		return m_iNameSymbol;
 	}
 
 	// Returns RVA to Import Address Table(IAT)
@@ -111,10 +157,28 @@ namespace OpenPE
 
 	// Setters do not change everything inside image, they are used by PE class
 	// You also can use them to rebuild image imports
-	// Sets 'Name' of the Library
-	void PEImportLibrary::setName(const std::string& sName)
+	// Sets 'Name' of the Library (the name is copied into the record)
+	void PEImportLibrary::setName(const PEStringView& sName)
+	{
+		m_sName.assign(sName.data(), sName.length());
+		m_vName = PEStringView();
+		m_iNameSymbol = PE_NO_SYMBOL;
+	}
+
+	// Sets 'Name' of the Library as a reference to memory owned by someone else (e.g. Image Section data)
+	void PEImportLibrary::setNameView(const PEStringView& vName)
 	{
-		m_sName = sName;
+		m_sName.clear();
+		m_vName = vName;
+		m_iNameSymbol = PE_NO_SYMBOL;
+	}
+
+	// Sets 'Name' of the Library as a symbol of the global intern table
+	void PEImportLibrary::setNameSymbol(PESymbolID iSymbol)
+	{
+		m_sName.clear();
+		m_vName = PEInternTable::getGlobal().getName(iSymbol);
+		m_iNameSymbol = iSymbol;
 	}
 
 	// Sets RVA to Import Address Table(IAT)
@@ -146,6 +210,12 @@ namespace OpenPE
 	{
 		m_vImportedFunctionList.clear();
 	}
+
+	// Reserves space for 'Imported' functions
+	void PEImportLibrary::reserveImports(size_t iCount)
+	{
+		m_vImportedFunctionList.reserve(iCount);
+	}
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -273,19 +343,539 @@ namespace OpenPE
 	}
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	const PEIMPORTED_FUNCTIONS_LIST	getImportedFunctionsList(const PEBase& peBase)
+	// Index of end iterators
+	static const uint32_t ITERATOR_END = static_cast<uint32_t>(-1);
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor
+	PEImportThunk::PEImportThunk()
+		: m_iHint(0)
+		, m_iOrdinal(0)
+		, m_bByOrdinal(false)
+		, m_iIAT_VA(0)
+		, m_iRVAOfIATEntry(0)
+		, m_iIndex(0)
+	{
+	}
+
+	// Returns 'true' if function is imported by ordinal
+	bool PEImportThunk::isImportedByOrdinal() const
+	{
+		return m_bByOrdinal;
+	}
+
+	// Returns 'true' if function is imported by 'Name' (& Hint)
+	bool PEImportThunk::hasName() const
+	{
+		return NOT m_bByOrdinal;
+	}
+
+	// Returns 'Name' of the function (references Image memory)
+	const PEStringView& PEImportThunk::getName() const
+	{
+		return m_vName;
+	}
+
+	// Returns 'Hint'
+	uint16_t PEImportThunk::getHint() const
+	{
+		return m_iHint;
+	}
+
+	// Returns 'Ordinal' of the function
+	uint16_t PEImportThunk::getOrdinal() const
+	{
+		return m_iOrdinal;
+	}
+
+	// Returns IAT entry value (VA, if image is bound)
+	uint64_t PEImportThunk::getIAT_VA() const
+	{
+		return m_iIAT_VA;
+	}
+
+	// Returns RVA of the IAT entry of this thunk
+	uint32_t PEImportThunk::getRVAOfIATEntry() const
+	{
+		return m_iRVAOfIATEntry;
+	}
+
+	// Returns index of the thunk inside of its table
+	uint32_t PEImportThunk::getIndex() const
+	{
+		return m_iIndex;
+	}
+
+	// Returns the thunk as PEImportedFunction (name is copied or referenced depending on eNameStorage)
+	const PEImportedFunction PEImportThunk::toImportedFunction(PENameStorage eNameStorage) const
+	{
+		PEImportedFunction func;
+		func.setIAT_VA(m_iIAT_VA);
+
+		if (m_bByOrdinal)
+		{
+			func.setOrdinal(m_iOrdinal);
+		}
+		else
+		{
+			if (eNameStorage == PE_NAME_STORAGE_INTERN)
+				func.setNameSymbol(PEInternTable::getGlobal().intern(m_vName));
+			else if (eNameStorage == PE_NAME_STORAGE_VIEW)
+				func.setNameView(m_vName);
+			else
+				func.setName(m_vName);
+
+			func.setHint(m_iHint);
+		}
+
+		return func;
+	}
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor (end iterator)
+	PEImportThunkRange::const_iterator::const_iterator()
+		: m_pRange(0)
+		, m_iIndex(ITERATOR_END)
+	{
+	}
+
+	PEImportThunkRange::const_iterator::const_iterator(const PEImportThunkRange* pRange, uint32_t iIndex)
+		: m_pRange(pRange)
+		, m_NameCursor(*pRange->m_pPEBase)
+		, m_iIndex(iIndex)
+	{
+		decode();
+	}
+
+	PEImportThunkRange::const_iterator::reference PEImportThunkRange::const_iterator::operator*() const
+	{
+		return m_Thunk;
+	}
+
+	PEImportThunkRange::const_iterator::pointer PEImportThunkRange::const_iterator::operator->() const
+	{
+		return &m_Thunk;
+	}
+
+	PEImportThunkRange::const_iterator& PEImportThunkRange::const_iterator::operator++()
+	{
+		if (m_iIndex NOT_EQUAL_TO ITERATOR_END)
+		{
+			m_iIndex++;
+			decode();
+		}
+
+		return *this;
+	}
+
+	PEImportThunkRange::const_iterator PEImportThunkRange::const_iterator::operator++(int)
+	{
+		const_iterator itr(*this);
+		++(*this);
+
+		return itr;
+	}
+
+	bool PEImportThunkRange::const_iterator::operator==(const const_iterator& other) const
+	{
+		return m_iIndex == other.m_iIndex;
+	}
+
+	bool PEImportThunkRange::const_iterator::operator!=(const const_iterator& other) const
+	{
+		return m_iIndex NOT_EQUAL_TO other.m_iIndex;
+	}
+
+	// Decodes thunk at current index, or turns into end iterator at the terminating thunk
+	void PEImportThunkRange::const_iterator::decode()
+	{
+		const PEImportThunkRange& peRange = *m_pRange;
+
+		// Thunk arrays must be terminated inside of their Sections
+		if (m_iIndex >= peRange.m_iIATCount || m_iIndex >= peRange.m_iLookupCount)
+			throw PEException("Incorrect Import Directory.", PEException::PEEXCEPTION_INCORRECT_IMPORT_DIRECTORY);
+
+		// Get VA from IAT & original IAT
+		uint64_t address = peRange.getThunk(peRange.m_pIAT, m_iIndex);
+		uint64_t lookup = peRange.getThunk(peRange.m_pLookupTable, m_iIndex);
+
+		// Finished with this library (lookup table is the IAT itself when there is no original IAT)
+		if (NOT lookup)
+		{
+			m_iIndex = ITERATOR_END;
+			return;
+		}
+
+		uint32_t iThunkSize = peRange.m_b64BitThunks ? sizeof(uint64_t) : sizeof(uint32_t);
+
+		m_Thunk = PEImportThunk();
+		m_Thunk.m_iIndex = m_iIndex;
+		m_Thunk.m_iIAT_VA = address;
+		m_Thunk.m_iRVAOfIATEntry = peRange.m_iRVAToIAT + m_iIndex * iThunkSize;
+
+		// Check if function is imported by ordinal
+		if ((lookup & (peRange.m_b64BitThunks ? IMAGE_ORDINAL_FLAG64 : IMAGE_ORDINAL_FLAG32)) NOT_EQUAL_TO 0)
+		{
+			m_Thunk.m_bByOrdinal = true;
+			m_Thunk.m_iOrdinal = static_cast<uint16_t>(lookup & 0xffff);
+			return;
+		}
+
+		// Lookup is an RVA (or VA) of IMAGE_IMPORT_BY_NAME: hint followed by null-terminated name
+		if (lookup < peRange.m_iLookupBase || lookup - peRange.m_iLookupBase > static_cast<uint32_t>(-1) - sizeof(uint16_t))
+			throw PEException("Incorrect Import Directory.", PEException::PEEXCEPTION_INCORRECT_IMPORT_DIRECTORY);
+
+		uint32_t iAvailable;
+		const char* pHintName = m_NameCursor.tryGetData(static_cast<uint32_t>(lookup - peRange.m_iLookupBase), iAvailable);
+		if (NOT pHintName || iAvailable < sizeof(uint16_t) + 1)
+			throw PEException("Incorrect Import Directory.", PEException::PEEXCEPTION_INCORRECT_IMPORT_DIRECTORY);
+
+		// Check for null-termination
+		const char* pFuncName = pHintName + sizeof(uint16_t);
+		const char* pFuncNameEnd = static_cast<const char*>(memchr(pFuncName, 0, iAvailable - sizeof(uint16_t)));
+		if (NOT pFuncNameEnd)
+			throw PEException("Incorrect Import Directory.", PEException::PEEXCEPTION_INCORRECT_IMPORT_DIRECTORY);
+
+		// HINT in import table is ORDINAL in export table
+		memcpy(&m_Thunk.m_iHint, pHintName, sizeof(uint16_t));
+		m_Thunk.m_vName = PEStringView(pFuncName, pFuncNameEnd - pFuncName);
+	}
+
+	// Default Constructor (empty range)
+	PEImportThunkRange::PEImportThunkRange()
+		: m_pPEBase(0)
+		, m_pIAT(0)
+		, m_pLookupTable(0)
+		, m_iIATCount(0)
+		, m_iLookupCount(0)
+		, m_iRVAToIAT(0)
+		, m_b64BitThunks(false)
+		, m_iLookupBase(0)
+	{
+	}
+
+	// Constructor from IAT & original IAT RVAs, thunk size is taken from the Image type
+	PEImportThunkRange::PEImportThunkRange(const PEBase& peBase, uint32_t iRVAToIAT, uint32_t iRVAToOriginalIAT)
+		: m_pPEBase(0)
+		, m_pIAT(0)
+		, m_pLookupTable(0)
+		, m_iIATCount(0)
+		, m_iLookupCount(0)
+		, m_iRVAToIAT(0)
+		, m_b64BitThunks(false)
+		, m_iLookupBase(0)
+	{
+		*this = PEImportThunkRange(peBase, iRVAToIAT, iRVAToOriginalIAT, peBase.getPEType() == PEType_64);
+	}
+
+	// Constructor from IAT & original IAT RVAs with explicit thunk size
+	PEImportThunkRange::PEImportThunkRange(const PEBase& peBase, uint32_t iRVAToIAT, uint32_t iRVAToOriginalIAT, bool b64BitThunks, uint64_t iLookupBase)
+		: m_pPEBase(&peBase)
+		, m_pIAT(0)
+		, m_pLookupTable(0)
+		, m_iIATCount(0)
+		, m_iLookupCount(0)
+		, m_iRVAToIAT(iRVAToIAT)
+		, m_b64BitThunks(b64BitThunks)
+		, m_iLookupBase(iLookupBase)
+	{
+		uint32_t iThunkSize = m_b64BitThunks ? sizeof(uint64_t) : sizeof(uint32_t);
+
+		// Resolve IAT (it must be filled by loader when loading PE) once
+		PEDataCursor peCursor(peBase);
+		uint32_t iAvailable;
+		m_pIAT = peCursor.tryGetData(iRVAToIAT, iAvailable);
+		if (NOT m_pIAT)
+			throw PEException("Incorrect Import Directory.", PEException::PEEXCEPTION_INCORRECT_IMPORT_DIRECTORY);
+
+		m_iIATCount = iAvailable / iThunkSize;
+
+		// Resolve original IAT (lookup table), which must handle imported functions names
+		// Some linkers leave this pointer zero-filled
+		// Such image is valid, but it is not possible to restore imported functions names
+		// afted image was loaded, because IAT becomes the only one table
+		// containing both function names and function RVAs after loading
+		if (iRVAToOriginalIAT == 0)
+		{
+			m_pLookupTable = m_pIAT;
+			m_iLookupCount = m_iIATCount;
+		}
+		else
+		{
+			m_pLookupTable = peCursor.tryGetData(iRVAToOriginalIAT, iAvailable);
+			if (NOT m_pLookupTable)
+				throw PEException("Incorrect Import Directory.", PEException::PEEXCEPTION_INCORRECT_IMPORT_DIRECTORY);
+
+			m_iLookupCount = iAvailable / iThunkSize;
+		}
+	}
+
+	PEImportThunkRange::const_iterator PEImportThunkRange::begin() const
+	{
+		return m_pPEBase ? const_iterator(this, 0) : const_iterator();
+	}
+
+	PEImportThunkRange::const_iterator PEImportThunkRange::end() const
+	{
+		return const_iterator();
+	}
+
+	// Returns 'true' if there are no thunks
+	bool PEImportThunkRange::empty() const
+	{
+		return count() == 0;
+	}
+
+	// Counts thunks up to the terminating one (no decoding)
+	uint32_t PEImportThunkRange::count() const
+	{
+		uint32_t iCount = 0;
+		while (	iCount < m_iIATCount 
+				&& 
+				iCount < m_iLookupCount 
+				&& 
+				getThunk(m_pLookupTable, iCount) NOT_EQUAL_TO 0
+		) {
+			iCount++;
+		}
+
+		return iCount;
+	}
+
+	// Returns thunk value at index from table
+	uint64_t PEImportThunkRange::getThunk(const char* pTable, uint32_t iIndex) const
+	{
+		if (m_b64BitThunks)
+		{
+			uint64_t iValue;
+			memcpy(&iValue, pTable + iIndex * sizeof(uint64_t), sizeof(uint64_t));
+			return iValue;
+		}
+
+		uint32_t iValue;
+		memcpy(&iValue, pTable + iIndex * sizeof(uint32_t), sizeof(uint32_t));
+		return iValue;
+	}
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor
+	PEImportDescriptorEntry::PEImportDescriptorEntry()
+		: m_pPEBase(0)
+		, m_b64BitThunks(false)
+	{
+		memset(&m_Descriptor, 0, sizeof(IMAGE_IMPORT_DESCRIPTOR));
+	}
+
+	// Returns 'Name' of the Library (references Image memory)
+	const PEStringView& PEImportDescriptorEntry::getName() const
+	{
+		return m_vName;
+	}
+
+	// Returns RVA to Import Address Table(IAT)
+	uint32_t PEImportDescriptorEntry::getRVAToIAT() const
+	{
+		return m_Descriptor.iFirstThunk;
+	}
+
+	// Returns RVA to Original Import Address Table(Original IAT)
+	uint32_t PEImportDescriptorEntry::getRVATOOriginalIAT() const
+	{
+		return m_Descriptor.iOriginalFirstThunk;
+	}
+
+	// Returns TimeStamp
+	uint32_t PEImportDescriptorEntry::getTimeStamp() const
+	{
+		return m_Descriptor.iTimeStamp;
+	}
+
+	// Returns Forwarder chain
+	uint32_t PEImportDescriptorEntry::getForwarderChain() const
+	{
+		return m_Descriptor.iForwarderChain;
+	}
+
+	// Returns lazy range over imported functions of the Library
+	const PEImportThunkRange PEImportDescriptorEntry::getThunks() const
+	{
+		return PEImportThunkRange(*m_pPEBase, m_Descriptor.iFirstThunk, m_Descriptor.iOriginalFirstThunk, m_b64BitThunks);
+	}
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor (end iterator)
+	PEImportDescriptorRange::const_iterator::const_iterator()
+		: m_pRange(0)
+		, m_iIndex(ITERATOR_END)
+	{
+	}
+
+	PEImportDescriptorRange::const_iterator::const_iterator(const PEImportDescriptorRange* pRange, uint32_t iIndex)
+		: m_pRange(pRange)
+		, m_NameCursor(*pRange->m_pPEBase)
+		, m_iIndex(iIndex)
+	{
+		decode();
+	}
+
+	PEImportDescriptorRange::const_iterator::reference PEImportDescriptorRange::const_iterator::operator*() const
+	{
+		return m_Entry;
+	}
+
+	PEImportDescriptorRange::const_iterator::pointer PEImportDescriptorRange::const_iterator::operator->() const
+	{
+		return &m_Entry;
+	}
+
+	PEImportDescriptorRange::const_iterator& PEImportDescriptorRange::const_iterator::operator++()
+	{
+		if (m_iIndex NOT_EQUAL_TO ITERATOR_END)
+		{
+			m_iIndex++;
+			decode();
+		}
+
+		return *this;
+	}
+
+	PEImportDescriptorRange::const_iterator PEImportDescriptorRange::const_iterator::operator++(int)
+	{
+		const_iterator itr(*this);
+		++(*this);
+
+		return itr;
+	}
+
+	bool PEImportDescriptorRange::const_iterator::operator==(const const_iterator& other) const
+	{
+		return m_iIndex == other.m_iIndex;
+	}
+
+	bool PEImportDescriptorRange::const_iterator::operator!=(const const_iterator& other) const
+	{
+		return m_iIndex NOT_EQUAL_TO other.m_iIndex;
+	}
+
+	// Decodes descriptor at current index, or turns into end iterator at the zero-element
+	void PEImportDescriptorRange::const_iterator::decode()
+	{
+		// Descriptor table must be terminated inside of the Section
+		if (m_iIndex >= m_pRange->m_iNumberOfDescriptors)
+			throw PEException("Incorrect Import Directory.", PEException::PEEXCEPTION_INCORRECT_IMPORT_DIRECTORY);
+
+		const IMAGE_IMPORT_DESCRIPTOR& peImportDescriptor = m_pRange->m_pDescriptors[m_iIndex];
+		if (NOT peImportDescriptor.iName)
+		{
+			m_iIndex = ITERATOR_END;
+			return;
+		}
+
+		// Get DLL name (null-terminated inside of its Section)
+		uint32_t iAvailable;
+		const char* pDllName = m_NameCursor.tryGetData(peImportDescriptor.iName, iAvailable);
+		const char* pDllNameEnd = pDllName ? static_cast<const char*>(memchr(pDllName, 0, iAvailable)) : 0;
+		if (NOT pDllNameEnd)
+			throw PEException("Incorrect Import Directory.", PEException::PEEXCEPTION_INCORRECT_IMPORT_DIRECTORY);
+
+		m_Entry.m_pPEBase = m_pRange->m_pPEBase;
+		m_Entry.m_b64BitThunks = m_pRange->m_pPEBase->getPEType() == PEType_64;
+		m_Entry.m_vName = PEStringView(pDllName, pDllNameEnd - pDllName);
+		m_Entry.m_Descriptor = peImportDescriptor;
+	}
+
+	// Constructor (empty range if image has no imports)
+	PEImportDescriptorRange::PEImportDescriptorRange(const PEBase& peBase)
+		: m_pPEBase(&peBase)
+		, m_pDescriptors(0)
+		, m_iNumberOfDescriptors(0)
+	{
+		if (NOT peBase.hasImports())
+			return;
+
+		// Get all IMAGE_IMPORT_DESCRIPTORs available up to the end of the Section
+		PEDataCursor peCursor(peBase);
+		uint32_t iAvailable;
+		const char* pData = peCursor.tryGetData(peBase.getDirectoryRVA(IMAGE_DIRECTORY_ENTRY_IMPORT), iAvailable);
+		if (NOT pData)
+			throw PEException("Incorrect Import Directory.", PEException::PEEXCEPTION_INCORRECT_IMPORT_DIRECTORY);
+
+		m_pDescriptors = reinterpret_cast<const IMAGE_IMPORT_DESCRIPTOR*>(pData);
+		m_iNumberOfDescriptors = iAvailable / sizeof(IMAGE_IMPORT_DESCRIPTOR);
+	}
+
+	PEImportDescriptorRange::const_iterator PEImportDescriptorRange::begin() const
+	{
+		return m_pDescriptors ? const_iterator(this, 0) : const_iterator();
+	}
+
+	PEImportDescriptorRange::const_iterator PEImportDescriptorRange::end() const
+	{
+		return const_iterator();
+	}
+
+	// Returns 'true' if there are no descriptors
+	bool PEImportDescriptorRange::empty() const
+	{
+		return count() == 0;
+	}
+
+	// Counts descriptors up to the zero-element (no decoding)
+	uint32_t PEImportDescriptorRange::count() const
+	{
+		uint32_t iCount = 0;
+		while (iCount < m_iNumberOfDescriptors && m_pDescriptors[iCount].iName)
+			iCount++;
+
+		return iCount;
+	}
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	// Returns lazy range over Import descriptors of the Image
+	const PEImportDescriptorRange getImportDescriptors(const PEBase& peBase)
+	{
+		return PEImportDescriptorRange(peBase);
+	}
+
+	// Returns 'true' if Image imports function by name, stops at the first match
+	bool isFunctionImported(const PEBase& peBase, const PEStringView& sFunctionName, const PEStringView& sLibraryName)
+	{
+		PEImportDescriptorRange peDescriptors(peBase);
+		for (PEImportDescriptorRange::const_iterator itr = peDescriptors.begin(); itr != peDescriptors.end(); ++itr)
+		{
+			if (NOT sLibraryName.empty() && NOT itr->getName().equalsIgnoreCase(sLibraryName))
+				continue;
+
+			const PEImportThunkRange peThunks = itr->getThunks();
+			for (PEImportThunkRange::const_iterator itrThunk = peThunks.begin(); itrThunk != peThunks.end(); ++itrThunk)
+			{
+				if (itrThunk->hasName() && itrThunk->getName() == sFunctionName)
+					return true;
+			}
+		}
+
+		return false;
+	}
+
+	const PEIMPORTED_FUNCTIONS_LIST	getImportedFunctionsList(const PEBase& peBase, PENameStorage eNameStorage)
 	{
 		return (	peBase.getPEType() == PEType_32
 					?
-					getImportedFunctionsBase<PETypeClass32>(peBase)
+					getImportedFunctionsBase<PETypeClass32>(peBase, eNameStorage)
 					:
-					getImportedFunctionsBase<PETypeClass64>(peBase)
+					getImportedFunctionsBase<PETypeClass64>(peBase, eNameStorage)
 			);
 	}
 
 	// Returns imported functions list with related libraries info
+	// Built on top of the lazy ranges: each descriptor's IAT & original IAT arrays are resolved once
+	// and then walked with direct bounded pointers
+	// If eNameStorage = PE_NAME_STORAGE_VIEW, names reference Image memory & the only allocations are the lists themselves
 	template<typename PEClassType>
-	const PEIMPORTED_FUNCTIONS_LIST	getImportedFunctionsBase(const PEBase& peBase)
+	const PEIMPORTED_FUNCTIONS_LIST	getImportedFunctionsBase(const PEBase& peBase, PENameStorage eNameStorage)
 	{
 		PEIMPORTED_FUNCTIONS_LIST returnList;
 
@@ -295,186 +885,610 @@ namespace OpenPE
 			return returnList;
 		}
 
-		unsigned long iCurrentDescriptorPosition = peBase.getDirectoryRVA(IMAGE_DIRECTORY_ENTRY_IMPORT);
+		PEImportDescriptorRange peDescriptors(peBase);
 
-		// Get first IMAGE_IMPORT_DESCRIPTOR
-		IMAGE_IMPORT_DESCRIPTOR peImportDescriptor = peBase.getSectionDataFromRVA<IMAGE_IMPORT_DESCRIPTOR>(	iCurrentDescriptorPosition,
-																											SECTION_DATA_VIRTUAL,
-																											true);
+		// Count descriptors up to the zero-element, so that the list is allocated once
+		returnList.reserve(peDescriptors.count());
 
-		// Iterate them until we reach zero-element
-		// We don't need to check correctness of this, because exception will be thrown
-		// inside of loop if we go outsize of section
-		while (peImportDescriptor.iName)
+		for (PEImportDescriptorRange::const_iterator itr = peDescriptors.begin(); itr != peDescriptors.end(); ++itr)
 		{
-			// Get imported library information
-			PEImportLibrary peLibrary;
-
-			unsigned long iMaxNameLength;
-
-			// Get byte count that we have for library name
-			if ((iMaxNameLength = peBase.getSectionDataLengthFromRVA(	peImportDescriptor.iName, 
-																		peImportDescriptor.iName, 
-																		SECTION_DATA_VIRTUAL,
-																		true)
-				) < 2
-			) {
-				throw PEException("Incorrect Import Directory.", PEException::PEEXCEPTION_INCORRECT_IMPORT_DIRECTORY);
-			}
+			// Save import information
+			returnList.push_back(PEImportLibrary());
+			PEImportLibrary& peLibrary = returnList.back();
+
+			// Set Library Name
+			if (eNameStorage == PE_NAME_STORAGE_INTERN)
+				peLibrary.setNameSymbol(PEInternTable::getGlobal().intern(itr->getName()));
+			else if (eNameStorage == PE_NAME_STORAGE_VIEW)
+				peLibrary.setNameView(itr->getName());
+			else
+				peLibrary.setName(itr->getName());
+
+			// Set Library TimeStamp
+			peLibrary.setTimeStamp(itr->getTimeStamp());
+
+			// Set library RVA to IAT and original IAT
+			peLibrary.setRVAToIAT(itr->getRVAToIAT());
+			peLibrary.setRVATOOriginalIAT(itr->getRVATOOriginalIAT());
+
+			// List all imported functions for current DLL
+			PEImportThunkRange peThunks(peBase, itr->getRVAToIAT(), itr->getRVATOOriginalIAT(), sizeof(typename PEClassType::BaseSize) == sizeof(uint64_t));
 
-			// Get DLL name pointer
-			const char* pDllName = peBase.getSectionDataFromRVA(peImportDescriptor.iName, SECTION_DATA_VIRTUAL, true);
+			// Count thunks up to the zero-element, so that the function list is allocated once
+			peLibrary.reserveImports(peThunks.count());
 
-			// Check for null-termination
-			if (NOT PEUtils::isNullTerminated(pDllName, iMaxNameLength))
+			for (PEImportThunkRange::const_iterator itrThunk = peThunks.begin(); itrThunk != peThunks.end(); ++itrThunk)
 			{
-				throw PEException("Incorrect Import Directory.", PEException::PEEXCEPTION_INCORRECT_IMPORT_DIRECTORY);
+				// Add function to list
+				peLibrary.addImport(itrThunk->toImportedFunction(eNameStorage));
 			}
+		}
+
+		// Return resulting list
+		return returnList;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor
+	PEDelayImportDescriptorEntry::PEDelayImportDescriptorEntry()
+		: m_pPEBase(0)
+		, m_iLookupBase(0)
+	{
+		memset(&m_Descriptor, 0, sizeof(IMAGE_DELAYLOAD_DESCRIPTOR));
+	}
+
+	// Returns 'Name' of the Library (references Image memory)
+	const PEStringView& PEDelayImportDescriptorEntry::getName() const
+	{
+		return m_vName;
+	}
+
+	// Returns Attributes
+	uint32_t PEDelayImportDescriptorEntry::getAttributes() const
+	{
+		return m_Descriptor.iAttributes;
+	}
+
+	// Returns 'true' if descriptor fields are RVAs ('false' for legacy VA-based descriptors)
+	bool PEDelayImportDescriptorEntry::isRVABased() const
+	{
+		return (m_Descriptor.iAttributes & IMAGE_DELAYLOAD_RVA_BASED) NOT_EQUAL_TO 0;
+	}
+
+	// Returns RVA to the module handle of the Library
+	uint32_t PEDelayImportDescriptorEntry::getRVAToModuleHandle() const
+	{
+		return m_Descriptor.iModuleHandleRVA;
+	}
+
+	// Returns RVA to Delay Import Address Table(IAT)
+	uint32_t PEDelayImportDescriptorEntry::getRVAToIAT() const
+	{
+		return m_Descriptor.iImportAddressTableRVA;
+	}
+
+	// Returns RVA to Delay Import Name Table(INT)
+	uint32_t PEDelayImportDescriptorEntry::getRVAToNameTable() const
+	{
+		return m_Descriptor.iImportNameTableRVA;
+	}
+
+	// Returns RVA to bound Delay Import Address Table (0, if none)
+	uint32_t PEDelayImportDescriptorEntry::getRVAToBoundIAT() const
+	{
+		return m_Descriptor.iBoundImportAddressTableRVA;
+	}
+
+	// Returns RVA to unload information table (copy of IAT, 0 if none)
+	uint32_t PEDelayImportDescriptorEntry::getRVAToUnloadInformationTable() const
+	{
+		return m_Descriptor.iUnloadInformationTableRVA;
+	}
+
+	// Returns TimeStamp of the Library bound to (0, if not bound)
+	uint32_t PEDelayImportDescriptorEntry::getTimeStamp() const
+	{
+		return m_Descriptor.iTimeDateStamp;
+	}
+
+	// Returns lazy range over delay imported functions of the Library
+	// Name pointers of legacy descriptors are VAs
+	const PEImportThunkRange PEDelayImportDescriptorEntry::getThunks() const
+	{
+		return PEImportThunkRange(	*m_pPEBase, 
+									m_Descriptor.iImportAddressTableRVA, 
+									m_Descriptor.iImportNameTableRVA, 
+									m_pPEBase->getPEType() == PEType_64, 
+									m_iLookupBase);
+	}
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor (end iterator)
+	PEDelayImportDescriptorRange::const_iterator::const_iterator()
+		: m_pRange(0)
+		, m_iIndex(ITERATOR_END)
+	{
+	}
+
+	PEDelayImportDescriptorRange::const_iterator::const_iterator(const PEDelayImportDescriptorRange* pRange, uint32_t iIndex)
+		: m_pRange(pRange)
+		, m_NameCursor(*pRange->m_pPEBase)
+		, m_iIndex(iIndex)
+	{
+		decode();
+	}
+
+	PEDelayImportDescriptorRange::const_iterator::reference PEDelayImportDescriptorRange::const_iterator::operator*() const
+	{
+		return m_Entry;
+	}
+
+	PEDelayImportDescriptorRange::const_iterator::pointer PEDelayImportDescriptorRange::const_iterator::operator->() const
+	{
+		return &m_Entry;
+	}
+
+	PEDelayImportDescriptorRange::const_iterator& PEDelayImportDescriptorRange::const_iterator::operator++()
+	{
+		if (m_iIndex NOT_EQUAL_TO ITERATOR_END)
+		{
+			m_iIndex++;
+			decode();
+		}
+
+		return *this;
+	}
+
+	PEDelayImportDescriptorRange::const_iterator PEDelayImportDescriptorRange::const_iterator::operator++(int)
+	{
+		const_iterator itr(*this);
+		++(*this);
+
+		return itr;
+	}
+
+	bool PEDelayImportDescriptorRange::const_iterator::operator==(const const_iterator& other) const
+	{
+		return m_iIndex == other.m_iIndex;
+	}
+
+	bool PEDelayImportDescriptorRange::const_iterator::operator!=(const const_iterator& other) const
+	{
+		return m_iIndex NOT_EQUAL_TO other.m_iIndex;
+	}
+
+	// Converts descriptor field to RVA (legacy descriptors hold 32-bit VAs)
+	uint32_t PEDelayImportDescriptorRange::const_iterator::toRVA(uint32_t iAddress, bool bRVABased) const
+	{
+		if (bRVABased || NOT iAddress)
+			return iAddress;
+
+		uint32_t iImageBase = static_cast<uint32_t>(m_pRange->m_pPEBase->getImageBase64());
+		if (iAddress < iImageBase)
+			throw PEException("Incorrect Delay Import Directory.", PEException::PEEXCEPTION_INCORRECT_DELAY_IMPORT_DIRECTORY);
+
+		return iAddress - iImageBase;
+	}
+
+	// Decodes descriptor at current index, or turns into end iterator at the zero-element
+	void PEDelayImportDescriptorRange::const_iterator::decode()
+	{
+		// Descriptor table must be terminated inside of the Section
+		if (m_iIndex >= m_pRange->m_iNumberOfDescriptors)
+			throw PEException("Incorrect Delay Import Directory.", PEException::PEEXCEPTION_INCORRECT_DELAY_IMPORT_DIRECTORY);
+
+		const IMAGE_DELAYLOAD_DESCRIPTOR& peDescriptor = m_pRange->m_pDescriptors[m_iIndex];
+		if (NOT peDescriptor.iDllNameRVA)
+		{
+			m_iIndex = ITERATOR_END;
+			return;
+		}
+
+		// Convert all addresses to RVAs
+		bool bRVABased = (peDescriptor.iAttributes & IMAGE_DELAYLOAD_RVA_BASED) NOT_EQUAL_TO 0;
+
+		IMAGE_DELAYLOAD_DESCRIPTOR& peEntryDescriptor = m_Entry.m_Descriptor;
+		peEntryDescriptor.iAttributes = peDescriptor.iAttributes;
+		peEntryDescriptor.iDllNameRVA = toRVA(peDescriptor.iDllNameRVA, bRVABased);
+		peEntryDescriptor.iModuleHandleRVA = toRVA(peDescriptor.iModuleHandleRVA, bRVABased);
+		peEntryDescriptor.iImportAddressTableRVA = toRVA(peDescriptor.iImportAddressTableRVA, bRVABased);
+		peEntryDescriptor.iImportNameTableRVA = toRVA(peDescriptor.iImportNameTableRVA, bRVABased);
+		peEntryDescriptor.iBoundImportAddressTableRVA = toRVA(peDescriptor.iBoundImportAddressTableRVA, bRVABased);
+		peEntryDescriptor.iUnloadInformationTableRVA = toRVA(peDescriptor.iUnloadInformationTableRVA, bRVABased);
+		peEntryDescriptor.iTimeDateStamp = peDescriptor.iTimeDateStamp;
+
+		// Both IAT & Name Table are required
+		if (NOT peEntryDescriptor.iImportAddressTableRVA || NOT peEntryDescriptor.iImportNameTableRVA)
+			throw PEException("Incorrect Delay Import Directory.", PEException::PEEXCEPTION_INCORRECT_DELAY_IMPORT_DIRECTORY);
+
+		// Get DLL name (null-terminated inside of its Section)
+		uint32_t iAvailable;
+		const char* pDllName = m_NameCursor.tryGetData(peEntryDescriptor.iDllNameRVA, iAvailable);
+		const char* pDllNameEnd = pDllName ? static_cast<const char*>(memchr(pDllName, 0, iAvailable)) : 0;
+		if (NOT pDllNameEnd)
+			throw PEException("Incorrect Delay Import Directory.", PEException::PEEXCEPTION_INCORRECT_DELAY_IMPORT_DIRECTORY);
+
+		m_Entry.m_pPEBase = m_pRange->m_pPEBase;
+		m_Entry.m_iLookupBase = bRVABased ? 0 : m_pRange->m_pPEBase->getImageBase64();
+		m_Entry.m_vName = PEStringView(pDllName, pDllNameEnd - pDllName);
+	}
+
+	// Constructor (empty range if image has no Delay Import Directory)
+	PEDelayImportDescriptorRange::PEDelayImportDescriptorRange(const PEBase& peBase)
+		: m_pPEBase(&peBase)
+		, m_pDescriptors(0)
+		, m_iNumberOfDescriptors(0)
+	{
+		if (NOT peBase.hasDelayImport())
+			return;
+
+		// Get all IMAGE_DELAYLOAD_DESCRIPTORs available up to the end of the Section
+		PEDataCursor peCursor(peBase);
+		uint32_t iAvailable;
+		const char* pData = peCursor.tryGetData(peBase.getDirectoryRVA(IMAGE_DIRECTORY_ENTRY_DELAY_IMPORT), iAvailable);
+		if (NOT pData)
+			throw PEException("Incorrect Delay Import Directory.", PEException::PEEXCEPTION_INCORRECT_DELAY_IMPORT_DIRECTORY);
+
+		m_pDescriptors = reinterpret_cast<const IMAGE_DELAYLOAD_DESCRIPTOR*>(pData);
+		m_iNumberOfDescriptors = iAvailable / sizeof(IMAGE_DELAYLOAD_DESCRIPTOR);
+	}
+
+	PEDelayImportDescriptorRange::const_iterator PEDelayImportDescriptorRange::begin() const
+	{
+		return m_pDescriptors ? const_iterator(this, 0) : const_iterator();
+	}
+
+	PEDelayImportDescriptorRange::const_iterator PEDelayImportDescriptorRange::end() const
+	{
+		return const_iterator();
+	}
+
+	// Returns 'true' if there are no descriptors
+	bool PEDelayImportDescriptorRange::empty() const
+	{
+		return count() == 0;
+	}
+
+	// Counts descriptors up to the zero-element (no decoding)
+	uint32_t PEDelayImportDescriptorRange::count() const
+	{
+		uint32_t iCount = 0;
+		while (iCount < m_iNumberOfDescriptors && m_pDescriptors[iCount].iDllNameRVA)
+			iCount++;
+
+		return iCount;
+	}
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	// Returns lazy range over Delay Import descriptors of the Image
+	const PEDelayImportDescriptorRange getDelayImportDescriptors(const PEBase& peBase)
+	{
+		return PEDelayImportDescriptorRange(peBase);
+	}
+
+	// Returns delay imported functions list with related libraries info
+	// Same single pass as getImportedFunctionsBase: lists are allocated once, names can reference Image memory
+	const PEIMPORTED_FUNCTIONS_LIST getDelayImportedFunctionsList(const PEBase& peBase, PENameStorage eNameStorage)
+	{
+		PEIMPORTED_FUNCTIONS_LIST returnList;
+
+		// If image has no delay imports, return empty array
+		if (NOT peBase.hasDelayImport())
+		{
+			return returnList;
+		}
+
+		PEDelayImportDescriptorRange peDescriptors(peBase);
+		returnList.reserve(peDescriptors.count());
+
+		for (PEDelayImportDescriptorRange::const_iterator itr = peDescriptors.begin(); itr != peDescriptors.end(); ++itr)
+		{
+			returnList.push_back(PEImportLibrary());
+			PEImportLibrary& peLibrary = returnList.back();
 
 			// Set Library Name
-			peLibrary.setName(pDllName);
+			if (eNameStorage == PE_NAME_STORAGE_INTERN)
+				peLibrary.setNameSymbol(PEInternTable::getGlobal().intern(itr->getName()));
+			else if (eNameStorage == PE_NAME_STORAGE_VIEW)
+				peLibrary.setNameView(itr->getName());
+			else
+				peLibrary.setName(itr->getName());
+
+			// Set Library TimeStamp, RVA to IAT and Name Table
+			peLibrary.setTimeStamp(itr->getTimeStamp());
+			peLibrary.setRVAToIAT(itr->getRVAToIAT());
+			peLibrary.setRVATOOriginalIAT(itr->getRVAToNameTable());
+
+			// List all delay imported functions for current DLL
+			const PEImportThunkRange peThunks = itr->getThunks();
+			peLibrary.reserveImports(peThunks.count());
+
+			for (PEImportThunkRange::const_iterator itrThunk = peThunks.begin(); itrThunk != peThunks.end(); ++itrThunk)
+			{
+				peLibrary.addImport(itrThunk->toImportedFunction(eNameStorage));
+			}
+		}
 
-			// Set Library TimeStamp
-			peLibrary.setTimeStamp(peImportDescriptor.iTimeStamp);
+		return returnList;
+	}
 
-			// Set library RVA to IAT and original IAT
-			peLibrary.setRVAToIAT(peImportDescriptor.iFirstThunk);
-			peLibrary.setRVATOOriginalIAT(peImportDescriptor.iOriginalFirstThunk);
-
-			// Get RVA to IAT (it must be filled by loader when loading PE)
-			uint32_t iCurrentThunkRVA = peImportDescriptor.iFirstThunk;
-			typename PEClassType::BaseSize importAddressTable = peBase.getSectionDataFromRVA<PETypeClass32::BaseSize>(	iCurrentThunkRVA,
-																														SECTION_DATA_VIRTUAL,
-																														true);
-			
-			// Get RVA to original IAT (lookup table), which must handle imported functions names
-			// Some linkers leave this pointer zero-filled
-			// Such image is valid, but it is not possible to restore imported functions names
-			// afted image was loaded, because IAT becomes the only one table
-			// containing both function names and function RVAs after loading
-			uint32_t iCurrentOriginalThunkRVA = peImportDescriptor.iOriginalFirstThunk;
-			typename PEClassType::BaseSize importLookUpTable = (iCurrentOriginalThunkRVA == 0) 
-																	? 
-																	importAddressTable
-																	:
-																	peBase.getSectionDataFromRVA<PETypeClass32::BaseSize>(	iCurrentOriginalThunkRVA,
-																															SECTION_DATA_VIRTUAL,
- 																															true);
-			if (iCurrentOriginalThunkRVA == 0)
-				iCurrentOriginalThunkRVA = iCurrentThunkRVA;
+	// Rebuilds Import Directory of the Image into peImportSection
+	const PEImageDirectory rebuildImports(	PEBase& peBase,
+											const PEIMPORTED_FUNCTIONS_LIST& vImports,
+											PESection& peImportSection,
+											const PEImportRebuilderSettings& peSettings
+	) {
+		return (	peBase.getPEType() == PEType_32
+					?
+					rebuildImportsBase<PETypeClass32>(peBase, vImports, peImportSection, peSettings)
+					:
+					rebuildImportsBase<PETypeClass64>(peBase, vImports, peImportSection, peSettings)
+			);
+	}
 
-			// List all imported functions for current DLL
-			if (importLookUpTable NOT_EQUAL_TO 0 && importAddressTable NOT_EQUAL_TO 0)
+	// Helper: describes which thunk tables of an imported library are written & where
+	struct PEImportThunkPlan
+	{
+		bool	bNewIAT;				// IAT is placed into the import section
+		bool	bWriteIAT;				// IAT is written (new, or rewritten at its saved RVA)
+		bool	bNewOriginalIAT;		// Original IAT is placed into the import section
+		bool	bWriteOriginalIAT;		// Original IAT is written (new, or rewritten at its saved RVA)
+		bool	bHasOriginalIAT;		// Descriptor references an original IAT, so IAT can keep prebound values
+		bool	bWriteHintNames;		// IMAGE_IMPORT_BY_NAME entries are referenced by a written table
+	};
+
+	// Helper: decides how thunk tables of the library are rebuilt according to settings
+	static const PEImportThunkPlan getImportThunkPlan(const PEImportLibrary& peLibrary, const PEImportRebuilderSettings& peSettings)
+	{
+		PEImportThunkPlan pePlan;
+
+		bool bSaveIATs = peSettings.saveIATAndOriginalIATRVAs() && peLibrary.getRVAToIAT();
+		bool bRewriteSaved = bSaveIATs && peSettings.rewriteIATAndOriginalIATContents();
+
+		pePlan.bNewIAT = NOT bSaveIATs;
+		pePlan.bWriteIAT = pePlan.bNewIAT || bRewriteSaved;
+
+		if (NOT peSettings.canBuildOriginalIAT())
+		{
+			pePlan.bNewOriginalIAT = false;
+			pePlan.bWriteOriginalIAT = false;
+			pePlan.bHasOriginalIAT = false;
+		}
+		else if (NOT bSaveIATs)
+		{
+			pePlan.bNewOriginalIAT = true;
+			pePlan.bWriteOriginalIAT = true;
+			pePlan.bHasOriginalIAT = true;
+		}
+		else if (peLibrary.getRVATOOriginalIAT())
+		{
+			pePlan.bNewOriginalIAT = false;
+			pePlan.bWriteOriginalIAT = bRewriteSaved;
+			pePlan.bHasOriginalIAT = true;
+		}
+		else
+		{
+			// Saved IAT without original IAT, it can be added
+			pePlan.bNewOriginalIAT = peSettings.fillMissingOriginalIATs();
+			pePlan.bWriteOriginalIAT = pePlan.bNewOriginalIAT;
+			pePlan.bHasOriginalIAT = pePlan.bNewOriginalIAT;
+		}
+
+		// IAT references names only if there is no original IAT for the loader to read them from
+		pePlan.bWriteHintNames = pePlan.bWriteOriginalIAT || (pePlan.bWriteIAT && NOT pePlan.bHasOriginalIAT);
+
+		return pePlan;
+	}
+
+	// Helper: returns writable thunk table at saved RVA, checking that iTableSize bytes fit into its Section (or headers)
+	static char* getSavedThunkTable(PEBase& peBase, uint32_t iRVA, uint32_t iTableSize)
+	{
+		if (peBase.getSectionDataLengthFromRVA(iRVA, iRVA, SECTION_DATA_RAW, true) < iTableSize)
+			throw PEException("Insufficient space inside initial IAT", PEException::PEEXCEPTION_INSUFFICIENT_SPACE);
+
+		return peBase.getSectionDataFromRVA(iRVA, true);
+	}
+
+	// Rebuilds Import Directory of the Image into peImportSection
+	// Layout (from OffsetFromSectionStart): descriptors, IATs & original IATs (aligned), hints/names, library names
+	template<typename PEClassType>
+	const PEImageDirectory rebuildImportsBase(	PEBase& peBase,
+												const PEIMPORTED_FUNCTIONS_LIST& vImports,
+												PESection& peImportSection,
+												const PEImportRebuilderSettings& peSettings
+	) {
+		typedef typename PEClassType::BaseSize		THUNK;
+
+		// Check that peImportSection is attached to this Image
+		if (NOT peBase.sectionAttached(peImportSection))
+			throw PEException("Import Section must be attached to the Image", PEException::PEEXCEPTION_SECTION_IS_NOT_ATTACHED);
+
+		// Layout pass: size every part of the directory up front
+		// Hints/names & library names are staged here, as names may reference the data of peImportSection
+		// (PE_NAME_STORAGE_VIEW), which is resized & cleared below (only their lengths are used after that)
+		uint32_t iDescriptorsSize = static_cast<uint32_t>((vImports.size() + 1 /* ending null descriptor */) * sizeof(IMAGE_IMPORT_DESCRIPTOR));
+		uint32_t iNumberOfThunks = 0;
+		std::string sHintNames;
+		std::string sLibraryNames;
+
+		for (PEIMPORTED_FUNCTIONS_LIST::const_iterator itr = vImports.begin(); itr != vImports.end(); ++itr)
+		{
+			const PEImportThunkPlan pePlan = getImportThunkPlan(*itr, peSettings);
+			const PEImportLibrary::IMPORTED_LIST& vFunctions = itr->getImportedFunctionList();
+
+			const PEStringView sLibraryName = itr->getNameView();
+			sLibraryNames.append(sLibraryName.data(), sLibraryName.length());
+			sLibraryNames.push_back(0);
+
+			uint32_t iTableLength = static_cast<uint32_t>(vFunctions.size() + 1 /* ending null thunk */);
+			if (pePlan.bNewIAT)
+				iNumberOfThunks += iTableLength;
+			if (pePlan.bNewOriginalIAT)
+				iNumberOfThunks += iTableLength;
+
+			if (pePlan.bWriteHintNames)
 			{
-				while (true)
+				for (PEImportLibrary::IMPORTED_LIST::const_iterator itrFunction = vFunctions.begin(); itrFunction != vFunctions.end(); ++itrFunction)
 				{
-					// Imported Function Descriptor
-					PEImportedFunction func;
-
-					// Get VA from IAT
-					typename PEClassType::BaseSize address = peBase.getSectionDataFromRVA<typename PEClassType::BaseSize>(	iCurrentThunkRVA,
-																															SECTION_DATA_VIRTUAL,
-																															true);
-					// Move Pointer
-					iCurrentThunkRVA += sizeof(typename PEClassType::BaseSize);
-
-					// Jump to next DLL if we finished with this one
-					if (NOT address)
+					// IMAGE_IMPORT_BY_NAME entries are WORD-aligned
+					if (itrFunction->hasName())
 					{
-						break;
+						const PEStringView sFunctionName = itrFunction->getNameView();
+						uint16_t iHint = itrFunction->getHint();
+
+						sHintNames.append(reinterpret_cast<const char*>(&iHint), sizeof(uint16_t));
+						sHintNames.append(sFunctionName.data(), sFunctionName.length());
+						sHintNames.resize(PEUtils::alignUp(static_cast<uint32_t>(sHintNames.length() + 1 /* nullbyte */), sizeof(uint16_t)), 0);
 					}
+				}
+			}
+		}
 
-					func.setIAT_VA(address);
+		uint32_t iHintNamesSize = static_cast<uint32_t>(sHintNames.length());
+		uint32_t iLibraryNamesSize = static_cast<uint32_t>(sLibraryNames.length());
+
+		uint32_t iDescriptorsOffset = peSettings.getOffsetFromSectionStart();
+		uint32_t iThunksOffset = PEUtils::alignUp(iDescriptorsOffset + iDescriptorsSize, sizeof(THUNK));
+		uint32_t iHintNamesOffset = iThunksOffset + iNumberOfThunks * static_cast<uint32_t>(sizeof(THUNK));
+		uint32_t iLibraryNamesOffset = iHintNamesOffset + iHintNamesSize;
+		uint32_t iEndOffset = iLibraryNamesOffset + iLibraryNamesSize;
+
+		// If peImportSection is not the last one, the directory must fit into its raw data
+		bool bLastSection = (&peImportSection == &peBase.getImageSectionList().back());
+		if (NOT bLastSection && peImportSection.getAlignedRawSize(peBase.getFileAlignment()) < iEndOffset)
+			throw PEException("Insufficient space for Import Directory", PEException::PEEXCEPTION_INSUFFICIENT_SPACE);
+
+		// The only (re)allocation of the Section data
+		std::string& sRawData = peImportSection.getRawData();
+		if (sRawData.length() < iEndOffset)
+			sRawData.resize(iEndOffset);
+
+		char* pData = &sRawData[0];
+		memset(pData + iDescriptorsOffset, 0, iHintNamesOffset - iDescriptorsOffset);
+		memcpy(pData + iHintNamesOffset, sHintNames.data(), iHintNamesSize);
+		memcpy(pData + iLibraryNamesOffset, sLibraryNames.data(), iLibraryNamesSize);
+
+		// Write pass
+		uint32_t iDescriptorPos = iDescriptorsOffset;
+		uint32_t iThunkPos = iThunksOffset;
+		uint32_t iHintNamePos = iHintNamesOffset;
+		uint32_t iLibraryNamePos = iLibraryNamesOffset;
+
+		for (PEIMPORTED_FUNCTIONS_LIST::const_iterator itr = vImports.begin(); itr != vImports.end(); ++itr)
+		{
+			const PEImportThunkPlan pePlan = getImportThunkPlan(*itr, peSettings);
+			const PEImportLibrary::IMPORTED_LIST& vFunctions = itr->getImportedFunctionList();
+			uint32_t iTableSize = static_cast<uint32_t>((vFunctions.size() + 1 /* ending null thunk */) * sizeof(THUNK));
 
-					// Get VA from original IAT
-					typename PEClassType::BaseSize lookup = peBase.getSectionDataFromRVA<typename PEClassType::BaseSize>(	iCurrentOriginalThunkRVA,
-																															SECTION_DATA_VIRTUAL,
-																															true);
-					// Move Pointer
-					iCurrentOriginalThunkRVA += sizeof(typename PEClassType::BaseSize);
+			IMAGE_IMPORT_DESCRIPTOR peDescriptor;
+			memset(&peDescriptor, 0, sizeof(IMAGE_IMPORT_DESCRIPTOR));
+			peDescriptor.iTimeStamp = itr->getTimeStamp();
 
-					// Check if function is imported by ordinal
-					if ((lookup & PEClassType::ImportSnapFlag) NOT_EQUAL_TO 0)
-					{
-						// Set function ordinal
-						func.setOrdinal(static_cast<uint16_t>(lookup & 0xffff));
-					}
-					else
+			// Library name (already copied from the staging buffer)
+			peDescriptor.iName = peBase.getRVAFromSectionOffset(peImportSection, iLibraryNamePos);
+			iLibraryNamePos += static_cast<uint32_t>(itr->getNameView().length() + 1 /* nullbyte */);
+
+			// Tables to be written (ending null thunks of the new ones are already zeroed)
+			char* pIAT = 0;
+			if (pePlan.bNewIAT)
+			{
+				peDescriptor.iFirstThunk = peBase.getRVAFromSectionOffset(peImportSection, iThunkPos);
+				pIAT = pData + iThunkPos;
+				iThunkPos += iTableSize;
+			}
+			else
+			{
+				peDescriptor.iFirstThunk = itr->getRVAToIAT();
+				if (pePlan.bWriteIAT)
+				{
+					pIAT = getSavedThunkTable(peBase, peDescriptor.iFirstThunk, iTableSize);
+					memset(pIAT + iTableSize - sizeof(THUNK), 0, sizeof(THUNK));
+				}
+			}
+
+			char* pOriginalIAT = 0;
+			if (pePlan.bNewOriginalIAT)
+			{
+				peDescriptor.iOriginalFirstThunk = peBase.getRVAFromSectionOffset(peImportSection, iThunkPos);
+				pOriginalIAT = pData + iThunkPos;
+				iThunkPos += iTableSize;
+			}
+			else if (pePlan.bHasOriginalIAT)
+			{
+				peDescriptor.iOriginalFirstThunk = itr->getRVATOOriginalIAT();
+				if (pePlan.bWriteOriginalIAT)
+				{
+					pOriginalIAT = getSavedThunkTable(peBase, peDescriptor.iOriginalFirstThunk, iTableSize);
+					memset(pOriginalIAT + iTableSize - sizeof(THUNK), 0, sizeof(THUNK));
+				}
+			}
+
+			memcpy(pData + iDescriptorPos, &peDescriptor, sizeof(IMAGE_IMPORT_DESCRIPTOR));
+			iDescriptorPos += sizeof(IMAGE_IMPORT_DESCRIPTOR);
+
+			if (NOT pIAT && NOT pOriginalIAT)
+				continue;
+
+			for (PEImportLibrary::IMPORTED_LIST::const_iterator itrFunction = vFunctions.begin(); itrFunction != vFunctions.end(); ++itrFunction)
+			{
+				// Thunk value: RVA of IMAGE_IMPORT_BY_NAME or ordinal
+				THUNK iThunk = 0;
+				if (itrFunction->hasName())
+				{
+					// Hint/name is already copied from the staging buffer
+					if (pePlan.bWriteHintNames)
 					{
-						// Get byte count that we have for function name
-						if (lookup > static_cast<uint32_t>(-1) - sizeof(uint16_t))
-						{
-							throw PEException("Incorrect Import Directory.", PEException::PEEXCEPTION_INCORRECT_IMPORT_DIRECTORY);
-						}
-
-						// Get maximum available length of function name
-						if ((iMaxNameLength = peBase.getSectionDataLengthFromRVA(	static_cast<uint32_t>(lookup + sizeof(uint16_t)),
-																					static_cast<uint32_t>(lookup + sizeof(uint16_t)), 
-																					SECTION_DATA_VIRTUAL, 
-																					true)) < 2)
-						{
-							throw PEException("Incorrect Import Directory.", PEException::PEEXCEPTION_INCORRECT_IMPORT_DIRECTORY);
-						}
-
-						// Get imported function name
-						const char* pFuncName = peBase.getSectionDataFromRVA(	static_cast<uint32_t>(lookup + sizeof(uint16_t)),
-																				SECTION_DATA_VIRTUAL, 
-																				true);
-
-						// Check for null-termination
-						if (!PEUtils::isNullTerminated(pFuncName, iMaxNameLength))
-							throw PEException("Incorrect Import Directory.", PEException::PEEXCEPTION_INCORRECT_IMPORT_DIRECTORY);
-
-						// HINT in import table is ORDINAL in export table
-						uint16_t iHint = peBase.getSectionDataFromRVA<uint16_t>(static_cast<uint32_t>(lookup), SECTION_DATA_VIRTUAL, true);
-
-						//Save hint and name
-						func.setName(pFuncName);
-						func.setHint(iHint);
+						iThunk = peBase.getRVAFromSectionOffset(peImportSection, iHintNamePos);
+						iHintNamePos += PEUtils::alignUp(static_cast<uint32_t>(sizeof(uint16_t) /* hint */ + itrFunction->getNameView().length() + 1 /* nullbyte */), sizeof(uint16_t));
 					}
+				}
+				else
+				{
+					iThunk = static_cast<THUNK>(itrFunction->getOrdinal()) | PEClassType::ImportSnapFlag;
+				}
 
-					// Add function to list
-					peLibrary.addImport(func);
+				if (pOriginalIAT)
+				{
+					memcpy(pOriginalIAT, &iThunk, sizeof(THUNK));
+					pOriginalIAT += sizeof(THUNK);
+				}
+
+				if (pIAT)
+				{
+					// The loader reads names from original IAT, so IAT keeps prebound values (if there are any)
+					THUNK iIATValue = (pePlan.bHasOriginalIAT && itrFunction->getIAT_VA())
+										?
+										static_cast<THUNK>(itrFunction->getIAT_VA())
+										:
+										iThunk;
+
+					memcpy(pIAT, &iIATValue, sizeof(THUNK));
+					pIAT += sizeof(THUNK);
 				}
 			}
+		}
 
-			// Check possible overflow
-			if (!PEUtils::isSumSafe(iCurrentDescriptorPosition, sizeof(IMAGE_IMPORT_DESCRIPTOR)))
-				throw PEException("Incorrect Import Directory.", PEException::PEEXCEPTION_INCORRECT_IMPORT_DIRECTORY);
+		// Adjust Section raw & virtual sizes
+		peBase.recalculateSectionSizes(peImportSection, peSettings.autoStripLastSectionEnabled());
 
-			//Go to next library
-			iCurrentDescriptorPosition += sizeof(IMAGE_IMPORT_DESCRIPTOR);
-			peImportDescriptor = peBase.getSectionDataFromRVA<IMAGE_IMPORT_DESCRIPTOR>(iCurrentDescriptorPosition, SECTION_DATA_VIRTUAL, true);
+		// Return information about rebuilt Import Directory
+		PEImageDirectory peDirectory(peBase.getRVAFromSectionOffset(peImportSection, iDescriptorsOffset), iDescriptorsSize);
 
-			// Save import information
-			returnList.push_back(peLibrary);
+		// If auto-rewrite of PE headers is required
+		if (peSettings.autoSetToPEHeaders())
+		{
+			peBase.setDirectoryRVA(IMAGE_DIRECTORY_ENTRY_IMPORT, peDirectory.getRVA());
+			peBase.setDirectorySize(IMAGE_DIRECTORY_ENTRY_IMPORT, peDirectory.getSize());
+
+			// If we have to zero IMAGE_DIRECTORY_ENTRY_IAT
+			if (peSettings.zeroDirectoryEntryIAT())
+			{
+				peBase.setDirectoryRVA(IMAGE_DIRECTORY_ENTRY_IAT, 0);
+				peBase.setDirectorySize(IMAGE_DIRECTORY_ENTRY_IAT, 0);
+			}
 		}
 
-		// Return resulting list
-		return returnList;
+		return peDirectory;
 	}
-
-	// TODO - PEImportAdder
-	//const PEImageDirectory rebuildImports(	PEBase& peBase,
-	//										const PEIMPORTED_FUNCTIONS_LIST& imports,
-	//										PESection& importSection,
-	//										const PEImportRebuilderSettings& import_settings
-	//) {
-	//	return (	peBase.getPEType() == PEType_32
-	//				?
-	//				rebuildImportsBase<PETypeClass32>(peBase, imports, importSection, import_settings)
-	//				:
-	//				rebuildImportsBase<PETypeClass64>(peBase, imports, importSection, import_settings)
-	//		);
-	//}
-
-	// TODO - PEImportAdder
-	//template<typename PEClassType>
-	//const PEImageDirectory rebuildImportsBase(	PEBase& pe,
-	//											const PEIMPORTED_FUNCTIONS_LIST& imports,
-	//											PESection& importSection,
-	//											const PEImportRebuilderSettings& import_settings
-	//) {
-	//
-	//}
 }
\ No newline at end of file
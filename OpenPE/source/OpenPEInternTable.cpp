@@ -0,0 +1,222 @@
+#include "OpenPEInternTable.h"
+#include "OpenPEException.h"
+#include <string.h>
+
+namespace OpenPE
+{
+	// Process-wide table, constructed before main() (function-local statics are not thread-safe on VS2013)
+	static PEInternTable g_peGlobalInternTable;
+
+	// Default Constructor
+	PEInternTable::PEInternTable()
+		: m_pBlockPosition(0)
+		, m_iBlockAvailable(0)
+		, m_iMemoryUsage(0)
+	{
+		for (uint32_t i = 0; i < MAX_PAGES; i++)
+			m_pPages[i].store(0, std::memory_order_relaxed);
+
+		PESlotArray* pSlotArray = new PESlotArray();
+		pSlotArray->m_iMask = INITIAL_SLOTS - 1;
+		pSlotArray->m_pSlots = new std::atomic<PESymbolID>[INITIAL_SLOTS];
+		pSlotArray->m_pPrevious = 0;
+		for (uint32_t i = 0; i < INITIAL_SLOTS; i++)
+			pSlotArray->m_pSlots[i].store(PE_NO_SYMBOL, std::memory_order_relaxed);
+
+		m_iMemoryUsage += sizeof(PESlotArray) + INITIAL_SLOTS * sizeof(std::atomic<PESymbolID>);
+
+		m_pSlotArray.store(pSlotArray, std::memory_order_release);
+		m_iNumberOfSymbols.store(0, std::memory_order_release);
+	}
+
+	// Destructor
+	PEInternTable::~PEInternTable()
+	{
+		PESlotArray* pSlotArray = m_pSlotArray.load(std::memory_order_relaxed);
+		while (pSlotArray)
+		{
+			PESlotArray* pPrevious = pSlotArray->m_pPrevious;
+			delete[] pSlotArray->m_pSlots;
+			delete pSlotArray;
+			pSlotArray = pPrevious;
+		}
+
+		for (uint32_t i = 0; i < MAX_PAGES; i++)
+			delete[] m_pPages[i].load(std::memory_order_relaxed);
+
+		for (std::vector<char*>::iterator itr = m_vBlocks.begin(); itr != m_vBlocks.end(); ++itr)
+			delete[] *itr;
+	}
+
+	// Returns the table shared by the whole process (used by PE_NAME_STORAGE_INTERN)
+	PEInternTable& PEInternTable::getGlobal()
+	{
+		return g_peGlobalInternTable;
+	}
+
+	// Returns symbol of the name, stores the name if it is not in the table yet
+	PESymbolID PEInternTable::intern(const PEStringView& sName)
+	{
+		const uint32_t iHash = PEUtils::hashName(sName);
+
+		// Most names are already in the table, look them up without locking
+		PESymbolID iSymbol = findInSlots(m_pSlotArray.load(std::memory_order_acquire), sName, iHash);
+		if (iSymbol NOT_EQUAL_TO PE_NO_SYMBOL)
+			return iSymbol;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		// Other thread may have interned the name (or replaced the slots) meanwhile
+		iSymbol = findInSlots(m_pSlotArray.load(std::memory_order_acquire), sName, iHash);
+		if (iSymbol NOT_EQUAL_TO PE_NO_SYMBOL)
+			return iSymbol;
+
+		const uint32_t iNumberOfSymbols = m_iNumberOfSymbols.load(std::memory_order_relaxed);
+		if (iNumberOfSymbols >= MAX_PAGES * PAGE_SIZE - 1 || static_cast<uint64_t>(sName.length()) > 0xFFFFFFFF)
+			throw PEException("Intern table is full.", PEException::PEEXCEPTION_INSUFFICIENT_SPACE);
+
+		// Keep at most half of the slots used
+		if ((iNumberOfSymbols + 1) * 2 > m_pSlotArray.load(std::memory_order_relaxed)->m_iMask + 1)
+			growSlots();
+
+		// Symbols start with 1, entry of symbol S is (S - 1) of the pages
+		iSymbol = iNumberOfSymbols + 1;
+		const uint32_t iPage = iNumberOfSymbols >> PAGE_SHIFT;
+
+		PESymbolEntry* pPage = m_pPages[iPage].load(std::memory_order_relaxed);
+		if (NOT pPage)
+		{
+			pPage = new PESymbolEntry[PAGE_SIZE];
+			m_iMemoryUsage += PAGE_SIZE * sizeof(PESymbolEntry);
+			m_pPages[iPage].store(pPage, std::memory_order_release);
+		}
+
+		PESymbolEntry& peEntry = pPage[iNumberOfSymbols & (PAGE_SIZE - 1)];
+		peEntry.m_pName = storeName(sName);
+		peEntry.m_iLength = static_cast<uint32_t>(sName.length());
+		peEntry.m_iHash = iHash;
+
+		// The entry must be complete before readers can reach it through the symbol count or a slot
+		m_iNumberOfSymbols.store(iSymbol, std::memory_order_release);
+
+		PESlotArray* pSlotArray = m_pSlotArray.load(std::memory_order_relaxed);
+		uint32_t iSlot = iHash & pSlotArray->m_iMask;
+		while (pSlotArray->m_pSlots[iSlot].load(std::memory_order_relaxed) NOT_EQUAL_TO PE_NO_SYMBOL)
+			iSlot = (iSlot + 1) & pSlotArray->m_iMask;
+
+		pSlotArray->m_pSlots[iSlot].store(iSymbol, std::memory_order_release);
+
+		return iSymbol;
+	}
+
+	// Returns symbol of the name, or PE_NO_SYMBOL if it is not in the table
+	PESymbolID PEInternTable::find(const PEStringView& sName) const
+	{
+		return findInSlots(m_pSlotArray.load(std::memory_order_acquire), sName, PEUtils::hashName(sName));
+	}
+
+	// Returns name of the symbol (null-terminated), empty if there is no such symbol
+	const PEStringView PEInternTable::getName(PESymbolID iSymbol) const
+	{
+		if (iSymbol == PE_NO_SYMBOL || iSymbol > m_iNumberOfSymbols.load(std::memory_order_acquire))
+			return PEStringView();
+
+		const PESymbolEntry& peEntry = getEntry(iSymbol);
+		return PEStringView(peEntry.m_pName, peEntry.m_iLength);
+	}
+
+	// Returns number of symbols
+	uint32_t PEInternTable::getNumberOfSymbols() const
+	{
+		return m_iNumberOfSymbols.load(std::memory_order_acquire);
+	}
+
+	// Returns number of bytes allocated by the table
+	size_t PEInternTable::getMemoryUsage() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_iMemoryUsage;
+	}
+
+	// Returns entry of the (existing) symbol
+	const PEInternTable::PESymbolEntry& PEInternTable::getEntry(PESymbolID iSymbol) const
+	{
+		const uint32_t iIndex = iSymbol - 1;
+		return m_pPages[iIndex >> PAGE_SHIFT].load(std::memory_order_acquire)[iIndex & (PAGE_SIZE - 1)];
+	}
+
+	// Probes the slot array for the name
+	PESymbolID PEInternTable::findInSlots(const PESlotArray* pSlotArray, const PEStringView& sName, uint32_t iHash) const
+	{
+		for (uint32_t iSlot = iHash & pSlotArray->m_iMask; ; iSlot = (iSlot + 1) & pSlotArray->m_iMask)
+		{
+			const PESymbolID iSymbol = pSlotArray->m_pSlots[iSlot].load(std::memory_order_acquire);
+			if (iSymbol == PE_NO_SYMBOL)
+				return PE_NO_SYMBOL;
+
+			const PESymbolEntry& peEntry = getEntry(iSymbol);
+			if (	peEntry.m_iHash == iHash
+					&&
+					peEntry.m_iLength == sName.length()
+					&&
+					memcmp(peEntry.m_pName, sName.data(), sName.length()) == 0)
+				return iSymbol;
+		}
+	}
+
+	// Copies the name into the name blocks (lock must be held)
+	const char* PEInternTable::storeName(const PEStringView& sName)
+	{
+		const size_t iSize = sName.length() + 1;
+
+		if (iSize > m_iBlockAvailable)
+		{
+			const size_t iBlockSize = iSize > BLOCK_SIZE ? iSize : BLOCK_SIZE;
+			m_vBlocks.push_back(new char[iBlockSize]);
+			m_iMemoryUsage += iBlockSize;
+
+			m_pBlockPosition = m_vBlocks.back();
+			m_iBlockAvailable = iBlockSize;
+		}
+
+		char* pName = m_pBlockPosition;
+		if (sName.length())
+			memcpy(pName, sName.data(), sName.length());
+		pName[sName.length()] = 0;
+
+		m_pBlockPosition += iSize;
+		m_iBlockAvailable -= iSize;
+
+		return pName;
+	}
+
+	// Doubles the number of slots (lock must be held)
+	void PEInternTable::growSlots()
+	{
+		PESlotArray* pOldSlotArray = m_pSlotArray.load(std::memory_order_relaxed);
+		const uint32_t iNumberOfSlots = (pOldSlotArray->m_iMask + 1) * 2;
+
+		PESlotArray* pSlotArray = new PESlotArray();
+		pSlotArray->m_iMask = iNumberOfSlots - 1;
+		pSlotArray->m_pSlots = new std::atomic<PESymbolID>[iNumberOfSlots];
+		pSlotArray->m_pPrevious = pOldSlotArray;
+		for (uint32_t i = 0; i < iNumberOfSlots; i++)
+			pSlotArray->m_pSlots[i].store(PE_NO_SYMBOL, std::memory_order_relaxed);
+
+		m_iMemoryUsage += sizeof(PESlotArray) + iNumberOfSlots * sizeof(std::atomic<PESymbolID>);
+
+		// Rehash from the stored hashes, names are not touched
+		const uint32_t iNumberOfSymbols = m_iNumberOfSymbols.load(std::memory_order_relaxed);
+		for (PESymbolID iSymbol = 1; iSymbol <= iNumberOfSymbols; iSymbol++)
+		{
+			uint32_t iSlot = getEntry(iSymbol).m_iHash & pSlotArray->m_iMask;
+			while (pSlotArray->m_pSlots[iSlot].load(std::memory_order_relaxed) NOT_EQUAL_TO PE_NO_SYMBOL)
+				iSlot = (iSlot + 1) & pSlotArray->m_iMask;
+
+			pSlotArray->m_pSlots[iSlot].store(iSymbol, std::memory_order_relaxed);
+		}
+
+		// Readers which loaded the old array keep probing it, it is complete for all symbols published before
+		m_pSlotArray.store(pSlotArray, std::memory_order_release);
+	}
+}
\ No newline at end of file
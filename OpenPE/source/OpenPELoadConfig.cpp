@@ -0,0 +1,380 @@
+#include "OpenPELoadConfig.h"
+#include "OpenPEDataCursor.h"
+#include "OpenPEPropertiesGeneric.h"
+#include <algorithm>
+#include <string.h>
+
+namespace OpenPE
+{
+	// Helper: returns data of a table of the Load Configuration Directory (iCount entries of iEntrySize bytes at VA)
+	// Throws PEException if the table is not inside the Image data
+	template<typename BaseSize>
+	static const char* getLoadConfigTable(const PEBase& peBase, PEDataCursor& peCursor, BaseSize iVA, BaseSize iCount, uint32_t iEntrySize)
+	{
+		uint32_t iAvailable = 0;
+		const char* pData = 0;
+
+		const uint64_t iOffset = static_cast<uint64_t>(iVA) - peBase.getImageBase64();
+		if (static_cast<uint64_t>(iVA) >= peBase.getImageBase64() && iOffset < peBase.getSizeOfImage())
+			pData = peCursor.tryGetData(static_cast<uint32_t>(iOffset), iAvailable);
+
+		if (NOT pData || static_cast<uint64_t>(iCount) > iAvailable / iEntrySize)
+			throw PEException("Incorrect load configuration directory", PEException::PEEXCEPTION_INCORRECT_LOAD_CONFIG_DIRECTORY);
+
+		return pData;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor (empty table)
+	PEGuardTable::PEGuardTable()
+	{
+	}
+
+	// Returns number of entries
+	size_t PEGuardTable::size() const
+	{
+		return m_vRVAs.size();
+	}
+
+	// Returns 'true' if table has no entries
+	bool PEGuardTable::empty() const
+	{
+		return m_vRVAs.empty();
+	}
+
+	// Returns RVA of entry at index
+	uint32_t PEGuardTable::getRVA(size_t iIndex) const
+	{
+		return m_vRVAs[iIndex];
+	}
+
+	// Returns metadata of entry at index (IMAGE_GUARD_FLAG_*, 0 if the table has no metadata)
+	uint8_t PEGuardTable::getFlags(size_t iIndex) const
+	{
+		return m_vFlags.empty() ? 0 : m_vFlags[iIndex];
+	}
+
+	// Returns the sorted RVAs
+	const std::vector<uint32_t>& PEGuardTable::getRVAs() const
+	{
+		return m_vRVAs;
+	}
+
+	// Returns 'true' if RVA is in the table
+	bool PEGuardTable::contains(uint32_t iRVA) const
+	{
+		return std::binary_search(m_vRVAs.begin(), m_vRVAs.end(), iRVA);
+	}
+
+	// Sets iIndex to the index of the RVA, returns 'false' if it is not in the table
+	bool PEGuardTable::find(uint32_t iRVA, size_t& iIndex) const
+	{
+		std::vector<uint32_t>::const_iterator itr = std::lower_bound(m_vRVAs.begin(), m_vRVAs.end(), iRVA);
+		if (itr == m_vRVAs.end() || *itr NOT_EQUAL_TO iRVA)
+			return false;
+
+		iIndex = itr - m_vRVAs.begin();
+		return true;
+	}
+
+	// Clears the table (keeps capacity)
+	void PEGuardTable::clear()
+	{
+		m_vRVAs.clear();
+		m_vFlags.clear();
+	}
+
+	// Decodes iCount entries of iEntrySize bytes (RVA, then metadata) at pData & sorts them
+	void PEGuardTable::assign(const char* pData, uint32_t iCount, uint32_t iEntrySize)
+	{
+		const bool bHasFlags = iEntrySize > sizeof(uint32_t);
+
+		m_vRVAs.resize(iCount);
+		m_vFlags.resize(bHasFlags ? iCount : 0);
+
+		bool bSorted = true;
+		for (uint32_t i = 0; i < iCount; i++)
+		{
+			memcpy(&m_vRVAs[i], pData + static_cast<size_t>(i) * iEntrySize, sizeof(uint32_t));
+			if (bHasFlags)
+				m_vFlags[i] = static_cast<uint8_t>(pData[static_cast<size_t>(i) * iEntrySize + sizeof(uint32_t)]);
+
+			if (i && m_vRVAs[i] < m_vRVAs[i - 1])
+				bSorted = false;
+		}
+
+		// Linkers write the tables sorted, only malformed Images pay for sorting
+		if (bSorted)
+			return;
+
+		if (NOT bHasFlags)
+		{
+			std::sort(m_vRVAs.begin(), m_vRVAs.end());
+			return;
+		}
+
+		std::vector<uint64_t> vEntries(iCount);
+		for (uint32_t i = 0; i < iCount; i++)
+			vEntries[i] = (static_cast<uint64_t>(m_vRVAs[i]) << 8) | m_vFlags[i];
+
+		std::sort(vEntries.begin(), vEntries.end());
+
+		for (uint32_t i = 0; i < iCount; i++)
+		{
+			m_vRVAs[i] = static_cast<uint32_t>(vEntries[i] >> 8);
+			m_vFlags[i] = static_cast<uint8_t>(vEntries[i]);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor
+	PELoadConfig::PELoadConfig()
+	{
+		clear();
+	}
+
+	// Returns Size of the structure in the Image (its version)
+	uint32_t PELoadConfig::getSize() const
+	{
+		return m_iSize;
+	}
+
+	// Returns TimeDateStamp
+	uint32_t PELoadConfig::getTimeDateStamp() const
+	{
+		return m_iTimeDateStamp;
+	}
+
+	// Returns major version
+	uint16_t PELoadConfig::getMajorVersion() const
+	{
+		return m_iMajorVersion;
+	}
+
+	// Returns minor version
+	uint16_t PELoadConfig::getMinorVersion() const
+	{
+		return m_iMinorVersion;
+	}
+
+	// Returns global flags cleared by the loader
+	uint32_t PELoadConfig::getGlobalFlagsClear() const
+	{
+		return m_iGlobalFlagsClear;
+	}
+
+	// Returns global flags set by the loader
+	uint32_t PELoadConfig::getGlobalFlagsSet() const
+	{
+		return m_iGlobalFlagsSet;
+	}
+
+	// Returns VA of the /GS security cookie
+	uint64_t PELoadConfig::getSecurityCookie() const
+	{
+		return m_iSecurityCookie;
+	}
+
+	// Returns VA of the Control Flow Guard check function pointer
+	uint64_t PELoadConfig::getGuardCFCheckFunctionPointer() const
+	{
+		return m_iGuardCFCheckFunctionPointer;
+	}
+
+	// Returns VA of the Control Flow Guard dispatch function pointer
+	uint64_t PELoadConfig::getGuardCFDispatchFunctionPointer() const
+	{
+		return m_iGuardCFDispatchFunctionPointer;
+	}
+
+	// Returns VA of the XFG check function pointer
+	uint64_t PELoadConfig::getGuardXFGCheckFunctionPointer() const
+	{
+		return m_iGuardXFGCheckFunctionPointer;
+	}
+
+	// Returns VA of the XFG dispatch function pointer
+	uint64_t PELoadConfig::getGuardXFGDispatchFunctionPointer() const
+	{
+		return m_iGuardXFGDispatchFunctionPointer;
+	}
+
+	// Returns VA of the XFG table dispatch function pointer
+	uint64_t PELoadConfig::getGuardXFGTableDispatchFunctionPointer() const
+	{
+		return m_iGuardXFGTableDispatchFunctionPointer;
+	}
+
+	// Returns GuardFlags (IMAGE_GUARD_*)
+	uint32_t PELoadConfig::getGuardFlags() const
+	{
+		return m_iGuardFlags;
+	}
+
+	// Returns dependent load flags (LOAD_LIBRARY_SEARCH_*)
+	uint16_t PELoadConfig::getDependentLoadFlags() const
+	{
+		return m_iDependentLoadFlags;
+	}
+
+	// Returns SafeSEH handler table (32-bit Images)
+	const PEGuardTable& PELoadConfig::getSEHandlerTable() const
+	{
+		return m_SEHandlerTable;
+	}
+
+	// Returns Guard CF function table (valid indirect call targets)
+	const PEGuardTable& PELoadConfig::getGuardCFFunctionTable() const
+	{
+		return m_GuardCFFunctionTable;
+	}
+
+	// Returns Guard address-taken IAT entry table
+	const PEGuardTable& PELoadConfig::getGuardAddressTakenIATEntryTable() const
+	{
+		return m_GuardAddressTakenIATEntryTable;
+	}
+
+	// Returns Guard long jump target table
+	const PEGuardTable& PELoadConfig::getGuardLongJumpTargetTable() const
+	{
+		return m_GuardLongJumpTargetTable;
+	}
+
+	// Returns Guard EH continuation table
+	const PEGuardTable& PELoadConfig::getGuardEHContinuationTable() const
+	{
+		return m_GuardEHContinuationTable;
+	}
+
+	// Clears the information (keeps capacity of the tables)
+	void PELoadConfig::clear()
+	{
+		m_iSize = 0;
+		m_iTimeDateStamp = 0;
+		m_iMajorVersion = 0;
+		m_iMinorVersion = 0;
+		m_iGlobalFlagsClear = 0;
+		m_iGlobalFlagsSet = 0;
+		m_iSecurityCookie = 0;
+		m_iGuardCFCheckFunctionPointer = 0;
+		m_iGuardCFDispatchFunctionPointer = 0;
+		m_iGuardXFGCheckFunctionPointer = 0;
+		m_iGuardXFGDispatchFunctionPointer = 0;
+		m_iGuardXFGTableDispatchFunctionPointer = 0;
+		m_iGuardFlags = 0;
+		m_iDependentLoadFlags = 0;
+
+		m_SEHandlerTable.clear();
+		m_GuardCFFunctionTable.clear();
+		m_GuardAddressTakenIATEntryTable.clear();
+		m_GuardLongJumpTargetTable.clear();
+		m_GuardEHContinuationTable.clear();
+	}
+
+	// Reads Load Configuration Directory of the Image & its tables
+	bool readLoadConfig(const PEBase& peBase, PELoadConfig& peLoadConfig)
+	{
+		return (	peBase.getPEType() == PEType_32
+					?
+					readLoadConfigBase<PETypeClass32>(peBase, peLoadConfig)
+					:
+					readLoadConfigBase<PETypeClass64>(peBase, peLoadConfig)
+			);
+	}
+
+	template<typename PEClassType>
+	bool readLoadConfigBase(const PEBase& peBase, PELoadConfig& peLoadConfig)
+	{
+		typedef typename PEClassType::ConfigStruct ConfigStruct;
+		typedef typename PEClassType::BaseSize BaseSize;
+
+		peLoadConfig.clear();
+
+		if (NOT peBase.hasConfig())
+			return false;
+
+		PEDataCursor peCursor(peBase);
+
+		uint32_t iAvailable;
+		const char* pDirectory = peCursor.tryGetData(peBase.getDirectoryRVA(IMAGE_DIRECTORY_ENTRY_LOAD_CONFIG), iAvailable);
+		if (NOT pDirectory || iAvailable < sizeof(uint32_t))
+			throw PEException("Incorrect load configuration directory", PEException::PEEXCEPTION_INCORRECT_LOAD_CONFIG_DIRECTORY);
+
+		// Size tells the version: fields past it (or past the data) are left zero
+		uint32_t iSize;
+		memcpy(&iSize, pDirectory, sizeof(uint32_t));
+		if (iSize > iAvailable)
+			throw PEException("Incorrect load configuration directory", PEException::PEEXCEPTION_INCORRECT_LOAD_CONFIG_DIRECTORY);
+
+		ConfigStruct peDirectory;
+		memset(&peDirectory, 0, sizeof(ConfigStruct));
+		memcpy(&peDirectory, pDirectory, std::min<uint32_t>(iSize, sizeof(ConfigStruct)));
+
+		peLoadConfig.m_iSize = iSize;
+		peLoadConfig.m_iTimeDateStamp = peDirectory.TimeDateStamp;
+		peLoadConfig.m_iMajorVersion = peDirectory.MajorVersion;
+		peLoadConfig.m_iMinorVersion = peDirectory.MinorVersion;
+		peLoadConfig.m_iGlobalFlagsClear = peDirectory.GlobalFlagsClear;
+		peLoadConfig.m_iGlobalFlagsSet = peDirectory.GlobalFlagsSet;
+		peLoadConfig.m_iSecurityCookie = peDirectory.SecurityCookie;
+		peLoadConfig.m_iGuardCFCheckFunctionPointer = peDirectory.GuardCFCheckFunctionPointer;
+		peLoadConfig.m_iGuardCFDispatchFunctionPointer = peDirectory.GuardCFDispatchFunctionPointer;
+		peLoadConfig.m_iGuardXFGCheckFunctionPointer = peDirectory.GuardXFGCheckFunctionPointer;
+		peLoadConfig.m_iGuardXFGDispatchFunctionPointer = peDirectory.GuardXFGDispatchFunctionPointer;
+		peLoadConfig.m_iGuardXFGTableDispatchFunctionPointer = peDirectory.GuardXFGTableDispatchFunctionPointer;
+		peLoadConfig.m_iGuardFlags = peDirectory.GuardFlags;
+		peLoadConfig.m_iDependentLoadFlags = peDirectory.DependentLoadFlags;
+
+		// SafeSEH handlers are plain RVAs, entries of the Guard tables may be followed by metadata bytes
+		if (peDirectory.SEHandlerTable && peDirectory.SEHandlerCount)
+		{
+			const char* pTable = getLoadConfigTable<BaseSize>(peBase, peCursor, peDirectory.SEHandlerTable, peDirectory.SEHandlerCount, sizeof(uint32_t));
+			peLoadConfig.m_SEHandlerTable.assign(pTable, static_cast<uint32_t>(peDirectory.SEHandlerCount), sizeof(uint32_t));
+		}
+
+		const uint32_t iEntrySize = sizeof(uint32_t) + ((peDirectory.GuardFlags & IMAGE_GUARD_CF_FUNCTION_TABLE_SIZE_MASK) >> IMAGE_GUARD_CF_FUNCTION_TABLE_SIZE_SHIFT);
+
+		if (peDirectory.GuardCFFunctionTable && peDirectory.GuardCFFunctionCount)
+		{
+			const char* pTable = getLoadConfigTable<BaseSize>(peBase, peCursor, peDirectory.GuardCFFunctionTable, peDirectory.GuardCFFunctionCount, iEntrySize);
+			peLoadConfig.m_GuardCFFunctionTable.assign(pTable, static_cast<uint32_t>(peDirectory.GuardCFFunctionCount), iEntrySize);
+		}
+
+		if (peDirectory.GuardAddressTakenIatEntryTable && peDirectory.GuardAddressTakenIatEntryCount)
+		{
+			const char* pTable = getLoadConfigTable<BaseSize>(peBase, peCursor, peDirectory.GuardAddressTakenIatEntryTable, peDirectory.GuardAddressTakenIatEntryCount, iEntrySize);
+			peLoadConfig.m_GuardAddressTakenIATEntryTable.assign(pTable, static_cast<uint32_t>(peDirectory.GuardAddressTakenIatEntryCount), iEntrySize);
+		}
+
+		if (peDirectory.GuardLongJumpTargetTable && peDirectory.GuardLongJumpTargetCount)
+		{
+			const char* pTable = getLoadConfigTable<BaseSize>(peBase, peCursor, peDirectory.GuardLongJumpTargetTable, peDirectory.GuardLongJumpTargetCount, iEntrySize);
+			peLoadConfig.m_GuardLongJumpTargetTable.assign(pTable, static_cast<uint32_t>(peDirectory.GuardLongJumpTargetCount), iEntrySize);
+		}
+
+		if (peDirectory.GuardEHContinuationTable && peDirectory.GuardEHContinuationCount)
+		{
+			const char* pTable = getLoadConfigTable<BaseSize>(peBase, peCursor, peDirectory.GuardEHContinuationTable, peDirectory.GuardEHContinuationCount, iEntrySize);
+			peLoadConfig.m_GuardEHContinuationTable.assign(pTable, static_cast<uint32_t>(peDirectory.GuardEHContinuationCount), iEntrySize);
+		}
+
+		return true;
+	}
+
+	// Reads XFG type hash of the function (the QWORD preceding it), returns 'false' if it is not inside the Image data
+	bool readXFGHash(const PEBase& peBase, uint32_t iFunctionRVA, uint64_t& iHash)
+	{
+		if (iFunctionRVA < sizeof(uint64_t))
+			return false;
+
+		uint32_t iAvailable;
+		PEDataCursor peCursor(peBase);
+		const char* pData = peCursor.tryGetData(iFunctionRVA - sizeof(uint64_t), iAvailable);
+		if (NOT pData || iAvailable < sizeof(uint64_t))
+			return false;
+
+		memcpy(&iHash, pData, sizeof(uint64_t));
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,226 @@
+#include "OpenPEMessageTable.h"
+#include "OpenPEException.h"
+#include <string.h>
+
+namespace OpenPE
+{
+	// Helper: returns 16-bit little-endian value at pData
+	static inline uint16_t readMessageWord(const char* pData)
+	{
+		return static_cast<uint16_t>(static_cast<uint8_t>(pData[0]) | (static_cast<uint8_t>(pData[1]) << 8));
+	}
+
+	// Helper: returns slot of the message ID
+	static inline uint32_t getMessageSlot(uint32_t iID, uint32_t iMask)
+	{
+		const uint32_t iHash = iID * 0x9E3779B1;
+		return (iHash ^ (iHash >> 16)) & iMask;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor
+	PEMessage::PEMessage()
+		: m_iID(0)
+		, m_iFlags(0)
+	{
+	}
+
+	// Returns ID of the message
+	uint32_t PEMessage::getID() const
+	{
+		return m_iID;
+	}
+
+	// Returns flags of the entry (MESSAGE_RESOURCE_UNICODE, MESSAGE_RESOURCE_UTF8)
+	uint16_t PEMessage::getFlags() const
+	{
+		return m_iFlags;
+	}
+
+	// Returns 'true' if the text is UTF-16
+	bool PEMessage::isUnicode() const
+	{
+		return (m_iFlags & MESSAGE_RESOURCE_UNICODE) NOT_EQUAL_TO 0;
+	}
+
+	// Returns ANSI/UTF-8 text (empty if the text is UTF-16), without trailing nulls
+	const PEStringView& PEMessage::getText() const
+	{
+		return m_vText;
+	}
+
+	// Returns UTF-16 text (empty if the text is ANSI/UTF-8), without trailing nulls
+	const PEWideStringView& PEMessage::getWideText() const
+	{
+		return m_vWideText;
+	}
+
+	// Returns the text, UTF-16 text is converted to UTF-8 (ANSI text is returned as is)
+	std::string PEMessage::str() const
+	{
+		return isUnicode() ? m_vWideText.str() : m_vText.str();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor (no messages)
+	PEMessageTable::PEMessageTable()
+	{
+	}
+
+	// Decodes all message tables of the language, returns 'false' if Image has no message table
+	bool PEMessageTable::load(const PEResources& peResources, uint32_t iLanguage)
+	{
+		clear();
+
+		PEResourceEntry peTypeEntry;
+		if (	NOT peResources.hasResources()
+				||
+				NOT peResources.getRoot().findEntry(static_cast<uint16_t>(PE_RESOURCE_MESSAGETABLE), peTypeEntry)
+				||
+				NOT peTypeEntry.isDirectory()
+		) {
+			return false;
+		}
+
+		bool bHasTable = false;
+
+		const PEResourceDirectory peNames = peTypeEntry.getDirectory();
+		for (PEResourceDirectory::const_iterator itr = peNames.begin(); itr NOT_EQUAL_TO peNames.end(); ++itr)
+		{
+			PEResourceData peData;
+			if (NOT peResources.findLanguage(*itr, iLanguage, peData))
+				continue;
+
+			if (NOT peData.hasData())
+				throw PEException("Incorrect message table", PEException::PEEXCEPTION_INCORRECT_RESOURCE_DATA);
+
+			addMessages(peData.getData(), peData.getSize());
+			bHasTable = true;
+		}
+
+		buildSlots();
+
+		return bHasTable;
+	}
+
+	// Returns number of messages
+	size_t PEMessageTable::getNumberOfMessages() const
+	{
+		return m_vMessages.size();
+	}
+
+	// Returns all messages (ID order of the tables)
+	const PEMESSAGE_LIST& PEMessageTable::getMessages() const
+	{
+		return m_vMessages;
+	}
+
+	// Returns the message with the ID, or 0 if there is none
+	const PEMessage* PEMessageTable::findMessage(uint32_t iID) const
+	{
+		if (m_vSlots.empty())
+			return 0;
+
+		const uint32_t iMask = static_cast<uint32_t>(m_vSlots.size()) - 1;
+		for (uint32_t iSlot = getMessageSlot(iID, iMask); m_vSlots[iSlot]; iSlot = (iSlot + 1) & iMask)
+		{
+			const PEMessage& peMessage = m_vMessages[m_vSlots[iSlot] - 1];
+			if (peMessage.m_iID == iID)
+				return &peMessage;
+		}
+
+		return 0;
+	}
+
+	// Clears the table (keeps capacity of the lists)
+	void PEMessageTable::clear()
+	{
+		m_vMessages.clear();
+		m_vSlots.clear();
+	}
+
+	// Decodes MESSAGE_RESOURCE_DATA of iSize bytes at pData into the message list
+	void PEMessageTable::addMessages(const char* pData, uint32_t iSize)
+	{
+		uint32_t iNumberOfBlocks;
+		if (iSize < sizeof(uint32_t))
+			throw PEException("Incorrect message table", PEException::PEEXCEPTION_INCORRECT_RESOURCE_DATA);
+
+		memcpy(&iNumberOfBlocks, pData, sizeof(uint32_t));
+		if (iNumberOfBlocks > (iSize - sizeof(uint32_t)) / sizeof(MESSAGE_RESOURCE_BLOCK))
+			throw PEException("Incorrect message table", PEException::PEEXCEPTION_INCORRECT_RESOURCE_DATA);
+
+		for (uint32_t iBlock = 0; iBlock < iNumberOfBlocks; iBlock++)
+		{
+			MESSAGE_RESOURCE_BLOCK peBlock;
+			memcpy(&peBlock, pData + sizeof(uint32_t) + iBlock * sizeof(MESSAGE_RESOURCE_BLOCK), sizeof(MESSAGE_RESOURCE_BLOCK));
+
+			if (peBlock.iLowId > peBlock.iHighId)
+				throw PEException("Incorrect message table", PEException::PEEXCEPTION_INCORRECT_RESOURCE_DATA);
+
+			// Every entry takes at least its header, so a block cannot claim more entries than the data holds
+			uint32_t iOffset = peBlock.iOffsetToEntries;
+			for (uint64_t iID = peBlock.iLowId; iID <= peBlock.iHighId; iID++)
+			{
+				if (iOffset > iSize || iSize - iOffset < MESSAGE_RESOURCE_ENTRY_HEADER_SIZE)
+					throw PEException("Incorrect message table", PEException::PEEXCEPTION_INCORRECT_RESOURCE_DATA);
+
+				const uint16_t iLength = readMessageWord(pData + iOffset);
+				const uint16_t iFlags = readMessageWord(pData + iOffset + sizeof(uint16_t));
+				if (iLength < MESSAGE_RESOURCE_ENTRY_HEADER_SIZE || iLength > iSize - iOffset)
+					throw PEException("Incorrect message table", PEException::PEEXCEPTION_INCORRECT_RESOURCE_DATA);
+
+				PEMessage peMessage;
+				peMessage.m_iID = static_cast<uint32_t>(iID);
+				peMessage.m_iFlags = iFlags;
+
+				// Entries are padded with nulls
+				const char* pText = pData + iOffset + MESSAGE_RESOURCE_ENTRY_HEADER_SIZE;
+				size_t iTextLength = iLength - MESSAGE_RESOURCE_ENTRY_HEADER_SIZE;
+				if (iFlags & MESSAGE_RESOURCE_UNICODE)
+				{
+					iTextLength /= sizeof(uint16_t);
+					while (iTextLength && readMessageWord(pText + (iTextLength - 1) * sizeof(uint16_t)) == 0)
+						iTextLength--;
+
+					peMessage.m_vWideText = PEWideStringView(pText, iTextLength);
+				}
+				else
+				{
+					while (iTextLength && pText[iTextLength - 1] == 0)
+						iTextLength--;
+
+					peMessage.m_vText = PEStringView(pText, iTextLength);
+				}
+
+				m_vMessages.push_back(peMessage);
+				iOffset += iLength;
+			}
+		}
+	}
+
+	// Builds the table of IDs (at most half full, so that probe sequences stay short)
+	void PEMessageTable::buildSlots()
+	{
+		if (m_vMessages.empty())
+			return;
+
+		uint32_t iNumberOfSlots = 1;
+		while (iNumberOfSlots <= m_vMessages.size() * 2)
+			iNumberOfSlots <<= 1;
+
+		m_vSlots.assign(iNumberOfSlots, 0);
+
+		const uint32_t iMask = iNumberOfSlots - 1;
+		for (size_t i = 0; i < m_vMessages.size(); i++)
+		{
+			uint32_t iSlot = getMessageSlot(m_vMessages[i].m_iID, iMask);
+			while (m_vSlots[iSlot] && m_vMessages[m_vSlots[iSlot] - 1].m_iID NOT_EQUAL_TO m_vMessages[i].m_iID)
+				iSlot = (iSlot + 1) & iMask;
+
+			// The first message with the ID is kept
+			if (NOT m_vSlots[iSlot])
+				m_vSlots[iSlot] = static_cast<uint32_t>(i + 1);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,595 @@
+#include "OpenPEModuleCorpus.h"
+#include "OpenPEFactory.h"
+#include <algorithm>
+#include <fstream>
+
+namespace OpenPE
+{
+	// Offset of strings which don't exist
+	static const uint32_t NO_STRING = static_cast<uint32_t>(-1);
+
+	// Module cache signature ("OPEC") & format version
+	static const uint32_t MODULE_CACHE_SIGNATURE = 0x4345504F;
+	static const uint32_t MODULE_CACHE_VERSION = 1;
+
+	// Maximum size of strings of a single library in module cache
+	static const uint32_t MAX_CACHED_STRINGS_SIZE = 0x04000000;
+
+	// Helpers: write & read plain values, arrays & strings of module cache
+	template<typename T>
+	static void writeCacheValue(std::ostream& fStream, const T& value)
+	{
+		fStream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template<typename T>
+	static void writeCacheArray(std::ostream& fStream, const std::vector<T>& vArray)
+	{
+		writeCacheValue(fStream, static_cast<uint32_t>(vArray.size()));
+		if (NOT vArray.empty())
+			fStream.write(reinterpret_cast<const char*>(&vArray[0]), vArray.size() * sizeof(T));
+	}
+
+	static void writeCacheString(std::ostream& fStream, const std::string& sString)
+	{
+		writeCacheValue(fStream, static_cast<uint32_t>(sString.length()));
+		fStream.write(sString.data(), sString.length());
+	}
+
+	template<typename T>
+	static void readCacheValue(std::istream& fStream, T& value)
+	{
+		fStream.read(reinterpret_cast<char*>(&value), sizeof(T));
+		if (NOT fStream)
+			throw PEException("Incorrect module cache", PEException::PEEXCEPTION_INCORRECT_MODULE_CACHE);
+	}
+
+	template<typename T>
+	static void readCacheArray(std::istream& fStream, std::vector<T>& vArray, uint32_t iMaxSize)
+	{
+		uint32_t iSize;
+		readCacheValue(fStream, iSize);
+		if (iSize > iMaxSize)
+			throw PEException("Incorrect module cache", PEException::PEEXCEPTION_INCORRECT_MODULE_CACHE);
+
+		vArray.resize(iSize);
+		if (iSize)
+			fStream.read(reinterpret_cast<char*>(&vArray[0]), iSize * sizeof(T));
+
+		if (NOT fStream)
+			throw PEException("Incorrect module cache", PEException::PEEXCEPTION_INCORRECT_MODULE_CACHE);
+	}
+
+	static void readCacheString(std::istream& fStream, std::string& sString, uint32_t iMaxSize)
+	{
+		uint32_t iSize;
+		readCacheValue(fStream, iSize);
+		if (iSize > iMaxSize)
+			throw PEException("Incorrect module cache", PEException::PEEXCEPTION_INCORRECT_MODULE_CACHE);
+
+		sString.resize(iSize);
+		if (iSize)
+			fStream.read(&sString[0], iSize);
+
+		if (NOT fStream)
+			throw PEException("Incorrect module cache", PEException::PEEXCEPTION_INCORRECT_MODULE_CACHE);
+	}
+
+	// Default Constructor
+	PEModuleExports::PEModuleExports()
+		: m_iTimeStamp(0)
+		, m_iImageBase(0)
+		, m_iOrdinalBase(0)
+		, m_iNumberOfExports(0)
+	{
+	}
+
+	// Constructor, takes the snapshot of exports of the library Image
+	PEModuleExports::PEModuleExports(const PEBase& peLibrary, const std::string& sModuleName)
+		: m_sName(sModuleName)
+		, m_iTimeStamp(peLibrary.getTimeDateStamp())
+		, m_iImageBase(peLibrary.getImageBase64())
+		, m_iOrdinalBase(0)
+		, m_iNumberOfExports(0)
+	{
+		PEExportTables peTables(peLibrary);
+		if (NOT peTables.hasExports())
+			return;
+
+		m_iOrdinalBase = peTables.getOrdinalBase();
+
+		// All ordinals must fit into 16 bits
+		uint32_t iNumberOfFunctions = peTables.getNumberOfFunctions();
+		if (iNumberOfFunctions && (	NOT PEUtils::isSumSafe(m_iOrdinalBase, iNumberOfFunctions - 1)
+									||
+									m_iOrdinalBase + iNumberOfFunctions - 1 > PEUtils::MAX_WORD)
+		) {
+			throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
+		}
+
+		// Copy AddressOfFunctions & forwarded names
+		m_vFunctionRVAs.resize(iNumberOfFunctions);
+		m_vForwarderOffsets.resize(iNumberOfFunctions, NO_STRING);
+		for (uint32_t i = 0; i < iNumberOfFunctions; i++)
+		{
+			uint32_t iRVA = peTables.getFunctionRVA(i);
+			if (NOT iRVA)
+				continue;
+
+			m_vFunctionRVAs[i] = iRVA;
+			m_iNumberOfExports++;
+
+			if (peTables.isForwarderRVA(iRVA))
+				m_vForwarderOffsets[i] = addString(peTables.getForwardedName(iRVA));
+		}
+
+		// Copy AddressOfNames & AddressOfNameOrdinals
+		uint32_t iNumberOfNames = peTables.getNumberOfNames();
+		m_vNameOffsets.reserve(iNumberOfNames);
+		m_vNameFunctionIndices.reserve(iNumberOfNames);
+		for (uint32_t i = 0; i < iNumberOfNames; i++)
+		{
+			uint16_t iNameOrdinal = peTables.getNameOrdinal(i);
+			if (iNameOrdinal >= iNumberOfFunctions)
+				throw PEException("Incorrect export directory", PEException::PEEXCEPTION_INCORRECT_EXPORT_DIRECTORY);
+
+			m_vNameOffsets.push_back(addString(peTables.getName(i)));
+			m_vNameFunctionIndices.push_back(iNameOrdinal);
+		}
+
+		buildNameHashTable();
+	}
+
+	// Returns file name of the library
+	const std::string& PEModuleExports::getName() const
+	{
+		return m_sName;
+	}
+
+	// Returns TimeDateStamp of the library (File Header)
+	uint32_t PEModuleExports::getTimeStamp() const
+	{
+		return m_iTimeStamp;
+	}
+
+	// Returns preferred Image base of the library
+	uint64_t PEModuleExports::getImageBase() const
+	{
+		return m_iImageBase;
+	}
+
+	// Returns ordinal base
+	uint32_t PEModuleExports::getOrdinalBase() const
+	{
+		return m_iOrdinalBase;
+	}
+
+	// Returns number of exported functions (non-zero entries of AddressOfFunctions)
+	uint32_t PEModuleExports::getNumberOfExports() const
+	{
+		return m_iNumberOfExports;
+	}
+
+	// Returns number of entries in AddressOfFunctions (including the empty ones)
+	uint32_t PEModuleExports::getNumberOfFunctions() const
+	{
+		return static_cast<uint32_t>(m_vFunctionRVAs.size());
+	}
+
+	// Returns number of named exports
+	uint32_t PEModuleExports::getNumberOfNames() const
+	{
+		return static_cast<uint32_t>(m_vNameOffsets.size());
+	}
+
+	// Looks up export by name, returns 'false' if there is none
+	bool PEModuleExports::findExport(const PEStringView& sName, PEExportEntry& peExport) const
+	{
+		if (m_vNameHashTable.empty())
+			return false;
+
+		uint32_t iMask = static_cast<uint32_t>(m_vNameHashTable.size() - 1);
+		for (uint32_t iSlot = PEUtils::hashName(sName) & iMask; m_vNameHashTable[iSlot]; iSlot = (iSlot + 1) & iMask)
+		{
+			uint32_t iNameIndex = m_vNameHashTable[iSlot] - 1;
+			if (getStringAt(m_vNameOffsets[iNameIndex]) NOT_EQUAL_TO sName)
+				continue;
+
+			uint16_t iIndex = m_vNameFunctionIndices[iNameIndex];
+			if (NOT m_vFunctionRVAs[iIndex])
+				return false;
+
+			getExport(iIndex, peExport);
+			peExport.m_bHasName = true;
+			peExport.m_vName = getStringAt(m_vNameOffsets[iNameIndex]);
+			peExport.m_iNameOrdinal = iIndex;
+
+			return true;
+		}
+
+		return false;
+	}
+
+	// Looks up export by ordinal (ordinal base included), returns 'false' if there is none
+	bool PEModuleExports::findExport(uint16_t iOrdinal, PEExportEntry& peExport) const
+	{
+		if (iOrdinal < m_iOrdinalBase || iOrdinal - m_iOrdinalBase >= m_vFunctionRVAs.size())
+			return false;
+
+		uint32_t iIndex = iOrdinal - m_iOrdinalBase;
+		if (NOT m_vFunctionRVAs[iIndex])
+			return false;
+
+		getExport(iIndex, peExport);
+
+		return true;
+	}
+
+	// Writes the snapshot to the stream (native byte order)
+	void PEModuleExports::save(std::ostream& fStream) const
+	{
+		writeCacheString(fStream, m_sName);
+		writeCacheValue(fStream, m_iTimeStamp);
+		writeCacheValue(fStream, m_iImageBase);
+		writeCacheValue(fStream, m_iOrdinalBase);
+		writeCacheString(fStream, m_sStrings);
+		writeCacheArray(fStream, m_vFunctionRVAs);
+		writeCacheArray(fStream, m_vForwarderOffsets);
+		writeCacheArray(fStream, m_vNameOffsets);
+		writeCacheArray(fStream, m_vNameFunctionIndices);
+	}
+
+	// Reads the snapshot written by save(), throws PEException if the data is incorrect
+	void PEModuleExports::load(std::istream& fStream)
+	{
+		PEModuleExports peModule;
+
+		readCacheString(fStream, peModule.m_sName, MAX_CACHED_STRINGS_SIZE);
+		readCacheValue(fStream, peModule.m_iTimeStamp);
+		readCacheValue(fStream, peModule.m_iImageBase);
+		readCacheValue(fStream, peModule.m_iOrdinalBase);
+		readCacheString(fStream, peModule.m_sStrings, MAX_CACHED_STRINGS_SIZE);
+		readCacheArray(fStream, peModule.m_vFunctionRVAs, PEUtils::MAX_WORD + 1);
+		readCacheArray(fStream, peModule.m_vForwarderOffsets, PEUtils::MAX_WORD + 1);
+		readCacheArray(fStream, peModule.m_vNameOffsets, MAX_CACHED_STRINGS_SIZE);
+		readCacheArray(fStream, peModule.m_vNameFunctionIndices, MAX_CACHED_STRINGS_SIZE);
+
+		// Lookups rely on these, so they are checked instead of trusted
+		uint32_t iNumberOfFunctions = static_cast<uint32_t>(peModule.m_vFunctionRVAs.size());
+		uint32_t iStringsSize = static_cast<uint32_t>(peModule.m_sStrings.length());
+		if (	peModule.m_vForwarderOffsets.size() NOT_EQUAL_TO iNumberOfFunctions
+				||
+				peModule.m_vNameOffsets.size() NOT_EQUAL_TO peModule.m_vNameFunctionIndices.size()
+				||
+				(iStringsSize && peModule.m_sStrings[iStringsSize - 1])
+				||
+				(iNumberOfFunctions && peModule.m_iOrdinalBase + iNumberOfFunctions - 1 > PEUtils::MAX_WORD)
+		) {
+			throw PEException("Incorrect module cache", PEException::PEEXCEPTION_INCORRECT_MODULE_CACHE);
+		}
+
+		for (uint32_t i = 0; i < iNumberOfFunctions; i++)
+		{
+			if (peModule.m_vFunctionRVAs[i])
+				peModule.m_iNumberOfExports++;
+
+			if (peModule.m_vForwarderOffsets[i] NOT_EQUAL_TO NO_STRING && peModule.m_vForwarderOffsets[i] >= iStringsSize)
+				throw PEException("Incorrect module cache", PEException::PEEXCEPTION_INCORRECT_MODULE_CACHE);
+		}
+
+		for (size_t i = 0; i < peModule.m_vNameOffsets.size(); i++)
+		{
+			if (peModule.m_vNameOffsets[i] >= iStringsSize || peModule.m_vNameFunctionIndices[i] >= iNumberOfFunctions)
+				throw PEException("Incorrect module cache", PEException::PEEXCEPTION_INCORRECT_MODULE_CACHE);
+		}
+
+		peModule.buildNameHashTable();
+		*this = peModule;
+	}
+
+	// Appends null-terminated string to the blob & returns its offset
+	uint32_t PEModuleExports::addString(const PEStringView& sString)
+	{
+		uint32_t iOffset = static_cast<uint32_t>(m_sStrings.length());
+		m_sStrings.append(sString.data(), sString.length());
+		m_sStrings.push_back(0);
+
+		return iOffset;
+	}
+
+	// Returns null-terminated string at offset of the blob
+	const PEStringView PEModuleExports::getStringAt(uint32_t iOffset) const
+	{
+		return PEStringView(m_sStrings.c_str() + iOffset);
+	}
+
+	// Fills export entry of the function at index
+	void PEModuleExports::getExport(uint32_t iIndex, PEExportEntry& peExport) const
+	{
+		peExport = PEExportEntry();
+		peExport.m_iOrdinal = static_cast<uint16_t>(m_iOrdinalBase + iIndex);
+		peExport.m_iRVA = m_vFunctionRVAs[iIndex];
+
+		if (m_vForwarderOffsets[iIndex] NOT_EQUAL_TO NO_STRING)
+			peExport.m_vForwardedName = getStringAt(m_vForwarderOffsets[iIndex]);
+	}
+
+	// (Re)builds the name hash table from the per-name arrays
+	void PEModuleExports::buildNameHashTable()
+	{
+		m_vNameHashTable.clear();
+
+		uint32_t iNumberOfNames = static_cast<uint32_t>(m_vNameOffsets.size());
+		if (NOT iNumberOfNames)
+			return;
+
+		// Keep the load factor at or below 1/2
+		uint32_t iTableSize = 1;
+		while (iTableSize < iNumberOfNames * 2)
+			iTableSize <<= 1;
+
+		m_vNameHashTable.resize(iTableSize, 0);
+
+		uint32_t iMask = iTableSize - 1;
+		for (uint32_t i = 0; i < iNumberOfNames; i++)
+		{
+			uint32_t iSlot = PEUtils::hashName(getStringAt(m_vNameOffsets[i])) & iMask;
+			while (m_vNameHashTable[iSlot])
+				iSlot = (iSlot + 1) & iMask;
+
+			m_vNameHashTable[iSlot] = i + 1;
+		}
+	}
+
+	// Default Constructor
+	PEModuleCorpus::PEModuleCorpus()
+	{
+	}
+
+	// Adds export snapshot of the library Image (replaces the library with the same name)
+	void PEModuleCorpus::addModule(const PEBase& peLibrary, const std::string& sModuleName)
+	{
+		addModule(PEModuleExports(peLibrary, sModuleName));
+	}
+
+	// Adds export snapshot (replaces the library with the same name)
+	void PEModuleCorpus::addModule(const PEModuleExports& peModule)
+	{
+		// Libraries stay where they were added, only their indices are kept sorted by name
+		ModuleFinder moduleFinder = { this };
+		std::vector<uint32_t>::iterator itr = std::lower_bound(m_vSortedModules.begin(), m_vSortedModules.end(), PEStringView(peModule.getName()), moduleFinder);
+		if (itr NOT_EQUAL_TO m_vSortedModules.end() && PEStringView(m_vModules[*itr].getName()).equalsIgnoreCase(peModule.getName()))
+		{
+			m_vModules[*itr] = peModule;
+			return;
+		}
+
+		m_vSortedModules.insert(itr, static_cast<uint32_t>(m_vModules.size()));
+		m_vModules.push_back(peModule);
+	}
+
+	// Reads the library file & adds its export snapshot under its file name
+	// Returns 'false' if the file can't be opened or is not a correct PE file
+	bool PEModuleCorpus::addModuleFile(const std::string& sFilePath)
+	{
+		std::ifstream fStream(sFilePath.c_str(), std::ios::in | std::ios::binary);
+		if (NOT fStream)
+			return false;
+
+		std::string::size_type iNameStart = sFilePath.find_last_of("\\/");
+		std::string sModuleName = (iNameStart == std::string::npos) ? sFilePath : sFilePath.substr(iNameStart + 1);
+
+		try
+		{
+			PEBase peLibrary(PEFactory::createPE(fStream, false));
+			addModule(peLibrary, sModuleName);
+		}
+		catch (const PEException&)
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	// Redirects sAlias to the library sModuleName (replaces existing alias)
+	void PEModuleCorpus::addAlias(const std::string& sAlias, const std::string& sModuleName)
+	{
+		ALIAS_LIST::iterator itr = std::lower_bound(m_vAliases.begin(), m_vAliases.end(), PEStringView(sAlias), AliasFinder());
+		if (itr NOT_EQUAL_TO m_vAliases.end() && PEStringView(itr->first).equalsIgnoreCase(sAlias))
+			itr->second = sModuleName;
+		else
+			m_vAliases.insert(itr, std::make_pair(sAlias, sModuleName));
+	}
+
+	// Returns export snapshot of the library (or of the library its alias redirects to), or 0 if it is not in the corpus
+	const PEModuleExports* PEModuleCorpus::findModule(const PEStringView& sModuleName) const
+	{
+		const PEModuleExports* pModule = findModuleByName(sModuleName);
+		if (pModule || m_vAliases.empty())
+			return pModule;
+
+		ALIAS_LIST::const_iterator itr = std::lower_bound(m_vAliases.begin(), m_vAliases.end(), sModuleName, AliasFinder());
+		if (itr == m_vAliases.end() || NOT PEStringView(itr->first).equalsIgnoreCase(sModuleName))
+			return 0;
+
+		return findModuleByName(itr->second);
+	}
+
+	// Follows forwarders of peExport exported by pModule ("LIBRARY.Function" or "LIBRARY.#Ordinal")
+	PEExportResolution PEModuleCorpus::followForwarders(const PEModuleExports*& pModule, PEExportEntry& peExport, uint32_t* pNumberOfForwarders) const
+	{
+		// Functions of the chain (library & ordinal), a chain coming back to one of them loops
+		std::pair<const PEModuleExports*, uint16_t> vChain[MAX_FORWARDER_DEPTH];
+
+		uint32_t iDepth = 0;
+		for (; peExport.isForwarded(); iDepth++)
+		{
+			if (iDepth >= MAX_FORWARDER_DEPTH)
+				return PE_EXPORT_FORWARDER_LOOP;
+
+			for (uint32_t i = 0; i < iDepth; i++)
+			{
+				if (vChain[i].first == pModule && vChain[i].second == peExport.getOrdinal())
+					return PE_EXPORT_FORWARDER_LOOP;
+			}
+
+			vChain[iDepth] = std::make_pair(pModule, peExport.getOrdinal());
+
+			// The forwarded name references the blob of the current library, which is not modified
+			const PEExportResolution eResolution = findForwardedExport(peExport.getForwardedName(), pModule, peExport);
+			if (eResolution NOT_EQUAL_TO PE_EXPORT_RESOLVED)
+				return eResolution;
+		}
+
+		if (pNumberOfForwarders)
+			*pNumberOfForwarders = iDepth;
+
+		return PE_EXPORT_RESOLVED;
+	}
+
+	// Follows a single forwarder ("LIBRARY.Function" or "LIBRARY.#Ordinal")
+	PEExportResolution PEModuleCorpus::findForwardedExport(const PEStringView& sForwardedName, const PEModuleExports*& pModule, PEExportEntry& peExport) const
+	{
+		// Library name ends at the last dot, function names never contain dots
+		const char* pDot = 0;
+		for (const char* p = sForwardedName.end(); NOT pDot && p NOT_EQUAL_TO sForwardedName.begin(); )
+		{
+			if (*--p == '.')
+				pDot = p;
+		}
+
+		if (NOT pDot)
+			return PE_EXPORT_FUNCTION_NOT_FOUND;
+
+		std::string sModuleName(sForwardedName.data(), pDot - sForwardedName.data());
+		sModuleName += ".dll";
+
+		const PEModuleExports* pForwardedModule = findModule(sModuleName);
+		if (NOT pForwardedModule)
+			return PE_EXPORT_MODULE_NOT_FOUND;
+
+		// The forwarded name references the blob of a library, so it stays valid while peExport is replaced
+		PEStringView sFunction(pDot + 1, sForwardedName.end() - pDot - 1);
+		if (sFunction.length() > 1 && sFunction[0] == '#')
+		{
+			uint32_t iOrdinal = 0;
+			for (size_t i = 1; i < sFunction.length(); i++)
+			{
+				if (sFunction[i] < '0' || sFunction[i] > '9' || (iOrdinal = iOrdinal * 10 + (sFunction[i] - '0')) > PEUtils::MAX_WORD)
+					return PE_EXPORT_FUNCTION_NOT_FOUND;
+			}
+
+			if (NOT pForwardedModule->findExport(static_cast<uint16_t>(iOrdinal), peExport))
+				return PE_EXPORT_FUNCTION_NOT_FOUND;
+		}
+		else if (NOT pForwardedModule->findExport(sFunction, peExport))
+		{
+			return PE_EXPORT_FUNCTION_NOT_FOUND;
+		}
+
+		pModule = pForwardedModule;
+
+		return PE_EXPORT_RESOLVED;
+	}
+
+	// Returns all libraries (in the order they were added)
+	const PEModuleCorpus::MODULE_LIST& PEModuleCorpus::getModuleList() const
+	{
+		return m_vModules;
+	}
+
+	// Returns all aliases sorted by name
+	const PEModuleCorpus::ALIAS_LIST& PEModuleCorpus::getAliasList() const
+	{
+		return m_vAliases;
+	}
+
+	// Returns number of libraries
+	size_t PEModuleCorpus::getNumberOfModules() const
+	{
+		return m_vModules.size();
+	}
+
+	// Removes all libraries & aliases
+	void PEModuleCorpus::clear()
+	{
+		m_vModules.clear();
+		m_vSortedModules.clear();
+		m_vAliases.clear();
+	}
+
+	// Writes all libraries & aliases to the stream
+	void PEModuleCorpus::save(std::ostream& fStream) const
+	{
+		writeCacheValue(fStream, MODULE_CACHE_SIGNATURE);
+		writeCacheValue(fStream, MODULE_CACHE_VERSION);
+
+		writeCacheValue(fStream, static_cast<uint32_t>(m_vModules.size()));
+		for (MODULE_LIST::const_iterator itr = m_vModules.begin(); itr != m_vModules.end(); ++itr)
+			itr->save(fStream);
+
+		writeCacheValue(fStream, static_cast<uint32_t>(m_vAliases.size()));
+		for (ALIAS_LIST::const_iterator itr = m_vAliases.begin(); itr != m_vAliases.end(); ++itr)
+		{
+			writeCacheString(fStream, itr->first);
+			writeCacheString(fStream, itr->second);
+		}
+	}
+
+	// Replaces the corpus with the one written by save(), throws PEException if the data is incorrect
+	void PEModuleCorpus::load(std::istream& fStream)
+	{
+		uint32_t iSignature, iVersion;
+		readCacheValue(fStream, iSignature);
+		readCacheValue(fStream, iVersion);
+		if (iSignature NOT_EQUAL_TO MODULE_CACHE_SIGNATURE || iVersion NOT_EQUAL_TO MODULE_CACHE_VERSION)
+			throw PEException("Incorrect module cache", PEException::PEEXCEPTION_INCORRECT_MODULE_CACHE);
+
+		PEModuleCorpus peCorpus;
+
+		uint32_t iNumberOfModules;
+		readCacheValue(fStream, iNumberOfModules);
+		for (uint32_t i = 0; i < iNumberOfModules; i++)
+		{
+			PEModuleExports peModule;
+			peModule.load(fStream);
+			peCorpus.addModule(peModule);
+		}
+
+		uint32_t iNumberOfAliases;
+		readCacheValue(fStream, iNumberOfAliases);
+		for (uint32_t i = 0; i < iNumberOfAliases; i++)
+		{
+			std::string sAlias, sModuleName;
+			readCacheString(fStream, sAlias, MAX_CACHED_STRINGS_SIZE);
+			readCacheString(fStream, sModuleName, MAX_CACHED_STRINGS_SIZE);
+			peCorpus.addAlias(sAlias, sModuleName);
+		}
+
+		m_vModules.swap(peCorpus.m_vModules);
+		m_vSortedModules.swap(peCorpus.m_vSortedModules);
+		m_vAliases.swap(peCorpus.m_vAliases);
+	}
+
+	// Returns library of the corpus by its own name, or 0
+	const PEModuleExports* PEModuleCorpus::findModuleByName(const PEStringView& sModuleName) const
+	{
+		ModuleFinder moduleFinder = { this };
+		std::vector<uint32_t>::const_iterator itr = std::lower_bound(m_vSortedModules.begin(), m_vSortedModules.end(), sModuleName, moduleFinder);
+		if (itr == m_vSortedModules.end() || NOT PEStringView(m_vModules[*itr].getName()).equalsIgnoreCase(sModuleName))
+			return 0;
+
+		return &m_vModules[*itr];
+	}
+
+	bool PEModuleCorpus::ModuleFinder::operator()(uint32_t iModuleIndex, const PEStringView& sModuleName) const
+	{
+		return PEStringView(m_pCorpus->m_vModules[iModuleIndex].getName()).compareIgnoreCase(sModuleName) < 0;
+	}
+
+	bool PEModuleCorpus::AliasFinder::operator()(const std::pair<std::string, std::string>& peAlias, const PEStringView& sAlias) const
+	{
+		return PEStringView(peAlias.first).compareIgnoreCase(sAlias) < 0;
+	}
+}
\ No newline at end of file
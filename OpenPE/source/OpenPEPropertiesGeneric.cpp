@@ -51,6 +51,12 @@ namespace OpenPE
 		return static_cast<uint64_t>(m_NTHeader.OptionalHeader.ImageBase);
 	}
 
+	template<typename PEClassType>
+	void PEPropertiesGeneric<PEClassType>::setImageBase(uint64_t iNewImageBase)
+	{
+		m_NTHeader.OptionalHeader.ImageBase = static_cast<typename PEClassType::BaseSize>(iNewImageBase);
+	}
+
 	template<typename PEClassType>
 	uint32_t PEPropertiesGeneric<PEClassType>::getEntryPoint() const
 	{
@@ -129,6 +135,12 @@ namespace OpenPE
 		return m_NTHeader.OptionalHeader.SizeOfImage;
 	}
 
+	template<typename PEClassType>
+	void PEPropertiesGeneric<PEClassType>::setSizeOfImage(uint32_t iSizeOfImage)
+	{
+		m_NTHeader.OptionalHeader.SizeOfImage = iSizeOfImage;
+	}
+
 	template<typename PEClassType>
 	uint32_t PEPropertiesGeneric<PEClassType>::getNumberOfRVAsAndSizes() const
 	{
@@ -269,6 +281,26 @@ namespace OpenPE
 		return m_NTHeader.OptionalHeader.DataDirectory[iDirectoryID].Size;
 	}
 
+	template<typename PEClassType>
+	void PEPropertiesGeneric<PEClassType>::setDirectoryRVA(uint32_t iDirectoryID, uint32_t iRVA)
+	{
+		//Check if directory slot exists
+		if (iDirectoryID >= m_NTHeader.OptionalHeader.NumberOfRVAAndSizes)
+			throw PEException("Specified directory does not exists.", PEException::PEEXCEPTION_DIRECTORY_DOESNT_NOT_EXISTS);
+
+		m_NTHeader.OptionalHeader.DataDirectory[iDirectoryID].RVA = iRVA;
+	}
+
+	template<typename PEClassType>
+	void PEPropertiesGeneric<PEClassType>::setDirectorySize(uint32_t iDirectoryID, uint32_t iSize)
+	{
+		//Check if directory slot exists
+		if (iDirectoryID >= m_NTHeader.OptionalHeader.NumberOfRVAAndSizes)
+			throw PEException("Specified directory does not exists.", PEException::PEEXCEPTION_DIRECTORY_DOESNT_NOT_EXISTS);
+
+		m_NTHeader.OptionalHeader.DataDirectory[iDirectoryID].Size = iSize;
+	}
+
 	// Virtual Address(VA) to Relative Virtual Address(RVA) convertion
 	// for PE32 & PE64 respectively
 	template<typename PEClassType>
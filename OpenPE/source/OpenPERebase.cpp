@@ -0,0 +1,301 @@
+#include "OpenPERebase.h"
+#include <string.h>
+
+namespace OpenPE
+{
+	// Helper: returns value of type T at pData (need not be aligned)
+	template<typename T>
+	static inline T readValue(const char* pData)
+	{
+		T value;
+		memcpy(&value, pData, sizeof(T));
+
+		return value;
+	}
+
+	// Helper: stores value of type T at pData (need not be aligned)
+	template<typename T>
+	static inline void writeValue(char* pData, T value)
+	{
+		memcpy(pData, &value, sizeof(T));
+	}
+
+	// Helper: returns 16-bit immediate of ARM MOVW/MOVT (imm4:imm12)
+	static inline uint32_t getARMImmediate(uint32_t iInstruction)
+	{
+		return ((iInstruction >> 4) & 0xF000) | (iInstruction & 0x0FFF);
+	}
+
+	// Helper: returns ARM MOVW/MOVT with the 16-bit immediate replaced
+	static inline uint32_t setARMImmediate(uint32_t iInstruction, uint32_t iImmediate)
+	{
+		return (iInstruction & 0xFFF0F000) | ((iImmediate & 0xF000) << 4) | (iImmediate & 0x0FFF);
+	}
+
+	// Helper: returns 16-bit immediate of Thumb-2 MOVW/MOVT (imm4:i:imm3:imm8 of both halfwords)
+	static inline uint32_t getThumbImmediate(uint16_t iHalfword1, uint16_t iHalfword2)
+	{
+		return ((iHalfword1 & 0x000F) << 12) | ((iHalfword1 & 0x0400) << 1) | ((iHalfword2 & 0x7000) >> 4) | (iHalfword2 & 0x00FF);
+	}
+
+	// Helper: replaces 16-bit immediate of Thumb-2 MOVW/MOVT
+	static inline void setThumbImmediate(uint16_t& iHalfword1, uint16_t& iHalfword2, uint32_t iImmediate)
+	{
+		iHalfword1 = static_cast<uint16_t>((iHalfword1 & 0xFBF0) | ((iImmediate >> 12) & 0x000F) | ((iImmediate >> 1) & 0x0400));
+		iHalfword2 = static_cast<uint16_t>((iHalfword2 & 0x8F00) | ((iImmediate << 4) & 0x7000) | (iImmediate & 0x00FF));
+	}
+
+	// Helper: returns 'true' if relocation types ARM_MOV32 & THUMB_MOV32 are defined for the machine
+	static inline bool isARMMachine(uint16_t iMachine)
+	{
+		return	iMachine == IMAGE_FILE_MACHINE_ARM
+				||
+				iMachine == IMAGE_FILE_MACHINE_THUMB
+				||
+				iMachine == IMAGE_FILE_MACHINE_ARMNT;
+	}
+
+	// Helper: patches the value of a relocation of type Type
+	template<uint16_t Type>
+	struct RelocationPatcher;
+
+	template<>
+	struct RelocationPatcher<IMAGE_REL_BASED_HIGH>
+	{
+		static const uint32_t SIZE = sizeof(uint16_t);
+		static void patch(char* pData, uint64_t iDelta, uint16_t)
+		{
+			writeValue<uint16_t>(pData, static_cast<uint16_t>(readValue<uint16_t>(pData) + (static_cast<uint32_t>(iDelta) >> 16)));
+		}
+	};
+
+	template<>
+	struct RelocationPatcher<IMAGE_REL_BASED_LOW>
+	{
+		static const uint32_t SIZE = sizeof(uint16_t);
+		static void patch(char* pData, uint64_t iDelta, uint16_t)
+		{
+			writeValue<uint16_t>(pData, static_cast<uint16_t>(readValue<uint16_t>(pData) + static_cast<uint16_t>(iDelta)));
+		}
+	};
+
+	template<>
+	struct RelocationPatcher<IMAGE_REL_BASED_HIGHLOW>
+	{
+		static const uint32_t SIZE = sizeof(uint32_t);
+		static void patch(char* pData, uint64_t iDelta, uint16_t)
+		{
+			writeValue<uint32_t>(pData, readValue<uint32_t>(pData) + static_cast<uint32_t>(iDelta));
+		}
+	};
+
+	template<>
+	struct RelocationPatcher<IMAGE_REL_BASED_HIGHADJ>
+	{
+		// High half of the 32-bit value (low half in the parameter), rounded as by the loader
+		static const uint32_t SIZE = sizeof(uint16_t);
+		static void patch(char* pData, uint64_t iDelta, uint16_t iParameter)
+		{
+			uint32_t iValue = static_cast<uint32_t>(readValue<uint16_t>(pData)) << 16;
+			iValue += static_cast<uint32_t>(static_cast<int32_t>(static_cast<int16_t>(iParameter)));
+			iValue += static_cast<uint32_t>(iDelta) + 0x8000;
+
+			writeValue<uint16_t>(pData, static_cast<uint16_t>(iValue >> 16));
+		}
+	};
+
+	template<>
+	struct RelocationPatcher<IMAGE_REL_BASED_DIR64>
+	{
+		static const uint32_t SIZE = sizeof(uint64_t);
+		static void patch(char* pData, uint64_t iDelta, uint16_t)
+		{
+			writeValue<uint64_t>(pData, readValue<uint64_t>(pData) + iDelta);
+		}
+	};
+
+	template<>
+	struct RelocationPatcher<IMAGE_REL_BASED_ARM_MOV32>
+	{
+		// MOVW (low half) followed by MOVT (high half)
+		static const uint32_t SIZE = 2 * sizeof(uint32_t);
+		static void patch(char* pData, uint64_t iDelta, uint16_t)
+		{
+			const uint32_t iMOVW = readValue<uint32_t>(pData);
+			const uint32_t iMOVT = readValue<uint32_t>(pData + sizeof(uint32_t));
+			const uint32_t iValue = ((getARMImmediate(iMOVT) << 16) | getARMImmediate(iMOVW)) + static_cast<uint32_t>(iDelta);
+
+			writeValue<uint32_t>(pData, setARMImmediate(iMOVW, iValue & 0xFFFF));
+			writeValue<uint32_t>(pData + sizeof(uint32_t), setARMImmediate(iMOVT, iValue >> 16));
+		}
+	};
+
+	template<>
+	struct RelocationPatcher<IMAGE_REL_BASED_THUMB_MOV32>
+	{
+		// MOVW (low half) followed by MOVT (high half), each of 2 halfwords
+		static const uint32_t SIZE = 2 * sizeof(uint32_t);
+		static void patch(char* pData, uint64_t iDelta, uint16_t)
+		{
+			uint16_t iMOVW1 = readValue<uint16_t>(pData), iMOVW2 = readValue<uint16_t>(pData + 2);
+			uint16_t iMOVT1 = readValue<uint16_t>(pData + 4), iMOVT2 = readValue<uint16_t>(pData + 6);
+			const uint32_t iValue = ((getThumbImmediate(iMOVT1, iMOVT2) << 16) | getThumbImmediate(iMOVW1, iMOVW2)) + static_cast<uint32_t>(iDelta);
+
+			setThumbImmediate(iMOVW1, iMOVW2, iValue & 0xFFFF);
+			setThumbImmediate(iMOVT1, iMOVT2, iValue >> 16);
+
+			writeValue<uint16_t>(pData, iMOVW1);
+			writeValue<uint16_t>(pData + 2, iMOVW2);
+			writeValue<uint16_t>(pData + 4, iMOVT1);
+			writeValue<uint16_t>(pData + 6, iMOVT2);
+		}
+	};
+
+	// Helper: applies a run of relocations of type Type, returns number of relocations applied
+	template<uint16_t Type>
+	static size_t applyRun(const PERelocation* pFirst, const PERelocation* pLast, char* pData, uint32_t iDataRVA, uint32_t iSize, uint64_t iDelta)
+	{
+		typedef RelocationPatcher<Type> Patcher;
+
+		if (iSize < Patcher::SIZE)
+			return 0;
+
+		size_t iNumberOfApplied = 0;
+		const uint32_t iLastOffset = iSize - Patcher::SIZE;
+		for (const PERelocation* pRelocation = pFirst; pRelocation NOT_EQUAL_TO pLast; ++pRelocation)
+		{
+			const uint32_t iOffset = pRelocation->getRVA() - iDataRVA;
+			if (iOffset > iLastOffset)
+				continue;
+
+			Patcher::patch(pData + iOffset, iDelta, pRelocation->getParameter());
+			iNumberOfApplied++;
+		}
+
+		return iNumberOfApplied;
+	}
+
+	// Default Constructor (no relocations)
+	PERebaser::PERebaser()
+		: m_iImageBase(0)
+		, m_iMachine(0)
+	{
+	}
+
+	// Constructor, decodes relocations of the Image
+	PERebaser::PERebaser(const PEBase& peBase)
+		: m_iImageBase(peBase.getImageBase64())
+		, m_iMachine(peBase.getMachine())
+	{
+		PERelocations(peBase).getRelocations(m_vRelocations);
+	}
+
+	// Returns Image base of the Image the relocations were decoded from
+	uint64_t PERebaser::getImageBase() const
+	{
+		return m_iImageBase;
+	}
+
+	// Returns the relocations (sorted by RVA)
+	const PERELOCATION_LIST& PERebaser::getRelocations() const
+	{
+		return m_vRelocations;
+	}
+
+	// Rebases loaded Image from iOldBase to iNewBase in place, returns number of relocations applied
+	size_t PERebaser::rebase(char* pImage, uint32_t iSize, uint64_t iOldBase, uint64_t iNewBase) const
+	{
+		return applyRelocations(0, m_vRelocations.size(), pImage, 0, iSize, iNewBase - iOldBase);
+	}
+
+	// Copies loaded Image from pSource to pTarget & rebases the copy, returns number of relocations applied
+	size_t PERebaser::rebase(const char* pSource, char* pTarget, uint32_t iSize, uint64_t iOldBase, uint64_t iNewBase) const
+	{
+		if (pSource NOT_EQUAL_TO pTarget)
+			memcpy(pTarget, pSource, iSize);
+
+		return rebase(pTarget, iSize, iOldBase, iNewBase);
+	}
+
+	// Rebases Section data of the Image to iNewBase in place & sets its Image base, returns number of relocations applied
+	size_t PERebaser::rebase(PEBase& peBase, uint64_t iNewBase) const
+	{
+		const uint64_t iDelta = iNewBase - peBase.getImageBase64();
+		size_t iNumberOfApplied = 0;
+
+		// Relocations are sorted, so those of a Section are a range found by two binary searches
+		SECTION_LIST& vSections = peBase.getImageSectionList();
+		for (SECTION_LIST::iterator itr = vSections.begin(); itr NOT_EQUAL_TO vSections.end(); ++itr)
+		{
+			std::string& sRawData = itr->getRawData();
+			if (sRawData.empty())
+				continue;
+
+			const uint32_t iSectionRVA = itr->getVirtualAddress();
+			const uint32_t iSize = static_cast<uint32_t>(sRawData.length());
+
+			const size_t iFirst = findRelocation(m_vRelocations, iSectionRVA);
+			const size_t iLast = PEUtils::isSumSafe(iSectionRVA, iSize) ? findRelocation(m_vRelocations, iSectionRVA + iSize) : m_vRelocations.size();
+
+			iNumberOfApplied += applyRelocations(iFirst, iLast, &sRawData[0], iSectionRVA, iSize, iDelta);
+		}
+
+		peBase.setImageBase(iNewBase);
+
+		return iNumberOfApplied;
+	}
+
+	// Applies relocations [iFirst, iLast) to iSize bytes at pData, which holds RVA iDataRVA
+	size_t PERebaser::applyRelocations(size_t iFirst, size_t iLast, char* pData, uint32_t iDataRVA, uint32_t iSize, uint64_t iDelta) const
+	{
+		if (iDelta == 0 || iFirst >= iLast)
+			return 0;
+
+		size_t iNumberOfApplied = 0;
+		const PERelocation* pRelocations = &m_vRelocations[0];
+
+		// Dispatch once per run of relocations of the same type (an Image has one or two types)
+		for (size_t iRun = iFirst; iRun < iLast; )
+		{
+			const uint16_t iType = pRelocations[iRun].getType();
+
+			size_t iRunEnd = iRun + 1;
+			while (iRunEnd < iLast && pRelocations[iRunEnd].getType() == iType)
+				iRunEnd++;
+
+			const PERelocation* pFirst = pRelocations + iRun;
+			const PERelocation* pLast = pRelocations + iRunEnd;
+			switch (iType)
+			{
+				case IMAGE_REL_BASED_HIGH:
+					iNumberOfApplied += applyRun<IMAGE_REL_BASED_HIGH>(pFirst, pLast, pData, iDataRVA, iSize, iDelta);
+					break;
+				case IMAGE_REL_BASED_LOW:
+					iNumberOfApplied += applyRun<IMAGE_REL_BASED_LOW>(pFirst, pLast, pData, iDataRVA, iSize, iDelta);
+					break;
+				case IMAGE_REL_BASED_HIGHLOW:
+					iNumberOfApplied += applyRun<IMAGE_REL_BASED_HIGHLOW>(pFirst, pLast, pData, iDataRVA, iSize, iDelta);
+					break;
+				case IMAGE_REL_BASED_HIGHADJ:
+					iNumberOfApplied += applyRun<IMAGE_REL_BASED_HIGHADJ>(pFirst, pLast, pData, iDataRVA, iSize, iDelta);
+					break;
+				// Types 5 & 7 are other relocations on other machines (e.g. MIPS_JMPADDR), those are skipped
+				case IMAGE_REL_BASED_ARM_MOV32:
+					if (isARMMachine(m_iMachine))
+						iNumberOfApplied += applyRun<IMAGE_REL_BASED_ARM_MOV32>(pFirst, pLast, pData, iDataRVA, iSize, iDelta);
+					break;
+				case IMAGE_REL_BASED_THUMB_MOV32:
+					if (isARMMachine(m_iMachine))
+						iNumberOfApplied += applyRun<IMAGE_REL_BASED_THUMB_MOV32>(pFirst, pLast, pData, iDataRVA, iSize, iDelta);
+					break;
+				case IMAGE_REL_BASED_DIR64:
+					iNumberOfApplied += applyRun<IMAGE_REL_BASED_DIR64>(pFirst, pLast, pData, iDataRVA, iSize, iDelta);
+					break;
+			}
+
+			iRun = iRunEnd;
+		}
+
+		return iNumberOfApplied;
+	}
+}
\ No newline at end of file
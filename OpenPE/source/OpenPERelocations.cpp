@@ -0,0 +1,315 @@
+#include "OpenPERelocations.h"
+#include "OpenPEDataCursor.h"
+#include <algorithm>
+#include <string.h>
+
+namespace OpenPE
+{
+	// Offset of the end iterator
+	static const uint32_t ITERATOR_END = static_cast<uint32_t>(-1);
+
+	// Size of the largest value patched by a relocation
+	static const uint32_t MAX_RELOCATION_SIZE = sizeof(uint64_t);
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor
+	PERelocation::PERelocation()
+		: m_iRVA(0)
+		, m_iType(IMAGE_REL_BASED_ABSOLUTE)
+		, m_iParameter(0)
+	{
+	}
+
+	// Constructor
+	PERelocation::PERelocation(uint32_t iRVA, uint16_t iType, uint16_t iParameter)
+		: m_iRVA(iRVA)
+		, m_iType(iType)
+		, m_iParameter(iParameter)
+	{
+	}
+
+	// Returns RVA of the relocated value
+	uint32_t PERelocation::getRVA() const
+	{
+		return m_iRVA;
+	}
+
+	// Returns type of the relocation (IMAGE_REL_BASED_*)
+	uint16_t PERelocation::getType() const
+	{
+		return m_iType;
+	}
+
+	// Returns low 16 bits of the 32-bit value of IMAGE_REL_BASED_HIGHADJ (the entry following it)
+	uint16_t PERelocation::getParameter() const
+	{
+		return m_iParameter;
+	}
+
+	// Returns number of bytes patched by the relocation, 0 if the type is unknown
+	uint32_t PERelocation::getSize() const
+	{
+		switch (m_iType)
+		{
+			case IMAGE_REL_BASED_HIGH:
+			case IMAGE_REL_BASED_LOW:
+			case IMAGE_REL_BASED_HIGHADJ:
+				return sizeof(uint16_t);
+			case IMAGE_REL_BASED_HIGHLOW:
+				return sizeof(uint32_t);
+			case IMAGE_REL_BASED_ARM_MOV32:
+			case IMAGE_REL_BASED_THUMB_MOV32:
+				return 2 * sizeof(uint32_t);
+			case IMAGE_REL_BASED_DIR64:
+				return sizeof(uint64_t);
+		}
+
+		return 0;
+	}
+
+	// Orders relocations by RVA
+	bool PERelocation::operator<(const PERelocation& other) const
+	{
+		return m_iRVA < other.m_iRVA;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	PERelocations::const_iterator::const_iterator()
+		: m_pRelocations(0)
+		, m_iBlockOffset(ITERATOR_END)
+		, m_iOffset(ITERATOR_END)
+	{
+	}
+
+	PERelocations::const_iterator::const_iterator(const PERelocations* pRelocations, uint32_t iBlockOffset)
+		: m_pRelocations(pRelocations)
+		, m_iBlockOffset(iBlockOffset)
+		, m_iOffset(iBlockOffset)
+	{
+		decode();
+	}
+
+	PERelocations::const_iterator::reference PERelocations::const_iterator::operator*() const
+	{
+		return m_Relocation;
+	}
+
+	PERelocations::const_iterator::pointer PERelocations::const_iterator::operator->() const
+	{
+		return &m_Relocation;
+	}
+
+	PERelocations::const_iterator& PERelocations::const_iterator::operator++()
+	{
+		if (m_iOffset NOT_EQUAL_TO ITERATOR_END)
+		{
+			// IMAGE_REL_BASED_HIGHADJ takes the next entry, too
+			m_iOffset += (m_Relocation.getType() == IMAGE_REL_BASED_HIGHADJ) ? 2 * sizeof(uint16_t) : sizeof(uint16_t);
+			decode();
+		}
+
+		return *this;
+	}
+
+	PERelocations::const_iterator PERelocations::const_iterator::operator++(int)
+	{
+		const_iterator itr(*this);
+		++(*this);
+
+		return itr;
+	}
+
+	bool PERelocations::const_iterator::operator==(const const_iterator& other) const
+	{
+		return m_iOffset == other.m_iOffset;
+	}
+
+	bool PERelocations::const_iterator::operator!=(const const_iterator& other) const
+	{
+		return m_iOffset NOT_EQUAL_TO other.m_iOffset;
+	}
+
+	// Decodes entry at current offset (or the next one that is not padding), or turns into end iterator
+	void PERelocations::const_iterator::decode()
+	{
+		while (m_iBlockOffset < m_pRelocations->m_iDirectorySize)
+		{
+			const IMAGE_BASE_RELOCATION peBlock = m_pRelocations->getBlock(m_iBlockOffset);
+			const uint32_t iBlockEnd = m_iBlockOffset + peBlock.iSizeOfBlock;
+
+			if (m_iOffset < m_iBlockOffset + sizeof(IMAGE_BASE_RELOCATION))
+				m_iOffset = m_iBlockOffset + sizeof(IMAGE_BASE_RELOCATION);
+
+			for (; m_iOffset < iBlockEnd; m_iOffset += sizeof(uint16_t))
+			{
+				const uint16_t iEntry = m_pRelocations->getEntry(m_iOffset);
+				const uint16_t iType = iEntry >> 12;
+				if (iType == IMAGE_REL_BASED_ABSOLUTE)
+					continue;
+
+				const uint16_t iParameter = (iType == IMAGE_REL_BASED_HIGHADJ && m_iOffset + sizeof(uint16_t) < iBlockEnd) ? m_pRelocations->getEntry(m_iOffset + sizeof(uint16_t)) : 0;
+				m_Relocation = PERelocation(peBlock.iVirtualAddress + (iEntry & 0x0FFF), iType, iParameter);
+
+				return;
+			}
+
+			m_iBlockOffset = iBlockEnd;
+		}
+
+		m_iBlockOffset = ITERATOR_END;
+		m_iOffset = ITERATOR_END;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor (no relocations)
+	PERelocations::PERelocations()
+		: m_pDirectory(0)
+		, m_iDirectoryRVA(0)
+		, m_iDirectorySize(0)
+		, m_iNumberOfBlocks(0)
+		, m_iNumberOfEntries(0)
+	{
+	}
+
+	// Constructor, validates all blocks of the Base Relocation Directory of the Image
+	PERelocations::PERelocations(const PEBase& peBase)
+		: m_pDirectory(0)
+		, m_iDirectoryRVA(0)
+		, m_iDirectorySize(0)
+		, m_iNumberOfBlocks(0)
+		, m_iNumberOfEntries(0)
+	{
+		if (NOT peBase.hasReloc())
+			return;
+
+		m_iDirectoryRVA = peBase.getDirectoryRVA(IMAGE_DIRECTORY_ENTRY_BASERELOC);
+		const uint32_t iDirectorySize = peBase.getDirectorySize(IMAGE_DIRECTORY_ENTRY_BASERELOC);
+
+		uint32_t iAvailable;
+		PEDataCursor peCursor(peBase);
+		m_pDirectory = peCursor.tryGetData(m_iDirectoryRVA, iAvailable);
+		if (NOT m_pDirectory || iDirectorySize > iAvailable)
+			throw PEException("Incorrect relocation directory", PEException::PEEXCEPTION_INCORRECT_RELOCATION_DIRECTORY);
+
+		// Walk the block headers only, a few bytes at the end that can't hold a header are padding
+		uint32_t iBlockOffset = 0;
+		while (iDirectorySize - iBlockOffset >= sizeof(IMAGE_BASE_RELOCATION))
+		{
+			const IMAGE_BASE_RELOCATION peBlock = getBlock(iBlockOffset);
+
+			// Some linkers terminate the list with an empty block
+			if (peBlock.iVirtualAddress == 0 && peBlock.iSizeOfBlock == 0)
+				break;
+
+			if (	peBlock.iSizeOfBlock < sizeof(IMAGE_BASE_RELOCATION)
+					||
+					peBlock.iSizeOfBlock > iDirectorySize - iBlockOffset
+					||
+					(peBlock.iSizeOfBlock % sizeof(uint16_t))
+			) {
+				throw PEException("Incorrect relocation directory", PEException::PEEXCEPTION_INCORRECT_RELOCATION_DIRECTORY);
+			}
+
+			m_iNumberOfBlocks++;
+			m_iNumberOfEntries += (peBlock.iSizeOfBlock - sizeof(IMAGE_BASE_RELOCATION)) / sizeof(uint16_t);
+			iBlockOffset += peBlock.iSizeOfBlock;
+		}
+
+		m_iDirectorySize = iBlockOffset;
+	}
+
+	PERelocations::const_iterator PERelocations::begin() const
+	{
+		return m_pDirectory ? const_iterator(this, 0) : const_iterator();
+	}
+
+	PERelocations::const_iterator PERelocations::end() const
+	{
+		return const_iterator();
+	}
+
+	// Returns 'true' if Image has Base Relocation Directory
+	bool PERelocations::hasRelocations() const
+	{
+		return m_pDirectory NOT_EQUAL_TO 0;
+	}
+
+	// Returns RVA of the Base Relocation Directory
+	uint32_t PERelocations::getDirectoryRVA() const
+	{
+		return m_iDirectoryRVA;
+	}
+
+	// Returns number of blocks
+	uint32_t PERelocations::getNumberOfBlocks() const
+	{
+		return m_iNumberOfBlocks;
+	}
+
+	// Returns number of entries (including padding)
+	uint32_t PERelocations::getNumberOfEntries() const
+	{
+		return m_iNumberOfEntries;
+	}
+
+	// Decodes all relocations into vRelocations (cleared first) sorted by RVA, returns number of relocations
+	size_t PERelocations::getRelocations(PERELOCATION_LIST& vRelocations) const
+	{
+		vRelocations.clear();
+		vRelocations.reserve(m_iNumberOfEntries);
+
+		bool bSorted = true;
+		for (const_iterator itr = begin(); itr NOT_EQUAL_TO end(); ++itr)
+		{
+			if (NOT vRelocations.empty() && *itr < vRelocations.back())
+				bSorted = false;
+
+			vRelocations.push_back(*itr);
+		}
+
+		// Stable, so that the entries of a value patched twice keep their order
+		if (NOT bSorted)
+			std::stable_sort(vRelocations.begin(), vRelocations.end());
+
+		return vRelocations.size();
+	}
+
+	// Returns block header at offset
+	IMAGE_BASE_RELOCATION PERelocations::getBlock(uint32_t iBlockOffset) const
+	{
+		IMAGE_BASE_RELOCATION peBlock;
+		memcpy(&peBlock, m_pDirectory + iBlockOffset, sizeof(IMAGE_BASE_RELOCATION));
+
+		return peBlock;
+	}
+
+	// Returns entry at offset
+	uint16_t PERelocations::getEntry(uint32_t iOffset) const
+	{
+		uint16_t iEntry;
+		memcpy(&iEntry, m_pDirectory + iOffset, sizeof(uint16_t));
+
+		return iEntry;
+	}
+
+	// Returns index of the first relocation of the sorted list with RVA >= iRVA (binary search)
+	size_t findRelocation(const PERELOCATION_LIST& vRelocations, uint32_t iRVA)
+	{
+		return std::lower_bound(vRelocations.begin(), vRelocations.end(), PERelocation(iRVA, IMAGE_REL_BASED_ABSOLUTE)) - vRelocations.begin();
+	}
+
+	// Returns 'true' if a relocation of the sorted list patches any of iSize bytes at iRVA
+	bool isRelocated(const PERELOCATION_LIST& vRelocations, uint32_t iRVA, uint32_t iSize)
+	{
+		const uint64_t iEnd = static_cast<uint64_t>(iRVA) + iSize;
+
+		// A relocation starting up to MAX_RELOCATION_SIZE - 1 bytes before iRVA may still cover it
+		for (size_t i = findRelocation(vRelocations, iRVA < MAX_RELOCATION_SIZE ? 0 : iRVA - (MAX_RELOCATION_SIZE - 1)); i < vRelocations.size() && vRelocations[i].getRVA() < iEnd; i++)
+		{
+			if (static_cast<uint64_t>(vRelocations[i].getRVA()) + vRelocations[i].getSize() > iRVA)
+				return true;
+		}
+
+		return false;
+	}
+}
\ No newline at end of file
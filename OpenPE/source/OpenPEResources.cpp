@@ -0,0 +1,449 @@
+#include "OpenPEResources.h"
+
+namespace OpenPE
+{
+	// Index of the end iterator
+	static const uint32_t ITERATOR_END = static_cast<uint32_t>(-1);
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor
+	PEResourceData::PEResourceData()
+		: m_iRVA(0)
+		, m_iSize(0)
+		, m_iCodePage(0)
+		, m_pData(0)
+	{
+	}
+
+	// Returns RVA of the data
+	uint32_t PEResourceData::getRVA() const
+	{
+		return m_iRVA;
+	}
+
+	// Returns size of the data
+	uint32_t PEResourceData::getSize() const
+	{
+		return m_iSize;
+	}
+
+	// Returns code page of the data
+	uint32_t PEResourceData::getCodePage() const
+	{
+		return m_iCodePage;
+	}
+
+	// Returns 'true' if all of the data is inside the Image data
+	bool PEResourceData::hasData() const
+	{
+		return m_pData NOT_EQUAL_TO 0;
+	}
+
+	// Returns the data (getSize() bytes), 0 if it is not inside the Image data
+	const char* PEResourceData::getData() const
+	{
+		return m_pData;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor
+	PEResourceEntry::PEResourceEntry()
+		: m_pResources(0)
+		, m_iLevel(0)
+		, m_bHasName(false)
+		, m_iID(0)
+		, m_bIsDirectory(false)
+		, m_iDirectoryOffset(0)
+	{
+	}
+
+	// Returns 'true' if the entry is named (identified by ID otherwise)
+	bool PEResourceEntry::hasName() const
+	{
+		return m_bHasName;
+	}
+
+	// Returns name of the entry (UTF-16)
+	const PEWideStringView& PEResourceEntry::getName() const
+	{
+		return m_vName;
+	}
+
+	// Returns ID of the entry (if it is not named)
+	uint16_t PEResourceEntry::getID() const
+	{
+		return m_iID;
+	}
+
+	// Returns 'true' if the entry is a subdirectory (data otherwise)
+	bool PEResourceEntry::isDirectory() const
+	{
+		return m_bIsDirectory;
+	}
+
+	// Returns the subdirectory (decodes its header), throws PEException if the entry is not a subdirectory
+	const PEResourceDirectory PEResourceEntry::getDirectory() const
+	{
+		if (NOT m_bIsDirectory || NOT m_pResources)
+			throw PEException("Resource entry is not a directory", PEException::PEEXCEPTION_INCORRECT_RESOURCE_DIRECTORY);
+
+		return m_pResources->getDirectory(m_iDirectoryOffset, m_iLevel + 1);
+	}
+
+	// Returns the data (empty if the entry is a subdirectory)
+	const PEResourceData& PEResourceEntry::getData() const
+	{
+		return m_Data;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	PEResourceDirectory::const_iterator::const_iterator()
+		: m_pDirectory(0)
+		, m_iIndex(ITERATOR_END)
+	{
+	}
+
+	PEResourceDirectory::const_iterator::const_iterator(const PEResourceDirectory* pDirectory, uint32_t iIndex)
+		: m_pDirectory(pDirectory)
+		, m_iIndex(iIndex)
+	{
+		decode();
+	}
+
+	PEResourceDirectory::const_iterator::reference PEResourceDirectory::const_iterator::operator*() const
+	{
+		return m_Entry;
+	}
+
+	PEResourceDirectory::const_iterator::pointer PEResourceDirectory::const_iterator::operator->() const
+	{
+		return &m_Entry;
+	}
+
+	PEResourceDirectory::const_iterator& PEResourceDirectory::const_iterator::operator++()
+	{
+		if (m_iIndex NOT_EQUAL_TO ITERATOR_END)
+		{
+			m_iIndex++;
+			decode();
+		}
+
+		return *this;
+	}
+
+	PEResourceDirectory::const_iterator PEResourceDirectory::const_iterator::operator++(int)
+	{
+		const_iterator itr(*this);
+		++(*this);
+
+		return itr;
+	}
+
+	bool PEResourceDirectory::const_iterator::operator==(const const_iterator& other) const
+	{
+		return m_iIndex == other.m_iIndex;
+	}
+
+	bool PEResourceDirectory::const_iterator::operator!=(const const_iterator& other) const
+	{
+		return m_iIndex NOT_EQUAL_TO other.m_iIndex;
+	}
+
+	// Decodes entry at current index, or turns into end iterator
+	void PEResourceDirectory::const_iterator::decode()
+	{
+		if (NOT m_pDirectory->getEntry(m_iIndex, m_Entry))
+			m_iIndex = ITERATOR_END;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor (empty directory)
+	PEResourceDirectory::PEResourceDirectory()
+		: m_pResources(0)
+		, m_iOffset(0)
+		, m_iLevel(0)
+	{
+		memset(&m_Directory, 0, sizeof(IMAGE_RESOURCE_DIRECTORY));
+	}
+
+	PEResourceDirectory::const_iterator PEResourceDirectory::begin() const
+	{
+		return const_iterator(this, 0);
+	}
+
+	PEResourceDirectory::const_iterator PEResourceDirectory::end() const
+	{
+		return const_iterator();
+	}
+
+	// Returns level of the directory in the tree (0 = types, 1 = names, 2 = languages)
+	uint32_t PEResourceDirectory::getLevel() const
+	{
+		return m_iLevel;
+	}
+
+	// Returns Characteristics of the directory
+	uint32_t PEResourceDirectory::getCharacteristics() const
+	{
+		return m_Directory.iCharacteristics;
+	}
+
+	// Returns TimeDateStamp of the directory
+	uint32_t PEResourceDirectory::getTimeDateStamp() const
+	{
+		return m_Directory.iTimeDateStamp;
+	}
+
+	// Returns major version of the directory
+	uint16_t PEResourceDirectory::getMajorVersion() const
+	{
+		return m_Directory.iMajorVersion;
+	}
+
+	// Returns minor version of the directory
+	uint16_t PEResourceDirectory::getMinorVersion() const
+	{
+		return m_Directory.iMinorVersion;
+	}
+
+	// Returns number of named entries
+	uint32_t PEResourceDirectory::getNumberOfNamedEntries() const
+	{
+		return m_Directory.iNumberOfNamedEntries;
+	}
+
+	// Returns number of ID entries
+	uint32_t PEResourceDirectory::getNumberOfIdEntries() const
+	{
+		return m_Directory.iNumberOfIdEntries;
+	}
+
+	// Returns number of entries
+	uint32_t PEResourceDirectory::getNumberOfEntries() const
+	{
+		return static_cast<uint32_t>(m_Directory.iNumberOfNamedEntries) + m_Directory.iNumberOfIdEntries;
+	}
+
+	// Decodes entry at index (named entries first), returns 'false' if there is none
+	bool PEResourceDirectory::getEntry(uint32_t iIndex, PEResourceEntry& peEntry) const
+	{
+		if (NOT m_pResources || iIndex >= getNumberOfEntries())
+			return false;
+
+		m_pResources->decodeEntry(*this, iIndex, peEntry);
+		return true;
+	}
+
+	// Looks up entry by ID (binary search, ID entries are sorted by the linker), returns 'false' if there is none
+	bool PEResourceDirectory::findEntry(uint16_t iID, PEResourceEntry& peEntry) const
+	{
+		if (NOT m_pResources)
+			return false;
+
+		// Only the Name field of the entries is read while searching
+		const char* pEntries = m_pResources->m_pDirectory + m_iOffset + sizeof(IMAGE_RESOURCE_DIRECTORY);
+		uint32_t iFirst = m_Directory.iNumberOfNamedEntries, iLast = getNumberOfEntries();
+		while (iFirst < iLast)
+		{
+			const uint32_t iMiddle = iFirst + (iLast - iFirst) / 2;
+
+			uint32_t iName;
+			memcpy(&iName, pEntries + iMiddle * sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY), sizeof(uint32_t));
+
+			if ((iName & 0xFFFF) < iID)
+				iFirst = iMiddle + 1;
+			else
+				iLast = iMiddle;
+		}
+
+		if (iFirst == getNumberOfEntries())
+			return false;
+
+		m_pResources->decodeEntry(*this, iFirst, peEntry);
+		return NOT peEntry.hasName() && peEntry.getID() == iID;
+	}
+
+	// Looks up entry by name (ASCII, case-insensitive), returns 'false' if there is none
+	bool PEResourceDirectory::findEntry(const PEStringView& sName, PEResourceEntry& peEntry) const
+	{
+		for (uint32_t i = 0; i < m_Directory.iNumberOfNamedEntries; i++)
+		{
+			m_pResources->decodeEntry(*this, i, peEntry);
+			if (peEntry.hasName() && peEntry.getName().equalsIgnoreCase(sName))
+				return true;
+		}
+
+		return false;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor (no resources)
+	PEResources::PEResources()
+		: m_pDirectory(0)
+		, m_iDirectoryRVA(0)
+		, m_iDirectorySize(0)
+	{
+	}
+
+	// Constructor, validates the root of the Resource Directory of the Image
+	PEResources::PEResources(const PEBase& peBase)
+		: m_Cursor(peBase)
+		, m_pDirectory(0)
+		, m_iDirectoryRVA(0)
+		, m_iDirectorySize(0)
+	{
+		if (NOT peBase.hasResources())
+			return;
+
+		// Offsets of the tree are relative to the Resource Directory & bounded by its Section
+		m_iDirectoryRVA = peBase.getDirectoryRVA(IMAGE_DIRECTORY_ENTRY_RESOURCE);
+		m_pDirectory = m_Cursor.tryGetData(m_iDirectoryRVA, m_iDirectorySize);
+		if (NOT m_pDirectory)
+			throw PEException("Incorrect resource directory", PEException::PEEXCEPTION_INCORRECT_RESOURCE_DIRECTORY);
+
+		getDirectory(0, 0);
+	}
+
+	// Returns 'true' if Image has Resource Directory
+	bool PEResources::hasResources() const
+	{
+		return m_pDirectory NOT_EQUAL_TO 0;
+	}
+
+	// Returns RVA of the Resource Directory
+	uint32_t PEResources::getDirectoryRVA() const
+	{
+		return m_iDirectoryRVA;
+	}
+
+	// Returns the root directory (types)
+	const PEResourceDirectory PEResources::getRoot() const
+	{
+		return m_pDirectory ? getDirectory(0, 0) : PEResourceDirectory();
+	}
+
+	// Looks up the data of resource type/name/language (PE_RESOURCE_ANY_LANGUAGE: the first language)
+	bool PEResources::findResource(uint16_t iType, uint16_t iName, uint32_t iLanguage, PEResourceData& peData) const
+	{
+		PEResourceEntry peEntry;
+		if (NOT getRoot().findEntry(iType, peEntry) || NOT peEntry.isDirectory())
+			return false;
+
+		if (NOT peEntry.getDirectory().findEntry(iName, peEntry))
+			return false;
+
+		return findLanguage(peEntry, iLanguage, peData);
+	}
+
+	// Looks up the data of named resource of the type, returns 'false' if there is none
+	bool PEResources::findResource(uint16_t iType, const PEStringView& sName, uint32_t iLanguage, PEResourceData& peData) const
+	{
+		PEResourceEntry peEntry;
+		if (NOT getRoot().findEntry(iType, peEntry) || NOT peEntry.isDirectory())
+			return false;
+
+		if (NOT peEntry.getDirectory().findEntry(sName, peEntry))
+			return false;
+
+		return findLanguage(peEntry, iLanguage, peData);
+	}
+
+	// Looks up the data of a language of the name entry (second level of the tree), returns 'false' if there is none
+	bool PEResources::findLanguage(const PEResourceEntry& peNameEntry, uint32_t iLanguage, PEResourceData& peData) const
+	{
+		if (NOT peNameEntry.isDirectory())
+			return false;
+
+		PEResourceEntry peEntry;
+		const PEResourceDirectory peLanguages = peNameEntry.getDirectory();
+		const bool bFound = (iLanguage == PE_RESOURCE_ANY_LANGUAGE)
+							?
+							peLanguages.getEntry(0, peEntry)
+							:
+							iLanguage <= PEUtils::MAX_WORD && peLanguages.findEntry(static_cast<uint16_t>(iLanguage), peEntry);
+
+		if (NOT bFound || peEntry.isDirectory())
+			return false;
+
+		peData = peEntry.getData();
+		return true;
+	}
+
+	// Decodes directory header at offset
+	const PEResourceDirectory PEResources::getDirectory(uint32_t iOffset, uint32_t iLevel) const
+	{
+		if (iLevel > MAX_LEVEL || NOT isInside(iOffset, sizeof(IMAGE_RESOURCE_DIRECTORY)))
+			throw PEException("Incorrect resource directory", PEException::PEEXCEPTION_INCORRECT_RESOURCE_DIRECTORY);
+
+		PEResourceDirectory peDirectory;
+		peDirectory.m_pResources = this;
+		peDirectory.m_iOffset = iOffset;
+		peDirectory.m_iLevel = iLevel;
+		memcpy(&peDirectory.m_Directory, m_pDirectory + iOffset, sizeof(IMAGE_RESOURCE_DIRECTORY));
+
+		// All entries must be inside, so that they can be read without further checks
+		if (NOT isInside(iOffset + sizeof(IMAGE_RESOURCE_DIRECTORY), peDirectory.getNumberOfEntries() * sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY)))
+			throw PEException("Incorrect resource directory", PEException::PEEXCEPTION_INCORRECT_RESOURCE_DIRECTORY);
+
+		return peDirectory;
+	}
+
+	// Decodes entry at index of the directory
+	void PEResources::decodeEntry(const PEResourceDirectory& peDirectory, uint32_t iIndex, PEResourceEntry& peEntry) const
+	{
+		IMAGE_RESOURCE_DIRECTORY_ENTRY peDirectoryEntry;
+		memcpy(&peDirectoryEntry, m_pDirectory + peDirectory.m_iOffset + sizeof(IMAGE_RESOURCE_DIRECTORY) + iIndex * sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY), sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY));
+
+		peEntry = PEResourceEntry();
+		peEntry.m_pResources = this;
+		peEntry.m_iLevel = peDirectory.m_iLevel;
+
+		// Name is a length-prefixed UTF-16 string (IMAGE_RESOURCE_DIR_STRING_U)
+		if (peDirectoryEntry.iName & IMAGE_RESOURCE_NAME_IS_STRING)
+		{
+			const uint32_t iNameOffset = peDirectoryEntry.iName & ~IMAGE_RESOURCE_NAME_IS_STRING;
+			if (NOT isInside(iNameOffset, sizeof(uint16_t)))
+				throw PEException("Incorrect resource directory", PEException::PEEXCEPTION_INCORRECT_RESOURCE_DIRECTORY);
+
+			uint16_t iLength;
+			memcpy(&iLength, m_pDirectory + iNameOffset, sizeof(uint16_t));
+			if (NOT isInside(iNameOffset + sizeof(uint16_t), iLength * sizeof(uint16_t)))
+				throw PEException("Incorrect resource directory", PEException::PEEXCEPTION_INCORRECT_RESOURCE_DIRECTORY);
+
+			peEntry.m_bHasName = true;
+			peEntry.m_vName = PEWideStringView(m_pDirectory + iNameOffset + sizeof(uint16_t), iLength);
+		}
+		else
+			peEntry.m_iID = static_cast<uint16_t>(peDirectoryEntry.iName);
+
+		if (peDirectoryEntry.iOffsetToData & IMAGE_RESOURCE_DATA_IS_DIRECTORY)
+		{
+			peEntry.m_bIsDirectory = true;
+			peEntry.m_iDirectoryOffset = peDirectoryEntry.iOffsetToData & ~IMAGE_RESOURCE_DATA_IS_DIRECTORY;
+			return;
+		}
+
+		if (NOT isInside(peDirectoryEntry.iOffsetToData, sizeof(IMAGE_RESOURCE_DATA_ENTRY)))
+			throw PEException("Incorrect resource directory", PEException::PEEXCEPTION_INCORRECT_RESOURCE_DIRECTORY);
+
+		IMAGE_RESOURCE_DATA_ENTRY peDataEntry;
+		memcpy(&peDataEntry, m_pDirectory + peDirectoryEntry.iOffsetToData, sizeof(IMAGE_RESOURCE_DATA_ENTRY));
+
+		PEResourceData& peData = peEntry.m_Data;
+		peData.m_iRVA = peDataEntry.iOffsetToData;
+		peData.m_iSize = peDataEntry.iSize;
+		peData.m_iCodePage = peDataEntry.iCodePage;
+
+		// Data may be anywhere in the Image, it is referenced only if all of it is there
+		uint32_t iAvailable;
+		const char* pData = m_Cursor.tryGetData(peDataEntry.iOffsetToData, iAvailable);
+		if (pData && iAvailable >= peDataEntry.iSize)
+			peData.m_pData = pData;
+	}
+
+	// Returns 'true' if iSize bytes at offset are inside the Resource Directory
+	bool PEResources::isInside(uint32_t iOffset, uint32_t iSize) const
+	{
+		return iOffset <= m_iDirectorySize && iSize <= m_iDirectorySize - iOffset;
+	}
+}
\ No newline at end of file
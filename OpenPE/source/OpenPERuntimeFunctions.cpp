@@ -0,0 +1,198 @@
+#include "OpenPERuntimeFunctions.h"
+#include "OpenPEDataCursor.h"
+#include <algorithm>
+
+namespace OpenPE
+{
+	// Orders functions by iBeginAddress
+	static bool beginsBefore(const IMAGE_RUNTIME_FUNCTION_ENTRY& peFunction, const IMAGE_RUNTIME_FUNCTION_ENTRY& peOther)
+	{
+		return peFunction.iBeginAddress < peOther.iBeginAddress;
+	}
+
+	// Returns 'true' if RVA is before the beginning of the function
+	static bool isBefore(uint32_t iRVA, const IMAGE_RUNTIME_FUNCTION_ENTRY& peFunction)
+	{
+		return iRVA < peFunction.iBeginAddress;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor (no functions)
+	PERuntimeFunctions::PERuntimeFunctions()
+		: m_pFunctions(0)
+		, m_iNumberOfFunctions(0)
+		, m_iDirectoryRVA(0)
+		, m_bSortedInImage(true)
+	{
+	}
+
+	// Constructor, validates the Exception Directory of the Image
+	PERuntimeFunctions::PERuntimeFunctions(const PEBase& peBase)
+		: m_pFunctions(0)
+		, m_iNumberOfFunctions(0)
+		, m_iDirectoryRVA(0)
+		, m_bSortedInImage(true)
+	{
+		if (	NOT peBase.hasExceptionDirectory()
+				||
+				(peBase.getMachine() NOT_EQUAL_TO IMAGE_FILE_MACHINE_AMD64 && peBase.getMachine() NOT_EQUAL_TO IMAGE_FILE_MACHINE_IA64)
+		) {
+			return;
+		}
+
+		m_iDirectoryRVA = peBase.getDirectoryRVA(IMAGE_DIRECTORY_ENTRY_EXCEPTION);
+		const uint32_t iNumberOfFunctions = peBase.getDirectorySize(IMAGE_DIRECTORY_ENTRY_EXCEPTION) / sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY);
+
+		uint32_t iAvailable;
+		PEDataCursor peCursor(peBase);
+		const char* pDirectory = peCursor.tryGetData(m_iDirectoryRVA, iAvailable);
+		if (NOT pDirectory || iAvailable / sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY) < iNumberOfFunctions)
+			throw PEException("Incorrect exception directory", PEException::PEEXCEPTION_INCORRECT_EXCEPTION_DIRECTORY);
+
+		m_pFunctions = reinterpret_cast<const IMAGE_RUNTIME_FUNCTION_ENTRY*>(pDirectory);
+		m_iNumberOfFunctions = iNumberOfFunctions;
+
+		// One pass validates every function & the order, lookups rely on it from then on
+		for (uint32_t i = 0; i < m_iNumberOfFunctions; i++)
+		{
+			if (m_pFunctions[i].iEndAddress < m_pFunctions[i].iBeginAddress)
+				throw PEException("Incorrect exception directory", PEException::PEEXCEPTION_INCORRECT_EXCEPTION_DIRECTORY);
+
+			if (i && m_pFunctions[i].iBeginAddress < m_pFunctions[i - 1].iEndAddress)
+				m_bSortedInImage = false;
+		}
+
+		// Overlapping functions stay as they are, a lookup then finds the last one beginning before the RVA
+		if (NOT m_bSortedInImage)
+		{
+			m_vSortedFunctions.assign(m_pFunctions, m_pFunctions + m_iNumberOfFunctions);
+			std::stable_sort(m_vSortedFunctions.begin(), m_vSortedFunctions.end(), beginsBefore);
+		}
+	}
+
+	PERuntimeFunctions::const_iterator PERuntimeFunctions::begin() const
+	{
+		return getFunctions();
+	}
+
+	PERuntimeFunctions::const_iterator PERuntimeFunctions::end() const
+	{
+		return getFunctions() + m_iNumberOfFunctions;
+	}
+
+	// Returns function at index
+	const IMAGE_RUNTIME_FUNCTION_ENTRY& PERuntimeFunctions::operator[](uint32_t iIndex) const
+	{
+		return getFunctions()[iIndex];
+	}
+
+	// Returns number of functions
+	uint32_t PERuntimeFunctions::size() const
+	{
+		return m_iNumberOfFunctions;
+	}
+
+	// Returns 'true' if there are no functions
+	bool PERuntimeFunctions::empty() const
+	{
+		return m_iNumberOfFunctions == 0;
+	}
+
+	// Returns RVA of the Exception Directory
+	uint32_t PERuntimeFunctions::getDirectoryRVA() const
+	{
+		return m_iDirectoryRVA;
+	}
+
+	// Returns 'true' if the functions are sorted & don't overlap in the Image (as linkers write them)
+	bool PERuntimeFunctions::isSortedInImage() const
+	{
+		return m_bSortedInImage;
+	}
+
+	// Returns index of the function containing RVA, FUNCTION_NOT_FOUND if there is none
+	uint32_t PERuntimeFunctions::findFunction(uint32_t iRVA) const
+	{
+		return containingFunction(iRVA, upperBound(iRVA, 0, m_iNumberOfFunctions));
+	}
+
+	// Returns the function containing RVA, 0 if there is none
+	const IMAGE_RUNTIME_FUNCTION_ENTRY* PERuntimeFunctions::getFunction(uint32_t iRVA) const
+	{
+		const uint32_t iIndex = findFunction(iRVA);
+
+		return (iIndex == FUNCTION_NOT_FOUND) ? 0 : getFunctions() + iIndex;
+	}
+
+	// Maps iCount RVAs to indices of the functions containing them (FUNCTION_NOT_FOUND if there is none)
+	size_t PERuntimeFunctions::findFunctions(const uint32_t* pRVAs, size_t iCount, uint32_t* pIndices) const
+	{
+		const IMAGE_RUNTIME_FUNCTION_ENTRY* pFunctions = getFunctions();
+
+		size_t iFound = 0;
+		uint32_t iUpperBound = 0;
+		for (size_t i = 0; i < iCount; i++)
+		{
+			const uint32_t iRVA = pRVAs[i];
+
+			uint32_t iLow = 0;
+			uint32_t iHigh = m_iNumberOfFunctions;
+
+			// Functions before the previous upper bound begin at or before the previous RVA,
+			// gallop forward from there: iLow .. iHigh - 1 is the range holding the new upper bound
+			if (i && iRVA >= pRVAs[i - 1])
+			{
+				uint32_t iStep = 1;
+
+				iLow = iUpperBound;
+				iHigh = iUpperBound;
+				while (iHigh < m_iNumberOfFunctions && pFunctions[iHigh].iBeginAddress <= iRVA)
+				{
+					iLow = iHigh + 1;
+					iHigh = (m_iNumberOfFunctions - iHigh > iStep) ? iHigh + iStep : m_iNumberOfFunctions;
+					iStep <<= 1;
+				}
+			}
+
+			iUpperBound = upperBound(iRVA, iLow, iHigh);
+			pIndices[i] = containingFunction(iRVA, iUpperBound);
+			if (pIndices[i] NOT_EQUAL_TO FUNCTION_NOT_FOUND)
+				iFound++;
+		}
+
+		return iFound;
+	}
+
+	// Same as above, vIndices is resized to the number of RVAs
+	size_t PERuntimeFunctions::findFunctions(const std::vector<uint32_t>& vRVAs, std::vector<uint32_t>& vIndices) const
+	{
+		vIndices.resize(vRVAs.size());
+		if (vRVAs.empty())
+			return 0;
+
+		return findFunctions(&vRVAs[0], vRVAs.size(), &vIndices[0]);
+	}
+
+	// Returns the functions (in the Image, or the sorted copy)
+	const IMAGE_RUNTIME_FUNCTION_ENTRY* PERuntimeFunctions::getFunctions() const
+	{
+		return m_vSortedFunctions.empty() ? m_pFunctions : &m_vSortedFunctions[0];
+	}
+
+	// Returns index of the first function in [iLow, iHigh) beginning after iRVA
+	uint32_t PERuntimeFunctions::upperBound(uint32_t iRVA, uint32_t iLow, uint32_t iHigh) const
+	{
+		const IMAGE_RUNTIME_FUNCTION_ENTRY* pFunctions = getFunctions();
+
+		return static_cast<uint32_t>(std::upper_bound(pFunctions + iLow, pFunctions + iHigh, iRVA, isBefore) - pFunctions);
+	}
+
+	// Returns index of the function containing RVA, given index of the first function beginning after it
+	uint32_t PERuntimeFunctions::containingFunction(uint32_t iRVA, uint32_t iUpperBound) const
+	{
+		if (iUpperBound == 0 || iRVA >= getFunctions()[iUpperBound - 1].iEndAddress)
+			return FUNCTION_NOT_FOUND;
+
+		return iUpperBound - 1;
+	}
+}
\ No newline at end of file
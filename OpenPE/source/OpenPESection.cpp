@@ -12,6 +12,32 @@ namespace OpenPE
 		memset(&m_SectionHeader, 0, sizeof(Image_Section_Header));
 	}
 
+	// Copy Constructor (room reserved for the virtual data is kept, see getRawData())
+	PESection::PESection(const PESection& peSection)
+		: m_SectionHeader(peSection.m_SectionHeader)
+		, m_iOldSize(peSection.m_iOldSize)
+	{
+		m_sRawData.reserve(peSection.m_sRawData.capacity());
+		m_sRawData = peSection.m_sRawData;
+	}
+
+	// Assignment (room reserved for the virtual data is kept, see getRawData())
+	PESection& PESection::operator=(const PESection& peSection)
+	{
+		if (this NOT_EQUAL_TO &peSection)
+		{
+			m_SectionHeader = peSection.m_SectionHeader;
+			m_iOldSize = peSection.m_iOldSize;
+
+			if (m_sRawData.capacity() < peSection.m_sRawData.capacity())
+				m_sRawData.reserve(peSection.m_sRawData.capacity());
+
+			m_sRawData = peSection.m_sRawData;
+		}
+
+		return *this;
+	}
+
 	// Sets the name of the Section(Stripped off to 8 characters)
 	void PESection::SetName(const std::string& sName)
 	{
@@ -227,6 +253,11 @@ namespace OpenPE
 		uint32_t iAlignedVirtualSize = getAlignedVirtualSize(iSectionAlignement);
 		if (m_iOldSize == static_cast<size_t>(-1) && iAlignedVirtualSize && iAlignedVirtualSize > m_sRawData.length())
 		{
+			// Capacity is kept when unmapping, so only the first mapping of new data may reallocate
+			// (Images read by PEBase reserve it when the data is read)
+			if (m_sRawData.capacity() < iAlignedVirtualSize)
+				m_sRawData.reserve(iAlignedVirtualSize);
+
 			m_iOldSize = m_sRawData.length();
 			m_sRawData.resize(iAlignedVirtualSize, 0);
 		}
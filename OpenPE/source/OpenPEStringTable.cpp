@@ -0,0 +1,122 @@
+#include "OpenPEStringTable.h"
+#include "OpenPEException.h"
+
+namespace OpenPE
+{
+	// Default Constructor (no strings)
+	PEStringTable::PEStringTable()
+		: m_iNumberOfStrings(0)
+	{
+	}
+
+	// Decodes all string bundles of the language, returns 'false' if Image has no string table
+	bool PEStringTable::load(const PEResources& peResources, uint32_t iLanguage)
+	{
+		clear();
+
+		PEResourceEntry peTypeEntry;
+		if (	NOT peResources.hasResources()
+				||
+				NOT peResources.getRoot().findEntry(static_cast<uint16_t>(PE_RESOURCE_STRING), peTypeEntry)
+				||
+				NOT peTypeEntry.isDirectory()
+		) {
+			return false;
+		}
+
+		bool bHasTable = false;
+
+		// Name of a bundle is its number + 1, named entries are not bundles
+		const PEResourceDirectory peNames = peTypeEntry.getDirectory();
+		for (PEResourceDirectory::const_iterator itr = peNames.begin(); itr NOT_EQUAL_TO peNames.end(); ++itr)
+		{
+			PEResourceData peData;
+			if (itr->hasName() || itr->getID() == 0 || NOT peResources.findLanguage(*itr, iLanguage, peData))
+				continue;
+
+			if (NOT peData.hasData())
+				throw PEException("Incorrect string table", PEException::PEEXCEPTION_INCORRECT_RESOURCE_DATA);
+
+			addBundle(itr->getID() - 1, peData.getData(), peData.getSize());
+			bHasTable = true;
+		}
+
+		return bHasTable;
+	}
+
+	// Returns number of (non-empty) strings
+	size_t PEStringTable::getNumberOfStrings() const
+	{
+		return m_iNumberOfStrings;
+	}
+
+	// Sets vString to the string with the ID (UTF-16), returns 'false' if there is none
+	bool PEStringTable::findString(uint16_t iID, PEWideStringView& vString) const
+	{
+		const uint32_t iBundle = iID / STRING_TABLE_BUNDLE_SIZE;
+		if (iBundle >= m_vBundles.size() || NOT m_vBundles[iBundle])
+			return false;
+
+		const PEWideStringView& vBundleString = m_vStrings[m_vBundles[iBundle] - 1 + iID % STRING_TABLE_BUNDLE_SIZE];
+		if (vBundleString.empty())
+			return false;
+
+		vString = vBundleString;
+		return true;
+	}
+
+	// Sets sString to UTF-8 string with the ID, returns 'false' if there is none
+	bool PEStringTable::getString(uint16_t iID, std::string& sString) const
+	{
+		PEWideStringView vString;
+		if (NOT findString(iID, vString))
+			return false;
+
+		sString.clear();
+		PEUtils::appendUTF8(sString, vString.data(), vString.length());
+
+		return true;
+	}
+
+	// Clears the table (keeps capacity of the lists)
+	void PEStringTable::clear()
+	{
+		m_vStrings.clear();
+		m_vBundles.clear();
+		m_iNumberOfStrings = 0;
+	}
+
+	// Decodes a bundle of iSize bytes at pData (every string is its length in characters followed by the characters)
+	void PEStringTable::addBundle(uint16_t iBundle, const char* pData, uint32_t iSize)
+	{
+		if (iBundle >= m_vBundles.size())
+			m_vBundles.resize(iBundle + 1, 0);
+
+		// The first bundle with the number is kept
+		if (m_vBundles[iBundle])
+			return;
+
+		const size_t iFirstString = m_vStrings.size();
+
+		uint32_t iOffset = 0;
+		for (uint32_t i = 0; i < STRING_TABLE_BUNDLE_SIZE; i++)
+		{
+			if (iSize - iOffset < sizeof(uint16_t))
+				throw PEException("Incorrect string table", PEException::PEEXCEPTION_INCORRECT_RESOURCE_DATA);
+
+			const uint32_t iLength = static_cast<uint8_t>(pData[iOffset]) | (static_cast<uint8_t>(pData[iOffset + 1]) << 8);
+			iOffset += sizeof(uint16_t);
+
+			if (iLength > (iSize - iOffset) / sizeof(uint16_t))
+				throw PEException("Incorrect string table", PEException::PEEXCEPTION_INCORRECT_RESOURCE_DATA);
+
+			m_vStrings.push_back(PEWideStringView(pData + iOffset, iLength));
+			iOffset += iLength * sizeof(uint16_t);
+
+			if (iLength)
+				m_iNumberOfStrings++;
+		}
+
+		m_vBundles[iBundle] = static_cast<uint32_t>(iFirstString + 1);
+	}
+}
\ No newline at end of file
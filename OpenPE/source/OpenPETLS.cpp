@@ -0,0 +1,208 @@
+#include "OpenPETLS.h"
+#include "OpenPEDataCursor.h"
+#include "OpenPEPropertiesGeneric.h"
+#include <string.h>
+
+namespace OpenPE
+{
+	// Helper: converts VA to RVA, returns 'false' if VA is not inside the Image
+	static inline bool getTLSAddressRVA(const PEBase& peBase, uint64_t iVA, uint32_t& iRVA)
+	{
+		const uint64_t iOffset = iVA - peBase.getImageBase64();
+		if (iVA < peBase.getImageBase64() || iOffset >= peBase.getSizeOfImage())
+			return false;
+
+		iRVA = static_cast<uint32_t>(iOffset);
+		return true;
+	}
+
+	// Default Constructor
+	PETLSInfo::PETLSInfo()
+		: m_iStartAddressOfRawData(0)
+		, m_iEndAddressOfRawData(0)
+		, m_iAddressOfIndex(0)
+		, m_iAddressOfCallbacks(0)
+		, m_iSizeOfZeroFill(0)
+		, m_iCharacteristics(0)
+		, m_iRawDataRVA(0)
+		, m_iSizeOfRawData(0)
+		, m_pRawData(0)
+		, m_bCallbackListTruncated(false)
+	{
+	}
+
+	// Returns VA of the beginning of the template data
+	uint64_t PETLSInfo::getStartAddressOfRawData() const
+	{
+		return m_iStartAddressOfRawData;
+	}
+
+	// Returns VA of the end of the template data
+	uint64_t PETLSInfo::getEndAddressOfRawData() const
+	{
+		return m_iEndAddressOfRawData;
+	}
+
+	// Returns VA of the TLS index variable
+	uint64_t PETLSInfo::getAddressOfIndex() const
+	{
+		return m_iAddressOfIndex;
+	}
+
+	// Returns VA of the null-terminated callback list (0 if there is none)
+	uint64_t PETLSInfo::getAddressOfCallbacks() const
+	{
+		return m_iAddressOfCallbacks;
+	}
+
+	// Returns number of bytes zero-filled after the template data
+	uint32_t PETLSInfo::getSizeOfZeroFill() const
+	{
+		return m_iSizeOfZeroFill;
+	}
+
+	// Returns Characteristics (alignment of the TLS block, IMAGE_SCN_ALIGN_*)
+	uint32_t PETLSInfo::getCharacteristics() const
+	{
+		return m_iCharacteristics;
+	}
+
+	// Returns RVA of the template data (0 if there is none)
+	uint32_t PETLSInfo::getRawDataRVA() const
+	{
+		return m_iRawDataRVA;
+	}
+
+	// Returns size of the template data
+	uint32_t PETLSInfo::getSizeOfRawData() const
+	{
+		return m_iSizeOfRawData;
+	}
+
+	// Returns the template data (getSizeOfRawData() bytes), 0 if it is not inside the Image data
+	const char* PETLSInfo::getRawData() const
+	{
+		return m_pRawData;
+	}
+
+	// Returns VAs of the callbacks
+	const std::vector<uint64_t>& PETLSInfo::getCallbacks() const
+	{
+		return m_vCallbacks;
+	}
+
+	// Returns 'true' if the callback list doesn't end inside the Image data
+	bool PETLSInfo::isCallbackListTruncated() const
+	{
+		return m_bCallbackListTruncated;
+	}
+
+	// Clears the information (keeps capacity of the callback list)
+	void PETLSInfo::clear()
+	{
+		m_iStartAddressOfRawData = 0;
+		m_iEndAddressOfRawData = 0;
+		m_iAddressOfIndex = 0;
+		m_iAddressOfCallbacks = 0;
+		m_iSizeOfZeroFill = 0;
+		m_iCharacteristics = 0;
+		m_iRawDataRVA = 0;
+		m_iSizeOfRawData = 0;
+		m_pRawData = 0;
+		m_vCallbacks.clear();
+		m_bCallbackListTruncated = false;
+	}
+
+	// Reads TLS Directory of the Image & walks its callback list
+	bool readTLS(const PEBase& peBase, PETLSInfo& peTLSInfo)
+	{
+		return (	peBase.getPEType() == PEType_32
+					?
+					readTLSBase<PETypeClass32>(peBase, peTLSInfo)
+					:
+					readTLSBase<PETypeClass64>(peBase, peTLSInfo)
+			);
+	}
+
+	template<typename PEClassType>
+	bool readTLSBase(const PEBase& peBase, PETLSInfo& peTLSInfo)
+	{
+		typedef typename PEClassType::TLSStruct TLSStruct;
+		typedef typename PEClassType::BaseSize BaseSize;
+
+		peTLSInfo.clear();
+
+		if (NOT peBase.hasTLS())
+			return false;
+
+		// Reads are bounded by the data block (Section) of the cursor, no Section is copied or mapped
+		PEDataCursor peCursor(peBase);
+
+		uint32_t iAvailable;
+		const char* pDirectory = peCursor.tryGetData(peBase.getDirectoryRVA(IMAGE_DIRECTORY_ENTRY_TLS), iAvailable);
+		if (NOT pDirectory || iAvailable < sizeof(TLSStruct))
+			throw PEException("Incorrect TLS directory", PEException::PEEXCEPTION_INCORRECT_TLS_DIRECTORY);
+
+		TLSStruct peDirectory;
+		memcpy(&peDirectory, pDirectory, sizeof(TLSStruct));
+
+		peTLSInfo.m_iStartAddressOfRawData = peDirectory.StartAddressOfRawData;
+		peTLSInfo.m_iEndAddressOfRawData = peDirectory.EndAddressOfRawData;
+		peTLSInfo.m_iAddressOfIndex = peDirectory.AddressOfIndex;
+		peTLSInfo.m_iAddressOfCallbacks = peDirectory.AddressOfCallback;
+		peTLSInfo.m_iSizeOfZeroFill = static_cast<uint32_t>(peDirectory.SizeOfZeroFill);
+		peTLSInfo.m_iCharacteristics = static_cast<uint32_t>(peDirectory.Charecteristics);
+
+		// Template data
+		uint32_t iRawDataRVA;
+		if (	peDirectory.StartAddressOfRawData
+				&&
+				peDirectory.EndAddressOfRawData > peDirectory.StartAddressOfRawData
+				&&
+				peDirectory.EndAddressOfRawData - peDirectory.StartAddressOfRawData <= peBase.getSizeOfImage()
+				&&
+				getTLSAddressRVA(peBase, peDirectory.StartAddressOfRawData, iRawDataRVA)
+		) {
+			peTLSInfo.m_iRawDataRVA = iRawDataRVA;
+			peTLSInfo.m_iSizeOfRawData = static_cast<uint32_t>(peDirectory.EndAddressOfRawData - peDirectory.StartAddressOfRawData);
+
+			const char* pRawData = peCursor.tryGetData(iRawDataRVA, iAvailable);
+			if (pRawData && iAvailable >= peTLSInfo.m_iSizeOfRawData)
+				peTLSInfo.m_pRawData = pRawData;
+		}
+
+		// Callbacks, up to the null entry or the end of the data block
+		if (peDirectory.AddressOfCallback)
+		{
+			uint32_t iCallbacksRVA;
+			const BaseSize* pCallbacks = 0;
+			uint32_t iNumberOfEntries = 0;
+
+			if (getTLSAddressRVA(peBase, peDirectory.AddressOfCallback, iCallbacksRVA))
+			{
+				const char* pData = peCursor.tryGetData(iCallbacksRVA, iAvailable);
+				if (pData)
+				{
+					pCallbacks = reinterpret_cast<const BaseSize*>(pData);
+					iNumberOfEntries = iAvailable / sizeof(BaseSize);
+				}
+			}
+
+			peTLSInfo.m_bCallbackListTruncated = true;
+			for (uint32_t i = 0; i < iNumberOfEntries; i++)
+			{
+				BaseSize iCallback;
+				memcpy(&iCallback, pCallbacks + i, sizeof(BaseSize));
+				if (NOT iCallback)
+				{
+					peTLSInfo.m_bCallbackListTruncated = false;
+					break;
+				}
+
+				peTLSInfo.m_vCallbacks.push_back(iCallback);
+			}
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
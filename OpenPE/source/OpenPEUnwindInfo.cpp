@@ -0,0 +1,382 @@
+#include "OpenPEUnwindInfo.h"
+#include <string.h>
+
+namespace OpenPE
+{
+	// Number of unwind operations in a code pool (UNWIND_INFO holds at most 255)
+	static const uint32_t CODE_POOL_SIZE = 4096;
+
+	// Maximum number of chained unwind infos followed to the primary function
+	static const uint32_t MAX_CHAIN_LENGTH = 32;
+
+	// Returns number of UNWIND_CODE slots taken by the operation
+	static uint32_t getNumberOfSlots(uint8_t iOperation, uint8_t iOperationInfo)
+	{
+		switch (iOperation)
+		{
+			case UWOP_ALLOC_LARGE:
+				return (iOperationInfo == 0) ? 2 : 3;
+			case UWOP_SAVE_NONVOL:
+			case UWOP_EPILOG:
+			case UWOP_SAVE_XMM128:
+				return 2;
+			case UWOP_SAVE_NONVOL_FAR:
+			case UWOP_SPARE_CODE:
+			case UWOP_SAVE_XMM128_FAR:
+				return 3;
+		}
+
+		return 1;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor
+	PEUnwindCode::PEUnwindCode()
+		: m_iCodeOffset(0)
+		, m_iOperation(0)
+		, m_iOperationInfo(0)
+		, m_iOperand(0)
+	{
+	}
+
+	// Constructor
+	PEUnwindCode::PEUnwindCode(uint8_t iCodeOffset, uint8_t iOperation, uint8_t iOperationInfo, uint32_t iOperand)
+		: m_iCodeOffset(iCodeOffset)
+		, m_iOperation(iOperation)
+		, m_iOperationInfo(iOperationInfo)
+		, m_iOperand(iOperand)
+	{
+	}
+
+	// Returns offset of the end of the prolog instruction from the beginning of the prolog
+	uint8_t PEUnwindCode::getCodeOffset() const
+	{
+		return m_iCodeOffset;
+	}
+
+	// Returns the operation (UWOP_*)
+	uint8_t PEUnwindCode::getOperation() const
+	{
+		return m_iOperation;
+	}
+
+	// Returns the operation info (register number for pushes & saves)
+	uint8_t PEUnwindCode::getOperationInfo() const
+	{
+		return m_iOperationInfo;
+	}
+
+	// Returns allocation size (UWOP_ALLOC_*), stack offset (UWOP_SAVE_*, UWOP_SET_FPREG) in bytes,
+	// or the raw value of the following slots for other operations
+	uint32_t PEUnwindCode::getOperand() const
+	{
+		return m_iOperand;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Default Constructor
+	PEUnwindInfo::PEUnwindInfo()
+		: m_iUnwindInfoRVA(0)
+		, m_iVersion(0)
+		, m_iFlags(0)
+		, m_iSizeOfProlog(0)
+		, m_iFrameRegisterAndOffset(0)
+		, m_iNumberOfCodes(0)
+		, m_pCodes(0)
+		, m_iHandlerRVA(0)
+		, m_iHandlerDataRVA(0)
+	{
+		memset(&m_ChainedFunction, 0, sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY));
+	}
+
+	// Returns RVA of the UNWIND_INFO
+	uint32_t PEUnwindInfo::getUnwindInfoRVA() const
+	{
+		return m_iUnwindInfoRVA;
+	}
+
+	// Returns version (1 or 2)
+	uint8_t PEUnwindInfo::getVersion() const
+	{
+		return m_iVersion;
+	}
+
+	// Returns flags (UNW_FLAG_*)
+	uint8_t PEUnwindInfo::getFlags() const
+	{
+		return m_iFlags;
+	}
+
+	// Returns size of the prolog in bytes
+	uint8_t PEUnwindInfo::getSizeOfProlog() const
+	{
+		return m_iSizeOfProlog;
+	}
+
+	// Returns the frame register (0 if the function doesn't use one)
+	uint8_t PEUnwindInfo::getFrameRegister() const
+	{
+		return m_iFrameRegisterAndOffset & 0x0F;
+	}
+
+	// Returns offset of the frame register from RSP in bytes
+	uint32_t PEUnwindInfo::getFrameOffset() const
+	{
+		return (m_iFrameRegisterAndOffset >> 4) * 16;
+	}
+
+	// Returns number of decoded unwind operations
+	uint32_t PEUnwindInfo::getNumberOfCodes() const
+	{
+		return m_iNumberOfCodes;
+	}
+
+	// Returns unwind operation at index (in the order of UNWIND_INFO, the reverse of the prolog)
+	const PEUnwindCode& PEUnwindInfo::getCode(uint32_t iIndex) const
+	{
+		return m_pCodes[iIndex];
+	}
+
+	// Returns 'true' if function has an exception or termination handler
+	bool PEUnwindInfo::hasHandler() const
+	{
+		return (m_iFlags & (UNW_FLAG_EHANDLER | UNW_FLAG_UHANDLER)) NOT_EQUAL_TO 0;
+	}
+
+	// Returns RVA of the exception handler (0 if there is none)
+	uint32_t PEUnwindInfo::getHandlerRVA() const
+	{
+		return m_iHandlerRVA;
+	}
+
+	// Returns RVA of the language-specific handler data (0 if there is no handler)
+	uint32_t PEUnwindInfo::getHandlerDataRVA() const
+	{
+		return m_iHandlerDataRVA;
+	}
+
+	// Returns 'true' if the unwind info is chained to the one of a primary function
+	bool PEUnwindInfo::isChained() const
+	{
+		return (m_iFlags & UNW_FLAG_CHAININFO) NOT_EQUAL_TO 0;
+	}
+
+	// Returns the primary function the unwind info is chained to (zeros if it is not chained)
+	const IMAGE_RUNTIME_FUNCTION_ENTRY& PEUnwindInfo::getChainedFunction() const
+	{
+		return m_ChainedFunction;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Constructor
+	PEUnwindTable::PEUnwindTable(const PEBase& peBase, const PERuntimeFunctions& peFunctions)
+		: m_pPEBase(&peBase)
+		, m_pFunctions(&peFunctions)
+		, m_Cursor(peBase)
+		, m_vInfoIndices(peFunctions.size(), 0)
+	{
+		if (peBase.getMachine() NOT_EQUAL_TO IMAGE_FILE_MACHINE_AMD64)
+			throw PEException("Unwind info can be decoded for x64 Images only", PEException::PEEXCEPTION_INCORRECT_UNWIND_INFO);
+	}
+
+	// Returns the functions the unwind infos belong to
+	const PERuntimeFunctions& PEUnwindTable::getFunctions() const
+	{
+		return *m_pFunctions;
+	}
+
+	// Returns unwind info of the function at index (decodes it on first use)
+	const PEUnwindInfo& PEUnwindTable::getUnwindInfo(uint32_t iFunctionIndex)
+	{
+		if (m_vInfoIndices[iFunctionIndex])
+			return m_dInfos[m_vInfoIndices[iFunctionIndex] - 1];
+
+		uint32_t iUnwindInfoRVA = (*m_pFunctions)[iFunctionIndex].iUnwindInfoAddress;
+
+		// Odd address points to the entry of another function sharing its unwind info
+		if (iUnwindInfoRVA & 1)
+		{
+			uint32_t iAvailable;
+			const char* pEntry = m_Cursor.tryGetData(iUnwindInfoRVA & ~1u, iAvailable);
+			if (NOT pEntry || iAvailable < sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY))
+				throw PEException("Incorrect unwind info", PEException::PEEXCEPTION_INCORRECT_UNWIND_INFO);
+
+			IMAGE_RUNTIME_FUNCTION_ENTRY peEntry;
+			memcpy(&peEntry, pEntry, sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY));
+			iUnwindInfoRVA = peEntry.iUnwindInfoAddress;
+		}
+
+		PEUnwindInfo peUnwindInfo;
+		decode(iUnwindInfoRVA, peUnwindInfo);
+
+		m_dInfos.push_back(peUnwindInfo);
+		m_vInfoIndices[iFunctionIndex] = static_cast<uint32_t>(m_dInfos.size());
+
+		return m_dInfos.back();
+	}
+
+	// Returns unwind info of the function containing RVA, 0 if there is none
+	const PEUnwindInfo* PEUnwindTable::findUnwindInfo(uint32_t iRVA)
+	{
+		const uint32_t iFunctionIndex = m_pFunctions->findFunction(iRVA);
+		if (iFunctionIndex == FUNCTION_NOT_FOUND)
+			return 0;
+
+		return &getUnwindInfo(iFunctionIndex);
+	}
+
+	// Returns index of the primary function of the function at index (itself if its unwind info is not chained)
+	uint32_t PEUnwindTable::getPrimaryFunction(uint32_t iFunctionIndex)
+	{
+		for (uint32_t i = 0; i < MAX_CHAIN_LENGTH; i++)
+		{
+			const PEUnwindInfo& peUnwindInfo = getUnwindInfo(iFunctionIndex);
+			if (NOT peUnwindInfo.isChained())
+				return iFunctionIndex;
+
+			iFunctionIndex = m_pFunctions->findFunction(peUnwindInfo.getChainedFunction().iBeginAddress);
+			if (iFunctionIndex == FUNCTION_NOT_FOUND)
+				throw PEException("Incorrect unwind info", PEException::PEEXCEPTION_INCORRECT_UNWIND_INFO);
+		}
+
+		throw PEException("Incorrect unwind info", PEException::PEEXCEPTION_INCORRECT_UNWIND_INFO);
+	}
+
+	// Returns number of decoded unwind infos
+	uint32_t PEUnwindTable::getNumberOfDecoded() const
+	{
+		return static_cast<uint32_t>(m_dInfos.size());
+	}
+
+	// Drops the decoded unwind infos
+	void PEUnwindTable::clear()
+	{
+		m_vInfoIndices.assign(m_pFunctions->size(), 0);
+		m_dInfos.clear();
+		m_dCodePools.clear();
+	}
+
+	// Decodes UNWIND_INFO at RVA into peUnwindInfo
+	void PEUnwindTable::decode(uint32_t iUnwindInfoRVA, PEUnwindInfo& peUnwindInfo)
+	{
+		uint32_t iAvailable;
+		const char* pData = m_Cursor.tryGetData(iUnwindInfoRVA, iAvailable);
+		if (NOT pData || iAvailable < sizeof(UNWIND_INFO))
+			throw PEException("Incorrect unwind info", PEException::PEEXCEPTION_INCORRECT_UNWIND_INFO);
+
+		UNWIND_INFO peHeader;
+		memcpy(&peHeader, pData, sizeof(UNWIND_INFO));
+
+		peUnwindInfo.m_iUnwindInfoRVA = iUnwindInfoRVA;
+		peUnwindInfo.m_iVersion = peHeader.iVersionAndFlags & 0x07;
+		peUnwindInfo.m_iFlags = peHeader.iVersionAndFlags >> 3;
+		peUnwindInfo.m_iSizeOfProlog = peHeader.iSizeOfProlog;
+		peUnwindInfo.m_iFrameRegisterAndOffset = peHeader.iFrameRegisterAndOffset;
+
+		// Slots are padded to an even count, the handler or the chained function follows
+		const uint32_t iCodesSize = ((peHeader.iCountOfCodes + 1) & ~1u) * sizeof(uint16_t);
+		if (	(peUnwindInfo.m_iVersion NOT_EQUAL_TO 1 && peUnwindInfo.m_iVersion NOT_EQUAL_TO 2)
+				||
+				iAvailable - sizeof(UNWIND_INFO) < iCodesSize
+		) {
+			throw PEException("Incorrect unwind info", PEException::PEEXCEPTION_INCORRECT_UNWIND_INFO);
+		}
+
+		const uint8_t* pSlots = reinterpret_cast<const uint8_t*>(pData + sizeof(UNWIND_INFO));
+
+		// First pass counts the operations, so that their storage is taken once
+		uint32_t iNumberOfCodes = 0;
+		for (uint32_t iSlot = 0; iSlot < peHeader.iCountOfCodes; iNumberOfCodes++)
+		{
+			const uint32_t iNumberOfSlots = getNumberOfSlots(pSlots[iSlot * 2 + 1] & 0x0F, pSlots[iSlot * 2 + 1] >> 4);
+			if (iNumberOfSlots > static_cast<uint32_t>(peHeader.iCountOfCodes - iSlot))
+				throw PEException("Incorrect unwind info", PEException::PEEXCEPTION_INCORRECT_UNWIND_INFO);
+
+			iSlot += iNumberOfSlots;
+		}
+
+		PEUnwindCode* pCodes = iNumberOfCodes ? allocateCodes(iNumberOfCodes) : 0;
+		peUnwindInfo.m_pCodes = pCodes;
+		peUnwindInfo.m_iNumberOfCodes = iNumberOfCodes;
+
+		for (uint32_t iSlot = 0, iCode = 0; iCode < iNumberOfCodes; iCode++)
+		{
+			const uint8_t iCodeOffset = pSlots[iSlot * 2];
+			const uint8_t iOperation = pSlots[iSlot * 2 + 1] & 0x0F;
+			const uint8_t iOperationInfo = pSlots[iSlot * 2 + 1] >> 4;
+			const uint32_t iNumberOfSlots = getNumberOfSlots(iOperation, iOperationInfo);
+
+			// Value of the following slots (1 or 2 of them)
+			uint32_t iValue = 0;
+			if (iNumberOfSlots == 2)
+			{
+				uint16_t iSlotValue;
+				memcpy(&iSlotValue, pSlots + (iSlot + 1) * 2, sizeof(uint16_t));
+				iValue = iSlotValue;
+			}
+			else if (iNumberOfSlots == 3)
+			{
+				memcpy(&iValue, pSlots + (iSlot + 1) * 2, sizeof(uint32_t));
+			}
+
+			uint32_t iOperand = iValue;
+			switch (iOperation)
+			{
+				case UWOP_ALLOC_LARGE:
+					iOperand = (iOperationInfo == 0) ? iValue * 8 : iValue;
+					break;
+				case UWOP_ALLOC_SMALL:
+					iOperand = iOperationInfo * 8 + 8;
+					break;
+				case UWOP_SET_FPREG:
+					iOperand = peUnwindInfo.getFrameOffset();
+					break;
+				case UWOP_SAVE_NONVOL:
+					iOperand = iValue * 8;
+					break;
+				case UWOP_SAVE_XMM128:
+					iOperand = iValue * 16;
+					break;
+			}
+
+			pCodes[iCode] = PEUnwindCode(iCodeOffset, iOperation, iOperationInfo, iOperand);
+			iSlot += iNumberOfSlots;
+		}
+
+		const char* pTrailer = pData + sizeof(UNWIND_INFO) + iCodesSize;
+		const uint32_t iTrailerRVA = iUnwindInfoRVA + sizeof(UNWIND_INFO) + iCodesSize;
+		const uint32_t iTrailerAvailable = iAvailable - sizeof(UNWIND_INFO) - iCodesSize;
+
+		if (peUnwindInfo.isChained())
+		{
+			if (iTrailerAvailable < sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY))
+				throw PEException("Incorrect unwind info", PEException::PEEXCEPTION_INCORRECT_UNWIND_INFO);
+
+			memcpy(&peUnwindInfo.m_ChainedFunction, pTrailer, sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY));
+		}
+		else if (peUnwindInfo.hasHandler())
+		{
+			if (iTrailerAvailable < sizeof(uint32_t))
+				throw PEException("Incorrect unwind info", PEException::PEEXCEPTION_INCORRECT_UNWIND_INFO);
+
+			memcpy(&peUnwindInfo.m_iHandlerRVA, pTrailer, sizeof(uint32_t));
+			peUnwindInfo.m_iHandlerDataRVA = iTrailerRVA + sizeof(uint32_t);
+		}
+	}
+
+	// Returns storage for iCount unwind operations
+	PEUnwindCode* PEUnwindTable::allocateCodes(uint32_t iCount)
+	{
+		if (m_dCodePools.empty() || m_dCodePools.back().capacity() - m_dCodePools.back().size() < iCount)
+		{
+			m_dCodePools.push_back(std::vector<PEUnwindCode>());
+			m_dCodePools.back().reserve(CODE_POOL_SIZE);
+		}
+
+		// Within the reserved capacity, so the pool (& the codes handed out before) is not reallocated
+		std::vector<PEUnwindCode>& vPool = m_dCodePools.back();
+		vPool.resize(vPool.size() + iCount);
+
+		return &vPool[vPool.size() - iCount];
+	}
+}
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "OpenPEUtils.h"
+#include "OpenPEStringView.h"
+#include <string.h>
 
 namespace OpenPE
 {
@@ -15,4 +17,79 @@ namespace OpenPE
 
 		return iFileSize;
 	}
+
+	// Appends little-endian UTF-16 string (iLength code units, need not be aligned) to sResult as UTF-8
+	void PEUtils::appendUTF8(std::string& sResult, const char* pUTF16, size_t iLength)
+	{
+		const uint8_t* pData = reinterpret_cast<const uint8_t*>(pUTF16);
+		sResult.reserve(sResult.size() + iLength);
+
+		for (size_t i = 0; i < iLength; i++)
+		{
+			// ASCII fast path: 4 code units a word (the high byte & bit 7 of the low byte of each unit are clear)
+			while (i + 4 <= iLength)
+			{
+				uint64_t iWord;
+				memcpy(&iWord, pData + 2 * i, sizeof(uint64_t));
+				if (iWord & 0xFF80FF80FF80FF80ULL)
+					break;
+
+				const char szASCII[4] = { static_cast<char>(pData[2 * i]), static_cast<char>(pData[2 * i + 2]), static_cast<char>(pData[2 * i + 4]), static_cast<char>(pData[2 * i + 6]) };
+				sResult.append(szASCII, 4);
+				i += 4;
+			}
+
+			if (i == iLength)
+				break;
+
+			uint32_t iCodePoint = pData[2 * i] | (pData[2 * i + 1] << 8);
+
+			if (iCodePoint >= 0xD800 && iCodePoint <= 0xDFFF)
+			{
+				// Surrogate pair, or U+FFFD
+				const uint32_t iLow = (i + 1 < iLength) ? (pData[2 * i + 2] | (pData[2 * i + 3] << 8)) : 0;
+				if (iCodePoint <= 0xDBFF && iLow >= 0xDC00 && iLow <= 0xDFFF)
+				{
+					iCodePoint = 0x10000 + ((iCodePoint - 0xD800) << 10) + (iLow - 0xDC00);
+					i++;
+				}
+				else
+					iCodePoint = 0xFFFD;
+			}
+
+			if (iCodePoint < 0x80)
+				sResult.push_back(static_cast<char>(iCodePoint));
+			else if (iCodePoint < 0x800)
+			{
+				sResult.push_back(static_cast<char>(0xC0 | (iCodePoint >> 6)));
+				sResult.push_back(static_cast<char>(0x80 | (iCodePoint & 0x3F)));
+			}
+			else if (iCodePoint < 0x10000)
+			{
+				sResult.push_back(static_cast<char>(0xE0 | (iCodePoint >> 12)));
+				sResult.push_back(static_cast<char>(0x80 | ((iCodePoint >> 6) & 0x3F)));
+				sResult.push_back(static_cast<char>(0x80 | (iCodePoint & 0x3F)));
+			}
+			else
+			{
+				sResult.push_back(static_cast<char>(0xF0 | (iCodePoint >> 18)));
+				sResult.push_back(static_cast<char>(0x80 | ((iCodePoint >> 12) & 0x3F)));
+				sResult.push_back(static_cast<char>(0x80 | ((iCodePoint >> 6) & 0x3F)));
+				sResult.push_back(static_cast<char>(0x80 | (iCodePoint & 0x3F)));
+			}
+		}
+	}
+
+	// Returns FNV-1a hash of the name
+	uint32_t PEUtils::hashName(const PEStringView& sName)
+	{
+		uint32_t iHash = 0x811C9DC5;
+		for (const char* p = sName.begin(); p != sName.end(); ++p)
+		{
+			iHash ^= static_cast<uint8_t>(*p);
+			iHash *= 0x01000193;
+		}
+
+		return iHash;
+	}
 }
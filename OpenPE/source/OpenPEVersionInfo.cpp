@@ -0,0 +1,368 @@
+#include "OpenPEVersionInfo.h"
+#include "OpenPEResources.h"
+#include "OpenPEException.h"
+#include <stdio.h>
+#include <string.h>
+
+namespace OpenPE
+{
+	// Type of blocks with text values
+	static const uint16_t VERSION_BLOCK_TEXT = 1;
+
+	// Helper: header of a version block (VS_VERSIONINFO, StringFileInfo, StringTable, String, VarFileInfo, Var)
+	struct PEVersionBlock
+	{
+		uint32_t			m_iEnd;						// Offset of the end of the block (bounded by the parent)
+		uint32_t			m_iNext;					// Offset of the next sibling
+		PEWideStringView	m_vKey;
+		uint32_t			m_iValueOffset;
+		uint32_t			m_iValueSize;				// In bytes (bounded by the block)
+		uint32_t			m_iChildren;				// Offset of the first child
+		uint16_t			m_iType;
+	};
+
+	// Helper: returns 16-bit little-endian value at offset
+	static inline uint16_t readWord(const char* pData, uint32_t iOffset)
+	{
+		return static_cast<uint16_t>(static_cast<uint8_t>(pData[iOffset]) | (static_cast<uint8_t>(pData[iOffset + 1]) << 8));
+	}
+
+	// Helper: returns offset aligned up to DWORD (offsets are relative to the start of VS_VERSIONINFO)
+	static inline uint32_t alignBlockOffset(uint32_t iOffset)
+	{
+		return (iOffset + 3) & ~static_cast<uint32_t>(3);
+	}
+
+	// Helper: decodes header of the block at offset, returns 'false' if there is no block
+	static bool decodeBlock(const char* pData, uint32_t iOffset, uint32_t iEnd, PEVersionBlock& peBlock)
+	{
+		// wLength, wValueLength, wType, at least the key terminator
+		if (iOffset >= iEnd || iEnd - iOffset < 4 * sizeof(uint16_t))
+			return false;
+
+		const uint16_t iLength = readWord(pData, iOffset);
+		const uint16_t iValueLength = readWord(pData, iOffset + 2);
+		if (iLength < 4 * sizeof(uint16_t))
+			return false;
+
+		peBlock.m_iType = readWord(pData, iOffset + 4);
+		peBlock.m_iEnd = (iLength < iEnd - iOffset) ? iOffset + iLength : iEnd;
+		peBlock.m_iNext = alignBlockOffset(iOffset + iLength);
+
+		// Null-terminated key
+		const uint32_t iKeyOffset = iOffset + 3 * sizeof(uint16_t);
+		uint32_t iKeyEnd = iKeyOffset;
+		while (iKeyEnd + sizeof(uint16_t) <= peBlock.m_iEnd && readWord(pData, iKeyEnd))
+			iKeyEnd += sizeof(uint16_t);
+
+		peBlock.m_vKey = PEWideStringView(pData + iKeyOffset, (iKeyEnd - iKeyOffset) / sizeof(uint16_t));
+
+		// Text values are measured in characters (some tools write bytes, the block bounds them either way)
+		peBlock.m_iValueOffset = alignBlockOffset(iKeyEnd + sizeof(uint16_t));
+		if (peBlock.m_iValueOffset > peBlock.m_iEnd)
+			peBlock.m_iValueOffset = peBlock.m_iEnd;
+
+		uint32_t iValueSize = (peBlock.m_iType == VERSION_BLOCK_TEXT) ? iValueLength * sizeof(uint16_t) : iValueLength;
+		if (iValueSize > peBlock.m_iEnd - peBlock.m_iValueOffset)
+			iValueSize = peBlock.m_iEnd - peBlock.m_iValueOffset;
+
+		peBlock.m_iValueSize = iValueSize;
+		peBlock.m_iChildren = alignBlockOffset(peBlock.m_iValueOffset + iValueSize);
+
+		return true;
+	}
+
+	// Helper: returns hex digit value, or -1
+	static int getHexDigit(uint16_t c)
+	{
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return -1;
+	}
+
+	// Helper: returns version as "major.minor.build.revision"
+	static std::string formatVersion(uint32_t iMS, uint32_t iLS)
+	{
+		char szVersion[32];
+		sprintf(szVersion, "%u.%u.%u.%u", iMS >> 16, iMS & 0xFFFF, iLS >> 16, iLS & 0xFFFF);
+
+		return szVersion;
+	}
+
+	// Default Constructor
+	PEVersionString::PEVersionString()
+		: m_iLanguage(0)
+		, m_iCodePage(0)
+	{
+	}
+
+	// Returns language of the StringTable
+	uint16_t PEVersionString::getLanguage() const
+	{
+		return m_iLanguage;
+	}
+
+	// Returns code page of the StringTable
+	uint16_t PEVersionString::getCodePage() const
+	{
+		return m_iCodePage;
+	}
+
+	// Returns the key
+	const PEWideStringView& PEVersionString::getKey() const
+	{
+		return m_vKey;
+	}
+
+	// Returns the value (without trailing nulls)
+	const PEWideStringView& PEVersionString::getValue() const
+	{
+		return m_vValue;
+	}
+
+	// Returns the value converted to UTF-8
+	std::string PEVersionString::getValueUTF8() const
+	{
+		return m_vValue.str();
+	}
+
+	// Default Constructor
+	PEVersionInfo::PEVersionInfo()
+		: m_bHasFixedFileInfo(false)
+	{
+		memset(&m_FixedFileInfo, 0, sizeof(VS_FIXEDFILEINFO));
+	}
+
+	// Returns 'true' if version information has VS_FIXEDFILEINFO
+	bool PEVersionInfo::hasFixedFileInfo() const
+	{
+		return m_bHasFixedFileInfo;
+	}
+
+	// Returns VS_FIXEDFILEINFO (zero-filled if there is none)
+	const VS_FIXEDFILEINFO& PEVersionInfo::getFixedFileInfo() const
+	{
+		return m_FixedFileInfo;
+	}
+
+	// Returns file version (FileVersionMS:FileVersionLS)
+	uint64_t PEVersionInfo::getFileVersion() const
+	{
+		return (static_cast<uint64_t>(m_FixedFileInfo.iFileVersionMS) << 32) | m_FixedFileInfo.iFileVersionLS;
+	}
+
+	// Returns product version (ProductVersionMS:ProductVersionLS)
+	uint64_t PEVersionInfo::getProductVersion() const
+	{
+		return (static_cast<uint64_t>(m_FixedFileInfo.iProductVersionMS) << 32) | m_FixedFileInfo.iProductVersionLS;
+	}
+
+	// Returns file flags (masked by FileFlagsMask)
+	uint32_t PEVersionInfo::getFileFlags() const
+	{
+		return m_FixedFileInfo.iFileFlags & m_FixedFileInfo.iFileFlagsMask;
+	}
+
+	// Returns operating system the file was designed for
+	uint32_t PEVersionInfo::getFileOS() const
+	{
+		return m_FixedFileInfo.iFileOS;
+	}
+
+	// Returns file type
+	uint32_t PEVersionInfo::getFileType() const
+	{
+		return m_FixedFileInfo.iFileType;
+	}
+
+	// Returns file subtype
+	uint32_t PEVersionInfo::getFileSubtype() const
+	{
+		return m_FixedFileInfo.iFileSubtype;
+	}
+
+	// Returns file version as "major.minor.build.revision" (empty, if there is no VS_FIXEDFILEINFO)
+	std::string PEVersionInfo::getFileVersionString() const
+	{
+		return m_bHasFixedFileInfo ? formatVersion(m_FixedFileInfo.iFileVersionMS, m_FixedFileInfo.iFileVersionLS) : std::string();
+	}
+
+	// Returns product version as "major.minor.build.revision" (empty, if there is no VS_FIXEDFILEINFO)
+	std::string PEVersionInfo::getProductVersionString() const
+	{
+		return m_bHasFixedFileInfo ? formatVersion(m_FixedFileInfo.iProductVersionMS, m_FixedFileInfo.iProductVersionLS) : std::string();
+	}
+
+	// Returns all strings of all StringTables (in the order of the resource)
+	const PEVERSION_STRING_LIST& PEVersionInfo::getStrings() const
+	{
+		return m_vStrings;
+	}
+
+	// Returns the first string with the key (ASCII, case-insensitive), or 0 if there is none
+	const PEVersionString* PEVersionInfo::findString(const PEStringView& sKey) const
+	{
+		for (PEVERSION_STRING_LIST::const_iterator itr = m_vStrings.begin(); itr != m_vStrings.end(); ++itr)
+		{
+			if (itr->getKey().equalsIgnoreCase(sKey))
+				return &*itr;
+		}
+
+		return 0;
+	}
+
+	// Sets sValue to UTF-8 value of the first string with the key, returns 'false' if there is none
+	bool PEVersionInfo::getString(const PEStringView& sKey, std::string& sValue) const
+	{
+		const PEVersionString* pString = findString(sKey);
+		if (NOT pString)
+			return false;
+
+		sValue.clear();
+		PEUtils::appendUTF8(sValue, pString->getValue().data(), pString->getValue().length());
+
+		return true;
+	}
+
+	// Returns translations of VarFileInfo (language in the low word, code page in the high word)
+	const std::vector<uint32_t>& PEVersionInfo::getTranslations() const
+	{
+		return m_vTranslations;
+	}
+
+	// Clears the information (keeps capacity of the lists)
+	void PEVersionInfo::clear()
+	{
+		m_bHasFixedFileInfo = false;
+		memset(&m_FixedFileInfo, 0, sizeof(VS_FIXEDFILEINFO));
+		m_vStrings.clear();
+		m_vTranslations.clear();
+	}
+
+	// Decodes VS_VERSIONINFO of iSize bytes at pData
+	bool parseVersionInfo(const char* pData, uint32_t iSize, PEVersionInfo& peVersionInfo)
+	{
+		peVersionInfo.clear();
+
+		PEVersionBlock peRoot;
+		if (NOT pData || NOT decodeBlock(pData, 0, iSize, peRoot) || NOT peRoot.m_vKey.equalsIgnoreCase(PEStringView("VS_VERSION_INFO")))
+			return false;
+
+		if (peRoot.m_iValueSize >= sizeof(VS_FIXEDFILEINFO))
+		{
+			VS_FIXEDFILEINFO peFixedFileInfo;
+			memcpy(&peFixedFileInfo, pData + peRoot.m_iValueOffset, sizeof(VS_FIXEDFILEINFO));
+
+			if (peFixedFileInfo.iSignature == VS_FFI_SIGNATURE)
+			{
+				peVersionInfo.m_FixedFileInfo = peFixedFileInfo;
+				peVersionInfo.m_bHasFixedFileInfo = true;
+			}
+		}
+
+		// Every sibling starts past the previous one, so the loops end
+		PEVersionBlock peFileInfo;
+		for (uint32_t iFileInfo = peRoot.m_iChildren; decodeBlock(pData, iFileInfo, peRoot.m_iEnd, peFileInfo); iFileInfo = peFileInfo.m_iNext)
+		{
+			if (peFileInfo.m_vKey.equalsIgnoreCase(PEStringView("StringFileInfo")))
+			{
+				PEVersionBlock peTable;
+				for (uint32_t iTable = peFileInfo.m_iChildren; decodeBlock(pData, iTable, peFileInfo.m_iEnd, peTable); iTable = peTable.m_iNext)
+				{
+					// Key is the language & code page as 8 hex digits ("040904B0")
+					uint32_t iTranslation = 0;
+					for (size_t i = 0; i < peTable.m_vKey.length() && i < 8; i++)
+					{
+						const int iDigit = getHexDigit(peTable.m_vKey[i]);
+						iTranslation = (iTranslation << 4) | (iDigit < 0 ? 0 : iDigit);
+					}
+
+					PEVersionBlock peString;
+					for (uint32_t iString = peTable.m_iChildren; decodeBlock(pData, iString, peTable.m_iEnd, peString); iString = peString.m_iNext)
+					{
+						size_t iValueLength = peString.m_iValueSize / sizeof(uint16_t);
+						while (iValueLength && readWord(pData, peString.m_iValueOffset + static_cast<uint32_t>(iValueLength - 1) * sizeof(uint16_t)) == 0)
+							iValueLength--;
+
+						peVersionInfo.m_vStrings.push_back(PEVersionString());
+						PEVersionString& peVersionString = peVersionInfo.m_vStrings.back();
+						peVersionString.m_iLanguage = static_cast<uint16_t>(iTranslation >> 16);
+						peVersionString.m_iCodePage = static_cast<uint16_t>(iTranslation);
+						peVersionString.m_vKey = peString.m_vKey;
+						peVersionString.m_vValue = PEWideStringView(pData + peString.m_iValueOffset, iValueLength);
+					}
+				}
+			}
+			else if (peFileInfo.m_vKey.equalsIgnoreCase(PEStringView("VarFileInfo")))
+			{
+				PEVersionBlock peVar;
+				for (uint32_t iVar = peFileInfo.m_iChildren; decodeBlock(pData, iVar, peFileInfo.m_iEnd, peVar); iVar = peVar.m_iNext)
+				{
+					if (NOT peVar.m_vKey.equalsIgnoreCase(PEStringView("Translation")))
+						continue;
+
+					for (uint32_t i = 0; i + sizeof(uint32_t) <= peVar.m_iValueSize; i += sizeof(uint32_t))
+					{
+						const uint32_t iOffset = peVar.m_iValueOffset + i;
+						peVersionInfo.m_vTranslations.push_back(readWord(pData, iOffset) | (static_cast<uint32_t>(readWord(pData, iOffset + 2)) << 16));
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+
+	// Locates RT_VERSION resource of the Image & decodes it
+	bool readVersionInfo(const PEBase& peBase, PEVersionInfo& peVersionInfo)
+	{
+		peVersionInfo.clear();
+
+		PEResources peResources(peBase);
+		if (NOT peResources.hasResources())
+			return false;
+
+		// The first name & the first language (there is normally a single VS_VERSION_INFO)
+		PEResourceEntry peEntry;
+		if (	NOT peResources.getRoot().findEntry(static_cast<uint16_t>(PE_RESOURCE_VERSION), peEntry)
+				||
+				NOT peEntry.isDirectory()
+				||
+				NOT peEntry.getDirectory().getEntry(0, peEntry)
+				||
+				NOT peEntry.isDirectory()
+				||
+				NOT peEntry.getDirectory().getEntry(0, peEntry)
+				||
+				peEntry.isDirectory()
+				||
+				NOT peEntry.getData().hasData()
+		) {
+			return false;
+		}
+
+		return parseVersionInfo(peEntry.getData().getData(), peEntry.getData().getSize(), peVersionInfo);
+	}
+
+	// Reads version information of iNumberOfImages Images into pVersionInfos, returns number of Images with version information
+	size_t readVersionInfos(const PEBase* const* pImages, size_t iNumberOfImages, PEVersionInfo* pVersionInfos)
+	{
+		size_t iNumberOfRead = 0;
+
+		for (size_t i = 0; i < iNumberOfImages; i++)
+		{
+			try
+			{
+				if (readVersionInfo(*pImages[i], pVersionInfos[i]))
+					iNumberOfRead++;
+			}
+			catch (const PEException&)
+			{
+				pVersionInfos[i].clear();
+			}
+		}
+
+		return iNumberOfRead;
+	}
+}
\ No newline at end of file